@@ -25,12 +25,19 @@ LOCAL_SRC_FILES:= \
     src/amber.cc \
     src/amberscript/parser.cc \
     src/buffer.cc \
+    src/buffer_storage.cc \
     src/command.cc \
     src/command_data.cc \
     src/descriptor_set_and_binding_parser.cc \
+    src/encoding.cc \
     src/engine.cc \
     src/executor.cc \
     src/format.cc \
+    src/hash.cc \
+    src/image_converter.cc \
+    src/image_metrics.cc \
+    src/mapped_file.cc \
+    src/parallel.cc \
     src/parser.cc \
     src/pipeline.cc \
     src/pipeline_data.cc \
@@ -45,6 +45,19 @@ enum class ExecutionType {
   kPipelineCreateOnly
 };
 
+/// Layout of the pixels handed back for an image buffer extraction. The
+/// attachment is converted from its own format into this layout.
+enum class ImageDataFormat {
+  /// Four 8-bit unsigned normalized components in BGRA order.
+  kB8G8R8A8Unorm = 0,
+  /// Four 8-bit unsigned normalized components in RGBA order.
+  kR8G8B8A8Unorm,
+  /// Four 16-bit unsigned normalized components in RGBA order.
+  kR16G16B16A16Unorm,
+  /// Four 32-bit floats in RGBA order. Values are not clamped.
+  kR32G32B32A32Sfloat,
+};
+
 /// Override point of engines to add their own configuration.
 struct EngineConfig {
   virtual ~EngineConfig();
@@ -66,7 +79,20 @@ struct BufferInfo {
   uint32_t width;
   /// Holds the buffer height
   uint32_t height;
-  /// Contains the buffer internal data
+  /// The pixel layout to convert an image buffer into. Ignored for other
+  /// buffers.
+  ImageDataFormat image_format;
+  /// Holds the number of bytes in one element of |data|. For image buffers an
+  /// element is one pixel in |image_format|.
+  uint32_t element_size;
+  /// Contains the raw bytes of the buffer. Image buffers hold |width| *
+  /// |height| pixels in row-major order, without padding between rows.
+  std::vector<uint8_t> data;
+  /// Set to also fill |values|. Off by default, as a Value per byte is far
+  /// larger and slower to build than |data|.
+  bool fill_values;
+  /// Deprecated, read |data| instead. When |fill_values| is set, holds one
+  /// Value per pixel of a B8G8R8A8 image buffer, and one per byte otherwise.
   std::vector<Value> values;
 };
 
@@ -85,6 +111,31 @@ class Delegate {
   virtual uint64_t GetTimestampNs() const = 0;
   /// Tells whether to log each test as it's executed
   virtual bool LogExecuteCalls() const = 0;
+  /// Tells whether to report trace spans through TraceSpan(). Defaults to
+  /// false.
+  virtual bool IsTracing() const;
+  /// Reports that the step |name| in |category| ran from |start_ns| to
+  /// |end_ns|, as given by GetTimestampNs(). May be called from any thread.
+  virtual void TraceSpan(const char* category,
+                         const char* name,
+                         uint64_t start_ns,
+                         uint64_t end_ns);
+};
+
+/// Remembers the SPIR-V modules which passed validation, so a module seen
+/// before is not validated again. A module is identified by a key computed
+/// from its words, the SPIR-V environment, the validator options and the
+/// SPIRV-Tools version. Implementations may keep the keys between runs.
+class ValidationCache {
+ public:
+  virtual ~ValidationCache();
+
+  /// Returns true if the module identified by |key| passed validation. May
+  /// be called from any thread.
+  virtual bool IsValidated(uint64_t key) = 0;
+  /// Records that the module identified by |key| passed validation. May be
+  /// called from any thread.
+  virtual void AddValidated(uint64_t key) = 0;
 };
 
 /// Stores configuration options for Amber.
@@ -114,6 +165,13 @@ struct Options {
   /// If true, disables SPIR-V validation. If false, SPIR-V shaders will be
   /// validated using the Validator component (spirv-val) from SPIRV-Tools.
   bool disable_spirv_validation;
+  /// If set, shaders which passed validation are recorded in the cache, and
+  /// shaders found in it are not validated again. Ownership stays with the
+  /// caller.
+  ValidationCache* validation_cache;
+  /// Number of threads used to verify probes of large buffers. A value of 0
+  /// or 1 verifies on the calling thread.
+  uint32_t verifier_thread_count;
   /// Delegate implementation
   Delegate* delegate;
 };
@@ -122,8 +180,15 @@ struct Options {
 class Amber {
  public:
   Amber();
+  /// Creates an Amber which reports trace spans for Parse() through
+  /// |delegate|. Execution reports through the delegate of its |Options|.
+  explicit Amber(Delegate* delegate);
   ~Amber();
 
+  /// Sets the number of threads Parse() uses to generate the contents of
+  /// large buffers. Defaults to 1, which generates them on the calling thread.
+  void SetParseThreadCount(uint32_t count) { parse_thread_count_ = count; }
+
   /// Parse the given |data| into the |recipe|.
   amber::Result Parse(const std::string& data, amber::Recipe* recipe);
 
@@ -145,6 +210,10 @@ class Amber {
   amber::Result ExecuteWithShaderData(const amber::Recipe* recipe,
                                       Options* opts,
                                       const ShaderMap& shader_data);
+
+ private:
+  Delegate* delegate_ = nullptr;
+  uint32_t parse_thread_count_ = 1;
 };
 
 }  // namespace amber
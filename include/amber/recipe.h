@@ -31,6 +31,11 @@ class RecipeImpl {
   /// Retrieves information on all the shaders in the given recipe.
   virtual std::vector<ShaderInfo> GetShaderInfo() const = 0;
 
+  /// Returns the distinct optimization passes of the pipelines attaching the
+  /// shader |shader_name|.
+  virtual std::vector<std::vector<std::string>> GetShaderOptimizations(
+      const std::string& shader_name) const = 0;
+
   /// Returns required features in the given recipe.
   virtual std::vector<std::string> GetRequiredFeatures() const = 0;
 
@@ -53,9 +58,17 @@ class Recipe {
   Recipe();
   ~Recipe();
 
-  /// Retrieves information on all the shaders in the recipe.
+  /// Retrieves information on all the shaders in the recipe. The
+  /// optimizations of each are those of the first pipeline attaching it.
   std::vector<ShaderInfo> GetShaderInfo() const;
 
+  /// Returns each distinct set of optimization passes the pipelines attaching
+  /// the shader |shader_name| run on it. A ShaderMap entry for the shader is
+  /// used by all of those pipelines, so it can only be precompiled when there
+  /// is at most one set.
+  std::vector<std::vector<std::string>> GetShaderOptimizations(
+      const std::string& shader_name) const;
+
   RecipeImpl* GetImpl() const { return impl_; }
   /// Sets the recipe implementation. Ownership transfers to the recipe.
   void SetImpl(RecipeImpl* impl) { impl_ = impl; }
@@ -21,9 +21,11 @@ LOCAL_SRC_FILES:= \
     amber.cc \
     config_helper.cc \
     config_helper_vulkan.cc \
+    deflate.cc \
     log.cc \
     ppm.cc \
     png.cc \
+    shader_bundle.cc \
     timestamp.cc
 LOCAL_C_INCLUDES := $(LOCAL_PATH)/.. $(LOCAL_PATH)/../include
 LOCAL_LDLIBS:=-landroid -lvulkan -llog
@@ -15,21 +15,31 @@
 #include "amber/amber.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdlib>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <mutex>
 #include <set>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include "amber/recipe.h"
 #include "samples/config_helper.h"
 #include "samples/ppm.h"
+#include "samples/shader_bundle.h"
 #include "samples/timestamp.h"
 #include "src/build-versions.h"
+#include "src/hash.h"
 #include "src/make_unique.h"
+#include "src/mapped_file.h"
+#include "src/parallel.h"
+#include "src/trace.h"
 
 #if AMBER_ENABLE_LODEPNG
 #include "samples/png.h"
@@ -44,6 +54,9 @@ struct Options {
 
   std::vector<std::string> image_filenames;
   std::string buffer_filename;
+  std::string trace_filename;
+  std::string shader_bundle_filename;
+  std::string validation_cache_filename;
   std::vector<std::string> fb_names;
   std::vector<amber::BufferInfo> buffer_to_dump;
   uint32_t engine_major = 1;
@@ -59,6 +72,11 @@ struct Options {
   bool log_graphics_calls_time = false;
   bool log_execute_calls = false;
   bool disable_spirv_validation = false;
+  bool print_buffer_hashes = false;
+  uint32_t verifier_thread_count = 1;
+  uint32_t png_compression_level = 6;
+  uint32_t image_thread_count = 1;
+  uint32_t parse_thread_count = 1;
   amber::EngineType engine = amber::kEngineTypeVulkan;
   std::string spv_env;
 };
@@ -79,6 +97,7 @@ const char kUsage[] = R"(Usage: amber [options] SCRIPT [SCRIPTS...]
                                Use vulkan1.1spv1.4 for SPIR-V 1.4 with Vulkan 1.1.
                                Defaults to spv1.0.
   -i <filename>             -- Write rendering to <filename> as a PNG image if it ends with '.png',
+                               as a float PFM image if it ends with '.pfm',
                                or as a PPM image otherwise.
   -I <buffername>           -- Name of framebuffer to dump. Defaults to 'framebuffer'.
   -b <filename>             -- Write contents of a UBO or SSBO to <filename>.
@@ -91,9 +110,66 @@ const char kUsage[] = R"(Usage: amber [options] SCRIPT [SCRIPTS...]
   --log-graphics-calls-time -- Log timing of graphics API calls timing (Vulkan only).
   --log-execute-calls       -- Log each execute call before run.
   --disable-spirv-val       -- Disable SPIR-V validation.
+  --verifier-threads <n>    -- Number of threads used to verify large probes. Default 1.
+  --png-level <0-9>         -- PNG compression level. 0 stores, 1 is a fast compressor. Default 6.
+  --image-threads <n>       -- Number of threads used to compress PNG levels 0 and 1. Default 1.
+  --parse-threads <n>       -- Number of threads used to read and parse the scripts. Default 1.
+  --print-buffer-hashes     -- Print the xxh64 and crc32c hashes of each buffer dumped with
+                               -I or -B, for use with EXPECT HASH.
+  --shader-bundle <file>    -- Use the precompiled shaders in <file>, written by
+                               amber_precompile. Shaders missing from the bundle, or
+                               changed since, are compiled as usual.
+  --validation-cache <file> -- Skip validating SPIR-V which passed validation in an earlier run,
+                               as recorded in <file>. Newly validated shaders are added to it.
+  --trace <filename>        -- Write a timeline of parsing, compiling, pipeline creation,
+                               submission, fence waits, verification and image writing to
+                               <filename> in the Chrome trace event JSON format.
   -h                        -- This help text.
 )";
 
+bool HasExtension(const std::string& filename, const std::string& extension) {
+  auto pos = filename.find_last_of('.');
+  return pos != std::string::npos && filename.substr(pos + 1) == extension;
+}
+
+// Returns the pixel layout |filename| is written from. PNG takes RGBA so the
+// encoder needs no copy, PFM takes floats and PPM takes the default BGRA.
+amber::ImageDataFormat ImageFormatForFilename(const std::string& filename) {
+  if (HasExtension(filename, "png"))
+    return amber::ImageDataFormat::kR8G8B8A8Unorm;
+  if (HasExtension(filename, "pfm"))
+    return amber::ImageDataFormat::kR32G32B32A32Sfloat;
+  return amber::ImageDataFormat::kB8G8R8A8Unorm;
+}
+
+// Returns the image extraction of |name| converted to |format|, if requested.
+const amber::BufferInfo* FindImageExtraction(
+    const std::vector<amber::BufferInfo>& extractions,
+    const std::string& name,
+    amber::ImageDataFormat format) {
+  for (const auto& info : extractions) {
+    if (info.is_image_buffer && info.buffer_name == name &&
+        info.image_format == format) {
+      return &info;
+    }
+  }
+  return nullptr;
+}
+
+// Prints the hashes of the bytes held in |info|, as would be computed by an
+// EXPECT HASH command.
+void PrintBufferHashes(const amber::BufferInfo& info) {
+  const std::vector<uint8_t>& bytes = info.data;
+  std::cout << info.buffer_name << std::hex << std::setfill('0')
+            << " xxh64 0x" << std::setw(16)
+            << amber::HashData(amber::HashType::kXXH64, bytes.data(),
+                               bytes.size())
+            << " crc32c 0x" << std::setw(8)
+            << amber::HashData(amber::HashType::kCRC32C, bytes.data(),
+                               bytes.size())
+            << std::dec << std::endl;
+}
+
 bool ParseArgs(const std::vector<std::string>& args, Options* opts) {
   for (size_t i = 1; i < args.size(); ++i) {
     const std::string& arg = args[i];
@@ -214,6 +290,86 @@ bool ParseArgs(const std::vector<std::string>& args, Options* opts) {
       opts->log_execute_calls = true;
     } else if (arg == "--disable-spirv-val") {
       opts->disable_spirv_validation = true;
+    } else if (arg == "--print-buffer-hashes") {
+      opts->print_buffer_hashes = true;
+    } else if (arg == "--shader-bundle") {
+      ++i;
+      if (i >= args.size()) {
+        std::cerr << "Missing value for --shader-bundle argument."
+                  << std::endl;
+        return false;
+      }
+      opts->shader_bundle_filename = args[i];
+    } else if (arg == "--validation-cache") {
+      ++i;
+      if (i >= args.size()) {
+        std::cerr << "Missing value for --validation-cache argument."
+                  << std::endl;
+        return false;
+      }
+      opts->validation_cache_filename = args[i];
+    } else if (arg == "--trace") {
+      ++i;
+      if (i >= args.size()) {
+        std::cerr << "Missing value for --trace argument." << std::endl;
+        return false;
+      }
+      opts->trace_filename = args[i];
+    } else if (arg == "--verifier-threads") {
+      ++i;
+      if (i >= args.size()) {
+        std::cerr << "Missing value for --verifier-threads argument."
+                  << std::endl;
+        return false;
+      }
+
+      int32_t val = std::stoi(std::string(args[i]));
+      if (val < 1) {
+        std::cerr << "Verifier thread count must be positive" << std::endl;
+        return false;
+      }
+      opts->verifier_thread_count = static_cast<uint32_t>(val);
+    } else if (arg == "--png-level") {
+      ++i;
+      if (i >= args.size()) {
+        std::cerr << "Missing value for --png-level argument." << std::endl;
+        return false;
+      }
+
+      int32_t val = std::stoi(std::string(args[i]));
+      if (val < 0 || val > 9) {
+        std::cerr << "PNG level must be between 0 and 9" << std::endl;
+        return false;
+      }
+      opts->png_compression_level = static_cast<uint32_t>(val);
+    } else if (arg == "--image-threads") {
+      ++i;
+      if (i >= args.size()) {
+        std::cerr << "Missing value for --image-threads argument."
+                  << std::endl;
+        return false;
+      }
+
+      int32_t val = std::stoi(std::string(args[i]));
+      if (val < 1) {
+        std::cerr << "Image thread count must be positive" << std::endl;
+        return false;
+      }
+      opts->image_thread_count = static_cast<uint32_t>(val);
+    } else if (arg == "--parse-threads") {
+      ++i;
+      if (i >= args.size()) {
+        std::cerr << "Missing value for --parse-threads argument."
+                  << std::endl;
+        return false;
+      }
+
+      int32_t val = std::stoi(std::string(args[i]));
+      if (val < 1) {
+        std::cerr << "Parse thread count must be positive" << std::endl;
+        return false;
+      }
+      opts->parse_thread_count = static_cast<uint32_t>(val);
     } else if (arg.size() > 0 && arg[0] == '-') {
       std::cerr << "Unrecognized option " << arg << std::endl;
       return false;
@@ -225,42 +381,6 @@ bool ParseArgs(const std::vector<std::string>& args, Options* opts) {
   return true;
 }
 
-std::string ReadFile(const std::string& input_file) {
-  FILE* file = nullptr;
-#if defined(_MSC_VER)
-  fopen_s(&file, input_file.c_str(), "rb");
-#else
-  file = fopen(input_file.c_str(), "rb");
-#endif
-  if (!file) {
-    std::cerr << "Failed to open " << input_file << std::endl;
-    return {};
-  }
-
-  fseek(file, 0, SEEK_END);
-  uint64_t tell_file_size = static_cast<uint64_t>(ftell(file));
-  if (tell_file_size <= 0) {
-    std::cerr << "Input file of incorrect size: " << input_file << std::endl;
-    fclose(file);
-    return {};
-  }
-  fseek(file, 0, SEEK_SET);
-
-  size_t file_size = static_cast<size_t>(tell_file_size);
-
-  std::vector<char> data;
-  data.resize(file_size);
-
-  size_t bytes_read = fread(data.data(), sizeof(char), file_size, file);
-  fclose(file);
-  if (bytes_read != file_size) {
-    std::cerr << "Failed to read " << input_file << std::endl;
-    return {};
-  }
-
-  return std::string(data.begin(), data.end());
-}
-
 class SampleDelegate : public amber::Delegate {
  public:
   SampleDelegate() = default;
@@ -295,12 +415,173 @@ class SampleDelegate : public amber::Delegate {
     return timestamp::SampleGetTimestampNs();
   }
 
+  bool IsTracing() const override { return tracing_; }
+  void SetTracing(bool tracing) {
+    tracing_ = tracing;
+    trace_start_ns_ = GetTimestampNs();
+  }
+
+  void TraceSpan(const char* category,
+                 const char* name,
+                 uint64_t start_ns,
+                 uint64_t end_ns) override {
+    std::lock_guard<std::mutex> lock(trace_mutex_);
+    auto id = thread_ids_.insert(
+        std::make_pair(std::this_thread::get_id(),
+                       static_cast<uint32_t>(thread_ids_.size() + 1)));
+    spans_.push_back({category, name, start_ns, end_ns, id.first->second});
+  }
+
+  // Writes the spans in the Chrome trace event format, which can be loaded
+  // into chrome://tracing or Perfetto. Times are in microseconds from the
+  // start of tracing.
+  void WriteTrace(std::ostream& out) {
+    std::lock_guard<std::mutex> lock(trace_mutex_);
+    out << std::fixed << std::setprecision(3);
+    out << "{\"traceEvents\": [";
+    for (size_t i = 0; i < spans_.size(); ++i) {
+      const auto& span = spans_[i];
+      uint64_t start_ns = std::max(span.start_ns, trace_start_ns_);
+      uint64_t end_ns = std::max(span.end_ns, start_ns);
+      out << (i == 0 ? "\n" : ",\n");
+      out << "  {\"name\": \"" << span.name << "\", \"cat\": \""
+          << span.category << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+          << span.thread << ", \"ts\": "
+          << static_cast<double>(start_ns - trace_start_ns_) / 1000.0
+          << ", \"dur\": " << static_cast<double>(end_ns - start_ns) / 1000.0
+          << "}";
+    }
+    out << "\n], \"displayTimeUnit\": \"ms\"}\n";
+  }
+
  private:
+  struct Span {
+    const char* category;
+    const char* name;
+    uint64_t start_ns;
+    uint64_t end_ns;
+    uint32_t thread;
+  };
+
   bool log_graphics_calls_ = false;
   bool log_graphics_calls_time_ = false;
   bool log_execute_calls_ = false;
+  bool tracing_ = false;
+  uint64_t trace_start_ns_ = 0;
+  std::mutex trace_mutex_;
+  std::map<std::thread::id, uint32_t> thread_ids_;
+  std::vector<Span> spans_;
 };
 
+// Keeps the keys of the shaders which passed validation in a file between
+// runs, one hexadecimal key per line.
+class SampleValidationCache : public amber::ValidationCache {
+ public:
+  SampleValidationCache() = default;
+  ~SampleValidationCache() override = default;
+
+  bool IsValidated(uint64_t key) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return keys_.count(key) > 0;
+  }
+
+  void AddValidated(uint64_t key) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (keys_.insert(key).second)
+      changed_ = true;
+  }
+
+  // Reads the keys in |filename|. A missing file is an empty cache, and lines
+  // which are not keys are skipped, those shaders are just validated again.
+  void Load(const std::string& filename) {
+    std::ifstream in(filename, std::ios::in);
+    std::string line;
+    while (std::getline(in, line)) {
+      char* end = nullptr;
+      uint64_t key = std::strtoull(line.c_str(), &end, 16);
+      if (end != line.c_str())
+        keys_.insert(key);
+    }
+  }
+
+  // Writes the keys to |filename| if any were added since Load().
+  bool Save(const std::string& filename) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!changed_)
+      return true;
+
+    std::ofstream out(filename, std::ios::out);
+    if (!out.is_open()) {
+      std::cerr << "Cannot open file for validation cache: " << filename
+                << std::endl;
+      return false;
+    }
+    out << std::hex << std::setfill('0');
+    for (uint64_t key : keys_)
+      out << std::setw(16) << key << "\n";
+    changed_ = false;
+    return true;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::set<uint64_t> keys_;
+  bool changed_ = false;
+};
+
+// Writes the spans traced by |delegate| to |filename|, if tracing.
+bool WriteTraceFile(SampleDelegate* delegate, const std::string& filename) {
+  if (filename.empty())
+    return true;
+
+  std::ofstream trace_file(filename, std::ios::out);
+  if (!trace_file.is_open()) {
+    std::cerr << "Cannot open file for trace: " << filename << std::endl;
+    return false;
+  }
+  delegate->WriteTrace(trace_file);
+  return true;
+}
+
+struct RecipeData {
+  std::string file;
+  std::unique_ptr<amber::Recipe> recipe;
+  // Why |file| could not be loaded, if |recipe| is null.
+  std::string error;
+};
+
+// Reads and parses |data->file| into |data->recipe|. On failure the reason is
+// stored in |data->error| instead, so it can be reported in input order.
+void LoadRecipe(const Options& options,
+                amber::Delegate* delegate,
+                RecipeData* data) {
+  // The parser needs the script as a string, so it is read straight into one.
+  std::ifstream in(data->file, std::ios::in | std::ios::binary);
+  if (!in.is_open()) {
+    data->error = "Failed to open " + data->file;
+    return;
+  }
+  std::string script((std::istreambuf_iterator<char>(in)),
+                     std::istreambuf_iterator<char>());
+  if (script.empty()) {
+    data->error = data->file + " is empty.";
+    return;
+  }
+
+  amber::Amber am(delegate);
+  auto recipe = amber::MakeUnique<amber::Recipe>();
+  amber::Result r = am.Parse(script, recipe.get());
+  if (!r.IsSuccess()) {
+    data->error = data->file + ": " + r.Error();
+    return;
+  }
+
+  if (options.fence_timeout > -1)
+    recipe->SetFenceTimeout(static_cast<uint32_t>(options.fence_timeout));
+
+  data->recipe = std::move(recipe);
+}
+
 }  // namespace
 
 int main(int argc, const char** argv) {
@@ -329,49 +610,49 @@ int main(int argc, const char** argv) {
     return 0;
   }
 
+  SampleDelegate delegate;
+  if (options.log_graphics_calls)
+    delegate.SetLogGraphicsCalls(true);
+  if (options.log_graphics_calls_time)
+    delegate.SetLogGraphicsCallsTime(true);
+  if (options.log_execute_calls)
+    delegate.SetLogExecuteCalls(true);
+  if (!options.trace_filename.empty())
+    delegate.SetTracing(true);
+
   amber::Result result;
   std::vector<std::string> failures;
-  struct RecipeData {
-    std::string file;
-    std::unique_ptr<amber::Recipe> recipe;
-  };
-  std::vector<RecipeData> recipe_data;
-  for (const auto& file : options.input_filenames) {
-    auto data = ReadFile(file);
-    if (data.empty()) {
-      std::cerr << file << " is empty." << std::endl;
-      failures.push_back(file);
-      continue;
-    }
 
-    amber::Amber am;
-    std::unique_ptr<amber::Recipe> recipe = amber::MakeUnique<amber::Recipe>();
+  // The scripts are read and parsed on a pool of threads, each taking the
+  // next script as it finishes one. Errors are reported afterwards, in input
+  // order, and only the scripts which loaded go on to be executed.
+  std::vector<RecipeData> loaded(options.input_filenames.size());
+  for (size_t i = 0; i < loaded.size(); ++i)
+    loaded[i].file = options.input_filenames[i];
+
+  std::atomic<size_t> next_script(0);
+  uint32_t parse_threads = static_cast<uint32_t>(
+      std::min(size_t(options.parse_thread_count), loaded.size()));
+  amber::ParallelFor(parse_threads, parse_threads, 1,
+                     [&](uint32_t, size_t, size_t) {
+                       for (size_t i = next_script++; i < loaded.size();
+                            i = next_script++) {
+                         LoadRecipe(options, &delegate, &loaded[i]);
+                       }
+                     });
 
-    result = am.Parse(data, recipe.get());
-    if (!result.IsSuccess()) {
-      std::cerr << file << ": " << result.Error() << std::endl;
-      failures.push_back(file);
+  std::vector<RecipeData> recipe_data;
+  for (auto& data : loaded) {
+    if (!data.recipe) {
+      std::cerr << data.error << std::endl;
+      failures.push_back(data.file);
       continue;
     }
-
-    if (options.fence_timeout > -1)
-      recipe->SetFenceTimeout(static_cast<uint32_t>(options.fence_timeout));
-
-    recipe_data.emplace_back();
-    recipe_data.back().file = file;
-    recipe_data.back().recipe = std::move(recipe);
+    recipe_data.push_back(std::move(data));
   }
 
   if (options.parse_only)
-    return 0;
-
-  SampleDelegate delegate;
-  if (options.log_graphics_calls)
-    delegate.SetLogGraphicsCalls(true);
-  if (options.log_graphics_calls_time)
-    delegate.SetLogGraphicsCallsTime(true);
-  if (options.log_execute_calls)
-    delegate.SetLogExecuteCalls(true);
+    return WriteTraceFile(&delegate, options.trace_filename) ? 0 : 1;
 
   amber::Options amber_options;
   amber_options.engine = options.engine;
@@ -381,6 +662,13 @@ int main(int argc, const char** argv) {
                                      : amber::ExecutionType::kExecute;
   amber_options.delegate = &delegate;
   amber_options.disable_spirv_validation = options.disable_spirv_validation;
+  amber_options.verifier_thread_count = options.verifier_thread_count;
+
+  SampleValidationCache validation_cache;
+  if (!options.validation_cache_filename.empty()) {
+    validation_cache.Load(options.validation_cache_filename);
+    amber_options.validation_cache = &validation_cache;
+  }
 
   std::set<std::string> required_features;
   std::set<std::string> required_device_extensions;
@@ -420,9 +708,9 @@ int main(int argc, const char** argv) {
 
   amber_options.config = config.get();
 
-  if (!options.buffer_filename.empty()) {
+  if (!options.buffer_filename.empty() || options.print_buffer_hashes) {
     // Have a filename to dump, but no explicit buffer, set the default of 0:0.
-    if (options.buffer_to_dump.empty()) {
+    if (!options.buffer_filename.empty() && options.buffer_to_dump.empty()) {
       options.buffer_to_dump.emplace_back();
       options.buffer_to_dump.back().buffer_name = "0:0";
     }
@@ -443,19 +731,49 @@ int main(int argc, const char** argv) {
   while (options.image_filenames.size() > options.fb_names.size())
     options.fb_names.push_back(kGeneratedColorBuffer);
 
-  for (const auto& fb_name : options.fb_names) {
+  // Each framebuffer is read back once per output format, however many images
+  // are written from it.
+  for (size_t i = 0; i < options.fb_names.size(); ++i) {
+    amber::ImageDataFormat format = amber::ImageDataFormat::kB8G8R8A8Unorm;
+    if (i < options.image_filenames.size())
+      format = ImageFormatForFilename(options.image_filenames[i]);
+    if (FindImageExtraction(amber_options.extractions, options.fb_names[i],
+                            format)) {
+      continue;
+    }
+
     amber::BufferInfo buffer_info;
-    buffer_info.buffer_name = fb_name;
+    buffer_info.buffer_name = options.fb_names[i];
     buffer_info.is_image_buffer = true;
+    buffer_info.image_format = format;
     amber_options.extractions.push_back(buffer_info);
   }
 
+  // The bundle is mapped rather than read, only the SPIR-V of the shaders
+  // each script uses is copied out of it.
+  std::unique_ptr<amber::MappedFile> bundle_file;
+  shader_bundle::Reader bundle;
+  if (!options.shader_bundle_filename.empty()) {
+    r = amber::MappedFile::Open(options.shader_bundle_filename, &bundle_file);
+    if (r.IsSuccess())
+      r = bundle.Parse(bundle_file->GetData(), bundle_file->GetSize());
+    if (!r.IsSuccess()) {
+      std::cerr << options.shader_bundle_filename << ": " << r.Error()
+                << std::endl;
+      return 1;
+    }
+  }
+
   for (const auto& recipe_data_elem : recipe_data) {
     const auto* recipe = recipe_data_elem.recipe.get();
     const auto& file = recipe_data_elem.file;
 
+    amber::ShaderMap shader_map;
+    bundle.AddToShaderMap(shader_bundle::GetBundledShaders(*recipe),
+                          options.spv_env, &shader_map);
+
     amber::Amber am;
-    result = am.Execute(recipe, &amber_options);
+    result = am.ExecuteWithShaderData(recipe, &amber_options, shader_map);
     if (!result.IsSuccess()) {
       std::cerr << file << ": " << result.Error() << std::endl;
       failures.push_back(file);
@@ -465,28 +783,39 @@ int main(int argc, const char** argv) {
 
     for (size_t i = 0; i < options.image_filenames.size(); ++i) {
       std::vector<uint8_t> out_buf;
-      auto image_filename = options.image_filenames[i];
-      auto pos = image_filename.find_last_of('.');
-      bool usePNG =
-          pos != std::string::npos && image_filename.substr(pos + 1) == "png";
-      for (const amber::BufferInfo& buffer_info : amber_options.extractions) {
-        if (buffer_info.buffer_name == options.fb_names[i]) {
-          if (usePNG) {
+      const auto& image_filename = options.image_filenames[i];
+      bool usePNG = HasExtension(image_filename, "png");
+      bool usePFM = HasExtension(image_filename, "pfm");
+      const amber::BufferInfo* buffer_info =
+          FindImageExtraction(amber_options.extractions, options.fb_names[i],
+                              ImageFormatForFilename(image_filename));
+      amber::TraceScope encode_trace(&delegate, "image", "EncodeImage");
+      if (buffer_info) {
+        const uint8_t* pixels = buffer_info->data.data();
+        size_t size = buffer_info->data.size();
+        if (usePNG) {
 #if AMBER_ENABLE_LODEPNG
-            result = png::ConvertToPNG(buffer_info.width, buffer_info.height,
-                                       buffer_info.values, &out_buf);
+          png::EncodeOptions png_options;
+          png_options.format = buffer_info->image_format;
+          png_options.compression_level = options.png_compression_level;
+          png_options.thread_count = options.image_thread_count;
+          result = png::ConvertToPNG(buffer_info->width, buffer_info->height,
+                                     pixels, size, png_options, &out_buf);
 #else   // AMBER_ENABLE_LODEPNG
-            result = amber::Result("PNG support not enabled");
+          result = amber::Result("PNG support not enabled");
 #endif  // AMBER_ENABLE_LODEPNG
-          } else {
-            ppm::ConvertToPPM(buffer_info.width, buffer_info.height,
-                              buffer_info.values, &out_buf);
-            result = {};
-          }
-          break;
+        } else if (usePFM) {
+          result = ppm::ConvertToPFM(buffer_info->width, buffer_info->height,
+                                     pixels, size, &out_buf);
+        } else {
+          result = ppm::ConvertToPPM(buffer_info->width, buffer_info->height,
+                                     pixels, size, &out_buf);
         }
       }
+      encode_trace.End();
+
       if (result.IsSuccess()) {
+        amber::TraceScope write_trace(&delegate, "image", "WriteImage");
         std::ofstream image_file;
         image_file.open(image_filename, std::ios::out | std::ios::binary);
         if (!image_file.is_open()) {
@@ -494,7 +823,8 @@ int main(int argc, const char** argv) {
           std::cerr << image_filename << std::endl;
           continue;
         }
-        image_file << std::string(out_buf.begin(), out_buf.end());
+        image_file.write(reinterpret_cast<const char*>(out_buf.data()),
+                         static_cast<std::streamsize>(out_buf.size()));
         image_file.close();
       } else {
         std::cerr << result.Error() << std::endl;
@@ -519,10 +849,10 @@ int main(int argc, const char** argv) {
           }
 
           buffer_file << buffer_info.buffer_name << std::endl;
-          const auto& values = buffer_info.values;
-          for (size_t i = 0; i < values.size(); ++i) {
+          const auto& data = buffer_info.data;
+          for (size_t i = 0; i < data.size(); ++i) {
             buffer_file << " " << std::setfill('0') << std::setw(2) << std::hex
-                        << values[i].AsUint32();
+                        << static_cast<uint32_t>(data[i]);
             if (i % 16 == 15)
               buffer_file << std::endl;
           }
@@ -531,6 +861,11 @@ int main(int argc, const char** argv) {
         buffer_file.close();
       }
     }
+
+    if (options.print_buffer_hashes) {
+      for (const amber::BufferInfo& buffer_info : amber_options.extractions)
+        PrintBufferHashes(buffer_info);
+    }
   }
 
   if (!options.quiet) {
@@ -546,5 +881,13 @@ int main(int argc, const char** argv) {
               << failures.size() << " fail" << std::endl;
   }
 
+  if (!options.validation_cache_filename.empty() &&
+      !validation_cache.Save(options.validation_cache_filename)) {
+    return 1;
+  }
+
+  if (!WriteTraceFile(&delegate, options.trace_filename))
+    return 1;
+
   return !failures.empty();
 }
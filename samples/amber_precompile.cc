@@ -0,0 +1,191 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "amber/amber.h"
+#include "amber/recipe.h"
+#include "samples/shader_bundle.h"
+#include "src/script.h"
+#include "src/shader_compiler.h"
+
+namespace {
+
+struct Options {
+  std::vector<std::string> input_filenames;
+  std::string output_filename;
+  std::string spv_env;
+  bool disable_spirv_validation = false;
+  bool show_help = false;
+};
+
+const char kUsage[] = R"(Usage: amber_precompile [options] -o <bundle> SCRIPT [SCRIPTS...]
+
+Compiles, validates and optimizes the shaders of every SCRIPT into a shader
+bundle, which the amber tool loads with --shader-bundle.
+
+ options:
+  -o <filename>             -- The shader bundle to write.
+  -t <spirv_env>            -- The target SPIR-V environment, as for the amber tool. Must
+                               match the environment the bundle is run with.
+  --disable-spirv-val       -- Disable SPIR-V validation.
+  -h                        -- This help text.
+)";
+
+bool ParseArgs(const std::vector<std::string>& args, Options* opts) {
+  for (size_t i = 1; i < args.size(); ++i) {
+    const std::string& arg = args[i];
+    if (arg == "-o" || arg == "-t") {
+      ++i;
+      if (i >= args.size()) {
+        std::cerr << "Missing value for " << arg << " argument." << std::endl;
+        return false;
+      }
+      if (arg == "-o")
+        opts->output_filename = args[i];
+      else
+        opts->spv_env = args[i];
+    } else if (arg == "--disable-spirv-val") {
+      opts->disable_spirv_validation = true;
+    } else if (arg == "-h" || arg == "--help") {
+      opts->show_help = true;
+    } else if (arg.size() > 0 && arg[0] == '-') {
+      std::cerr << "Unrecognized option " << arg << std::endl;
+      return false;
+    } else if (!arg.empty()) {
+      opts->input_filenames.push_back(arg);
+    }
+  }
+  return true;
+}
+
+// Compiles the shaders used by the pipelines of the script in |filename|
+// into |entries|, skipping shaders already bundled.
+amber::Result CompileScript(const std::string& filename,
+                            const Options& options,
+                            std::vector<shader_bundle::Entry>* entries) {
+  std::ifstream file(filename, std::ios::in | std::ios::binary);
+  if (!file.is_open())
+    return amber::Result("Failed to open " + filename);
+  std::string data((std::istreambuf_iterator<char>(file)),
+                   std::istreambuf_iterator<char>());
+
+  amber::Amber am;
+  amber::Recipe recipe;
+  amber::Result r = am.Parse(data, &recipe);
+  if (!r.IsSuccess())
+    return r;
+
+  const auto* script = static_cast<const amber::Script*>(recipe.GetImpl());
+  amber::ShaderCompiler compiler(options.spv_env,
+                                 options.disable_spirv_validation);
+
+  // Only the shaders the runner would look up in the bundle are compiled.
+  std::set<std::string> bundled_names;
+  for (const auto& info : shader_bundle::GetBundledShaders(recipe))
+    bundled_names.insert(info.shader_name);
+
+  for (const auto& pipeline : script->GetPipelines()) {
+    for (auto shader_info : pipeline->GetShaders()) {
+      const amber::Shader* shader = shader_info.GetShader();
+      if (bundled_names.count(shader->GetName()) == 0)
+        continue;
+
+      amber::ShaderInfo info{shader->GetFormat(), shader->GetType(),
+                             shader->GetName(), shader->GetData(),
+                             shader_info.GetShaderOptimizations()};
+      uint64_t hash = shader_bundle::HashShaderSource(info, options.spv_env);
+
+      bool bundled = false;
+      for (const auto& entry : *entries) {
+        if (entry.name == info.shader_name && entry.source_hash == hash) {
+          bundled = true;
+          break;
+        }
+      }
+      if (bundled)
+        continue;
+
+      std::vector<uint32_t> words;
+      std::tie(r, words) = compiler.Compile(&shader_info, amber::ShaderMap());
+      if (!r.IsSuccess())
+        return amber::Result("shader " + info.shader_name + ": " + r.Error());
+
+      entries->emplace_back();
+      entries->back().name = info.shader_name;
+      entries->back().source_hash = hash;
+      entries->back().words = std::move(words);
+    }
+  }
+  return {};
+}
+
+}  // namespace
+
+int main(int argc, const char** argv) {
+  std::vector<std::string> args(argv, argv + argc);
+  Options options;
+
+  if (!ParseArgs(args, &options)) {
+    std::cerr << "Failed to parse arguments." << std::endl;
+    return 1;
+  }
+
+  if (options.show_help) {
+    std::cout << kUsage << std::endl;
+    return 0;
+  }
+
+  if (options.output_filename.empty() || options.input_filenames.empty()) {
+    std::cerr << "An output bundle and at least one script are required."
+              << std::endl;
+    return 1;
+  }
+
+  std::vector<shader_bundle::Entry> entries;
+  for (const auto& filename : options.input_filenames) {
+    amber::Result r = CompileScript(filename, options, &entries);
+    if (!r.IsSuccess()) {
+      std::cerr << filename << ": " << r.Error() << std::endl;
+      return 1;
+    }
+  }
+
+  std::vector<uint8_t> data;
+  shader_bundle::WriteBundle(entries, &data);
+
+  std::ofstream out(options.output_filename, std::ios::out | std::ios::binary);
+  if (!out.is_open()) {
+    std::cerr << "Cannot open file for shader bundle: "
+              << options.output_filename << std::endl;
+    return 1;
+  }
+  out.write(reinterpret_cast<const char*>(data.data()),
+            static_cast<std::streamsize>(data.size()));
+  if (!out.good()) {
+    std::cerr << "Failed to write " << options.output_filename << std::endl;
+    return 1;
+  }
+
+  std::cout << "Wrote " << entries.size() << " shaders to "
+            << options.output_filename << std::endl;
+  return 0;
+}
@@ -0,0 +1,352 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "samples/deflate.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "src/parallel.h"
+
+namespace deflate {
+namespace {
+
+const uint32_t kAdlerBase = 65521;
+// The most bytes which can be summed before the Adler-32 sums can overflow.
+const size_t kAdlerMaxRun = 5552;
+
+const size_t kMaxStoredBlockSize = 65535;
+
+// A stripe smaller than this is not worth a thread of its own. Stripes are
+// also capped so positions within one always fit in 32 bits.
+const size_t kMinStripeSize = 256 * 1024;
+const size_t kMaxStripeSize = size_t(1) << 30;
+
+const size_t kWindowSize = 32768;
+const size_t kMinMatch = 4;
+const size_t kMaxMatch = 258;
+const uint32_t kHashBits = 15;
+
+const uint32_t kEndOfBlock = 256;
+
+const uint16_t kLengthBase[29] = {3,  4,  5,  6,   7,   8,   9,   10,  11, 13,
+                                  15, 17, 19, 23,  27,  31,  35,  43,  51, 59,
+                                  67, 83, 99, 115, 131, 163, 195, 227, 258};
+const uint8_t kLengthExtraBits[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1,
+                                      1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                      4, 4, 4, 4, 5, 5, 5, 5, 0};
+const uint16_t kDistanceBase[30] = {
+    1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,   97,
+    129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193,
+    12289, 16385, 24577};
+const uint8_t kDistanceExtraBits[30] = {0, 0, 0, 0, 1, 1, 2,  2,  3,  3,
+                                        4, 4, 5, 5, 6, 6, 7,  7,  8,  8,
+                                        9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+uint32_t ReverseBits(uint32_t code, uint32_t length) {
+  uint32_t reversed = 0;
+  for (uint32_t i = 0; i < length; ++i) {
+    reversed = (reversed << 1U) | (code & 1U);
+    code >>= 1U;
+  }
+  return reversed;
+}
+
+// The fixed Huffman codes of RFC 1951, section 3.2.6, bit reversed so they can
+// be written least significant bit first.
+struct FixedCodes {
+  FixedCodes() {
+    for (uint32_t i = 0; i < 288; ++i) {
+      uint32_t code = 0;
+      if (i < 144) {
+        code = 0x30 + i;
+        literal_lengths[i] = 8;
+      } else if (i < 256) {
+        code = 0x190 + i - 144;
+        literal_lengths[i] = 9;
+      } else if (i < 280) {
+        code = i - 256;
+        literal_lengths[i] = 7;
+      } else {
+        code = 0xc0 + i - 280;
+        literal_lengths[i] = 8;
+      }
+      literal_codes[i] =
+          static_cast<uint16_t>(ReverseBits(code, literal_lengths[i]));
+    }
+    for (uint32_t i = 0; i < 30; ++i)
+      distance_codes[i] = static_cast<uint8_t>(ReverseBits(i, 5));
+  }
+
+  uint16_t literal_codes[288];
+  uint8_t literal_lengths[288];
+  uint8_t distance_codes[30];
+};
+
+const FixedCodes& GetFixedCodes() {
+  static const FixedCodes codes;
+  return codes;
+}
+
+// Appends bits to a byte vector, least significant bit first.
+class BitWriter {
+ public:
+  explicit BitWriter(std::vector<uint8_t>* out) : out_(out) {}
+
+  void Write(uint32_t bits, uint32_t count) {
+    buffer_ |= uint64_t(bits) << count_;
+    count_ += count;
+    while (count_ >= 8) {
+      out_->push_back(static_cast<uint8_t>(buffer_));
+      buffer_ >>= 8U;
+      count_ -= 8;
+    }
+  }
+
+  // Pads with zero bits up to the next byte boundary.
+  void Align() {
+    if (count_ > 0)
+      Write(0, 8 - count_);
+  }
+
+ private:
+  std::vector<uint8_t>* out_;
+  uint64_t buffer_ = 0;
+  uint32_t count_ = 0;
+};
+
+uint32_t Load32(const uint8_t* data) {
+  uint32_t value = 0;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+uint32_t LengthCodeIndex(size_t length) {
+  if (length == kMaxMatch)
+    return 28;
+
+  uint32_t value = static_cast<uint32_t>(length - 3);
+  if (value < 8)
+    return value;
+
+  uint32_t top_bit = 0;
+  while ((value >> (top_bit + 1)) != 0)
+    ++top_bit;
+  return 4 * (top_bit - 1) + ((value >> (top_bit - 2)) & 3U);
+}
+
+uint32_t DistanceCode(size_t distance) {
+  uint32_t value = static_cast<uint32_t>(distance - 1);
+  if (value < 4)
+    return value;
+
+  uint32_t top_bit = 0;
+  while ((value >> (top_bit + 1)) != 0)
+    ++top_bit;
+  return 2 * top_bit + ((value >> (top_bit - 1)) & 1U);
+}
+
+void WriteLiteral(const FixedCodes& codes, uint32_t symbol, BitWriter* writer) {
+  writer->Write(codes.literal_codes[symbol], codes.literal_lengths[symbol]);
+}
+
+void WriteMatch(const FixedCodes& codes,
+                size_t length,
+                size_t distance,
+                BitWriter* writer) {
+  uint32_t length_index = LengthCodeIndex(length);
+  WriteLiteral(codes, 257 + length_index, writer);
+  writer->Write(static_cast<uint32_t>(length - kLengthBase[length_index]),
+                kLengthExtraBits[length_index]);
+
+  uint32_t distance_code = DistanceCode(distance);
+  writer->Write(codes.distance_codes[distance_code], 5);
+  writer->Write(static_cast<uint32_t>(distance - kDistanceBase[distance_code]),
+                kDistanceExtraBits[distance_code]);
+}
+
+// Returns the number of bytes CompressStored() writes for |size| bytes.
+size_t StoredSize(size_t size) {
+  return size + (size / kMaxStoredBlockSize + 1) * 5;
+}
+
+// Writes |data| as stored blocks. The last block is marked final if |final|.
+void CompressStored(const uint8_t* data,
+                    size_t size,
+                    bool final,
+                    std::vector<uint8_t>* out) {
+  out->reserve(out->size() + StoredSize(size));
+  do {
+    size_t block_size = std::min(size, kMaxStoredBlockSize);
+    size -= block_size;
+
+    uint16_t length = static_cast<uint16_t>(block_size);
+    uint16_t inverted = static_cast<uint16_t>(~length);
+    out->push_back(final && size == 0 ? 1 : 0);
+    out->push_back(static_cast<uint8_t>(length));
+    out->push_back(static_cast<uint8_t>(length >> 8U));
+    out->push_back(static_cast<uint8_t>(inverted));
+    out->push_back(static_cast<uint8_t>(inverted >> 8U));
+    out->insert(out->end(), data, data + block_size);
+    data += block_size;
+  } while (size > 0);
+}
+
+// Writes |data| as a single fixed Huffman block, taking the first match found
+// through a one entry per bucket hash table. Unless |final|, the block is
+// followed by an empty stored block so the output ends on a byte boundary.
+void CompressFast(const uint8_t* data,
+                  size_t size,
+                  bool final,
+                  std::vector<uint8_t>* out) {
+  const FixedCodes& codes = GetFixedCodes();
+  out->reserve(out->size() + size / 2 + 16);
+
+  BitWriter writer(out);
+  // BFINAL followed by BTYPE 01, fixed Huffman codes.
+  writer.Write(final ? 3U : 2U, 3);
+
+  // Positions are stored plus one, so zero marks an empty bucket.
+  std::vector<uint32_t> head(size_t(1) << kHashBits, 0);
+  size_t i = 0;
+  while (i + kMinMatch <= size) {
+    uint32_t word = Load32(data + i);
+    uint32_t hash = (word * 2654435761U) >> (32 - kHashBits);
+    size_t candidate = head[hash];
+    head[hash] = static_cast<uint32_t>(i + 1);
+
+    if (candidate > 0) {
+      --candidate;
+      if (i - candidate <= kWindowSize && Load32(data + candidate) == word) {
+        size_t max_length = std::min(kMaxMatch, size - i);
+        size_t length = kMinMatch;
+        while (length < max_length &&
+               data[candidate + length] == data[i + length]) {
+          ++length;
+        }
+        WriteMatch(codes, length, i - candidate, &writer);
+        i += length;
+        continue;
+      }
+    }
+
+    WriteLiteral(codes, data[i], &writer);
+    ++i;
+  }
+  for (; i < size; ++i)
+    WriteLiteral(codes, data[i], &writer);
+
+  WriteLiteral(codes, kEndOfBlock, &writer);
+  if (!final) {
+    // An empty, non-final stored block.
+    writer.Write(0, 3);
+    writer.Align();
+    out->push_back(0x00);
+    out->push_back(0x00);
+    out->push_back(0xff);
+    out->push_back(0xff);
+  }
+  writer.Align();
+}
+
+// Returns the Adler-32 of two byte ranges joined together, given the checksum
+// of each and the size of the second.
+uint32_t CombineAdler32(uint32_t first, uint32_t second, size_t second_size) {
+  uint64_t rem = second_size % kAdlerBase;
+  uint64_t first_a = first & 0xffffU;
+  uint64_t a = (first_a + (second & 0xffffU) + kAdlerBase - 1) % kAdlerBase;
+  uint64_t b = ((first >> 16U) + (second >> 16U) + rem * first_a + kAdlerBase -
+                rem) %
+               kAdlerBase;
+  return static_cast<uint32_t>((b << 16U) | a);
+}
+
+}  // namespace
+
+uint32_t Adler32(const uint8_t* data, size_t size, uint32_t adler) {
+  uint32_t a = adler & 0xffffU;
+  uint32_t b = adler >> 16U;
+  while (size > 0) {
+    size_t run = std::min(size, kAdlerMaxRun);
+    size -= run;
+    for (size_t i = 0; i < run; ++i) {
+      a += data[i];
+      b += a;
+    }
+    data += run;
+    a %= kAdlerBase;
+    b %= kAdlerBase;
+  }
+  return (b << 16U) | a;
+}
+
+void ZlibCompress(const uint8_t* data,
+                  size_t size,
+                  Mode mode,
+                  uint32_t thread_count,
+                  std::vector<uint8_t>* out) {
+  size_t stripe_count =
+      std::max(size_t(amber::ParallelChunkCount(thread_count, size,
+                                                kMinStripeSize)),
+               (size + kMaxStripeSize - 1) / kMaxStripeSize);
+  size_t stripe_size = (size + stripe_count - 1) / stripe_count;
+
+  std::vector<std::vector<uint8_t>> stripes(stripe_count);
+  std::vector<uint32_t> checksums(stripe_count);
+  amber::ParallelFor(
+      thread_count, stripe_count, 1,
+      [&](uint32_t, size_t begin, size_t end) {
+        for (size_t s = begin; s < end; ++s) {
+          size_t offset = std::min(size, s * stripe_size);
+          size_t length = std::min(size - offset, stripe_size);
+          bool final = s + 1 == stripe_count;
+          if (mode == Mode::kFast) {
+            CompressFast(data + offset, length, final, &stripes[s]);
+            // Data which does not compress grows under the fixed codes, store
+            // it instead.
+            if (stripes[s].size() > StoredSize(length))
+              stripes[s].clear();
+          }
+          if (stripes[s].empty())
+            CompressStored(data + offset, length, final, &stripes[s]);
+          checksums[s] = Adler32(data + offset, length);
+        }
+      });
+
+  size_t total = 6;
+  for (const auto& stripe : stripes)
+    total += stripe.size();
+
+  out->clear();
+  out->reserve(total);
+  // CMF: deflate with a 32K window. FLG: fastest compression, no dictionary.
+  out->push_back(0x78);
+  out->push_back(0x01);
+
+  uint32_t adler = 1;
+  for (size_t s = 0; s < stripe_count; ++s) {
+    out->insert(out->end(), stripes[s].begin(), stripes[s].end());
+
+    size_t offset = std::min(size, s * stripe_size);
+    adler = CombineAdler32(adler, checksums[s],
+                           std::min(size - offset, stripe_size));
+  }
+
+  out->push_back(static_cast<uint8_t>(adler >> 24U));
+  out->push_back(static_cast<uint8_t>(adler >> 16U));
+  out->push_back(static_cast<uint8_t>(adler >> 8U));
+  out->push_back(static_cast<uint8_t>(adler));
+}
+
+}  // namespace deflate
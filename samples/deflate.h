@@ -0,0 +1,48 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SAMPLES_DEFLATE_H_
+#define SAMPLES_DEFLATE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace deflate {
+
+enum class Mode {
+  /// Store the data in uncompressed deflate blocks.
+  kStored = 0,
+  /// A single pass LZ77 compressor using the fixed Huffman codes. This trades
+  /// compression ratio for speed.
+  kFast,
+};
+
+/// Returns the Adler-32 checksum of the |size| bytes at |data|, continuing
+/// from the checksum |adler| of the preceding bytes.
+uint32_t Adler32(const uint8_t* data, size_t size, uint32_t adler = 1);
+
+/// Compresses the |size| bytes at |data| into a zlib stream stored in |out|.
+/// Large inputs are split into stripes which are compressed on up to
+/// |thread_count| threads. Each stripe is flushed to a byte boundary so the
+/// stripes join into a single stream; matches never cross a stripe boundary.
+void ZlibCompress(const uint8_t* data,
+                  size_t size,
+                  Mode mode,
+                  uint32_t thread_count,
+                  std::vector<uint8_t>* out);
+
+}  // namespace deflate
+
+#endif  // SAMPLES_DEFLATE_H_
@@ -0,0 +1,231 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "samples/deflate.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace amber {
+namespace {
+
+const uint16_t kLengthBase[29] = {3,  4,  5,  6,   7,   8,   9,   10,  11, 13,
+                                  15, 17, 19, 23,  27,  31,  35,  43,  51, 59,
+                                  67, 83, 99, 115, 131, 163, 195, 227, 258};
+const uint16_t kDistanceBase[30] = {
+    1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,   97,
+    129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193,
+    12289, 16385, 24577};
+
+// Decodes the stored and fixed Huffman blocks written by ZlibCompress().
+class Inflater {
+ public:
+  explicit Inflater(const std::vector<uint8_t>& in) : in_(in) {}
+
+  bool Inflate(std::vector<uint8_t>* out) {
+    if (in_.size() < 6 || in_[0] != 0x78 || in_[1] != 0x01)
+      return false;
+
+    pos_ = 2;
+    bool final = false;
+    while (!final) {
+      final = ReadBits(1) == 1;
+      uint32_t type = ReadBits(2);
+      if (type == 0) {
+        bit_count_ = 0;
+        uint32_t length = ReadBits(16);
+        uint32_t inverted = ReadBits(16);
+        if ((length ^ inverted) != 0xffff)
+          return false;
+        for (uint32_t i = 0; i < length; ++i)
+          out->push_back(static_cast<uint8_t>(ReadBits(8)));
+      } else if (type == 1) {
+        for (;;) {
+          uint32_t symbol = ReadFixedSymbol();
+          if (symbol < 256) {
+            out->push_back(static_cast<uint8_t>(symbol));
+            continue;
+          }
+          if (symbol == 256)
+            break;
+
+          uint32_t index = symbol - 257;
+          uint32_t extra = index < 8 || index == 28 ? 0 : index / 4 - 1;
+          size_t length = kLengthBase[index] + ReadBits(extra);
+
+          uint32_t code = ReadReversed(5);
+          extra = code < 4 ? 0 : code / 2 - 1;
+          size_t distance = kDistanceBase[code] + ReadBits(extra);
+          if (distance > out->size())
+            return false;
+          for (size_t i = 0; i < length; ++i)
+            out->push_back((*out)[out->size() - distance]);
+        }
+      } else {
+        return false;
+      }
+    }
+
+    bit_count_ = 0;
+    uint32_t adler = 0;
+    for (uint32_t i = 0; i < 4; ++i)
+      adler = (adler << 8U) | ReadBits(8);
+    return pos_ == in_.size() &&
+           adler == deflate::Adler32(out->data(), out->size());
+  }
+
+ private:
+  uint32_t ReadBits(uint32_t count) {
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+      if (bit_count_ == 0) {
+        current_ = pos_ < in_.size() ? in_[pos_] : 0;
+        ++pos_;
+        bit_count_ = 8;
+      }
+      value |= static_cast<uint32_t>(current_ & 1U) << i;
+      current_ = static_cast<uint8_t>(current_ >> 1U);
+      --bit_count_;
+    }
+    return value;
+  }
+
+  // Huffman codes are packed starting with their most significant bit.
+  uint32_t ReadReversed(uint32_t count) {
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < count; ++i)
+      value = (value << 1U) | ReadBits(1);
+    return value;
+  }
+
+  uint32_t ReadFixedSymbol() {
+    uint32_t code = ReadReversed(7);
+    if (code <= 0x17)
+      return 256 + code;
+
+    code = (code << 1U) | ReadBits(1);
+    if (code >= 0x30 && code <= 0xbf)
+      return code - 0x30;
+    if (code >= 0xc0 && code <= 0xc7)
+      return 280 + code - 0xc0;
+
+    code = (code << 1U) | ReadBits(1);
+    return 144 + code - 0x190;
+  }
+
+  const std::vector<uint8_t>& in_;
+  size_t pos_ = 0;
+  uint8_t current_ = 0;
+  uint32_t bit_count_ = 0;
+};
+
+// Rows of a few colours, the kind of data a rendered image holds.
+std::vector<uint8_t> MakeImageLikeData(size_t size) {
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; ++i)
+    data[i] = static_cast<uint8_t>((i / 4096) % 5 * 40 + (i % 4 == 3 ? 15 : 0));
+  return data;
+}
+
+std::vector<uint8_t> MakeNoise(size_t size) {
+  std::vector<uint8_t> data(size);
+  uint32_t state = 12345;
+  for (size_t i = 0; i < size; ++i) {
+    state = state * 1103515245U + 12345U;
+    data[i] = static_cast<uint8_t>(state >> 24U);
+  }
+  return data;
+}
+
+}  // namespace
+
+using DeflateTest = testing::Test;
+
+TEST_F(DeflateTest, Adler32) {
+  std::string str = "Wikipedia";
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(str.data());
+  EXPECT_EQ(0x11E60398U, deflate::Adler32(data, str.size()));
+  EXPECT_EQ(1U, deflate::Adler32(data, 0));
+
+  uint32_t adler = deflate::Adler32(data, 4);
+  EXPECT_EQ(0x11E60398U, deflate::Adler32(data + 4, str.size() - 4, adler));
+}
+
+TEST_F(DeflateTest, Empty) {
+  for (auto mode : {deflate::Mode::kStored, deflate::Mode::kFast}) {
+    std::vector<uint8_t> out;
+    deflate::ZlibCompress(nullptr, 0, mode, 1, &out);
+
+    std::vector<uint8_t> decoded;
+    EXPECT_TRUE(Inflater(out).Inflate(&decoded));
+    EXPECT_TRUE(decoded.empty());
+  }
+}
+
+TEST_F(DeflateTest, Stored) {
+  std::vector<uint8_t> data = MakeNoise(200000);
+  std::vector<uint8_t> out;
+  deflate::ZlibCompress(data.data(), data.size(), deflate::Mode::kStored, 1,
+                        &out);
+
+  // Four blocks of up to 65535 bytes, each with a five byte header.
+  EXPECT_EQ(data.size() + 4 * 5 + 6, out.size());
+
+  std::vector<uint8_t> decoded;
+  ASSERT_TRUE(Inflater(out).Inflate(&decoded));
+  EXPECT_EQ(data, decoded);
+}
+
+TEST_F(DeflateTest, Fast) {
+  std::vector<uint8_t> data = MakeImageLikeData(100000);
+  std::vector<uint8_t> out;
+  deflate::ZlibCompress(data.data(), data.size(), deflate::Mode::kFast, 1,
+                        &out);
+  EXPECT_LT(out.size(), data.size() / 20);
+
+  std::vector<uint8_t> decoded;
+  ASSERT_TRUE(Inflater(out).Inflate(&decoded));
+  EXPECT_EQ(data, decoded);
+}
+
+TEST_F(DeflateTest, FastStoresIncompressibleData) {
+  std::vector<uint8_t> data = MakeNoise(100000);
+  std::vector<uint8_t> out;
+  deflate::ZlibCompress(data.data(), data.size(), deflate::Mode::kFast, 1,
+                        &out);
+  EXPECT_EQ(data.size() + 2 * 5 + 6, out.size());
+
+  std::vector<uint8_t> decoded;
+  ASSERT_TRUE(Inflater(out).Inflate(&decoded));
+  EXPECT_EQ(data, decoded);
+}
+
+TEST_F(DeflateTest, ParallelStripes) {
+  std::vector<uint8_t> data = MakeImageLikeData(3 * 1024 * 1024 + 7);
+  std::vector<uint8_t> noise = MakeNoise(512 * 1024);
+  data.insert(data.end(), noise.begin(), noise.end());
+
+  for (auto mode : {deflate::Mode::kStored, deflate::Mode::kFast}) {
+    std::vector<uint8_t> out;
+    deflate::ZlibCompress(data.data(), data.size(), mode, 4, &out);
+
+    std::vector<uint8_t> decoded;
+    ASSERT_TRUE(Inflater(out).Inflate(&decoded));
+    EXPECT_EQ(data, decoded);
+  }
+}
+
+}  // namespace amber
@@ -12,11 +12,19 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <atomic>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "src/buffer.h"
 #include "src/format.h"
+#include "src/image_metrics.h"
+#include "src/parallel.h"
 #include "src/type_parser.h"
 
 #pragma clang diagnostic push
@@ -28,20 +36,51 @@ namespace {
 
 enum class CompareAlgorithm {
   kRMSE = 0,
+  kSSIM,
+  kPSNR,
+  kMaxError,
 };
 
 struct Options {
   std::vector<std::string> input_filenames;
+  std::string manifest_filename;
+  std::string report_filename;
+  std::string heatmap_filename;
   bool show_help = false;
+  bool has_tolerance = false;
   float tolerance = 1.0f;
+  uint32_t thread_count = 1;
   CompareAlgorithm compare_algorithm = CompareAlgorithm::kRMSE;
 };
 
+// A pair of images to compare and the outcome of the comparison.
+struct ImagePair {
+  std::string filenames[2];
+  bool loaded = false;
+  amber::Result result;
+};
+
 const char kUsage[] = R"(Usage: image_diff [options] image1.png image2.png
+       image_diff [options] --batch <manifest>
 
  options:
   --rmse                    -- Compare using RMSE algorithm (default).
-  -t | --tolerance <float>  -- Tolerance value for RMSE comparison.
+  --ssim                    -- Compare the mean SSIM of 8x8 tiles against a threshold.
+  --psnr                    -- Compare the PSNR, in dB, against a threshold.
+  --max-error               -- Compare the largest error of any channel against a
+                               tolerance.
+  -t | --tolerance <float>  -- Tolerance or threshold for the comparison. Defaults are
+                               1 for RMSE, 0.99 for SSIM, 40 for PSNR and 0 for
+                               max-error.
+  --heatmap <filename>      -- Write a PNG heatmap of the differences to <filename>.
+                               Not available in batch mode.
+  --batch <manifest>        -- Compare every pair of images listed in <manifest>, one
+                               whitespace separated pair per line. Blank lines and lines
+                               starting with '#' are ignored.
+  -j | --threads <n>        -- Number of pairs compared at once in batch mode, or
+                               threads used to compare a single pair. Default 1.
+  --report <filename>       -- Write the batch results as JSON to <filename> instead of
+                               standard output.
   -h | --help               -- This help text.
 )";
 
@@ -53,6 +92,12 @@ bool ParseArgs(const std::vector<std::string>& args, Options* opts) {
       return true;
     } else if (arg == "--rmse") {
       opts->compare_algorithm = CompareAlgorithm::kRMSE;
+    } else if (arg == "--ssim") {
+      opts->compare_algorithm = CompareAlgorithm::kSSIM;
+    } else if (arg == "--psnr") {
+      opts->compare_algorithm = CompareAlgorithm::kPSNR;
+    } else if (arg == "--max-error") {
+      opts->compare_algorithm = CompareAlgorithm::kMaxError;
     } else if (arg == "-t" || arg == "--tolerance") {
       ++i;
       if (i >= args.size()) {
@@ -61,18 +106,100 @@ bool ParseArgs(const std::vector<std::string>& args, Options* opts) {
         return false;
       }
       opts->tolerance = std::stof(std::string(args[i]));
+      opts->has_tolerance = true;
       if (opts->tolerance < 0) {
         std::cerr << "Tolerance must be non-negative." << std::endl;
         return false;
       }
+    } else if (arg == "--heatmap") {
+      ++i;
+      if (i >= args.size()) {
+        std::cerr << "Missing value for --heatmap argument." << std::endl;
+        return false;
+      }
+      opts->heatmap_filename = args[i];
+    } else if (arg == "--batch") {
+      ++i;
+      if (i >= args.size()) {
+        std::cerr << "Missing value for --batch argument." << std::endl;
+        return false;
+      }
+      opts->manifest_filename = args[i];
+    } else if (arg == "-j" || arg == "--threads") {
+      ++i;
+      if (i >= args.size()) {
+        std::cerr << "Missing value for " << args[i - 1] << " argument."
+                  << std::endl;
+        return false;
+      }
+      int32_t val = std::stoi(std::string(args[i]));
+      if (val < 1) {
+        std::cerr << "Thread count must be positive." << std::endl;
+        return false;
+      }
+      opts->thread_count = static_cast<uint32_t>(val);
+    } else if (arg == "--report") {
+      ++i;
+      if (i >= args.size()) {
+        std::cerr << "Missing value for --report argument." << std::endl;
+        return false;
+      }
+      opts->report_filename = args[i];
     } else if (!arg.empty()) {
       opts->input_filenames.push_back(arg);
     }
   }
 
+  if (!opts->has_tolerance) {
+    switch (opts->compare_algorithm) {
+      case CompareAlgorithm::kRMSE:
+        opts->tolerance = 1.0f;
+        break;
+      case CompareAlgorithm::kSSIM:
+        opts->tolerance = 0.99f;
+        break;
+      case CompareAlgorithm::kPSNR:
+        opts->tolerance = 40.0f;
+        break;
+      case CompareAlgorithm::kMaxError:
+        opts->tolerance = 0.0f;
+        break;
+    }
+  }
+
   return true;
 }
 
+// Reads the image pairs listed in |filename| into |pairs|.
+amber::Result ReadManifest(const std::string& filename,
+                           std::vector<ImagePair>* pairs) {
+  std::ifstream manifest(filename);
+  if (!manifest.is_open())
+    return amber::Result("Unable to open manifest: " + filename);
+
+  std::string line;
+  for (size_t line_number = 1; std::getline(manifest, line); ++line_number) {
+    std::istringstream words(line);
+    std::vector<std::string> names;
+    std::string name;
+    while (words >> name)
+      names.push_back(name);
+
+    if (names.empty() || names[0][0] == '#')
+      continue;
+    if (names.size() != 2) {
+      return amber::Result(filename + ":" + std::to_string(line_number) +
+                           ": expected two image file names");
+    }
+
+    pairs->emplace_back();
+    pairs->back().filenames[0] = names[0];
+    pairs->back().filenames[1] = names[1];
+  }
+  return {};
+}
+
+// Decodes the PNG |filename| straight into the bytes of |buffer|.
 amber::Result LoadPngToBuffer(const std::string& filename,
                               amber::Buffer* buffer) {
   std::vector<unsigned char> image;
@@ -86,17 +213,187 @@ amber::Result LoadPngToBuffer(const std::string& filename,
     return amber::Result(result);
   }
 
-  std::vector<amber::Value> values;
-  values.resize(image.size());
-  for (size_t i = 0; i < image.size(); ++i) {
-    values[i].SetIntValue(image[i]);
+  buffer->SetWidth(width);
+  buffer->SetHeight(height);
+  return buffer->SetRawData(std::move(image));
+}
+
+// Returns an error unless both |buffers| hold images of the same size.
+amber::Result CheckSameSize(amber::Buffer* buffers) {
+  uint32_t width = buffers[0].GetWidth();
+  uint32_t height = buffers[0].GetHeight();
+  if (width != buffers[1].GetWidth() || height != buffers[1].GetHeight()) {
+    return amber::Result("Images have different sizes: " +
+                         std::to_string(width) + "x" + std::to_string(height) +
+                         " vs " + std::to_string(buffers[1].GetWidth()) + "x" +
+                         std::to_string(buffers[1].GetHeight()));
+  }
+  return {};
+}
+
+// Writes a PNG heatmap of the differences between |buffers| to |filename|.
+amber::Result WriteHeatmap(const std::string& filename,
+                           amber::Format* fmt,
+                           amber::Buffer* buffers) {
+  amber::Result res = CheckSameSize(buffers);
+  if (!res.IsSuccess())
+    return res;
+
+  uint32_t width = buffers[0].GetWidth();
+  uint32_t height = buffers[0].GetHeight();
+  std::vector<uint8_t> heatmap;
+  res = amber::MakeDifferenceHeatmap(fmt, buffers[0].GetRawData(),
+                                     buffers[1].GetRawData(), width, height,
+                                     &heatmap);
+  if (!res.IsSuccess())
+    return res;
+
+  uint32_t error = lodepng::encode(filename, heatmap, width, height);
+  if (error) {
+    return amber::Result("Unable to write heatmap " + filename + ": " +
+                         lodepng_error_text(error));
   }
+  return {};
+}
+
+// Checks the metrics of the images in |buffers| against the threshold of the
+// SSIM, PSNR or max-error algorithm.
+amber::Result CompareMetrics(const Options& options,
+                             amber::Format* fmt,
+                             uint32_t thread_count,
+                             amber::Buffer* buffers) {
+  amber::Result res = CheckSameSize(buffers);
+  if (!res.IsSuccess())
+    return res;
 
-  buffer->SetData(values);
+  uint32_t width = buffers[0].GetWidth();
+  uint32_t height = buffers[0].GetHeight();
+  amber::ImageMetrics metrics;
+  res = amber::ComputeImageMetrics(
+      fmt, buffers[0].GetRawData(), buffers[1].GetRawData(), width, height,
+      thread_count, &metrics);
+  if (!res.IsSuccess())
+    return res;
 
+  const double threshold = static_cast<double>(options.tolerance);
+  switch (options.compare_algorithm) {
+    case CompareAlgorithm::kSSIM:
+      if (!(metrics.ssim >= threshold)) {
+        return amber::Result("SSIM of " + std::to_string(metrics.ssim) +
+                             " is less than threshold of " +
+                             std::to_string(threshold));
+      }
+      break;
+    case CompareAlgorithm::kPSNR:
+      if (!(metrics.psnr >= threshold)) {
+        return amber::Result("PSNR of " + std::to_string(metrics.psnr) +
+                             " dB is less than threshold of " +
+                             std::to_string(threshold) + " dB");
+      }
+      break;
+    case CompareAlgorithm::kMaxError:
+      for (size_t i = 0; i < 4; ++i) {
+        if (!(metrics.max_abs_error[i] <= threshold)) {
+          return amber::Result(std::string("Maximum error of channel ") +
+                               "RGBA"[i] + " is " +
+                               std::to_string(metrics.max_abs_error[i]) +
+                               ", greater than tolerance of " +
+                               std::to_string(threshold));
+        }
+      }
+      break;
+    case CompareAlgorithm::kRMSE:
+      break;
+  }
   return {};
 }
 
+// Loads and compares the images of |pair|, recording the outcome in |pair|.
+// The comparison itself is spread over |thread_count| threads.
+void ComparePair(const Options& options,
+                 amber::Format* fmt,
+                 uint32_t thread_count,
+                 ImagePair* pair) {
+  amber::Buffer buffers[2];
+  for (size_t i = 0; i < 2; ++i) {
+    buffers[i].SetFormat(fmt);
+    amber::Result res = LoadPngToBuffer(pair->filenames[i], &buffers[i]);
+    if (!res.IsSuccess()) {
+      pair->result = amber::Result("Error loading " + pair->filenames[i] +
+                                   ": " + res.Error());
+      return;
+    }
+  }
+
+  pair->loaded = true;
+  // The heatmap is written whichever algorithm compares the images.
+  if (!options.heatmap_filename.empty()) {
+    pair->result = WriteHeatmap(options.heatmap_filename, fmt, buffers);
+    if (!pair->result.IsSuccess())
+      return;
+  }
+
+  if (options.compare_algorithm == CompareAlgorithm::kRMSE)
+    pair->result = buffers[0].CompareRMSE(&buffers[1], options.tolerance);
+  else
+    pair->result = CompareMetrics(options, fmt, thread_count, buffers);
+}
+
+std::string JsonString(const std::string& str) {
+  std::string out = "\"";
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      const char* hex = "0123456789abcdef";
+      out += "\\u00";
+      out += hex[(c >> 4) & 0xf];
+      out += hex[c & 0xf];
+    } else {
+      out += c;
+    }
+  }
+  return out + "\"";
+}
+
+// Writes |pairs| as a JSON object holding a summary and one entry per pair.
+// The status of a pair is "similar", "different" or "error".
+void WriteReport(const std::vector<ImagePair>& pairs, std::ostream& out) {
+  size_t different = 0;
+  size_t errors = 0;
+  for (const auto& pair : pairs) {
+    if (!pair.loaded)
+      ++errors;
+    else if (!pair.result.IsSuccess())
+      ++different;
+  }
+
+  out << "{\n";
+  out << "  \"total\": " << pairs.size() << ",\n";
+  out << "  \"similar\": " << pairs.size() - different - errors << ",\n";
+  out << "  \"different\": " << different << ",\n";
+  out << "  \"errors\": " << errors << ",\n";
+  out << "  \"pairs\": [";
+  for (size_t i = 0; i < pairs.size(); ++i) {
+    const auto& pair = pairs[i];
+    const char* status = "similar";
+    if (!pair.loaded)
+      status = "error";
+    else if (!pair.result.IsSuccess())
+      status = "different";
+
+    out << (i == 0 ? "\n" : ",\n");
+    out << "    {\"image1\": " << JsonString(pair.filenames[0])
+        << ", \"image2\": " << JsonString(pair.filenames[1])
+        << ", \"status\": \"" << status << "\"";
+    if (!pair.result.IsSuccess())
+      out << ", \"message\": " << JsonString(pair.result.Error());
+    out << "}";
+  }
+  out << "\n  ]\n}\n";
+}
+
 }  // namespace
 
 int main(int argc, const char** argv) {
@@ -112,35 +409,84 @@ int main(int argc, const char** argv) {
     return 0;
   }
 
-  if (options.input_filenames.size() != 2) {
-    std::cerr << "Two input file names are required." << std::endl;
-    return 1;
+  std::vector<ImagePair> pairs;
+  if (!options.manifest_filename.empty()) {
+    if (!options.input_filenames.empty()) {
+      std::cerr << "Input file names can not be combined with --batch."
+                << std::endl;
+      return 1;
+    }
+
+    if (!options.heatmap_filename.empty()) {
+      std::cerr << "--heatmap can not be combined with --batch." << std::endl;
+      return 1;
+    }
+
+    amber::Result res = ReadManifest(options.manifest_filename, &pairs);
+    if (!res.IsSuccess()) {
+      std::cerr << res.Error() << std::endl;
+      return 1;
+    }
+  } else {
+    if (options.input_filenames.size() != 2) {
+      std::cerr << "Two input file names are required." << std::endl;
+      return 1;
+    }
+
+    pairs.emplace_back();
+    pairs.back().filenames[0] = options.input_filenames[0];
+    pairs.back().filenames[1] = options.input_filenames[1];
   }
 
   amber::TypeParser parser;
   auto type = parser.Parse("R8G8B8A8_UNORM");
   amber::Format fmt(type.get());
 
-  amber::Buffer buffers[2];
-  for (size_t i = 0; i < 2; ++i) {
-    buffers[i].SetFormat(&fmt);
-    amber::Result res =
-        LoadPngToBuffer(options.input_filenames[i], &buffers[i]);
-    if (!res.IsSuccess()) {
-      std::cerr << "Error loading " << options.input_filenames[i] << ": "
-                << res.Error() << std::endl;
-      return 1;
-    }
+  // Each thread takes the next pair as it finishes one, so a few large images
+  // do not hold up the rest of the batch. A single pair gets all the threads
+  // for the comparison itself instead.
+  std::atomic<size_t> next_pair(0);
+  uint32_t thread_count = static_cast<uint32_t>(
+      std::min(size_t(options.thread_count), pairs.size()));
+  uint32_t compare_threads = pairs.size() == 1 ? options.thread_count : 1;
+  amber::ParallelFor(thread_count, thread_count, 1,
+                     [&](uint32_t, size_t, size_t) {
+                       for (size_t i = next_pair++; i < pairs.size();
+                            i = next_pair++) {
+                         ComparePair(options, &fmt, compare_threads,
+                                     &pairs[i]);
+                       }
+                     });
+
+  bool all_similar = true;
+  for (const auto& pair : pairs) {
+    if (!pair.result.IsSuccess())
+      all_similar = false;
   }
 
-  amber::Result res;
-  if (options.compare_algorithm == CompareAlgorithm::kRMSE)
-    res = buffers[0].CompareRMSE(&buffers[1], options.tolerance);
+  if (options.manifest_filename.empty()) {
+    const auto& pair = pairs[0];
+    if (!pair.loaded)
+      std::cerr << pair.result.Error() << std::endl;
+    else if (pair.result.IsSuccess())
+      std::cout << "Images similar" << std::endl;
+    else
+      std::cout << "Images differ: " << pair.result.Error() << std::endl;
 
-  if (res.IsSuccess())
-    std::cout << "Images similar" << std::endl;
-  else
-    std::cout << "Images differ: " << res.Error() << std::endl;
+    return !all_similar;
+  }
+
+  if (options.report_filename.empty()) {
+    WriteReport(pairs, std::cout);
+  } else {
+    std::ofstream report(options.report_filename);
+    if (!report.is_open()) {
+      std::cerr << "Cannot open file for report: " << options.report_filename
+                << std::endl;
+      return 1;
+    }
+    WriteReport(pairs, report);
+  }
 
-  return !res.IsSuccess();
+  return !all_similar;
 }
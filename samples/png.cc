@@ -15,9 +15,11 @@
 #include "samples/png.h"
 
 #include <cassert>
+#include <cstdlib>
+#include <cstring>
 
 #include "amber/result.h"
-#include "amber/value.h"
+#include "samples/deflate.h"
 
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wweak-vtables"
@@ -28,43 +30,76 @@ namespace png {
 
 namespace {
 
-unsigned char byte0(uint32_t word) {
-  return static_cast<unsigned char>(word);
+const uint32_t kBytesPerPixel = 4;
+const uint32_t kMaxCompressionLevel = 9;
+const unsigned char kFilterUp = 2;
+
+// Compresses the filtered scanlines for the levels lodepng does not handle
+// itself. |settings->custom_context| points at the EncodeOptions.
+unsigned CompressZlib(unsigned char** out,
+                      size_t* out_size,
+                      const unsigned char* in,
+                      size_t in_size,
+                      const LodePNGCompressSettings* settings) {
+  const EncodeOptions* options =
+      static_cast<const EncodeOptions*>(settings->custom_context);
+
+  std::vector<uint8_t> compressed;
+  deflate::ZlibCompress(in, in_size,
+                        options->compression_level == 0 ? deflate::Mode::kStored
+                                                        : deflate::Mode::kFast,
+                        options->thread_count, &compressed);
+
+  // lodepng releases the result with free().
+  *out = static_cast<unsigned char*>(malloc(compressed.size()));
+  if (!*out)
+    return 83;  // lodepng's allocation failure error.
+
+  std::memcpy(*out, compressed.data(), compressed.size());
+  *out_size = compressed.size();
+  return 0;
 }
 
-unsigned char byte1(uint32_t word) {
-  return static_cast<unsigned char>(word >> 8);
-}
-
-unsigned char byte2(uint32_t word) {
-  return static_cast<unsigned char>(word >> 16);
-}
-
-unsigned char byte3(uint32_t word) {
-  return static_cast<unsigned char>(word >> 24);
+// Swaps the red and blue bytes of each B8G8R8A8 pixel. Working on whole
+// pixels lets the compiler vectorise the loop.
+void SwizzleBGRAToRGBA(const uint8_t* src, size_t size, uint8_t* dst) {
+  for (size_t i = 0; i < size; i += kBytesPerPixel) {
+    uint32_t pixel = 0;
+    std::memcpy(&pixel, src + i, sizeof(pixel));
+    pixel = (pixel & 0xff00ff00U) | ((pixel >> 16U) & 0xffU) |
+            ((pixel & 0xffU) << 16U);
+    std::memcpy(dst + i, &pixel, sizeof(pixel));
+  }
 }
 
 }  // namespace
 
 amber::Result ConvertToPNG(uint32_t width,
                            uint32_t height,
-                           const std::vector<amber::Value>& values,
+                           const uint8_t* data,
+                           size_t size,
+                           const EncodeOptions& options,
                            std::vector<uint8_t>* buffer) {
-  if (values.size() != (width * height)) {
-    return amber::Result("Values size (" + std::to_string(values.size()) +
-                         ") != " + "width * height (" +
-                         std::to_string(width * height) + ")");
+  if (size != size_t(width) * height * kBytesPerPixel) {
+    return amber::Result("Data size (" + std::to_string(size) + ") != " +
+                         "width * height * 4 (" +
+                         std::to_string(width * height * kBytesPerPixel) +
+                         ")");
   }
-
-  std::vector<uint8_t> data;
-
-  // Prepare data as lodepng expects it
-  for (amber::Value value : values) {
-    const uint32_t pixel = value.AsUint32();
-    data.push_back(byte2(pixel));  // R
-    data.push_back(byte1(pixel));  // G
-    data.push_back(byte0(pixel));  // B
-    data.push_back(byte3(pixel));  // A
+  if (options.format != amber::ImageDataFormat::kB8G8R8A8Unorm &&
+      options.format != amber::ImageDataFormat::kR8G8B8A8Unorm) {
+    return amber::Result("PNG input must be B8G8R8A8 or R8G8B8A8");
+  }
+  if (options.compression_level > kMaxCompressionLevel)
+    return amber::Result("PNG compression level must be between 0 and 9");
+
+  // lodepng expects R8G8B8A8.
+  std::vector<uint8_t> rgba;
+  const uint8_t* pixels = data;
+  if (options.format == amber::ImageDataFormat::kB8G8R8A8Unorm) {
+    rgba.resize(size);
+    SwizzleBGRAToRGBA(data, size, rgba.data());
+    pixels = rgba.data();
   }
 
   lodepng::State state;
@@ -77,7 +112,32 @@ amber::Result ConvertToPNG(uint32_t width,
   state.info_png.color.colortype = LodePNGColorType::LCT_RGBA;
   state.info_png.color.bitdepth = 8;
 
-  if (lodepng::encode(*buffer, data, width, height, state) != 0)
+  std::vector<unsigned char> filters;
+  if (options.compression_level == 0) {
+    // Filtering cannot help stored data.
+    state.encoder.filter_strategy = LFS_ZERO;
+    state.encoder.zlibsettings.custom_zlib = CompressZlib;
+    state.encoder.zlibsettings.custom_context = &options;
+  } else if (options.compression_level == 1) {
+    // Trying every filter on each row costs more than the fast compressor,
+    // the up filter alone turns repeated rows into runs of zeros.
+    filters.assign(height, kFilterUp);
+    state.encoder.filter_strategy = LFS_PREDEFINED;
+    state.encoder.predefined_filters = filters.data();
+    state.encoder.zlibsettings.custom_zlib = CompressZlib;
+    state.encoder.zlibsettings.custom_context = &options;
+  } else {
+    // Level 6 keeps lodepng's defaults of a 2048 byte window with lazy
+    // matching.
+    state.encoder.zlibsettings.windowsize = 1U << (options.compression_level +
+                                                   5);
+    state.encoder.zlibsettings.lazymatching =
+        options.compression_level >= 5 ? 1 : 0;
+    state.encoder.zlibsettings.nicematch =
+        options.compression_level >= 8 ? 258 : 128;
+  }
+
+  if (lodepng::encode(*buffer, pixels, width, height, state) != 0)
     return amber::Result("lodepng::encode() returned non-zero");
 
   return {};
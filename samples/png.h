@@ -23,12 +23,29 @@
 
 namespace png {
 
-/// Converts the image of dimensions |width| and |height| and with pixels stored
-/// in row-major order in |values| with format B8G8R8A8 into PNG format,
-/// returning the PNG binary as a string.
+/// The compression level used unless another one is requested. It matches
+/// the default effort of lodepng.
+const uint32_t kDefaultCompressionLevel = 6;
+
+struct EncodeOptions {
+  /// The layout of the input pixels, either kB8G8R8A8Unorm or
+  /// kR8G8B8A8Unorm. RGBA input is handed to the encoder without a copy.
+  amber::ImageDataFormat format = amber::ImageDataFormat::kB8G8R8A8Unorm;
+  /// 0 stores the pixels without compression and 1 uses a fast single pass
+  /// compressor. 2 to 9 use lodepng with increasing effort.
+  uint32_t compression_level = kDefaultCompressionLevel;
+  /// The number of threads compression levels 0 and 1 may use.
+  uint32_t thread_count = 1;
+};
+
+/// Converts the image of dimensions |width| and |height| and with the |size|
+/// bytes of pixels stored in row-major order at |data| into PNG format,
+/// returning the PNG binary in |buffer|.
 amber::Result ConvertToPNG(uint32_t width,
                            uint32_t height,
-                           const std::vector<amber::Value>& values,
+                           const uint8_t* data,
+                           size_t size,
+                           const EncodeOptions& options,
                            std::vector<uint8_t>* buffer);
 
 }  // namespace png
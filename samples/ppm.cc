@@ -15,58 +15,90 @@
 #include "samples/ppm.h"
 
 #include <cassert>
+#include <cstring>
 
 #include "amber/result.h"
-#include "amber/value.h"
 
 namespace ppm {
 namespace {
 
 const uint32_t kMaximumColorValue = 255;
-
-uint8_t byte0(uint32_t word) {
-  return static_cast<uint8_t>(word & 0xff);
-}
-
-uint8_t byte1(uint32_t word) {
-  return static_cast<uint8_t>((word >> 8) & 0xff);
-}
-
-uint8_t byte2(uint32_t word) {
-  return static_cast<uint8_t>((word >> 16) & 0xff);
-}
+const uint32_t kBytesPerPixel = 4;
+const uint32_t kBytesPerColor = 3;
+const uint32_t kBytesPerFloatPixel = 16;
+const uint32_t kBytesPerFloatColor = 12;
 
 }  // namespace
 
 amber::Result ConvertToPPM(uint32_t width,
                            uint32_t height,
-                           const std::vector<amber::Value>& values,
+                           const uint8_t* data,
+                           size_t size,
                            std::vector<uint8_t>* buffer) {
-  if (values.size() != (width * height)) {
-    return amber::Result("Values size (" + std::to_string(values.size()) +
-                         ") != " + "width * height (" +
-                         std::to_string(width * height) + ")");
+  if (size != size_t(width) * height * kBytesPerPixel) {
+    return amber::Result("Data size (" + std::to_string(size) + ") != " +
+                         "width * height * 4 (" +
+                         std::to_string(width * height * kBytesPerPixel) +
+                         ")");
   }
 
   // Write PPM header
-  std::string image = "P6\n";
-  image += std::to_string(width) + " " + std::to_string(height) + "\n";
-  image += std::to_string(kMaximumColorValue) + "\n";
+  std::string header = "P6\n";
+  header += std::to_string(width) + " " + std::to_string(height) + "\n";
+  header += std::to_string(kMaximumColorValue) + "\n";
 
-  for (char ch : image)
-    buffer->push_back(static_cast<uint8_t>(ch));
+  // Write PPM data. The buffer is sized up front so the pixel loop is plain
+  // indexed stores.
+  const size_t pixel_count = size / kBytesPerPixel;
+  buffer->resize(header.size() + pixel_count * kBytesPerColor);
+  std::memcpy(buffer->data(), header.data(), header.size());
 
-  // Write PPM data
-  for (amber::Value value : values) {
-    const uint32_t pixel = value.AsUint32();
+  uint8_t* dst = buffer->data() + header.size();
+  for (size_t i = 0; i < pixel_count; ++i) {
     // We assume B8G8R8A8_UNORM here:
-    buffer->push_back(byte2(pixel));  // R
-    buffer->push_back(byte1(pixel));  // G
-    buffer->push_back(byte0(pixel));  // B
+    const uint8_t* src = data + i * kBytesPerPixel;
+    dst[i * kBytesPerColor] = src[2];      // R
+    dst[i * kBytesPerColor + 1] = src[1];  // G
+    dst[i * kBytesPerColor + 2] = src[0];  // B
     // PPM does not support alpha channel
   }
 
   return {};
 }
 
+amber::Result ConvertToPFM(uint32_t width,
+                           uint32_t height,
+                           const uint8_t* data,
+                           size_t size,
+                           std::vector<uint8_t>* buffer) {
+  if (size != size_t(width) * height * kBytesPerFloatPixel) {
+    return amber::Result("Data size (" + std::to_string(size) + ") != " +
+                         "width * height * 16 (" +
+                         std::to_string(width * height * kBytesPerFloatPixel) +
+                         ")");
+  }
+
+  // A negative scale marks the floats as little endian.
+  std::string header = "PF\n";
+  header += std::to_string(width) + " " + std::to_string(height) + "\n";
+  header += "-1.0\n";
+
+  buffer->resize(header.size() + size_t(width) * height * kBytesPerFloatColor);
+  std::memcpy(buffer->data(), header.data(), header.size());
+
+  // PFM stores the bottom row first. The RGB floats of each pixel are copied
+  // as they are and the alpha float is dropped.
+  const size_t row_size = size_t(width) * kBytesPerFloatPixel;
+  uint8_t* dst = buffer->data() + header.size();
+  for (uint32_t y = height; y > 0; --y) {
+    const uint8_t* row = data + (y - 1) * row_size;
+    for (size_t x = 0; x < row_size; x += kBytesPerFloatPixel) {
+      std::memcpy(dst, row + x, kBytesPerFloatColor);
+      dst += kBytesPerFloatColor;
+    }
+  }
+
+  return {};
+}
+
 }  // namespace ppm
@@ -24,12 +24,23 @@
 
 namespace ppm {
 
-/// Converts the image of dimensions |width| and |height| and with pixels stored
-/// in row-major order in |values| with format B8G8R8A8 into PPM format,
-/// returning the PPM binary in |buffer|.
+/// Converts the image of dimensions |width| and |height| and with the |size|
+/// bytes of pixels stored in row-major order at |data| with format B8G8R8A8
+/// into PPM format, returning the PPM binary in |buffer|.
 amber::Result ConvertToPPM(uint32_t width,
                            uint32_t height,
-                           const std::vector<amber::Value>& values,
+                           const uint8_t* data,
+                           size_t size,
+                           std::vector<uint8_t>* buffer);
+
+/// Converts the image of dimensions |width| and |height| and with the |size|
+/// bytes of pixels stored in row-major order at |data| with format
+/// R32G32B32A32_SFLOAT into the colour PFM format, returning the PFM binary in
+/// |buffer|. Alpha is dropped.
+amber::Result ConvertToPFM(uint32_t width,
+                           uint32_t height,
+                           const uint8_t* data,
+                           size_t size,
                            std::vector<uint8_t>* buffer);
 
 }  // namespace ppm
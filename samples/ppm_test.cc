@@ -55,7 +55,7 @@ TEST_F(PPMTest, ConvertToPPM) {
   const uint32_t width = 12;
   const uint32_t height = 6;
 
-  std::vector<amber::Value> data;
+  std::vector<uint8_t> data;
 
   const uint32_t MaskRed = 0x000000FF;
   const uint32_t MaskBlue = 0x0000FF00;
@@ -75,17 +75,51 @@ TEST_F(PPMTest, ConvertToPPM) {
         // reset alpha to 1
         pixel |= MaskAplha;
       }
-      Value v;
-      v.SetIntValue(static_cast<uint64_t>(pixel));
-      data.push_back(v);
+      // Pixels are stored as little endian B8G8R8A8.
+      for (uint32_t i = 0; i < 4; ++i)
+        data.push_back(static_cast<uint8_t>(pixel >> (8 * i)));
     }
   }
 
   std::vector<uint8_t> out_buf;
-  ppm::ConvertToPPM(width, height, data, &out_buf);
+  ppm::ConvertToPPM(width, height, data.data(), data.size(), &out_buf);
 
   EXPECT_EQ(out_buf.size(), sizeof(kExpectedPPM));
   EXPECT_EQ(std::memcmp(out_buf.data(), kExpectedPPM, sizeof(kExpectedPPM)), 0);
 }
 
+TEST_F(PPMTest, ConvertToPFM) {
+  // A 1x2 image, the top pixel is red and the bottom one is blue.
+  const float pixels[] = {1.5f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, -2.0f, 1.0f};
+  std::vector<uint8_t> data(sizeof(pixels));
+  std::memcpy(data.data(), pixels, sizeof(pixels));
+
+  std::vector<uint8_t> out_buf;
+  Result r = ppm::ConvertToPFM(1, 2, data.data(), data.size(), &out_buf);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  const std::string header = "PF\n1 2\n-1.0\n";
+  ASSERT_EQ(header.size() + 24, out_buf.size());
+  EXPECT_EQ(header, std::string(out_buf.data(),
+                                out_buf.data() + header.size()));
+
+  // Rows are written bottom up, without alpha.
+  float rgb[6];
+  std::memcpy(rgb, out_buf.data() + header.size(), sizeof(rgb));
+  EXPECT_FLOAT_EQ(0.0f, rgb[0]);
+  EXPECT_FLOAT_EQ(0.0f, rgb[1]);
+  EXPECT_FLOAT_EQ(-2.0f, rgb[2]);
+  EXPECT_FLOAT_EQ(1.5f, rgb[3]);
+  EXPECT_FLOAT_EQ(0.0f, rgb[4]);
+  EXPECT_FLOAT_EQ(0.0f, rgb[5]);
+}
+
+TEST_F(PPMTest, ConvertToPFMWrongSize) {
+  std::vector<uint8_t> data(20);
+  std::vector<uint8_t> out_buf;
+  Result r = ppm::ConvertToPFM(1, 1, data.data(), data.size(), &out_buf);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("Data size (20) != width * height * 16 (16)", r.Error());
+}
+
 }  // namespace amber
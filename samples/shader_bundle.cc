@@ -0,0 +1,187 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "samples/shader_bundle.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "src/hash.h"
+
+namespace shader_bundle {
+namespace {
+
+const char kMagic[4] = {'A', 'M', 'B', 'S'};
+const uint32_t kVersion = 2;
+const size_t kHeaderSize = 12;
+const size_t kEntryHeaderSize = 16;
+
+size_t PaddedSize(size_t size) {
+  return (size + 3) & ~size_t(3);
+}
+
+void AppendBytes(const void* data, size_t size, std::vector<uint8_t>* out) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  out->insert(out->end(), bytes, bytes + size);
+}
+
+void AppendUint32(uint32_t value, std::vector<uint8_t>* out) {
+  for (uint32_t i = 0; i < 4; ++i)
+    out->push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+void AppendUint64(uint64_t value, std::vector<uint8_t>* out) {
+  for (uint32_t i = 0; i < 8; ++i)
+    out->push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+uint32_t ReadUint32(const uint8_t* data) {
+  uint32_t value = 0;
+  for (uint32_t i = 0; i < 4; ++i)
+    value |= uint32_t(data[i]) << (8 * i);
+  return value;
+}
+
+uint64_t ReadUint64(const uint8_t* data) {
+  uint64_t value = 0;
+  for (uint32_t i = 0; i < 8; ++i)
+    value |= uint64_t(data[i]) << (8 * i);
+  return value;
+}
+
+}  // namespace
+
+uint64_t HashShaderSource(const amber::ShaderInfo& info,
+                          const std::string& spv_env) {
+  // The same source compiles differently for another stage, environment or
+  // set of optimization passes.
+  std::string key = std::to_string(info.format) + ":" +
+                    std::to_string(info.type) + ":" + spv_env + ":";
+  for (const auto& pass : info.optimizations)
+    key += pass + ";";
+  key += ":";
+  uint64_t seed = amber::XXH64(key.data(), key.size());
+  return amber::XXH64(info.shader_source.data(), info.shader_source.size(),
+                      seed);
+}
+
+void WriteBundle(const std::vector<Entry>& entries, std::vector<uint8_t>* out) {
+  out->clear();
+  AppendBytes(kMagic, sizeof(kMagic), out);
+  AppendUint32(kVersion, out);
+  AppendUint32(static_cast<uint32_t>(entries.size()), out);
+
+  for (const auto& entry : entries) {
+    AppendUint32(static_cast<uint32_t>(entry.name.size()), out);
+    AppendUint32(static_cast<uint32_t>(entry.words.size()), out);
+    AppendUint64(entry.source_hash, out);
+    AppendBytes(entry.name.data(), entry.name.size(), out);
+    out->resize(out->size() + PaddedSize(entry.name.size()) -
+                entry.name.size());
+    for (uint32_t word : entry.words)
+      AppendUint32(word, out);
+  }
+}
+
+Reader::Reader() = default;
+
+Reader::~Reader() = default;
+
+amber::Result Reader::Parse(const uint8_t* data, size_t size) {
+  entries_.clear();
+  if (size < kHeaderSize || memcmp(data, kMagic, sizeof(kMagic)) != 0)
+    return amber::Result("not a shader bundle");
+  if (ReadUint32(data + 4) != kVersion)
+    return amber::Result("unsupported shader bundle version");
+
+  uint32_t count = ReadUint32(data + 8);
+  size_t offset = kHeaderSize;
+  for (uint32_t i = 0; i < count; ++i) {
+    if (size - offset < kEntryHeaderSize)
+      return amber::Result("truncated shader bundle");
+
+    size_t name_size = ReadUint32(data + offset);
+    uint32_t word_count = ReadUint32(data + offset + 4);
+    uint64_t source_hash = ReadUint64(data + offset + 8);
+    offset += kEntryHeaderSize;
+
+    size_t words_size = size_t(word_count) * sizeof(uint32_t);
+    if (size - offset < PaddedSize(name_size) ||
+        size - offset - PaddedSize(name_size) < words_size) {
+      return amber::Result("truncated shader bundle");
+    }
+
+    EntryView view;
+    view.name.assign(reinterpret_cast<const char*>(data + offset), name_size);
+    view.source_hash = source_hash;
+    view.words = data + offset + PaddedSize(name_size);
+    view.word_count = word_count;
+    entries_.push_back(std::move(view));
+
+    offset += PaddedSize(name_size) + words_size;
+  }
+
+  // Sorted by hash so each lookup is a binary search, however many scripts
+  // the bundle was built from.
+  std::stable_sort(entries_.begin(), entries_.end(),
+                   [](const EntryView& a, const EntryView& b) {
+                     return a.source_hash < b.source_hash;
+                   });
+  return {};
+}
+
+std::vector<amber::ShaderInfo> GetBundledShaders(const amber::Recipe& recipe) {
+  std::vector<amber::ShaderInfo> shaders;
+  for (auto& info : recipe.GetShaderInfo()) {
+    // OpenCL C shaders also produce descriptor maps, which are not bundled.
+    if (info.format == amber::kShaderFormatOpenCLC)
+      continue;
+    // A ShaderMap entry is used by every pipeline attaching the shader, so a
+    // shader which pipelines optimize differently is compiled per pipeline.
+    if (recipe.GetShaderOptimizations(info.shader_name).size() > 1)
+      continue;
+
+    shaders.push_back(std::move(info));
+  }
+  return shaders;
+}
+
+size_t Reader::AddToShaderMap(const std::vector<amber::ShaderInfo>& shaders,
+                              const std::string& spv_env,
+                              amber::ShaderMap* map) const {
+  size_t added = 0;
+  for (const auto& shader : shaders) {
+    uint64_t hash = HashShaderSource(shader, spv_env);
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), hash,
+                               [](const EntryView& entry, uint64_t value) {
+                                 return entry.source_hash < value;
+                               });
+    for (; it != entries_.end() && it->source_hash == hash; ++it) {
+      const auto& entry = *it;
+      if (entry.name != shader.shader_name)
+        continue;
+
+      std::vector<uint32_t> words(entry.word_count);
+      for (uint32_t i = 0; i < entry.word_count; ++i)
+        words[i] = ReadUint32(entry.words + size_t(i) * sizeof(uint32_t));
+      (*map)[shader.shader_name] = std::move(words);
+      ++added;
+      break;
+    }
+  }
+  return added;
+}
+
+}  // namespace shader_bundle
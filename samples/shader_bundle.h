@@ -0,0 +1,91 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SAMPLES_SHADER_BUNDLE_H_
+#define SAMPLES_SHADER_BUNDLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "amber/amber.h"
+#include "amber/recipe.h"
+#include "amber/result.h"
+#include "amber/shader_info.h"
+
+/// A shader bundle holds precompiled SPIR-V for the shaders of a set of
+/// scripts, so they can be run through Amber::ExecuteWithShaderData without a
+/// shader compiler. Each entry is keyed by the shader name and a hash of its
+/// source and optimization passes, so shaders of the same name in different
+/// scripts do not collide and a stale entry is never used for changed source
+/// or optimizations.
+///
+/// The bundle starts with the magic "AMBS", a version and an entry count,
+/// each a little endian uint32. Each entry is the name length and word count
+/// as uint32, the source hash as uint64, the name padded with zeros to a
+/// multiple of 4 bytes, then the SPIR-V words.
+namespace shader_bundle {
+
+struct Entry {
+  std::string name;
+  uint64_t source_hash = 0;
+  std::vector<uint32_t> words;
+};
+
+/// Returns the hash identifying the source of |info| compiled with its
+/// optimization passes for the SPIR-V environment |spv_env|.
+uint64_t HashShaderSource(const amber::ShaderInfo& info,
+                          const std::string& spv_env);
+
+/// Returns the shaders of |recipe| which a bundle can hold. Shaders which
+/// pipelines optimize differently, and OpenCL C shaders, are left out.
+std::vector<amber::ShaderInfo> GetBundledShaders(const amber::Recipe& recipe);
+
+/// Serializes |entries| as a bundle into |out|.
+void WriteBundle(const std::vector<Entry>& entries, std::vector<uint8_t>* out);
+
+/// A read-only view of a serialized bundle. The entries are indexed in place,
+/// SPIR-V is only copied for the shaders looked up.
+class Reader {
+ public:
+  Reader();
+  ~Reader();
+
+  /// Indexes the bundle in the |size| bytes at |data|, which must outlive the
+  /// reader. The data can be a mapped file; only the entry headers are read.
+  amber::Result Parse(const uint8_t* data, size_t size);
+
+  size_t GetEntryCount() const { return entries_.size(); }
+
+  /// Adds the SPIR-V of each of |shaders| which has an entry for |spv_env|
+  /// to |map|. Returns the number of shaders added.
+  size_t AddToShaderMap(const std::vector<amber::ShaderInfo>& shaders,
+                        const std::string& spv_env,
+                        amber::ShaderMap* map) const;
+
+ private:
+  struct EntryView {
+    std::string name;
+    uint64_t source_hash;
+    const uint8_t* words;
+    uint32_t word_count;
+  };
+
+  std::vector<EntryView> entries_;
+};
+
+}  // namespace shader_bundle
+
+#endif  // SAMPLES_SHADER_BUNDLE_H_
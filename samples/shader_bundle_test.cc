@@ -0,0 +1,172 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "samples/shader_bundle.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace amber {
+namespace {
+
+ShaderInfo MakeShaderInfo(const std::string& name, const std::string& source) {
+  return ShaderInfo{kShaderFormatGlsl, kShaderTypeCompute, name, source, {}};
+}
+
+}  // namespace
+
+using ShaderBundleTest = testing::Test;
+
+TEST_F(ShaderBundleTest, RoundTrip) {
+  ShaderInfo first = MakeShaderInfo("shader", "void main() {}");
+  ShaderInfo second = MakeShaderInfo("shader", "void main() { return; }");
+  ShaderInfo odd_name = MakeShaderInfo("odd", "void main() {}");
+
+  std::vector<shader_bundle::Entry> entries(3);
+  entries[0].name = first.shader_name;
+  entries[0].source_hash = shader_bundle::HashShaderSource(first, "spv1.0");
+  entries[0].words = {0x07230203, 1, 2};
+  entries[1].name = second.shader_name;
+  entries[1].source_hash = shader_bundle::HashShaderSource(second, "spv1.0");
+  entries[1].words = {0x07230203, 3};
+  entries[2].name = odd_name.shader_name;
+  entries[2].source_hash = shader_bundle::HashShaderSource(odd_name, "spv1.0");
+  entries[2].words = {0x07230203, 4, 5, 6};
+
+  std::vector<uint8_t> data;
+  shader_bundle::WriteBundle(entries, &data);
+
+  shader_bundle::Reader reader;
+  Result r = reader.Parse(data.data(), data.size());
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+  EXPECT_EQ(3U, reader.GetEntryCount());
+
+  // Shaders of the same name are told apart by their source.
+  ShaderMap map;
+  EXPECT_EQ(1U, reader.AddToShaderMap({second}, "spv1.0", &map));
+  EXPECT_EQ(std::vector<uint32_t>({0x07230203, 3}), map["shader"]);
+
+  map.clear();
+  EXPECT_EQ(2U, reader.AddToShaderMap({first, odd_name}, "spv1.0", &map));
+  EXPECT_EQ(std::vector<uint32_t>({0x07230203, 1, 2}), map["shader"]);
+  EXPECT_EQ(std::vector<uint32_t>({0x07230203, 4, 5, 6}), map["odd"]);
+}
+
+TEST_F(ShaderBundleTest, SkipsStaleEntries) {
+  ShaderInfo info = MakeShaderInfo("shader", "void main() {}");
+
+  std::vector<shader_bundle::Entry> entries(1);
+  entries[0].name = info.shader_name;
+  entries[0].source_hash = shader_bundle::HashShaderSource(info, "spv1.0");
+  entries[0].words = {0x07230203};
+
+  std::vector<uint8_t> data;
+  shader_bundle::WriteBundle(entries, &data);
+
+  shader_bundle::Reader reader;
+  ASSERT_TRUE(reader.Parse(data.data(), data.size()).IsSuccess());
+
+  ShaderMap map;
+  EXPECT_EQ(0U, reader.AddToShaderMap({info}, "spv1.3", &map));
+
+  info.shader_source += " ";
+  EXPECT_EQ(0U, reader.AddToShaderMap({info}, "spv1.0", &map));
+
+  info.shader_source.pop_back();
+  info.type = kShaderTypeFragment;
+  EXPECT_EQ(0U, reader.AddToShaderMap({info}, "spv1.0", &map));
+  EXPECT_TRUE(map.empty());
+}
+
+TEST_F(ShaderBundleTest, KeyIncludesOptimizations) {
+  ShaderInfo info = MakeShaderInfo("shader", "void main() {}");
+  info.optimizations = {"--inline-entry-points-exhaustive"};
+
+  std::vector<shader_bundle::Entry> entries(1);
+  entries[0].name = info.shader_name;
+  entries[0].source_hash = shader_bundle::HashShaderSource(info, "spv1.0");
+  entries[0].words = {0x07230203};
+
+  std::vector<uint8_t> data;
+  shader_bundle::WriteBundle(entries, &data);
+
+  shader_bundle::Reader reader;
+  ASSERT_TRUE(reader.Parse(data.data(), data.size()).IsSuccess());
+
+  ShaderMap map;
+  EXPECT_EQ(1U, reader.AddToShaderMap({info}, "spv1.0", &map));
+
+  // Changed optimizations must not use the SPIR-V optimized the old way.
+  map.clear();
+  ShaderInfo other = info;
+  other.optimizations.push_back("--eliminate-dead-code-aggressive");
+  EXPECT_EQ(0U, reader.AddToShaderMap({other}, "spv1.0", &map));
+  EXPECT_TRUE(map.empty());
+}
+
+TEST_F(ShaderBundleTest, GetBundledShaders) {
+  std::string script = R"(#!amber
+SHADER compute mixed GLSL
+void main() {}
+END
+SHADER compute single GLSL
+void main() {}
+END
+
+PIPELINE compute first
+  ATTACH mixed
+  SHADER_OPTIMIZATION mixed
+    --inline-entry-points-exhaustive
+  END
+END
+PIPELINE compute second
+  ATTACH mixed
+END
+PIPELINE compute third
+  ATTACH single
+END)";
+
+  Amber am;
+  Recipe recipe;
+  Result r = am.Parse(script, &recipe);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+  ASSERT_EQ(2U, recipe.GetShaderInfo().size());
+
+  // The first pipeline optimizes |mixed| and the second does not, so a single
+  // precompiled binary can not serve both.
+  auto shaders = shader_bundle::GetBundledShaders(recipe);
+  ASSERT_EQ(1U, shaders.size());
+  EXPECT_EQ("single", shaders[0].shader_name);
+}
+
+TEST_F(ShaderBundleTest, RejectsInvalidData) {
+  shader_bundle::Reader reader;
+  std::vector<uint8_t> data = {'N', 'O', 'P', 'E', 1, 0, 0, 0, 0, 0, 0, 0};
+  Result r = reader.Parse(data.data(), data.size());
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("not a shader bundle", r.Error());
+
+  std::vector<shader_bundle::Entry> entries(1);
+  entries[0].name = "shader";
+  entries[0].words = {1, 2, 3};
+  shader_bundle::WriteBundle(entries, &data);
+  data.pop_back();
+  r = reader.Parse(data.data(), data.size());
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("truncated shader bundle", r.Error());
+}
+
+}  // namespace amber
@@ -14,8 +14,10 @@
 
 #include "amber/amber.h"
 
+#include <algorithm>
 #include <cctype>
 #include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <string>
 
@@ -23,41 +25,52 @@
 #include "src/descriptor_set_and_binding_parser.h"
 #include "src/engine.h"
 #include "src/executor.h"
+#include "src/image_converter.h"
 #include "src/make_unique.h"
 #include "src/parser.h"
+#include "src/trace.h"
 #include "src/vkscript/parser.h"
 
 namespace amber {
 namespace {
 
-const FormatType kDefaultFramebufferFormat = FormatType::kB8G8R8A8_UNORM;
+Result GetFrameBuffer(Buffer* buffer,
+                      ImageDataFormat output,
+                      std::vector<uint8_t>* data) {
+  data->clear();
 
-Result GetFrameBuffer(Buffer* buffer, std::vector<Value>* values) {
-  values->clear();
-
-  // TODO(jaebaek): Support other formats
-  if (buffer->GetFormat()->GetFormatType() != kDefaultFramebufferFormat)
-    return Result("GetFrameBuffer Unsupported buffer format");
-
-  const uint8_t* cpu_memory = buffer->ValuePtr()->data();
+  const uint8_t* cpu_memory = buffer->GetRawData();
   if (!cpu_memory)
     return Result("GetFrameBuffer missing memory pointer");
 
-  const auto texel_stride = buffer->GetElementStride();
-  const auto row_stride = buffer->GetRowStride();
+  size_t size = size_t(buffer->GetRowStride()) * buffer->GetHeight();
+  if (buffer->GetRawDataSize() < size)
+    return Result("GetFrameBuffer buffer is smaller than the frame");
 
-  for (uint32_t y = 0; y < buffer->GetHeight(); ++y) {
-    for (uint32_t x = 0; x < buffer->GetWidth(); ++x) {
-      Value pixel;
+  return ConvertImage(buffer->GetFormat(), cpu_memory, buffer->GetWidth(),
+                      buffer->GetHeight(), buffer->GetRowStride(), output,
+                      data);
+}
 
-      const uint8_t* ptr_8 = cpu_memory + (row_stride * y) + (texel_stride * x);
-      const uint32_t* ptr_32 = reinterpret_cast<const uint32_t*>(ptr_8);
-      pixel.SetIntValue(*ptr_32);
-      values->push_back(pixel);
+// Fills the deprecated |values| of |info| from its |data|, in the layout used
+// before |data| was added.
+void FillValues(BufferInfo* info) {
+  info->values.clear();
+  if (info->is_image_buffer &&
+      info->image_format == ImageDataFormat::kB8G8R8A8Unorm) {
+    for (size_t i = 0; i + 4 <= info->data.size(); i += 4) {
+      uint32_t pixel;
+      memcpy(&pixel, info->data.data() + i, sizeof(pixel));
+      info->values.emplace_back();
+      info->values.back().SetIntValue(pixel);
     }
+    return;
   }
 
-  return {};
+  for (uint8_t byte : info->data) {
+    info->values.emplace_back();
+    info->values.back().SetIntValue(byte);
+  }
 }
 
 }  // namespace
@@ -69,11 +82,19 @@ Options::Options()
       config(nullptr),
       execution_type(ExecutionType::kExecute),
       disable_spirv_validation(false),
+      validation_cache(nullptr),
+      verifier_thread_count(1),
       delegate(nullptr) {}
 
 Options::~Options() = default;
 
-BufferInfo::BufferInfo() : is_image_buffer(false), width(0), height(0) {}
+BufferInfo::BufferInfo()
+    : is_image_buffer(false),
+      width(0),
+      height(0),
+      image_format(ImageDataFormat::kB8G8R8A8Unorm),
+      element_size(0),
+      fill_values(false) {}
 
 BufferInfo::BufferInfo(const BufferInfo&) = default;
 
@@ -83,20 +104,32 @@ BufferInfo& BufferInfo::operator=(const BufferInfo&) = default;
 
 Delegate::~Delegate() = default;
 
+bool Delegate::IsTracing() const {
+  return false;
+}
+
+void Delegate::TraceSpan(const char*, const char*, uint64_t, uint64_t) {}
+
+ValidationCache::~ValidationCache() = default;
+
 Amber::Amber() = default;
 
+Amber::Amber(Delegate* delegate) : delegate_(delegate) {}
+
 Amber::~Amber() = default;
 
 amber::Result Amber::Parse(const std::string& input, amber::Recipe* recipe) {
   if (!recipe)
     return Result("Recipe must be provided to Parse.");
 
+  TraceScope trace(delegate_, "parse", "Parse");
   std::unique_ptr<Parser> parser;
   if (input.substr(0, 7) == "#!amber")
     parser = MakeUnique<amberscript::Parser>();
   else
     parser = MakeUnique<vkscript::Parser>();
 
+  parser->SetThreadCount(parse_thread_count_);
   Result r = parser->Parse(input);
   if (!r.IsSuccess())
     return r;
@@ -195,10 +228,15 @@ amber::Result Amber::ExecuteWithShaderData(const amber::Recipe* recipe,
 
       buffer_info.width = buffer->GetWidth();
       buffer_info.height = buffer->GetHeight();
-      r = GetFrameBuffer(buffer, &(buffer_info.values));
+      buffer_info.element_size =
+          ImageDataFormatSizeInBytes(buffer_info.image_format);
+      r = GetFrameBuffer(buffer, buffer_info.image_format,
+                         &(buffer_info.data));
       if (!r.IsSuccess())
         break;
 
+      if (buffer_info.fill_values)
+        FillValues(&buffer_info);
       continue;
     }
 
@@ -213,13 +251,13 @@ amber::Result Amber::ExecuteWithShaderData(const amber::Recipe* recipe,
     if (!buffer)
       break;
 
-    const uint8_t* ptr = buffer->ValuePtr()->data();
-    auto& values = buffer_info.values;
-    for (size_t i = 0; i < buffer->GetSizeInBytes(); ++i) {
-      values.emplace_back();
-      values.back().SetIntValue(*ptr);
-      ++ptr;
-    }
+    const uint8_t* ptr = buffer->GetRawData();
+    size_t size = std::min(size_t(buffer->GetSizeInBytes()),
+                           buffer->GetRawDataSize());
+    buffer_info.element_size = buffer->GetFormat()->SizeInBytes();
+    buffer_info.data.assign(ptr, ptr + size);
+    if (buffer_info.fill_values)
+      FillValues(&buffer_info);
   }
 
   if (!executor_result.IsSuccess())
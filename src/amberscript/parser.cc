@@ -20,7 +20,9 @@
 #include <utility>
 #include <vector>
 
+#include "src/encoding.h"
 #include "src/make_unique.h"
+#include "src/mapped_file.h"
 #include "src/shader_data.h"
 #include "src/tokenizer.h"
 #include "src/type_parser.h"
@@ -50,6 +52,25 @@ ProbeSSBOCommand::Comparator ToComparator(const std::string& in) {
   return ProbeSSBOCommand::Comparator::kLessOrEqual;
 }
 
+// Returns true if the components of |fmt| hold floating point values.
+bool HasFloatComponents(const Format* fmt) {
+  for (const auto& seg : fmt->GetSegments()) {
+    if (!seg.IsPadding())
+      return type::Type::IsFloat(seg.GetFormatMode());
+  }
+  return false;
+}
+
+// Returns |token| as a Value of the kind stored in the components of |fmt|.
+Value ToComponentValue(const Format* fmt, const Token& token) {
+  Value value;
+  if (HasFloatComponents(fmt))
+    value.SetDoubleValue(token.AsDouble());
+  else
+    value.SetIntValue(token.AsUint64());
+  return value;
+}
+
 std::unique_ptr<type::Type> ToType(const std::string& str) {
   TypeParser parser;
   if (str == "int8")
@@ -134,15 +155,15 @@ std::string Parser::make_error(const std::string& err) {
 Result Parser::Parse(const std::string& data) {
   tokenizer_ = MakeUnique<Tokenizer>(data);
 
-  for (auto token = tokenizer_->NextToken(); !token->IsEOS();
+  for (auto token = tokenizer_->NextToken(); !token.IsEOS();
        token = tokenizer_->NextToken()) {
-    if (token->IsEOL())
+    if (token.IsEOL())
       continue;
-    if (!token->IsString())
+    if (!token.IsString())
       return Result(make_error("expected string"));
 
     Result r;
-    std::string tok = token->AsString();
+    std::string tok = token.AsString();
     if (IsRepeatable(tok)) {
       r = ParseRepeatableCommand(tok);
     } else if (tok == "BUFFER") {
@@ -279,34 +300,34 @@ Result Parser::ToPipelineType(const std::string& str, PipelineType* type) {
 
 Result Parser::ValidateEndOfStatement(const std::string& name) {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return {};
   return Result("extra parameters after " + name);
 }
 
 Result Parser::ParseShaderBlock() {
   auto token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("invalid token when looking for shader type");
 
   ShaderType type = kShaderTypeVertex;
-  Result r = ToShaderType(token->AsString(), &type);
+  Result r = ToShaderType(token.AsString(), &type);
   if (!r.IsSuccess())
     return r;
 
   auto shader = MakeUnique<Shader>(type);
 
   token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("invalid token when looking for shader name");
 
-  shader->SetName(token->AsString());
+  shader->SetName(token.AsString());
 
   token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("invalid token when looking for shader format");
 
-  std::string fmt = token->AsString();
+  std::string fmt = token.AsString();
   if (fmt == "PASSTHROUGH") {
     if (type != kShaderTypeVertex) {
       return Result(
@@ -341,7 +362,7 @@ Result Parser::ParseShaderBlock() {
   shader->SetData(data);
 
   token = tokenizer_->NextToken();
-  if (!token->IsString() || token->AsString() != "END")
+  if (!token.IsString() || token.AsString() != "END")
     return Result("SHADER missing END command");
 
   r = script_->AddShader(std::move(shader));
@@ -353,21 +374,21 @@ Result Parser::ParseShaderBlock() {
 
 Result Parser::ParsePipelineBlock() {
   auto token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("invalid token when looking for pipeline type");
 
   PipelineType type = PipelineType::kCompute;
-  Result r = ToPipelineType(token->AsString(), &type);
+  Result r = ToPipelineType(token.AsString(), &type);
   if (!r.IsSuccess())
     return r;
 
   auto pipeline = MakeUnique<Pipeline>(type);
 
   token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("invalid token when looking for pipeline name");
 
-  pipeline->SetName(token->AsString());
+  pipeline->SetName(token.AsString());
 
   r = ValidateEndOfStatement("PIPELINE command");
   if (!r.IsSuccess())
@@ -378,16 +399,16 @@ Result Parser::ParsePipelineBlock() {
 
 Result Parser::ParsePipelineBody(const std::string& cmd_name,
                                  std::unique_ptr<Pipeline> pipeline) {
-  std::unique_ptr<Token> token;
-  for (token = tokenizer_->NextToken(); !token->IsEOS();
+  Token token(TokenType::kEOS);
+  for (token = tokenizer_->NextToken(); !token.IsEOS();
        token = tokenizer_->NextToken()) {
-    if (token->IsEOL())
+    if (token.IsEOL())
       continue;
-    if (!token->IsString())
+    if (!token.IsString())
       return Result("expected string");
 
     Result r;
-    std::string tok = token->AsString();
+    std::string tok = token.AsString();
     if (tok == "END") {
       break;
     } else if (tok == "ATTACH") {
@@ -413,7 +434,7 @@ Result Parser::ParsePipelineBody(const std::string& cmd_name,
       return r;
   }
 
-  if (!token->IsString() || token->AsString() != "END")
+  if (!token.IsString() || token.AsString() != "END")
     return Result(cmd_name + " missing END command");
 
   Result r = script_->AddPipeline(std::move(pipeline));
@@ -425,15 +446,15 @@ Result Parser::ParsePipelineBody(const std::string& cmd_name,
 
 Result Parser::ParsePipelineAttach(Pipeline* pipeline) {
   auto token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("invalid token in ATTACH command");
 
-  auto* shader = script_->GetShader(token->AsString());
+  auto* shader = script_->GetShader(token.AsString());
   if (!shader)
     return Result("unknown shader in ATTACH command");
 
   token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS()) {
+  if (token.IsEOL() || token.IsEOS()) {
     if (shader->GetType() == kShaderTypeMulti)
       return Result("multi shader ATTACH requires TYPE");
 
@@ -442,28 +463,28 @@ Result Parser::ParsePipelineAttach(Pipeline* pipeline) {
       return r;
     return {};
   }
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("Invalid token after ATTACH");
 
   bool set_shader_type = false;
   ShaderType shader_type = shader->GetType();
-  auto type = token->AsString();
+  auto type = token.AsString();
   if (type == "TYPE") {
     token = tokenizer_->NextToken();
-    if (!token->IsString())
+    if (!token.IsString())
       return Result("invalid type in ATTACH");
 
-    Result r = ToShaderType(token->AsString(), &shader_type);
+    Result r = ToShaderType(token.AsString(), &shader_type);
     if (!r.IsSuccess())
       return r;
 
     set_shader_type = true;
 
     token = tokenizer_->NextToken();
-    if (!token->IsString())
+    if (!token.IsString())
       return Result("ATTACH TYPE requires an ENTRY_POINT");
 
-    type = token->AsString();
+    type = token.AsString();
   }
   if (set_shader_type && type != "ENTRY_POINT")
     return Result("Unknown ATTACH parameter: " + type);
@@ -477,10 +498,10 @@ Result Parser::ParsePipelineAttach(Pipeline* pipeline) {
 
   if (type == "ENTRY_POINT") {
     token = tokenizer_->NextToken();
-    if (!token->IsString())
+    if (!token.IsString())
       return Result("missing shader name in ATTACH ENTRY_POINT command");
 
-    r = pipeline->SetShaderEntryPoint(shader, token->AsString());
+    r = pipeline->SetShaderEntryPoint(shader, token.AsString());
     if (!r.IsSuccess())
       return r;
 
@@ -488,17 +509,17 @@ Result Parser::ParsePipelineAttach(Pipeline* pipeline) {
   }
 
   while (true) {
-    if (token->IsString() && token->AsString() == "SPECIALIZE") {
+    if (token.IsString() && token.AsString() == "SPECIALIZE") {
       r = ParseShaderSpecialization(pipeline);
       if (!r.IsSuccess())
         return r;
 
       token = tokenizer_->NextToken();
     } else {
-      if (token->IsEOL() || token->IsEOS())
+      if (token.IsEOL() || token.IsEOS())
         return {};
-      if (token->IsString())
-        return Result("Unknown ATTACH parameter: " + token->AsString());
+      if (token.IsString())
+        return Result("Unknown ATTACH parameter: " + token.AsString());
       return Result("extra parameters after ATTACH command");
     }
   }
@@ -506,20 +527,20 @@ Result Parser::ParsePipelineAttach(Pipeline* pipeline) {
 
 Result Parser::ParseShaderSpecialization(Pipeline* pipeline) {
   auto token = tokenizer_->NextToken();
-  if (!token->IsInteger())
+  if (!token.IsInteger())
     return Result("specialization ID must be an integer");
 
-  auto spec_id = token->AsUint32();
+  auto spec_id = token.AsUint32();
 
   token = tokenizer_->NextToken();
-  if (!token->IsString() || token->AsString() != "AS")
+  if (!token.IsString() || token.AsString() != "AS")
     return Result("expected AS as next token");
 
   token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("expected data type in SPECIALIZE subcommand");
 
-  auto type = ToType(token->AsString());
+  auto type = ToType(token.AsString());
   if (!type)
     return Result("invalid data_type provided");
   if (!type->IsNumber())
@@ -531,9 +552,9 @@ Result Parser::ParseShaderSpecialization(Pipeline* pipeline) {
   uint32_t value = 0;
   if (type::Type::IsUint32(num->GetFormatMode(), num->NumBits()) ||
       type::Type::IsInt32(num->GetFormatMode(), num->NumBits())) {
-    value = token->AsUint32();
+    value = token.AsUint32();
   } else if (type::Type::IsFloat32(num->GetFormatMode(), num->NumBits())) {
-    Result r = token->ConvertToDouble();
+    Result r = token.ConvertToDouble();
     if (!r.IsSuccess())
       return Result("value is not a floating point value");
 
@@ -541,7 +562,7 @@ Result Parser::ParseShaderSpecialization(Pipeline* pipeline) {
       uint32_t u;
       float f;
     } u;
-    u.f = token->AsFloat();
+    u.f = token.AsFloat();
     value = u.u;
   } else {
     return Result(
@@ -555,30 +576,30 @@ Result Parser::ParseShaderSpecialization(Pipeline* pipeline) {
 
 Result Parser::ParsePipelineShaderOptimizations(Pipeline* pipeline) {
   auto token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("missing shader name in SHADER_OPTIMIZATION command");
 
-  auto* shader = script_->GetShader(token->AsString());
+  auto* shader = script_->GetShader(token.AsString());
   if (!shader)
     return Result("unknown shader in SHADER_OPTIMIZATION command");
 
   token = tokenizer_->NextToken();
-  if (!token->IsEOL())
+  if (!token.IsEOL())
     return Result("extra parameters after SHADER_OPTIMIZATION command");
 
   std::vector<std::string> optimizations;
   while (true) {
     token = tokenizer_->NextToken();
-    if (token->IsEOL())
+    if (token.IsEOL())
       continue;
-    if (token->IsEOS())
+    if (token.IsEOS())
       return Result("SHADER_OPTIMIZATION missing END command");
-    if (!token->IsString())
+    if (!token.IsString())
       return Result("SHADER_OPTIMIZATION options must be strings");
-    if (token->AsString() == "END")
+    if (token.AsString() == "END")
       break;
 
-    optimizations.push_back(token->AsString());
+    optimizations.push_back(token.AsString());
   }
 
   Result r = pipeline->SetShaderOptimizations(shader, optimizations);
@@ -590,10 +611,10 @@ Result Parser::ParsePipelineShaderOptimizations(Pipeline* pipeline) {
 
 Result Parser::ParsePipelineShaderCompileOptions(Pipeline* pipeline) {
   auto token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("missing shader name in COMPILE_OPTIONS command");
 
-  auto* shader = script_->GetShader(token->AsString());
+  auto* shader = script_->GetShader(token.AsString());
   if (!shader)
     return Result("unknown shader in COMPILE_OPTIONS command");
 
@@ -602,20 +623,20 @@ Result Parser::ParsePipelineShaderCompileOptions(Pipeline* pipeline) {
   }
 
   token = tokenizer_->NextToken();
-  if (!token->IsEOL())
+  if (!token.IsEOL())
     return Result("extra parameters after COMPILE_OPTIONS command");
 
   std::vector<std::string> options;
   while (true) {
     token = tokenizer_->NextToken();
-    if (token->IsEOL())
+    if (token.IsEOL())
       continue;
-    if (token->IsEOS())
+    if (token.IsEOS())
       return Result("COMPILE_OPTIONS missing END command");
-    if (token->AsString() == "END")
+    if (token.AsString() == "END")
       break;
 
-    options.push_back(token->AsString());
+    options.push_back(token.AsString());
   }
 
   Result r = pipeline->SetShaderCompileOptions(shader, options);
@@ -627,20 +648,20 @@ Result Parser::ParsePipelineShaderCompileOptions(Pipeline* pipeline) {
 
 Result Parser::ParsePipelineFramebufferSize(Pipeline* pipeline) {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return Result("missing size for FRAMEBUFFER_SIZE command");
-  if (!token->IsInteger())
+  if (!token.IsInteger())
     return Result("invalid width for FRAMEBUFFER_SIZE command");
 
-  pipeline->SetFramebufferWidth(token->AsUint32());
+  pipeline->SetFramebufferWidth(token.AsUint32());
 
   token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return Result("missing height for FRAMEBUFFER_SIZE command");
-  if (!token->IsInteger())
+  if (!token.IsInteger())
     return Result("invalid height for FRAMEBUFFER_SIZE command");
 
-  pipeline->SetFramebufferHeight(token->AsUint32());
+  pipeline->SetFramebufferHeight(token.AsUint32());
 
   return ValidateEndOfStatement("FRAMEBUFFER_SIZE command");
 }
@@ -659,52 +680,52 @@ Result Parser::ToBufferType(const std::string& name, BufferType* type) {
 
 Result Parser::ParsePipelineBind(Pipeline* pipeline) {
   auto token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("missing BUFFER in BIND command");
-  if (token->AsString() != "BUFFER")
+  if (token.AsString() != "BUFFER")
     return Result("missing BUFFER in BIND command");
 
   token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("missing buffer name in BIND command");
 
-  auto* buffer = script_->GetBuffer(token->AsString());
+  auto* buffer = script_->GetBuffer(token.AsString());
   if (!buffer)
-    return Result("unknown buffer: " + token->AsString());
+    return Result("unknown buffer: " + token.AsString());
 
   token = tokenizer_->NextToken();
-  if (token->IsString() && token->AsString() == "AS") {
+  if (token.IsString() && token.AsString() == "AS") {
     token = tokenizer_->NextToken();
-    if (!token->IsString())
+    if (!token.IsString())
       return Result("invalid token for BUFFER type");
 
-    if (token->AsString() == "color") {
+    if (token.AsString() == "color") {
       token = tokenizer_->NextToken();
-      if (!token->IsString() || token->AsString() != "LOCATION")
+      if (!token.IsString() || token.AsString() != "LOCATION")
         return Result("BIND missing LOCATION");
 
       token = tokenizer_->NextToken();
-      if (!token->IsInteger())
+      if (!token.IsInteger())
         return Result("invalid value for BIND LOCATION");
 
       buffer->SetBufferType(BufferType::kColor);
 
-      Result r = pipeline->AddColorAttachment(buffer, token->AsUint32());
+      Result r = pipeline->AddColorAttachment(buffer, token.AsUint32());
       if (!r.IsSuccess())
         return r;
-    } else if (token->AsString() == "depth_stencil") {
+    } else if (token.AsString() == "depth_stencil") {
       buffer->SetBufferType(BufferType::kDepth);
       Result r = pipeline->SetDepthBuffer(buffer);
       if (!r.IsSuccess())
         return r;
-    } else if (token->AsString() == "push_constant") {
+    } else if (token.AsString() == "push_constant") {
       buffer->SetBufferType(BufferType::kPushConstant);
       Result r = pipeline->SetPushConstantBuffer(buffer);
       if (!r.IsSuccess())
         return r;
     } else {
       BufferType type = BufferType::kColor;
-      Result r = ToBufferType(token->AsString(), &type);
+      Result r = ToBufferType(token.AsString(), &type);
       if (!r.IsSuccess())
         return r;
 
@@ -722,38 +743,38 @@ Result Parser::ParsePipelineBind(Pipeline* pipeline) {
     if (buffer->GetBufferType() != BufferType::kUnknown)
       token = tokenizer_->NextToken();
     // DESCRIPTOR_SET requires a buffer type to have been specified.
-    if (buffer->GetBufferType() != BufferType::kUnknown && token->IsString() &&
-        token->AsString() == "DESCRIPTOR_SET") {
+    if (buffer->GetBufferType() != BufferType::kUnknown && token.IsString() &&
+        token.AsString() == "DESCRIPTOR_SET") {
       token = tokenizer_->NextToken();
-      if (!token->IsInteger())
+      if (!token.IsInteger())
         return Result("invalid value for DESCRIPTOR_SET in BIND command");
-      uint32_t descriptor_set = token->AsUint32();
+      uint32_t descriptor_set = token.AsUint32();
 
       token = tokenizer_->NextToken();
-      if (!token->IsString() || token->AsString() != "BINDING")
+      if (!token.IsString() || token.AsString() != "BINDING")
         return Result("missing BINDING for BIND command");
 
       token = tokenizer_->NextToken();
-      if (!token->IsInteger())
+      if (!token.IsInteger())
         return Result("invalid value for BINDING in BIND command");
-      pipeline->AddBuffer(buffer, descriptor_set, token->AsUint32());
-    } else if (token->IsString() && token->AsString() == "KERNEL") {
+      pipeline->AddBuffer(buffer, descriptor_set, token.AsUint32());
+    } else if (token.IsString() && token.AsString() == "KERNEL") {
       token = tokenizer_->NextToken();
-      if (!token->IsString())
+      if (!token.IsString())
         return Result("missing kernel arg identifier");
 
-      if (token->AsString() == "ARG_NAME") {
+      if (token.AsString() == "ARG_NAME") {
         token = tokenizer_->NextToken();
-        if (!token->IsString())
+        if (!token.IsString())
           return Result("expected argument identifier");
 
-        pipeline->AddBuffer(buffer, token->AsString());
-      } else if (token->AsString() == "ARG_NUMBER") {
+        pipeline->AddBuffer(buffer, token.AsString());
+      } else if (token.AsString() == "ARG_NUMBER") {
         token = tokenizer_->NextToken();
-        if (!token->IsInteger())
+        if (!token.IsInteger())
           return Result("expected argument number");
 
-        pipeline->AddBuffer(buffer, token->AsUint32());
+        pipeline->AddBuffer(buffer, token.AsUint32());
       } else {
         return Result("missing ARG_NAME or ARG_NUMBER keyword");
       }
@@ -767,23 +788,23 @@ Result Parser::ParsePipelineBind(Pipeline* pipeline) {
 
 Result Parser::ParsePipelineVertexData(Pipeline* pipeline) {
   auto token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("missing buffer name in VERTEX_DATA command");
 
-  auto* buffer = script_->GetBuffer(token->AsString());
+  auto* buffer = script_->GetBuffer(token.AsString());
   if (!buffer)
-    return Result("unknown buffer: " + token->AsString());
+    return Result("unknown buffer: " + token.AsString());
 
   token = tokenizer_->NextToken();
-  if (!token->IsString() || token->AsString() != "LOCATION")
+  if (!token.IsString() || token.AsString() != "LOCATION")
     return Result("VERTEX_DATA missing LOCATION");
 
   token = tokenizer_->NextToken();
-  if (!token->IsInteger())
+  if (!token.IsInteger())
     return Result("invalid value for VERTEX_DATA LOCATION");
 
   buffer->SetBufferType(BufferType::kVertex);
-  Result r = pipeline->AddVertexBuffer(buffer, token->AsUint32());
+  Result r = pipeline->AddVertexBuffer(buffer, token.AsUint32());
   if (!r.IsSuccess())
     return r;
 
@@ -792,12 +813,12 @@ Result Parser::ParsePipelineVertexData(Pipeline* pipeline) {
 
 Result Parser::ParsePipelineIndexData(Pipeline* pipeline) {
   auto token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("missing buffer name in INDEX_DATA command");
 
-  auto* buffer = script_->GetBuffer(token->AsString());
+  auto* buffer = script_->GetBuffer(token.AsString());
   if (!buffer)
-    return Result("unknown buffer: " + token->AsString());
+    return Result("unknown buffer: " + token.AsString());
 
   buffer->SetBufferType(BufferType::kIndex);
   Result r = pipeline->SetIndexBuffer(buffer);
@@ -815,81 +836,80 @@ Result Parser::ParsePipelineSet(Pipeline* pipeline) {
   }
 
   auto token = tokenizer_->NextToken();
-  if (!token->IsString() || token->AsString() != "KERNEL")
+  if (!token.IsString() || token.AsString() != "KERNEL")
     return Result("missing KERNEL in SET command");
 
   token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("expected ARG_NAME or ARG_NUMBER");
 
   std::string arg_name = "";
   uint32_t arg_no = std::numeric_limits<uint32_t>::max();
-  if (token->AsString() == "ARG_NAME") {
+  if (token.AsString() == "ARG_NAME") {
     token = tokenizer_->NextToken();
-    if (!token->IsString())
+    if (!token.IsString())
       return Result("expected argument identifier");
 
-    arg_name = token->AsString();
-  } else if (token->AsString() == "ARG_NUMBER") {
+    arg_name = token.AsString();
+  } else if (token.AsString() == "ARG_NUMBER") {
     token = tokenizer_->NextToken();
-    if (!token->IsInteger())
+    if (!token.IsInteger())
       return Result("expected argument number");
 
-    arg_no = token->AsUint32();
+    arg_no = token.AsUint32();
   } else {
     return Result("expected ARG_NAME or ARG_NUMBER");
   }
 
   token = tokenizer_->NextToken();
-  if (!token->IsString() || token->AsString() != "AS")
+  if (!token.IsString() || token.AsString() != "AS")
     return Result("missing AS in SET command");
 
   token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("expected data type");
 
-  auto type = ToType(token->AsString());
+  auto type = ToType(token.AsString());
   if (!type)
     return Result("invalid data_type provided");
 
   token = tokenizer_->NextToken();
-  if (!token->IsInteger() && !token->IsDouble())
+  if (!token.IsInteger() && !token.IsDouble())
     return Result("expected data value");
 
-  auto fmt = MakeUnique<Format>(type.get());
+  auto* fmt = script_->RegisterFormat(
+      MakeUnique<Format>(script_->RegisterType(std::move(type))));
   Value value;
   if (fmt->IsFloat32() || fmt->IsFloat64())
-    value.SetDoubleValue(token->AsDouble());
+    value.SetDoubleValue(token.AsDouble());
   else
-    value.SetIntValue(token->AsUint64());
+    value.SetIntValue(token.AsUint64());
 
   Pipeline::ArgSetInfo info;
   info.name = arg_name;
   info.ordinal = arg_no;
-  info.fmt = fmt.get();
+  info.fmt = fmt;
   info.value = value;
   pipeline->SetArg(std::move(info));
-  script_->RegisterFormat(std::move(fmt));
-  script_->RegisterType(std::move(type));
 
   return ValidateEndOfStatement("SET command");
 }
 
 Result Parser::ParseBuffer() {
   auto token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("invalid BUFFER name provided");
 
-  auto name = token->AsString();
+  auto name = token.AsString();
   if (name == "DATA_TYPE" || name == "FORMAT")
     return Result("missing BUFFER name");
 
   token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("invalid BUFFER command provided");
 
   std::unique_ptr<Buffer> buffer;
-  auto& cmd = token->AsString();
+  auto& cmd = token.AsString();
   if (cmd == "DATA_TYPE") {
     buffer = MakeUnique<Buffer>();
 
@@ -898,20 +918,18 @@ Result Parser::ParseBuffer() {
       return r;
   } else if (cmd == "FORMAT") {
     token = tokenizer_->NextToken();
-    if (!token->IsString())
+    if (!token.IsString())
       return Result("BUFFER FORMAT must be a string");
 
     buffer = MakeUnique<Buffer>();
 
     TypeParser type_parser;
-    auto type = type_parser.Parse(token->AsString());
+    auto type = type_parser.Parse(token.AsString());
     if (type == nullptr)
       return Result("invalid BUFFER FORMAT");
 
-    auto fmt = MakeUnique<Format>(type.get());
-    buffer->SetFormat(fmt.get());
-    script_->RegisterFormat(std::move(fmt));
-    script_->RegisterType(std::move(type));
+    buffer->SetFormat(script_->RegisterFormat(
+        MakeUnique<Format>(script_->RegisterType(std::move(type)))));
   } else {
     return Result("unknown BUFFER command provided: " + cmd);
   }
@@ -926,67 +944,68 @@ Result Parser::ParseBuffer() {
 
 Result Parser::ParseBufferInitializer(Buffer* buffer) {
   auto token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("BUFFER invalid data type");
 
   TypeParser parser;
-  auto type = parser.Parse(token->AsString());
-  std::unique_ptr<Format> fmt;
-  if (type != nullptr) {
-    fmt = MakeUnique<Format>(type.get());
-    buffer->SetFormat(fmt.get());
-  } else {
-    type = ToType(token->AsString());
+  auto type = parser.Parse(token.AsString());
+  if (type == nullptr) {
+    type = ToType(token.AsString());
     if (!type)
       return Result("invalid data_type provided");
-
-    fmt = MakeUnique<Format>(type.get());
-    buffer->SetFormat(fmt.get());
   }
-  script_->RegisterFormat(std::move(fmt));
-  script_->RegisterType(std::move(type));
+  auto fmt = MakeUnique<Format>(script_->RegisterType(std::move(type)));
 
   token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("BUFFER missing initializer");
 
-  if (token->AsString() == "STD140") {
-    buffer->GetFormat()->SetLayout(Format::Layout::kStd140);
+  // The layout is set before the format is registered, registered formats
+  // are shared and must not change.
+  if (token.AsString() == "STD140") {
+    fmt->SetLayout(Format::Layout::kStd140);
     token = tokenizer_->NextToken();
-  } else if (token->AsString() == "STD430") {
-    buffer->GetFormat()->SetLayout(Format::Layout::kStd430);
+  } else if (token.AsString() == "STD430") {
+    fmt->SetLayout(Format::Layout::kStd430);
     token = tokenizer_->NextToken();
   }
+  buffer->SetFormat(script_->RegisterFormat(std::move(fmt)));
 
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("BUFFER missing initializer");
 
-  if (token->AsString() == "SIZE")
+  if (token.AsString() == "SIZE")
     return ParseBufferInitializerSize(buffer);
-  if (token->AsString() == "DATA")
+  if (token.AsString() == "DATA")
     return ParseBufferInitializerData(buffer);
+  if (token.AsString() == "DATA_BASE64" || token.AsString() == "DATA_HEX_RAW")
+    return ParseBufferInitializerEncodedData(buffer, token.AsString());
+  if (token.AsString() == "FILE")
+    return ParseBufferInitializerFile(buffer);
 
   return Result("unknown initializer for BUFFER");
 }
 
 Result Parser::ParseBufferInitializerSize(Buffer* buffer) {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOS() || token->IsEOL())
+  if (token.IsEOS() || token.IsEOL())
     return Result("BUFFER size missing");
-  if (!token->IsInteger())
+  if (!token.IsInteger())
     return Result("BUFFER size invalid");
 
-  uint32_t size_in_items = token->AsUint32();
+  uint32_t size_in_items = token.AsUint32();
   buffer->SetElementCount(size_in_items);
 
   token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("BUFFER invalid initializer");
 
-  if (token->AsString() == "FILL")
+  if (token.AsString() == "FILL")
     return ParseBufferInitializerFill(buffer, size_in_items);
-  if (token->AsString() == "SERIES_FROM")
+  if (token.AsString() == "SERIES_FROM")
     return ParseBufferInitializerSeries(buffer, size_in_items);
+  if (token.AsString() == "RANDOM")
+    return ParseBufferInitializerRandom(buffer, size_in_items);
 
   return Result("invalid BUFFER initializer provided");
 }
@@ -994,26 +1013,13 @@ Result Parser::ParseBufferInitializerSize(Buffer* buffer) {
 Result Parser::ParseBufferInitializerFill(Buffer* buffer,
                                           uint32_t size_in_items) {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOS() || token->IsEOL())
+  if (token.IsEOS() || token.IsEOL())
     return Result("missing BUFFER fill value");
-  if (!token->IsInteger() && !token->IsDouble())
+  if (!token.IsInteger() && !token.IsDouble())
     return Result("invalid BUFFER fill value");
 
-  auto fmt = buffer->GetFormat();
-  bool is_double_data = fmt->IsFloat32() || fmt->IsFloat64();
-
-  // Inflate the size because our items are multi-dimensional.
-  size_in_items = size_in_items * fmt->InputNeededPerElement();
-
-  std::vector<Value> values;
-  values.resize(size_in_items);
-  for (size_t i = 0; i < size_in_items; ++i) {
-    if (is_double_data)
-      values[i].SetDoubleValue(token->AsDouble());
-    else
-      values[i].SetIntValue(token->AsUint64());
-  }
-  Result r = buffer->SetData(std::move(values));
+  Value value = ToComponentValue(buffer->GetFormat(), token);
+  Result r = buffer->SetFillData(size_in_items, value, thread_count_);
   if (!r.IsSuccess())
     return r;
 
@@ -1023,86 +1029,197 @@ Result Parser::ParseBufferInitializerFill(Buffer* buffer,
 Result Parser::ParseBufferInitializerSeries(Buffer* buffer,
                                             uint32_t size_in_items) {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOS() || token->IsEOL())
+  if (token.IsEOS() || token.IsEOL())
     return Result("missing BUFFER series_from value");
-  if (!token->IsInteger() && !token->IsDouble())
+  if (!token.IsInteger() && !token.IsDouble())
     return Result("invalid BUFFER series_from value");
 
   auto type = buffer->GetFormat()->GetType();
   if (type->IsMatrix() || type->IsVec())
     return Result("BUFFER series_from must not be multi-row/column types");
 
-  Value counter;
-
-  auto n = type->AsNumber();
-  FormatMode mode = n->GetFormatMode();
-  uint32_t num_bits = n->NumBits();
-  if (type::Type::IsFloat32(mode, num_bits) ||
-      type::Type::IsFloat64(mode, num_bits)) {
-    counter.SetDoubleValue(token->AsDouble());
-  } else {
-    counter.SetIntValue(token->AsUint64());
-  }
+  Value start = ToComponentValue(buffer->GetFormat(), token);
 
   token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("missing BUFFER series_from inc_by");
-  if (token->AsString() != "INC_BY")
+  if (token.AsString() != "INC_BY")
     return Result("BUFFER series_from invalid command");
 
   token = tokenizer_->NextToken();
-  if (token->IsEOS() || token->IsEOL())
+  if (token.IsEOS() || token.IsEOL())
     return Result("missing BUFFER series_from inc_by value");
-  if (!token->IsInteger() && !token->IsDouble())
+  if (!token.IsInteger() && !token.IsDouble())
     return Result("invalid BUFFER series_from inc_by value");
 
-  std::vector<Value> values;
-  values.resize(size_in_items);
-  for (size_t i = 0; i < size_in_items; ++i) {
-    if (type::Type::IsFloat32(mode, num_bits) ||
-        type::Type::IsFloat64(mode, num_bits)) {
-      double value = counter.AsDouble();
-      values[i].SetDoubleValue(value);
-      counter.SetDoubleValue(value + token->AsDouble());
-    } else {
-      uint64_t value = counter.AsUint64();
-      values[i].SetIntValue(value);
-      counter.SetIntValue(value + token->AsUint64());
-    }
-  }
-  Result r = buffer->SetData(std::move(values));
+  Value inc = ToComponentValue(buffer->GetFormat(), token);
+  Result r = buffer->SetSeriesData(size_in_items, start, inc, thread_count_);
   if (!r.IsSuccess())
     return r;
 
   return ValidateEndOfStatement("BUFFER series_from command");
 }
 
+Result Parser::ParseBufferInitializerRandom(Buffer* buffer,
+                                            uint32_t size_in_items) {
+  auto token = tokenizer_->NextToken();
+  if (!token.IsString() || token.AsString() != "SEED")
+    return Result("missing BUFFER random SEED");
+
+  token = tokenizer_->NextToken();
+  if (!token.IsInteger())
+    return Result("invalid BUFFER random SEED value");
+  uint64_t seed = token.AsUint64();
+
+  auto fmt = buffer->GetFormat();
+  bool has_range = false;
+  Value min;
+  Value max;
+  token = tokenizer_->NextToken();
+  if (token.IsString() && token.AsString() == "MIN") {
+    token = tokenizer_->NextToken();
+    if (!token.IsInteger() && !token.IsDouble())
+      return Result("invalid BUFFER random MIN value");
+    min = ToComponentValue(fmt, token);
+
+    token = tokenizer_->NextToken();
+    if (!token.IsString() || token.AsString() != "MAX")
+      return Result("missing BUFFER random MAX");
+
+    token = tokenizer_->NextToken();
+    if (!token.IsInteger() && !token.IsDouble())
+      return Result("invalid BUFFER random MAX value");
+    max = ToComponentValue(fmt, token);
+
+    bool in_order = min.AsUint64() <= max.AsUint64();
+    if (HasFloatComponents(fmt))
+      in_order = min.AsDouble() <= max.AsDouble();
+    else if (type::Type::IsSignedInt(fmt->GetSegments()[0].GetFormatMode()))
+      in_order = min.AsInt64() <= max.AsInt64();
+    if (!in_order)
+      return Result("BUFFER random MIN must not be greater than MAX");
+
+    has_range = true;
+    token = tokenizer_->NextToken();
+  }
+  if (!token.IsEOS() && !token.IsEOL())
+    return Result("extra parameters after BUFFER random command");
+
+  Result r = buffer->SetRandomData(size_in_items, seed,
+                                   has_range ? &min : nullptr,
+                                   has_range ? &max : nullptr, thread_count_);
+  if (!r.IsSuccess())
+    return Result("invalid BUFFER random data: " + r.Error());
+
+  return {};
+}
+
+Result Parser::ParseBufferInitializerEncodedData(Buffer* buffer,
+                                                 const std::string& cmd) {
+  // The encoded text is read a line at a time rather than tokenized, it does
+  // not split into tokens cleanly and may be large. The block ends at the
+  // first line starting with END, once comments are dropped.
+  const char* kSpaces = " \t\r\f";
+  std::string encoded;
+  for (;;) {
+    std::string line = tokenizer_->ExtractToNext("\n");
+    // '#' is not a valid character in either encoding.
+    size_t comment = line.find('#');
+    if (comment != std::string::npos)
+      line.erase(comment);
+
+    size_t begin = line.find_first_not_of(kSpaces);
+    size_t end = line.find_first_of(kSpaces, begin);
+    if (begin != std::string::npos &&
+        line.substr(begin, end - begin) == "END") {
+      if (line.find_first_not_of(kSpaces, end) != std::string::npos)
+        return Result("extra parameters after BUFFER " + cmd + " command");
+      break;
+    }
+    encoded += line;
+
+    auto token = tokenizer_->NextToken();
+    if (token.IsEOS())
+      return Result("missing BUFFER END command");
+  }
+
+  std::vector<uint8_t> data;
+  Result r = cmd == "DATA_BASE64" ? DecodeBase64(encoded, &data)
+                                  : DecodeHex(encoded, &data);
+  if (!r.IsSuccess())
+    return Result("invalid BUFFER " + cmd + ": " + r.Error());
+
+  r = buffer->SetRawData(std::move(data));
+  if (!r.IsSuccess())
+    return Result("invalid BUFFER " + cmd + ": " + r.Error());
+
+  return ValidateEndOfStatement("BUFFER " + cmd + " command");
+}
+
+Result Parser::ParseBufferInitializerFile(Buffer* buffer) {
+  auto token = tokenizer_->NextToken();
+  if (!token.IsString())
+    return Result("invalid BUFFER FILE path");
+
+  std::string path = token.AsString();
+  uint64_t offset = 0;
+
+  token = tokenizer_->NextToken();
+  if (token.IsString() && token.AsString() == "OFFSET") {
+    token = tokenizer_->NextToken();
+    if (!token.IsInteger())
+      return Result("invalid BUFFER FILE OFFSET");
+
+    offset = token.AsUint64();
+    token = tokenizer_->NextToken();
+  }
+  if (!token.IsEOS() && !token.IsEOL())
+    return Result("extra parameters after BUFFER FILE command");
+
+  std::unique_ptr<MappedFile> file;
+  Result r = MappedFile::Open(path, &file);
+  if (!r.IsSuccess())
+    return Result("BUFFER FILE " + r.Error());
+
+  if (offset > file->GetSize()) {
+    return Result("BUFFER FILE OFFSET " + std::to_string(offset) +
+                  " is past the end of " + path);
+  }
+
+  // The buffer keeps the mapping, the file is only copied if it is written.
+  r = buffer->SetMappedData(std::move(file), static_cast<size_t>(offset));
+  if (!r.IsSuccess())
+    return Result("invalid BUFFER FILE " + path + ": " + r.Error());
+
+  return {};
+}
+
 Result Parser::ParseBufferInitializerData(Buffer* buffer) {
   auto fmt = buffer->GetFormat();
   bool is_double_type = fmt->IsFloat32() || fmt->IsFloat64();
 
   std::vector<Value> values;
   for (auto token = tokenizer_->NextToken();; token = tokenizer_->NextToken()) {
-    if (token->IsEOL())
+    if (token.IsEOL())
       continue;
-    if (token->IsEOS())
+    if (token.IsEOS())
       return Result("missing BUFFER END command");
-    if (token->IsString() && token->AsString() == "END")
+    if (token.IsString() && token.AsString() == "END")
       break;
-    if (!token->IsInteger() && !token->IsDouble() && !token->IsHex())
-      return Result("invalid BUFFER data value: " + token->ToOriginalString());
-    if (!is_double_type && token->IsDouble())
-      return Result("invalid BUFFER data value: " + token->ToOriginalString());
+    if (!token.IsInteger() && !token.IsDouble() && !token.IsHex())
+      return Result("invalid BUFFER data value: " + token.ToOriginalString());
+    if (!is_double_type && token.IsDouble())
+      return Result("invalid BUFFER data value: " + token.ToOriginalString());
 
     Value v;
     if (is_double_type) {
-      token->ConvertToDouble();
+      token.ConvertToDouble();
 
-      double val = token->IsHex() ? static_cast<double>(token->AsHex())
-                                  : token->AsDouble();
+      double val = token.IsHex() ? static_cast<double>(token.AsHex())
+                                  : token.AsDouble();
       v.SetDoubleValue(val);
     } else {
-      uint64_t val = token->IsHex() ? token->AsHex() : token->AsUint64();
+      uint64_t val = token.IsHex() ? token.AsHex() : token.AsUint64();
       v.SetIntValue(val);
     }
 
@@ -1119,48 +1236,48 @@ Result Parser::ParseBufferInitializerData(Buffer* buffer) {
 
 Result Parser::ParseRun() {
   auto token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("missing pipeline name for RUN command");
 
   size_t line = tokenizer_->GetCurrentLine();
 
-  auto* pipeline = script_->GetPipeline(token->AsString());
+  auto* pipeline = script_->GetPipeline(token.AsString());
   if (!pipeline)
-    return Result("unknown pipeline for RUN command: " + token->AsString());
+    return Result("unknown pipeline for RUN command: " + token.AsString());
 
   token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return Result("RUN command requires parameters");
 
-  if (token->IsInteger()) {
+  if (token.IsInteger()) {
     if (!pipeline->IsCompute())
       return Result("RUN command requires compute pipeline");
 
     auto cmd = MakeUnique<ComputeCommand>(pipeline);
     cmd->SetLine(line);
-    cmd->SetX(token->AsUint32());
+    cmd->SetX(token.AsUint32());
 
     token = tokenizer_->NextToken();
-    if (!token->IsInteger()) {
+    if (!token.IsInteger()) {
       return Result("invalid parameter for RUN command: " +
-                    token->ToOriginalString());
+                    token.ToOriginalString());
     }
-    cmd->SetY(token->AsUint32());
+    cmd->SetY(token.AsUint32());
 
     token = tokenizer_->NextToken();
-    if (!token->IsInteger()) {
+    if (!token.IsInteger()) {
       return Result("invalid parameter for RUN command: " +
-                    token->ToOriginalString());
+                    token.ToOriginalString());
     }
-    cmd->SetZ(token->AsUint32());
+    cmd->SetZ(token.AsUint32());
 
     command_list_.push_back(std::move(cmd));
     return ValidateEndOfStatement("RUN command");
   }
-  if (!token->IsString())
-    return Result("invalid token in RUN command: " + token->ToOriginalString());
+  if (!token.IsString())
+    return Result("invalid token in RUN command: " + token.ToOriginalString());
 
-  if (token->AsString() == "DRAW_RECT") {
+  if (token.AsString() == "DRAW_RECT") {
     if (!pipeline->IsGraphics())
       return Result("RUN command requires graphics pipeline");
 
@@ -1171,65 +1288,65 @@ Result Parser::ParseRun() {
     }
 
     token = tokenizer_->NextToken();
-    if (token->IsEOS() || token->IsEOL())
+    if (token.IsEOS() || token.IsEOL())
       return Result("RUN DRAW_RECT command requires parameters");
 
-    if (!token->IsString() || token->AsString() != "POS") {
+    if (!token.IsString() || token.AsString() != "POS") {
       return Result("invalid token in RUN command: " +
-                    token->ToOriginalString() + "; expected POS");
+                    token.ToOriginalString() + "; expected POS");
     }
 
     token = tokenizer_->NextToken();
-    if (!token->IsInteger())
+    if (!token.IsInteger())
       return Result("missing X position for RUN command");
 
     auto cmd = MakeUnique<DrawRectCommand>(pipeline, PipelineData{});
     cmd->SetLine(line);
     cmd->EnableOrtho();
 
-    Result r = token->ConvertToDouble();
+    Result r = token.ConvertToDouble();
     if (!r.IsSuccess())
       return r;
-    cmd->SetX(token->AsFloat());
+    cmd->SetX(token.AsFloat());
 
     token = tokenizer_->NextToken();
-    if (!token->IsInteger())
+    if (!token.IsInteger())
       return Result("missing Y position for RUN command");
 
-    r = token->ConvertToDouble();
+    r = token.ConvertToDouble();
     if (!r.IsSuccess())
       return r;
-    cmd->SetY(token->AsFloat());
+    cmd->SetY(token.AsFloat());
 
     token = tokenizer_->NextToken();
-    if (!token->IsString() || token->AsString() != "SIZE") {
+    if (!token.IsString() || token.AsString() != "SIZE") {
       return Result("invalid token in RUN command: " +
-                    token->ToOriginalString() + "; expected SIZE");
+                    token.ToOriginalString() + "; expected SIZE");
     }
 
     token = tokenizer_->NextToken();
-    if (!token->IsInteger())
+    if (!token.IsInteger())
       return Result("missing width value for RUN command");
 
-    r = token->ConvertToDouble();
+    r = token.ConvertToDouble();
     if (!r.IsSuccess())
       return r;
-    cmd->SetWidth(token->AsFloat());
+    cmd->SetWidth(token.AsFloat());
 
     token = tokenizer_->NextToken();
-    if (!token->IsInteger())
+    if (!token.IsInteger())
       return Result("missing height value for RUN command");
 
-    r = token->ConvertToDouble();
+    r = token.ConvertToDouble();
     if (!r.IsSuccess())
       return r;
-    cmd->SetHeight(token->AsFloat());
+    cmd->SetHeight(token.AsFloat());
 
     command_list_.push_back(std::move(cmd));
     return ValidateEndOfStatement("RUN command");
   }
 
-  if (token->AsString() == "DRAW_ARRAY") {
+  if (token.AsString() == "DRAW_ARRAY") {
     if (!pipeline->IsGraphics())
       return Result("RUN command requires graphics pipeline");
 
@@ -1237,22 +1354,22 @@ Result Parser::ParseRun() {
       return Result("RUN DRAW_ARRAY requires attached vertex buffer");
 
     token = tokenizer_->NextToken();
-    if (!token->IsString() || token->AsString() != "AS")
+    if (!token.IsString() || token.AsString() != "AS")
       return Result("missing AS for RUN command");
 
     token = tokenizer_->NextToken();
-    if (!token->IsString()) {
+    if (!token.IsString()) {
       return Result("invalid topology for RUN command: " +
-                    token->ToOriginalString());
+                    token.ToOriginalString());
     }
 
-    Topology topo = NameToTopology(token->AsString());
+    Topology topo = NameToTopology(token.AsString());
     if (topo == Topology::kUnknown)
-      return Result("invalid topology for RUN command: " + token->AsString());
+      return Result("invalid topology for RUN command: " + token.AsString());
 
     token = tokenizer_->NextToken();
     bool indexed = false;
-    if (token->IsString() && token->AsString() == "INDEXED") {
+    if (token.IsString() && token.AsString() == "INDEXED") {
       if (!pipeline->GetIndexBuffer())
         return Result("RUN DRAW_ARRAYS INDEXED requires attached index buffer");
 
@@ -1262,34 +1379,34 @@ Result Parser::ParseRun() {
 
     uint32_t start_idx = 0;
     uint32_t count = 0;
-    if (!token->IsEOS() && !token->IsEOL()) {
-      if (!token->IsString() || token->AsString() != "START_IDX")
+    if (!token.IsEOS() && !token.IsEOL()) {
+      if (!token.IsString() || token.AsString() != "START_IDX")
         return Result("missing START_IDX for RUN command");
 
       token = tokenizer_->NextToken();
-      if (!token->IsInteger()) {
+      if (!token.IsInteger()) {
         return Result("invalid START_IDX value for RUN command: " +
-                      token->ToOriginalString());
+                      token.ToOriginalString());
       }
-      if (token->AsInt32() < 0)
+      if (token.AsInt32() < 0)
         return Result("START_IDX value must be >= 0 for RUN command");
-      start_idx = token->AsUint32();
+      start_idx = token.AsUint32();
 
       token = tokenizer_->NextToken();
 
-      if (!token->IsEOS() && !token->IsEOL()) {
-        if (!token->IsString() || token->AsString() != "COUNT")
+      if (!token.IsEOS() && !token.IsEOL()) {
+        if (!token.IsString() || token.AsString() != "COUNT")
           return Result("missing COUNT for RUN command");
 
         token = tokenizer_->NextToken();
-        if (!token->IsInteger()) {
+        if (!token.IsInteger()) {
           return Result("invalid COUNT value for RUN command: " +
-                        token->ToOriginalString());
+                        token.ToOriginalString());
         }
-        if (token->AsInt32() <= 0)
+        if (token.AsInt32() <= 0)
           return Result("COUNT value must be > 0 for RUN command");
 
-        count = token->AsUint32();
+        count = token.AsUint32();
       }
     }
     // If we get here then we never set count, as if count was set it must
@@ -1317,19 +1434,19 @@ Result Parser::ParseRun() {
     return ValidateEndOfStatement("RUN command");
   }
 
-  return Result("invalid token in RUN command: " + token->AsString());
+  return Result("invalid token in RUN command: " + token.AsString());
 }
 
 Result Parser::ParseClear() {
   auto token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("missing pipeline name for CLEAR command");
 
   size_t line = tokenizer_->GetCurrentLine();
 
-  auto* pipeline = script_->GetPipeline(token->AsString());
+  auto* pipeline = script_->GetPipeline(token.AsString());
   if (!pipeline)
-    return Result("unknown pipeline for CLEAR command: " + token->AsString());
+    return Result("unknown pipeline for CLEAR command: " + token.AsString());
   if (!pipeline->IsGraphics())
     return Result("CLEAR command requires graphics pipeline");
 
@@ -1346,69 +1463,92 @@ Result Parser::ParseValues(const std::string& name,
   assert(values);
 
   auto token = tokenizer_->NextToken();
-  while (!token->IsEOL() && !token->IsEOS()) {
+  while (!token.IsEOL() && !token.IsEOS()) {
     Value v;
+    Result r = ParseValue(name, fmt, &token, &v);
+    if (!r.IsSuccess())
+      return r;
 
-    if (fmt->IsFloat32() || fmt->IsFloat64()) {
-      if (!token->IsInteger() && !token->IsDouble()) {
-        return Result(std::string("Invalid value provided to ") + name +
-                      " command: " + token->ToOriginalString());
-      }
+    values->push_back(v);
+    token = tokenizer_->NextToken();
+  }
+  return {};
+}
 
-      Result r = token->ConvertToDouble();
-      if (!r.IsSuccess())
-        return r;
+Result Parser::ParseValue(const std::string& name,
+                          Format* fmt,
+                          Token* token,
+                          Value* value) {
+  if (fmt->IsFloat32() || fmt->IsFloat64()) {
+    if (!token->IsInteger() && !token->IsDouble()) {
+      return Result(std::string("Invalid value provided to ") + name +
+                    " command: " + token->ToOriginalString());
+    }
 
-      v.SetDoubleValue(token->AsDouble());
-    } else {
-      if (!token->IsInteger()) {
-        return Result(std::string("Invalid value provided to ") + name +
-                      " command: " + token->ToOriginalString());
-      }
+    Result r = token->ConvertToDouble();
+    if (!r.IsSuccess())
+      return r;
 
-      v.SetIntValue(token->AsUint64());
+    value->SetDoubleValue(token->AsDouble());
+  } else {
+    if (!token->IsInteger()) {
+      return Result(std::string("Invalid value provided to ") + name +
+                    " command: " + token->ToOriginalString());
     }
 
-    values->push_back(v);
-    token = tokenizer_->NextToken();
+    value->SetIntValue(token->AsUint64());
   }
   return {};
 }
 
 Result Parser::ParseExpect() {
   auto token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("invalid buffer name in EXPECT command");
 
-  if (token->AsString() == "IDX")
+  if (token.AsString() == "IDX")
     return Result("missing buffer name between EXPECT and IDX");
-  if (token->AsString() == "EQ_BUFFER")
+  if (token.AsString() == "EQ_BUFFER")
     return Result("missing buffer name between EXPECT and EQ_BUFFER");
-  if (token->AsString() == "RMSE_BUFFER")
+  if (token.AsString() == "RMSE_BUFFER")
     return Result("missing buffer name between EXPECT and RMSE_BUFFER");
+  if (token.AsString() == "SSIM_BUFFER")
+    return Result("missing buffer name between EXPECT and SSIM_BUFFER");
+  if (token.AsString() == "PSNR_BUFFER")
+    return Result("missing buffer name between EXPECT and PSNR_BUFFER");
+  if (token.AsString() == "MAX_ERROR_BUFFER")
+    return Result("missing buffer name between EXPECT and MAX_ERROR_BUFFER");
+  if (token.AsString() == "HASH")
+    return Result("missing buffer name between EXPECT and HASH");
+  if (token.AsString() == "EQ_FILE")
+    return Result("missing buffer name between EXPECT and EQ_FILE");
+  if (token.AsString() == "RMSE_FILE")
+    return Result("missing buffer name between EXPECT and RMSE_FILE");
 
   size_t line = tokenizer_->GetCurrentLine();
-  auto* buffer = script_->GetBuffer(token->AsString());
+  auto* buffer = script_->GetBuffer(token.AsString());
   if (!buffer)
     return Result("unknown buffer name for EXPECT command: " +
-                  token->AsString());
+                  token.AsString());
 
   token = tokenizer_->NextToken();
 
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("Invalid comparator in EXPECT command");
 
-  if (token->AsString() == "EQ_BUFFER" || token->AsString() == "RMSE_BUFFER") {
-    auto type = token->AsString();
+  if (token.AsString() == "EQ_BUFFER" || token.AsString() == "RMSE_BUFFER" ||
+      token.AsString() == "SSIM_BUFFER" || token.AsString() == "PSNR_BUFFER" ||
+      token.AsString() == "MAX_ERROR_BUFFER") {
+    auto type = token.AsString();
 
     token = tokenizer_->NextToken();
-    if (!token->IsString())
+    if (!token.IsString())
       return Result("invalid buffer name in EXPECT " + type + " command");
 
-    auto* buffer_2 = script_->GetBuffer(token->AsString());
+    auto* buffer_2 = script_->GetBuffer(token.AsString());
     if (!buffer_2) {
       return Result("unknown buffer name for EXPECT " + type +
-                    " command: " + token->AsString());
+                    " command: " + token.AsString());
     }
 
     if (!buffer->GetFormat()->Equal(buffer_2->GetFormat())) {
@@ -1435,50 +1575,164 @@ Result Parser::ParseExpect() {
       cmd->SetComparator(CompareBufferCommand::Comparator::kRmse);
 
       token = tokenizer_->NextToken();
-      if (!token->IsString() && token->AsString() == "TOLERANCE")
+      if (!token.IsString() && token.AsString() == "TOLERANCE")
         return Result("Missing TOLERANCE for EXPECT RMSE_BUFFER");
 
       token = tokenizer_->NextToken();
-      if (!token->IsInteger() && !token->IsDouble())
+      if (!token.IsInteger() && !token.IsDouble())
         return Result("Invalid TOLERANCE for EXPECT RMSE_BUFFER");
 
-      Result r = token->ConvertToDouble();
+      Result r = token.ConvertToDouble();
+      if (!r.IsSuccess())
+        return r;
+
+      cmd->SetTolerance(token.AsFloat());
+    } else if (type == "SSIM_BUFFER" || type == "PSNR_BUFFER") {
+      cmd->SetComparator(type == "SSIM_BUFFER"
+                             ? CompareBufferCommand::Comparator::kSsim
+                             : CompareBufferCommand::Comparator::kPsnr);
+
+      token = tokenizer_->NextToken();
+      if (!token.IsString() || token.AsString() != "THRESHOLD")
+        return Result("missing THRESHOLD for EXPECT " + type);
+
+      token = tokenizer_->NextToken();
+      if (!token.IsInteger() && !token.IsDouble())
+        return Result("invalid THRESHOLD for EXPECT " + type);
+
+      Result r = token.ConvertToDouble();
       if (!r.IsSuccess())
         return r;
 
-      cmd->SetTolerance(token->AsFloat());
+      cmd->SetTolerance(token.AsFloat());
+    } else if (type == "MAX_ERROR_BUFFER") {
+      cmd->SetComparator(CompareBufferCommand::Comparator::kMaxError);
+
+      token = tokenizer_->NextToken();
+      if (!token.IsString() || token.AsString() != "TOLERANCE")
+        return Result("missing TOLERANCE for EXPECT MAX_ERROR_BUFFER");
+
+      // One tolerance for all components, or one for each of R, G, B and A.
+      std::vector<float> tolerances;
+      for (token = tokenizer_->NextToken(); !token.IsEOL() && !token.IsEOS();
+           token = tokenizer_->NextToken()) {
+        if (!token.IsInteger() && !token.IsDouble())
+          return Result("invalid TOLERANCE for EXPECT MAX_ERROR_BUFFER");
+
+        Result r = token.ConvertToDouble();
+        if (!r.IsSuccess())
+          return r;
+        if (token.AsFloat() < 0) {
+          return Result(
+              "TOLERANCE for EXPECT MAX_ERROR_BUFFER must not be negative");
+        }
+        tolerances.push_back(token.AsFloat());
+      }
+      if (tolerances.size() != 1 && tolerances.size() != 4) {
+        return Result(
+            "EXPECT MAX_ERROR_BUFFER requires 1 or 4 TOLERANCE values");
+      }
+      if (tolerances.size() == 1)
+        tolerances.resize(4, tolerances[0]);
+
+      cmd->SetComponentTolerances(tolerances);
+      cmd->SetLine(line);
+      command_list_.push_back(std::move(cmd));
+
+      // The tolerances run to the end of the statement.
+      return {};
     }
 
+    cmd->SetLine(line);
     command_list_.push_back(std::move(cmd));
 
     // Early return
     return ValidateEndOfStatement("EXPECT " + type + " command");
   }
 
-  if (token->AsString() != "IDX")
+  if (token.AsString() == "EQ_FILE" || token.AsString() == "RMSE_FILE") {
+    auto type = token.AsString();
+
+    token = tokenizer_->NextToken();
+    if (!token.IsString())
+      return Result("invalid file path in EXPECT " + type + " command");
+
+    auto cmd = MakeUnique<CompareFileCommand>(buffer, token.AsString());
+    cmd->SetLine(line);
+    if (type == "RMSE_FILE") {
+      cmd->SetComparator(CompareFileCommand::Comparator::kRmse);
+
+      token = tokenizer_->NextToken();
+      if (!token.IsString() || token.AsString() != "TOLERANCE")
+        return Result("missing TOLERANCE for EXPECT RMSE_FILE");
+
+      token = tokenizer_->NextToken();
+      if (!token.IsInteger() && !token.IsDouble())
+        return Result("invalid TOLERANCE for EXPECT RMSE_FILE");
+
+      Result r = token.ConvertToDouble();
+      if (!r.IsSuccess())
+        return r;
+
+      cmd->SetTolerance(token.AsFloat());
+    }
+
+    command_list_.push_back(std::move(cmd));
+    return ValidateEndOfStatement("EXPECT " + type + " command");
+  }
+
+  if (token.AsString() == "HASH") {
+    token = tokenizer_->NextToken();
+    if (!token.IsString())
+      return Result("invalid hash type in EXPECT HASH command");
+
+    HashType hash_type = HashType::kXXH64;
+    if (!NameToHashType(token.AsString(), &hash_type)) {
+      return Result("unknown hash type for EXPECT HASH command: " +
+                    token.AsString());
+    }
+
+    token = tokenizer_->NextToken();
+    if (!token.IsHex() && !token.IsInteger())
+      return Result("invalid hash value in EXPECT HASH command");
+
+    uint64_t hash = token.IsHex() ? token.AsHex() : token.AsUint64();
+    if (hash_type == HashType::kCRC32C && hash > 0xffffffffULL)
+      return Result("crc32c hash value in EXPECT HASH command is too large");
+
+    auto cmd = MakeUnique<HashBufferCommand>(buffer);
+    cmd->SetLine(line);
+    cmd->SetHashType(hash_type);
+    cmd->SetExpectedHash(hash);
+    command_list_.push_back(std::move(cmd));
+
+    return ValidateEndOfStatement("EXPECT HASH command");
+  }
+
+  if (token.AsString() != "IDX")
     return Result("missing IDX in EXPECT command");
 
   token = tokenizer_->NextToken();
-  if (!token->IsInteger() || token->AsInt32() < 0)
+  if (!token.IsInteger() || token.AsInt32() < 0)
     return Result("invalid X value in EXPECT command");
-  token->ConvertToDouble();
-  float x = token->AsFloat();
+  token.ConvertToDouble();
+  float x = token.AsFloat();
 
   bool has_y_val = false;
   float y = 0;
   token = tokenizer_->NextToken();
-  if (token->IsInteger()) {
+  if (token.IsInteger()) {
     has_y_val = true;
 
-    if (token->AsInt32() < 0)
+    if (token.AsInt32() < 0)
       return Result("invalid Y value in EXPECT command");
-    token->ConvertToDouble();
-    y = token->AsFloat();
+    token.ConvertToDouble();
+    y = token.AsFloat();
 
     token = tokenizer_->NextToken();
   }
 
-  if (token->IsString() && token->AsString() == "SIZE") {
+  if (token.IsString() && token.AsString() == "SIZE") {
     if (!has_y_val)
       return Result("invalid Y value in EXPECT command");
 
@@ -1489,78 +1743,90 @@ Result Parser::ParseExpect() {
     probe->SetProbeRect();
 
     token = tokenizer_->NextToken();
-    if (!token->IsInteger() || token->AsInt32() <= 0)
+    if (!token.IsInteger() || token.AsInt32() <= 0)
       return Result("invalid width in EXPECT command");
-    token->ConvertToDouble();
-    probe->SetWidth(token->AsFloat());
+    token.ConvertToDouble();
+    probe->SetWidth(token.AsFloat());
 
     token = tokenizer_->NextToken();
-    if (!token->IsInteger() || token->AsInt32() <= 0)
+    if (!token.IsInteger() || token.AsInt32() <= 0)
       return Result("invalid height in EXPECT command");
-    token->ConvertToDouble();
-    probe->SetHeight(token->AsFloat());
+    token.ConvertToDouble();
+    probe->SetHeight(token.AsFloat());
 
     token = tokenizer_->NextToken();
-    if (!token->IsString()) {
+    if (!token.IsString()) {
       return Result("invalid token in EXPECT command:" +
-                    token->ToOriginalString());
+                    token.ToOriginalString());
     }
 
-    if (token->AsString() == "EQ_RGBA") {
+    if (token.AsString() == "EQ_RGBA") {
       probe->SetIsRGBA();
-    } else if (token->AsString() != "EQ_RGB") {
+    } else if (token.AsString() != "EQ_RGB") {
       return Result("unknown comparator type in EXPECT: " +
-                    token->ToOriginalString());
+                    token.ToOriginalString());
     }
 
     token = tokenizer_->NextToken();
-    if (!token->IsInteger() || token->AsInt32() < 0 || token->AsInt32() > 255)
+    if (!token.IsInteger() || token.AsInt32() < 0 || token.AsInt32() > 255)
       return Result("invalid R value in EXPECT command");
-    token->ConvertToDouble();
-    probe->SetR(token->AsFloat() / 255.f);
+    token.ConvertToDouble();
+    probe->SetR(token.AsFloat() / 255.f);
 
     token = tokenizer_->NextToken();
-    if (!token->IsInteger() || token->AsInt32() < 0 || token->AsInt32() > 255)
+    if (!token.IsInteger() || token.AsInt32() < 0 || token.AsInt32() > 255)
       return Result("invalid G value in EXPECT command");
-    token->ConvertToDouble();
-    probe->SetG(token->AsFloat() / 255.f);
+    token.ConvertToDouble();
+    probe->SetG(token.AsFloat() / 255.f);
 
     token = tokenizer_->NextToken();
-    if (!token->IsInteger() || token->AsInt32() < 0 || token->AsInt32() > 255)
+    if (!token.IsInteger() || token.AsInt32() < 0 || token.AsInt32() > 255)
       return Result("invalid B value in EXPECT command");
-    token->ConvertToDouble();
-    probe->SetB(token->AsFloat() / 255.f);
+    token.ConvertToDouble();
+    probe->SetB(token.AsFloat() / 255.f);
 
     if (probe->IsRGBA()) {
       token = tokenizer_->NextToken();
-      if (!token->IsInteger() || token->AsInt32() < 0 || token->AsInt32() > 255)
+      if (!token.IsInteger() || token.AsInt32() < 0 || token.AsInt32() > 255)
         return Result("invalid A value in EXPECT command");
-      token->ConvertToDouble();
-      probe->SetA(token->AsFloat() / 255.f);
+      token.ConvertToDouble();
+      probe->SetA(token.AsFloat() / 255.f);
     }
 
     command_list_.push_back(std::move(probe));
     return ValidateEndOfStatement("EXPECT command");
   }
 
+  bool has_count = false;
+  uint32_t count = 0;
+  if (token.IsString() && token.AsString() == "COUNT") {
+    token = tokenizer_->NextToken();
+    if (!token.IsInteger() || token.AsInt32() <= 0)
+      return Result("invalid COUNT value in EXPECT command");
+
+    has_count = true;
+    count = token.AsUint32();
+    token = tokenizer_->NextToken();
+  }
+
   auto probe = MakeUnique<ProbeSSBOCommand>(buffer);
   probe->SetLine(line);
 
-  if (token->IsString() && token->AsString() == "TOLERANCE") {
+  if (token.IsString() && token.AsString() == "TOLERANCE") {
     std::vector<Probe::Tolerance> tolerances;
 
     token = tokenizer_->NextToken();
-    while (!token->IsEOL() && !token->IsEOS()) {
-      if (!token->IsInteger() && !token->IsDouble())
+    while (!token.IsEOL() && !token.IsEOS()) {
+      if (!token.IsInteger() && !token.IsDouble())
         break;
 
-      Result r = token->ConvertToDouble();
+      Result r = token.ConvertToDouble();
       if (!r.IsSuccess())
         return r;
 
-      double value = token->AsDouble();
+      double value = token.AsDouble();
       token = tokenizer_->NextToken();
-      if (token->IsString() && token->AsString() == "%") {
+      if (token.IsString() && token.AsString() == "%") {
         tolerances.push_back(Probe::Tolerance{true, value});
         token = tokenizer_->NextToken();
       } else {
@@ -1575,15 +1841,65 @@ Result Parser::ParseExpect() {
     probe->SetTolerances(std::move(tolerances));
   }
 
-  if (!token->IsString() || !IsComparator(token->AsString())) {
+  if (token.IsString() &&
+      (token.AsString() == "EQ_FILL" || token.AsString() == "EQ_SERIES")) {
+    auto type = token.AsString();
+    if (!has_count)
+      return Result("missing COUNT for EXPECT " + type + " command");
+    if (has_y_val)
+      return Result("Y value not needed for non-color comparator");
+
+    probe->SetComparator(probe->HasTolerances()
+                             ? ProbeSSBOCommand::Comparator::kFuzzyEqual
+                             : ProbeSSBOCommand::Comparator::kEqual);
+    probe->SetFormat(buffer->GetFormat());
+    probe->SetOffset(static_cast<uint32_t>(x));
+
+    token = tokenizer_->NextToken();
+    if (token.IsEOL() || token.IsEOS())
+      return Result("missing value for EXPECT " + type + " command");
+
+    Value start;
+    Result r =
+        ParseValue("EXPECT " + type, buffer->GetFormat(), &token, &start);
+    if (!r.IsSuccess())
+      return r;
+
+    if (type == "EQ_FILL") {
+      probe->SetFill(start, count);
+    } else {
+      token = tokenizer_->NextToken();
+      if (!token.IsString() || token.AsString() != "INC_BY")
+        return Result("missing INC_BY for EXPECT EQ_SERIES command");
+
+      token = tokenizer_->NextToken();
+      if (token.IsEOL() || token.IsEOS())
+        return Result("missing INC_BY value for EXPECT EQ_SERIES command");
+
+      Value inc;
+      r = ParseValue("EXPECT EQ_SERIES", buffer->GetFormat(), &token, &inc);
+      if (!r.IsSuccess())
+        return r;
+
+      probe->SetSeries(start, inc, count);
+    }
+
+    command_list_.push_back(std::move(probe));
+    return ValidateEndOfStatement("EXPECT " + type + " command");
+  }
+
+  if (has_count)
+    return Result("COUNT requires EQ_FILL or EQ_SERIES in EXPECT command");
+
+  if (!token.IsString() || !IsComparator(token.AsString())) {
     return Result("unexpected token in EXPECT command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
   }
 
   if (has_y_val)
     return Result("Y value not needed for non-color comparator");
 
-  auto cmp = ToComparator(token->AsString());
+  auto cmp = ToComparator(token.AsString());
   if (probe->HasTolerances()) {
     if (cmp != ProbeSSBOCommand::Comparator::kEqual)
       return Result("TOLERANCE only available with EQ probes");
@@ -1611,14 +1927,14 @@ Result Parser::ParseExpect() {
 
 Result Parser::ParseCopy() {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return Result("missing buffer name after COPY");
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("invalid buffer name after COPY");
 
   size_t line = tokenizer_->GetCurrentLine();
 
-  auto name = token->AsString();
+  auto name = token.AsString();
   if (name == "TO")
     return Result("missing buffer name between COPY and TO");
 
@@ -1627,22 +1943,22 @@ Result Parser::ParseCopy() {
     return Result("COPY origin buffer was not declared");
 
   token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return Result("missing 'TO' after COPY and buffer name");
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("expected 'TO' after COPY and buffer name");
 
-  name = token->AsString();
+  name = token.AsString();
   if (name != "TO")
     return Result("expected 'TO' after COPY and buffer name");
 
   token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return Result("missing buffer name after TO");
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("invalid buffer name after TO");
 
-  name = token->AsString();
+  name = token.AsString();
   Buffer* buffer_to = script_->GetBuffer(name);
   if (!buffer_to)
     return Result("COPY destination buffer was not declared");
@@ -1669,15 +1985,15 @@ Result Parser::ParseCopy() {
 
 Result Parser::ParseClearColor() {
   auto token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("missing pipeline name for CLEAR_COLOR command");
 
   size_t line = tokenizer_->GetCurrentLine();
 
-  auto* pipeline = script_->GetPipeline(token->AsString());
+  auto* pipeline = script_->GetPipeline(token.AsString());
   if (!pipeline) {
     return Result("unknown pipeline for CLEAR_COLOR command: " +
-                  token->AsString());
+                  token.AsString());
   }
   if (!pipeline->IsGraphics()) {
     return Result("CLEAR_COLOR command requires graphics pipeline");
@@ -1687,44 +2003,44 @@ Result Parser::ParseClearColor() {
   cmd->SetLine(line);
 
   token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return Result("missing R value for CLEAR_COLOR command");
-  if (!token->IsInteger() || token->AsInt32() < 0 || token->AsInt32() > 255) {
+  if (!token.IsInteger() || token.AsInt32() < 0 || token.AsInt32() > 255) {
     return Result("invalid R value for CLEAR_COLOR command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
   }
-  token->ConvertToDouble();
-  cmd->SetR(token->AsFloat() / 255.f);
+  token.ConvertToDouble();
+  cmd->SetR(token.AsFloat() / 255.f);
 
   token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return Result("missing G value for CLEAR_COLOR command");
-  if (!token->IsInteger() || token->AsInt32() < 0 || token->AsInt32() > 255) {
+  if (!token.IsInteger() || token.AsInt32() < 0 || token.AsInt32() > 255) {
     return Result("invalid G value for CLEAR_COLOR command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
   }
-  token->ConvertToDouble();
-  cmd->SetG(token->AsFloat() / 255.f);
+  token.ConvertToDouble();
+  cmd->SetG(token.AsFloat() / 255.f);
 
   token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return Result("missing B value for CLEAR_COLOR command");
-  if (!token->IsInteger() || token->AsInt32() < 0 || token->AsInt32() > 255) {
+  if (!token.IsInteger() || token.AsInt32() < 0 || token.AsInt32() > 255) {
     return Result("invalid B value for CLEAR_COLOR command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
   }
-  token->ConvertToDouble();
-  cmd->SetB(token->AsFloat() / 255.f);
+  token.ConvertToDouble();
+  cmd->SetB(token.AsFloat() / 255.f);
 
   token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return Result("missing A value for CLEAR_COLOR command");
-  if (!token->IsInteger() || token->AsInt32() < 0 || token->AsInt32() > 255) {
+  if (!token.IsInteger() || token.AsInt32() < 0 || token.AsInt32() > 255) {
     return Result("invalid A value for CLEAR_COLOR command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
   }
-  token->ConvertToDouble();
-  cmd->SetA(token->AsFloat() / 255.f);
+  token.ConvertToDouble();
+  cmd->SetA(token.AsFloat() / 255.f);
 
   command_list_.push_back(std::move(cmd));
   return ValidateEndOfStatement("CLEAR_COLOR command");
@@ -1732,42 +2048,42 @@ Result Parser::ParseClearColor() {
 
 Result Parser::ParseDeviceFeature() {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOS() || token->IsEOL())
+  if (token.IsEOS() || token.IsEOL())
     return Result("missing feature name for DEVICE_FEATURE command");
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("invalid feature name for DEVICE_FEATURE command");
-  if (!script_->IsKnownFeature(token->AsString()))
+  if (!script_->IsKnownFeature(token.AsString()))
     return Result("unknown feature name for DEVICE_FEATURE command");
 
-  script_->AddRequiredFeature(token->AsString());
+  script_->AddRequiredFeature(token.AsString());
 
   return ValidateEndOfStatement("DEVICE_FEATURE command");
 }
 
 Result Parser::ParseRepeat() {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOL())
+  if (token.IsEOL() || token.IsEOL())
     return Result("missing count parameter for REPEAT command");
-  if (!token->IsInteger()) {
+  if (!token.IsInteger()) {
     return Result("invalid count parameter for REPEAT command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
   }
-  if (token->AsInt32() <= 0)
+  if (token.AsInt32() <= 0)
     return Result("count parameter must be > 0 for REPEAT command");
 
-  uint32_t count = token->AsUint32();
+  uint32_t count = token.AsUint32();
 
   std::vector<std::unique_ptr<Command>> cur_commands;
   std::swap(cur_commands, command_list_);
 
-  for (token = tokenizer_->NextToken(); !token->IsEOS();
+  for (token = tokenizer_->NextToken(); !token.IsEOS();
        token = tokenizer_->NextToken()) {
-    if (token->IsEOL())
+    if (token.IsEOL())
       continue;
-    if (!token->IsString())
+    if (!token.IsString())
       return Result("expected string");
 
-    std::string tok = token->AsString();
+    std::string tok = token.AsString();
     if (tok == "END")
       break;
     if (!IsRepeatable(tok))
@@ -1777,7 +2093,7 @@ Result Parser::ParseRepeat() {
     if (!r.IsSuccess())
       return r;
   }
-  if (!token->IsString() || token->AsString() != "END")
+  if (!token.IsString() || token.AsString() != "END")
     return Result("missing END for REPEAT command");
 
   auto cmd = MakeUnique<RepeatCommand>(count);
@@ -1791,22 +2107,22 @@ Result Parser::ParseRepeat() {
 
 Result Parser::ParseDerivePipelineBlock() {
   auto token = tokenizer_->NextToken();
-  if (!token->IsString() || token->AsString() == "FROM")
+  if (!token.IsString() || token.AsString() == "FROM")
     return Result("missing pipeline name for DERIVE_PIPELINE command");
 
-  std::string name = token->AsString();
+  std::string name = token.AsString();
   if (script_->GetPipeline(name) != nullptr)
     return Result("duplicate pipeline name for DERIVE_PIPELINE command");
 
   token = tokenizer_->NextToken();
-  if (!token->IsString() || token->AsString() != "FROM")
+  if (!token.IsString() || token.AsString() != "FROM")
     return Result("missing FROM in DERIVE_PIPELINE command");
 
   token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("missing parent pipeline name in DERIVE_PIPELINE command");
 
-  Pipeline* parent = script_->GetPipeline(token->AsString());
+  Pipeline* parent = script_->GetPipeline(token.AsString());
   if (!parent)
     return Result("unknown parent pipeline in DERIVE_PIPELINE command");
 
@@ -1822,54 +2138,54 @@ Result Parser::ParseDerivePipelineBlock() {
 
 Result Parser::ParseDeviceExtension() {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return Result("DEVICE_EXTENSION missing name");
-  if (!token->IsString()) {
+  if (!token.IsString()) {
     return Result("DEVICE_EXTENSION invalid name: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
   }
 
-  script_->AddRequiredDeviceExtension(token->AsString());
+  script_->AddRequiredDeviceExtension(token.AsString());
 
   return ValidateEndOfStatement("DEVICE_EXTENSION command");
 }
 
 Result Parser::ParseInstanceExtension() {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return Result("INSTANCE_EXTENSION missing name");
-  if (!token->IsString()) {
+  if (!token.IsString()) {
     return Result("INSTANCE_EXTENSION invalid name: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
   }
 
-  script_->AddRequiredInstanceExtension(token->AsString());
+  script_->AddRequiredInstanceExtension(token.AsString());
 
   return ValidateEndOfStatement("INSTANCE_EXTENSION command");
 }
 
 Result Parser::ParseSet() {
   auto token = tokenizer_->NextToken();
-  if (!token->IsString() || token->AsString() != "ENGINE_DATA")
+  if (!token.IsString() || token.AsString() != "ENGINE_DATA")
     return Result("SET missing ENGINE_DATA");
 
   token = tokenizer_->NextToken();
-  if (token->IsEOS() || token->IsEOL())
+  if (token.IsEOS() || token.IsEOL())
     return Result("SET missing variable to be set");
 
-  if (!token->IsString())
-    return Result("SET invalid variable to set: " + token->ToOriginalString());
+  if (!token.IsString())
+    return Result("SET invalid variable to set: " + token.ToOriginalString());
 
-  if (token->AsString() != "fence_timeout_ms")
-    return Result("SET unknown variable provided: " + token->AsString());
+  if (token.AsString() != "fence_timeout_ms")
+    return Result("SET unknown variable provided: " + token.AsString());
 
   token = tokenizer_->NextToken();
-  if (token->IsEOS() || token->IsEOL())
+  if (token.IsEOS() || token.IsEOL())
     return Result("SET missing value for fence_timeout_ms");
-  if (!token->IsInteger())
+  if (!token.IsInteger())
     return Result("SET invalid value for fence_timeout_ms, must be uint32");
 
-  script_->GetEngineData().fence_timeout_ms = token->AsUint32();
+  script_->GetEngineData().fence_timeout_ms = token.AsUint32();
 
   return ValidateEndOfStatement("SET command");
 }
@@ -26,6 +26,7 @@
 
 namespace amber {
 
+class Token;
 class Tokenizer;
 
 namespace amberscript {
@@ -52,7 +53,10 @@ class Parser : public amber::Parser {
   Result ParseBufferInitializerSize(Buffer*);
   Result ParseBufferInitializerFill(Buffer*, uint32_t);
   Result ParseBufferInitializerSeries(Buffer*, uint32_t);
+  Result ParseBufferInitializerRandom(Buffer*, uint32_t);
   Result ParseBufferInitializerData(Buffer*);
+  Result ParseBufferInitializerEncodedData(Buffer*, const std::string&);
+  Result ParseBufferInitializerFile(Buffer*);
   Result ParseShaderBlock();
   Result ParsePipelineBlock();
   Result ParsePipelineAttach(Pipeline*);
@@ -87,6 +91,12 @@ class Parser : public amber::Parser {
   Result ParseValues(const std::string& name,
                      Format* fmt,
                      std::vector<Value>* values);
+  /// Parses the single value in |token| into |value|, using |fmt| to decide
+  /// between integer and floating point data.
+  Result ParseValue(const std::string& name,
+                    Format* fmt,
+                    Token* token,
+                    Value* value);
 
   std::unique_ptr<Tokenizer> tokenizer_;
   std::vector<std::unique_ptr<Command>> command_list_;
@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdio>
+#include <fstream>
+
 #include "gtest/gtest.h"
 #include "src/amberscript/parser.h"
 
@@ -330,6 +333,60 @@ TEST_F(AmberScriptParserTest, BufferSeries) {
   }
 }
 
+TEST_F(AmberScriptParserTest, BufferRandom) {
+  std::string in = R"(
+BUFFER first DATA_TYPE int32 SIZE 64 RANDOM SEED 7 MIN -3 MAX 5
+BUFFER second DATA_TYPE int32 SIZE 64 RANDOM SEED 7 MIN -3 MAX 5
+BUFFER other_seed DATA_TYPE int32 SIZE 64 RANDOM SEED 8 MIN -3 MAX 5
+BUFFER unit DATA_TYPE vec2<float> SIZE 64 RANDOM SEED 1)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  auto script = parser.GetScript();
+  const auto& buffers = script->GetBuffers();
+  ASSERT_EQ(4U, buffers.size());
+
+  EXPECT_EQ(64U, buffers[0]->ElementCount());
+  EXPECT_TRUE(buffers[0]->IsEqual(buffers[1].get()).IsSuccess());
+  EXPECT_FALSE(buffers[0]->IsEqual(buffers[2].get()).IsSuccess());
+
+  const auto* ints = buffers[0]->GetValues<int32_t>();
+  for (size_t i = 0; i < 64; ++i) {
+    EXPECT_LE(-3, ints[i]);
+    EXPECT_GE(5, ints[i]);
+  }
+
+  EXPECT_EQ(64U, buffers[3]->ElementCount());
+  const auto* floats = buffers[3]->GetValues<float>();
+  for (size_t i = 0; i < 128; ++i) {
+    EXPECT_LE(0.f, floats[i]);
+    EXPECT_GT(1.f, floats[i]);
+  }
+}
+
+TEST_F(AmberScriptParserTest, BufferRandomWithThreads) {
+  // Large enough for the data to be generated on several threads.
+  std::string in = R"(
+BUFFER data DATA_TYPE uint32 SIZE 1048576 RANDOM SEED 3)";
+
+  Parser single;
+  Result r = single.Parse(in);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  Parser threaded;
+  threaded.SetThreadCount(4);
+  r = threaded.Parse(in);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  auto single_script = single.GetScript();
+  auto threaded_script = threaded.GetScript();
+  EXPECT_TRUE(single_script->GetBuffers()[0]
+                  ->IsEqual(threaded_script->GetBuffers()[0].get())
+                  .IsSuccess());
+}
+
 TEST_F(AmberScriptParserTest, BufferSeriesFloat) {
   std::string in =
       "BUFFER my_buffer DATA_TYPE float SIZE 5 SERIES_FROM 2.2 INC_BY "
@@ -547,6 +604,141 @@ END
   }
 }
 
+TEST_F(AmberScriptParserTest, BufferDataBase64) {
+  std::string in = R"(
+BUFFER my_buffer DATA_TYPE uint32 DATA_BASE64
+AQAAAAIAAAD/AAAA
+AAEAAA==
+END)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  auto script = parser.GetScript();
+  const auto& buffers = script->GetBuffers();
+  ASSERT_EQ(1U, buffers.size());
+
+  auto* buffer = buffers[0].get();
+  EXPECT_EQ("my_buffer", buffer->GetName());
+  EXPECT_TRUE(buffer->GetFormat()->IsUint32());
+  EXPECT_EQ(4U, buffer->ElementCount());
+  EXPECT_EQ(4U * sizeof(uint32_t), buffer->GetSizeInBytes());
+
+  std::vector<uint32_t> results = {1, 2, 255, 256};
+  const auto* data = buffer->GetValues<uint32_t>();
+  for (size_t i = 0; i < results.size(); ++i) {
+    EXPECT_EQ(results[i], data[i]);
+  }
+}
+
+TEST_F(AmberScriptParserTest, BufferDataBase64ContainingEnd) {
+  // "END" inside the encoded text must not terminate the data.
+  std::string in = R"(
+BUFFER my_buffer DATA_TYPE uint8 DATA_BASE64
+ENDx
+END)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  auto script = parser.GetScript();
+  const auto& buffers = script->GetBuffers();
+  ASSERT_EQ(1U, buffers.size());
+  EXPECT_EQ(3U, buffers[0]->ElementCount());
+}
+
+TEST_F(AmberScriptParserTest, BufferDataBase64EndInComment) {
+  // Comments are dropped before looking for END, whole lines or trailing.
+  std::string in = R"(
+BUFFER my_buffer DATA_TYPE uint8 DATA_BASE64
+# first chunk, the END marker follows later
+AAEC # END
+  END # of the data
+BUFFER other DATA_TYPE uint8 SIZE 1 FILL 0)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  auto script = parser.GetScript();
+  const auto& buffers = script->GetBuffers();
+  ASSERT_EQ(2U, buffers.size());
+  EXPECT_EQ(3U, buffers[0]->ElementCount());
+  EXPECT_EQ("other", buffers[1]->GetName());
+}
+
+TEST_F(AmberScriptParserTest, BufferDataHexRaw) {
+  std::string in = R"(
+BUFFER my_buffer DATA_TYPE uint16 DATA_HEX_RAW
+0100 0200
+ffff # trailing comment
+END)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  auto script = parser.GetScript();
+  const auto& buffers = script->GetBuffers();
+  ASSERT_EQ(1U, buffers.size());
+
+  auto* buffer = buffers[0].get();
+  EXPECT_TRUE(buffer->GetFormat()->IsUint16());
+  EXPECT_EQ(3U, buffer->ElementCount());
+
+  std::vector<uint16_t> results = {1, 2, 0xffff};
+  const auto* data = buffer->GetValues<uint16_t>();
+  for (size_t i = 0; i < results.size(); ++i) {
+    EXPECT_EQ(results[i], data[i]);
+  }
+}
+
+TEST_F(AmberScriptParserTest, BufferFile) {
+  std::string path = testing::TempDir() + "amber_parser_buffer_file.bin";
+  {
+    std::ofstream out(path, std::ios::out | std::ios::binary);
+    ASSERT_TRUE(out.is_open());
+    uint32_t values[] = {7, 8, 9};
+    out.write(reinterpret_cast<const char*>(values), sizeof(values));
+  }
+
+  std::string in = "BUFFER whole DATA_TYPE uint32 FILE " + path +
+                   "\nBUFFER tail DATA_TYPE uint32 FILE " + path +
+                   " OFFSET 4";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  std::remove(path.c_str());
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  auto script = parser.GetScript();
+  const auto& buffers = script->GetBuffers();
+  ASSERT_EQ(2U, buffers.size());
+
+  ASSERT_EQ(3U, buffers[0]->ElementCount());
+  const auto* whole = buffers[0]->GetValues<uint32_t>();
+  EXPECT_EQ(7U, whole[0]);
+  EXPECT_EQ(8U, whole[1]);
+  EXPECT_EQ(9U, whole[2]);
+
+  ASSERT_EQ(2U, buffers[1]->ElementCount());
+  const auto* tail = buffers[1]->GetValues<uint32_t>();
+  EXPECT_EQ(8U, tail[0]);
+  EXPECT_EQ(9U, tail[1]);
+}
+
+TEST_F(AmberScriptParserTest, BufferFileMissing) {
+  std::string path = testing::TempDir() + "amber_parser_missing_file.bin";
+  std::string in = "BUFFER my_buf DATA_TYPE uint32 FILE " + path;
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("1: BUFFER FILE unable to open file: " + path, r.Error());
+}
+
 TEST_F(AmberScriptParserTest, BufferFormat) {
   std::string in = "BUFFER my_buf FORMAT R32G32B32A32_SINT";
 
@@ -661,7 +853,52 @@ INSTANTIATE_TEST_SUITE_P(
         BufferParseError{"BUFFER my_buf DATA_TYPE int32 SIZE 5 FILL 5\nBUFFER "
                          "my_buf DATA_TYPE int16 SIZE 5 FILL 2",
                          // NOLINTNEXTLINE(whitespace/parens)
-                         "2: duplicate buffer name provided"}));
+                         "2: duplicate buffer name provided"},
+        BufferParseError{"BUFFER my_buf DATA_TYPE uint8 SIZE 5 RANDOM",
+                         "1: missing BUFFER random SEED"},
+        BufferParseError{"BUFFER my_buf DATA_TYPE uint8 SIZE 5 RANDOM SEED",
+                         "1: invalid BUFFER random SEED value"},
+        BufferParseError{
+            "BUFFER my_buf DATA_TYPE uint8 SIZE 5 RANDOM SEED 1 MIN",
+            "1: invalid BUFFER random MIN value"},
+        BufferParseError{
+            "BUFFER my_buf DATA_TYPE uint8 SIZE 5 RANDOM SEED 1 MIN 2",
+            "1: missing BUFFER random MAX"},
+        BufferParseError{
+            "BUFFER my_buf DATA_TYPE uint8 SIZE 5 RANDOM SEED 1 MIN 2 MAX",
+            "1: invalid BUFFER random MAX value"},
+        BufferParseError{
+            "BUFFER my_buf DATA_TYPE int8 SIZE 5 RANDOM SEED 1 MIN 2 MAX -2",
+            "1: BUFFER random MIN must not be greater than MAX"},
+        BufferParseError{
+            "BUFFER my_buf DATA_TYPE uint8 SIZE 5 RANDOM SEED 1 EXTRA",
+            "1: extra parameters after BUFFER random command"},
+        BufferParseError{
+            "BUFFER my_buf DATA_TYPE R16_SFLOAT SIZE 5 RANDOM SEED 1",
+            "1: invalid BUFFER random data: random data is not supported for "
+            "float16 components"},
+        BufferParseError{"BUFFER my_buf DATA_TYPE uint32 DATA_BASE64\nAAEC",
+                         "2: missing BUFFER END command"},
+        BufferParseError{
+            "BUFFER my_buf DATA_TYPE uint32 DATA_BASE64\nAAEC\nEND",
+            "3: invalid BUFFER DATA_BASE64: data size of 3 bytes is not a "
+            "multiple of the element size of 4 bytes"},
+        BufferParseError{
+            "BUFFER my_buf DATA_TYPE uint8 DATA_BASE64\nAA*C\nEND",
+            "3: invalid BUFFER DATA_BASE64: invalid base64 character: *"},
+        BufferParseError{
+            "BUFFER my_buf DATA_TYPE uint8 DATA_HEX_RAW\n0g\nEND",
+            "3: invalid BUFFER DATA_HEX_RAW: invalid hex byte: 0g"},
+        BufferParseError{
+            "BUFFER my_buf DATA_TYPE uint8 DATA_HEX_RAW\n00\nEND EXTRA",
+            "3: extra parameters after BUFFER DATA_HEX_RAW command"},
+        BufferParseError{"BUFFER my_buf DATA_TYPE uint8 FILE",
+                         "1: invalid BUFFER FILE path"},
+        BufferParseError{"BUFFER my_buf DATA_TYPE uint8 FILE a.bin OFFSET",
+                         "1: invalid BUFFER FILE OFFSET"},
+        BufferParseError{"BUFFER my_buf DATA_TYPE uint8 FILE a.bin EXTRA",
+                         // NOLINTNEXTLINE(whitespace/parens)
+                         "1: extra parameters after BUFFER FILE command"}));
 
 struct BufferData {
   const char* name;
@@ -1071,5 +1071,473 @@ EXPECT buf_1 RMSE_BUFFER buf_2)";
       r.Error());
 }
 
+TEST_F(AmberScriptParserTest, ExpectSSIMAndPSNRBuffer) {
+  std::string in = R"(
+BUFFER buf_1 FORMAT R8G8B8A8_UNORM
+BUFFER buf_2 FORMAT R8G8B8A8_UNORM
+EXPECT buf_1 SSIM_BUFFER buf_2 THRESHOLD 0.95
+EXPECT buf_1 PSNR_BUFFER buf_2 THRESHOLD 40)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  auto script = parser.GetScript();
+  const auto& commands = script->GetCommands();
+  ASSERT_EQ(2U, commands.size());
+
+  ASSERT_TRUE(commands[0]->IsCompareBuffer());
+  auto* cmp = commands[0]->AsCompareBuffer();
+  EXPECT_EQ(cmp->GetComparator(), CompareBufferCommand::Comparator::kSsim);
+  EXPECT_FLOAT_EQ(cmp->GetTolerance(), 0.95f);
+  EXPECT_EQ(4U, cmp->GetLine());
+
+  ASSERT_TRUE(commands[1]->IsCompareBuffer());
+  cmp = commands[1]->AsCompareBuffer();
+  EXPECT_EQ(cmp->GetComparator(), CompareBufferCommand::Comparator::kPsnr);
+  EXPECT_FLOAT_EQ(cmp->GetTolerance(), 40.0f);
+  EXPECT_EQ(5U, cmp->GetLine());
+}
+
+TEST_F(AmberScriptParserTest, ExpectSSIMBufferMissingFirstBuffer) {
+  std::string in = R"(
+BUFFER buf_2 FORMAT R8G8B8A8_UNORM
+EXPECT SSIM_BUFFER buf_2 THRESHOLD 0.9)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("3: missing buffer name between EXPECT and SSIM_BUFFER", r.Error());
+}
+
+TEST_F(AmberScriptParserTest, ExpectSSIMBufferMissingThreshold) {
+  std::string in = R"(
+BUFFER buf_1 FORMAT R8G8B8A8_UNORM
+BUFFER buf_2 FORMAT R8G8B8A8_UNORM
+EXPECT buf_1 SSIM_BUFFER buf_2)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("4: missing THRESHOLD for EXPECT SSIM_BUFFER", r.Error());
+}
+
+TEST_F(AmberScriptParserTest, ExpectPSNRBufferInvalidThreshold) {
+  std::string in = R"(
+BUFFER buf_1 FORMAT R8G8B8A8_UNORM
+BUFFER buf_2 FORMAT R8G8B8A8_UNORM
+EXPECT buf_1 PSNR_BUFFER buf_2 THRESHOLD high)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("4: invalid THRESHOLD for EXPECT PSNR_BUFFER", r.Error());
+}
+
+TEST_F(AmberScriptParserTest, ExpectMaxErrorBuffer) {
+  std::string in = R"(
+BUFFER buf_1 FORMAT R8G8B8A8_UNORM
+BUFFER buf_2 FORMAT R8G8B8A8_UNORM
+EXPECT buf_1 MAX_ERROR_BUFFER buf_2 TOLERANCE 0.01
+EXPECT buf_1 MAX_ERROR_BUFFER buf_2 TOLERANCE 0.01 0.02 0.03 1)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  auto script = parser.GetScript();
+  const auto& commands = script->GetCommands();
+  ASSERT_EQ(2U, commands.size());
+
+  ASSERT_TRUE(commands[0]->IsCompareBuffer());
+  auto* cmp = commands[0]->AsCompareBuffer();
+  EXPECT_EQ(cmp->GetComparator(), CompareBufferCommand::Comparator::kMaxError);
+  EXPECT_EQ(std::vector<float>({0.01f, 0.01f, 0.01f, 0.01f}),
+            cmp->GetComponentTolerances());
+
+  ASSERT_TRUE(commands[1]->IsCompareBuffer());
+  cmp = commands[1]->AsCompareBuffer();
+  EXPECT_EQ(cmp->GetComparator(), CompareBufferCommand::Comparator::kMaxError);
+  EXPECT_EQ(std::vector<float>({0.01f, 0.02f, 0.03f, 1.0f}),
+            cmp->GetComponentTolerances());
+  EXPECT_EQ(5U, cmp->GetLine());
+}
+
+TEST_F(AmberScriptParserTest, ExpectMaxErrorBufferInvalidToleranceCount) {
+  std::string in = R"(
+BUFFER buf_1 FORMAT R8G8B8A8_UNORM
+BUFFER buf_2 FORMAT R8G8B8A8_UNORM
+EXPECT buf_1 MAX_ERROR_BUFFER buf_2 TOLERANCE 0.1 0.2)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("4: EXPECT MAX_ERROR_BUFFER requires 1 or 4 TOLERANCE values",
+            r.Error());
+}
+
+TEST_F(AmberScriptParserTest, ExpectMaxErrorBufferNegativeTolerance) {
+  std::string in = R"(
+BUFFER buf_1 FORMAT R8G8B8A8_UNORM
+BUFFER buf_2 FORMAT R8G8B8A8_UNORM
+EXPECT buf_1 MAX_ERROR_BUFFER buf_2 TOLERANCE -0.1)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("4: TOLERANCE for EXPECT MAX_ERROR_BUFFER must not be negative",
+            r.Error());
+}
+
+TEST_F(AmberScriptParserTest, ExpectHash) {
+  std::string in = R"(
+BUFFER buf DATA_TYPE int32 SIZE 10 FILL 11
+EXPECT buf HASH xxh64 0x0123456789abcdef
+EXPECT buf HASH crc32c 0xe3069283)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  auto script = parser.GetScript();
+  const auto& commands = script->GetCommands();
+  ASSERT_EQ(2U, commands.size());
+
+  ASSERT_TRUE(commands[0]->IsHashBuffer());
+  auto* cmd = commands[0]->AsHashBuffer();
+  ASSERT_TRUE(cmd->GetBuffer() != nullptr);
+  EXPECT_EQ("buf", cmd->GetBuffer()->GetName());
+  EXPECT_EQ(HashType::kXXH64, cmd->GetHashType());
+  EXPECT_EQ(0x0123456789abcdefULL, cmd->GetExpectedHash());
+  EXPECT_EQ(3U, cmd->GetLine());
+
+  ASSERT_TRUE(commands[1]->IsHashBuffer());
+  cmd = commands[1]->AsHashBuffer();
+  EXPECT_EQ(HashType::kCRC32C, cmd->GetHashType());
+  EXPECT_EQ(0xe3069283ULL, cmd->GetExpectedHash());
+  EXPECT_EQ(4U, cmd->GetLine());
+}
+
+TEST_F(AmberScriptParserTest, ExpectHashMissingBuffer) {
+  std::string in = R"(EXPECT HASH xxh64 0x1234)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("1: missing buffer name between EXPECT and HASH", r.Error());
+}
+
+TEST_F(AmberScriptParserTest, ExpectHashInvalidType) {
+  std::string in = R"(
+BUFFER buf DATA_TYPE int32 SIZE 10 FILL 11
+EXPECT buf HASH 1234)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("3: invalid hash type in EXPECT HASH command", r.Error());
+}
+
+TEST_F(AmberScriptParserTest, ExpectHashUnknownType) {
+  std::string in = R"(
+BUFFER buf DATA_TYPE int32 SIZE 10 FILL 11
+EXPECT buf HASH md5 0x1234)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("3: unknown hash type for EXPECT HASH command: md5", r.Error());
+}
+
+TEST_F(AmberScriptParserTest, ExpectHashMissingValue) {
+  std::string in = R"(
+BUFFER buf DATA_TYPE int32 SIZE 10 FILL 11
+EXPECT buf HASH xxh64)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("3: invalid hash value in EXPECT HASH command", r.Error());
+}
+
+TEST_F(AmberScriptParserTest, ExpectHashCRC32CTooLarge) {
+  std::string in = R"(
+BUFFER buf DATA_TYPE int32 SIZE 10 FILL 11
+EXPECT buf HASH crc32c 0x123456789)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("3: crc32c hash value in EXPECT HASH command is too large",
+            r.Error());
+}
+
+TEST_F(AmberScriptParserTest, ExpectHashExtraParameters) {
+  std::string in = R"(
+BUFFER buf DATA_TYPE int32 SIZE 10 FILL 11
+EXPECT buf HASH xxh64 0x1234 EXTRA)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("3: extra parameters after EXPECT HASH command", r.Error());
+}
+
+
+TEST_F(AmberScriptParserTest, ExpectEqFile) {
+  std::string in = R"(
+BUFFER buf DATA_TYPE int32 SIZE 10 FILL 11
+EXPECT buf EQ_FILE golden/buf.bin)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  auto script = parser.GetScript();
+  const auto& commands = script->GetCommands();
+  ASSERT_EQ(1U, commands.size());
+
+  ASSERT_TRUE(commands[0]->IsCompareFile());
+  auto* cmd = commands[0]->AsCompareFile();
+  ASSERT_TRUE(cmd->GetBuffer() != nullptr);
+  EXPECT_EQ("buf", cmd->GetBuffer()->GetName());
+  EXPECT_EQ("golden/buf.bin", cmd->GetPath());
+  EXPECT_EQ(CompareFileCommand::Comparator::kEq, cmd->GetComparator());
+  EXPECT_EQ(3U, cmd->GetLine());
+}
+
+TEST_F(AmberScriptParserTest, ExpectRMSEFile) {
+  std::string in = R"(
+BUFFER buf DATA_TYPE float SIZE 10 FILL 1.5
+EXPECT buf RMSE_FILE golden/buf.bin TOLERANCE 0.25)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  auto script = parser.GetScript();
+  const auto& commands = script->GetCommands();
+  ASSERT_EQ(1U, commands.size());
+
+  ASSERT_TRUE(commands[0]->IsCompareFile());
+  auto* cmd = commands[0]->AsCompareFile();
+  EXPECT_EQ("golden/buf.bin", cmd->GetPath());
+  EXPECT_EQ(CompareFileCommand::Comparator::kRmse, cmd->GetComparator());
+  EXPECT_FLOAT_EQ(0.25f, cmd->GetTolerance());
+}
+
+TEST_F(AmberScriptParserTest, ExpectEqFileMissingBuffer) {
+  std::string in = R"(EXPECT EQ_FILE golden/buf.bin)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("1: missing buffer name between EXPECT and EQ_FILE", r.Error());
+}
+
+TEST_F(AmberScriptParserTest, ExpectEqFileMissingPath) {
+  std::string in = R"(
+BUFFER buf DATA_TYPE int32 SIZE 10 FILL 11
+EXPECT buf EQ_FILE)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("3: invalid file path in EXPECT EQ_FILE command", r.Error());
+}
+
+TEST_F(AmberScriptParserTest, ExpectEqFileExtraParameters) {
+  std::string in = R"(
+BUFFER buf DATA_TYPE int32 SIZE 10 FILL 11
+EXPECT buf EQ_FILE golden/buf.bin EXTRA)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("3: extra parameters after EXPECT EQ_FILE command", r.Error());
+}
+
+TEST_F(AmberScriptParserTest, ExpectRMSEFileMissingTolerance) {
+  std::string in = R"(
+BUFFER buf DATA_TYPE float SIZE 10 FILL 1.5
+EXPECT buf RMSE_FILE golden/buf.bin)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("3: missing TOLERANCE for EXPECT RMSE_FILE", r.Error());
+}
+
+TEST_F(AmberScriptParserTest, ExpectRMSEFileInvalidTolerance) {
+  std::string in = R"(
+BUFFER buf DATA_TYPE float SIZE 10 FILL 1.5
+EXPECT buf RMSE_FILE golden/buf.bin TOLERANCE abc)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("3: invalid TOLERANCE for EXPECT RMSE_FILE", r.Error());
+}
+
+
+TEST_F(AmberScriptParserTest, ExpectEqFill) {
+  std::string in = R"(
+BUFFER orig_buf DATA_TYPE int32 SIZE 100 FILL 11
+EXPECT orig_buf IDX 8 COUNT 92 EQ_FILL 11)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  auto script = parser.GetScript();
+  const auto& commands = script->GetCommands();
+  ASSERT_EQ(1U, commands.size());
+
+  auto* cmd = commands[0].get();
+  ASSERT_TRUE(cmd->IsProbeSSBO());
+
+  auto* probe = cmd->AsProbeSSBO();
+  EXPECT_EQ(ProbeSSBOCommand::Comparator::kEqual, probe->GetComparator());
+  EXPECT_EQ(ProbeSSBOCommand::ValueSource::kFill, probe->GetValueSource());
+  EXPECT_EQ(8U, probe->GetOffset());
+  EXPECT_EQ(92U, probe->GetValueCount());
+  EXPECT_TRUE(probe->GetValues().empty());
+  EXPECT_TRUE(probe->GetSeriesStart().IsInteger());
+  EXPECT_EQ(11, probe->GetSeriesStart().AsInt32());
+  EXPECT_EQ(11, probe->GetExpectedValue(91).AsInt32());
+}
+
+TEST_F(AmberScriptParserTest, ExpectEqSeries) {
+  std::string in = R"(
+BUFFER orig_buf DATA_TYPE int32 SIZE 100 SERIES_FROM 10 INC_BY -2
+EXPECT orig_buf IDX 0 COUNT 100 EQ_SERIES 10 INC_BY -2)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  auto script = parser.GetScript();
+  const auto& commands = script->GetCommands();
+  ASSERT_EQ(1U, commands.size());
+
+  auto* probe = commands[0]->AsProbeSSBO();
+  EXPECT_EQ(ProbeSSBOCommand::ValueSource::kSeries, probe->GetValueSource());
+  EXPECT_EQ(100U, probe->GetValueCount());
+  EXPECT_EQ(10, probe->GetExpectedValue(0).AsInt32());
+  EXPECT_EQ(-188, probe->GetExpectedValue(99).AsInt32());
+}
+
+TEST_F(AmberScriptParserTest, ExpectEqSeriesWithTolerance) {
+  std::string in = R"(
+BUFFER orig_buf DATA_TYPE float SIZE 100 SERIES_FROM 0.5 INC_BY 0.25
+EXPECT orig_buf IDX 0 COUNT 100 TOLERANCE 1% EQ_SERIES 0.5 INC_BY 0.25)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  auto script = parser.GetScript();
+  const auto& commands = script->GetCommands();
+  ASSERT_EQ(1U, commands.size());
+
+  auto* probe = commands[0]->AsProbeSSBO();
+  EXPECT_EQ(ProbeSSBOCommand::Comparator::kFuzzyEqual, probe->GetComparator());
+  ASSERT_TRUE(probe->HasTolerances());
+  EXPECT_TRUE(probe->GetTolerances()[0].is_percent);
+  EXPECT_DOUBLE_EQ(1.0, probe->GetTolerances()[0].value);
+  EXPECT_FALSE(probe->GetSeriesStart().IsInteger());
+  EXPECT_DOUBLE_EQ(1.0, probe->GetExpectedValue(2).AsDouble());
+}
+
+TEST_F(AmberScriptParserTest, ExpectEqFillMissingCount) {
+  std::string in = R"(
+BUFFER orig_buf DATA_TYPE int32 SIZE 100 FILL 11
+EXPECT orig_buf IDX 0 EQ_FILL 11)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("3: missing COUNT for EXPECT EQ_FILL command", r.Error());
+}
+
+TEST_F(AmberScriptParserTest, ExpectInvalidCount) {
+  std::string in = R"(
+BUFFER orig_buf DATA_TYPE int32 SIZE 100 FILL 11
+EXPECT orig_buf IDX 0 COUNT 0 EQ_FILL 11)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("3: invalid COUNT value in EXPECT command", r.Error());
+}
+
+TEST_F(AmberScriptParserTest, ExpectCountWithEq) {
+  std::string in = R"(
+BUFFER orig_buf DATA_TYPE int32 SIZE 100 FILL 11
+EXPECT orig_buf IDX 0 COUNT 2 EQ 11 11)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("3: COUNT requires EQ_FILL or EQ_SERIES in EXPECT command",
+            r.Error());
+}
+
+TEST_F(AmberScriptParserTest, ExpectEqFillMissingValue) {
+  std::string in = R"(
+BUFFER orig_buf DATA_TYPE int32 SIZE 100 FILL 11
+EXPECT orig_buf IDX 0 COUNT 2 EQ_FILL)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("3: missing value for EXPECT EQ_FILL command", r.Error());
+}
+
+TEST_F(AmberScriptParserTest, ExpectEqFillInvalidValue) {
+  std::string in = R"(
+BUFFER orig_buf DATA_TYPE int32 SIZE 100 FILL 11
+EXPECT orig_buf IDX 0 COUNT 2 EQ_FILL 1.5)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("3: Invalid value provided to EXPECT EQ_FILL command: 1.5",
+            r.Error());
+}
+
+TEST_F(AmberScriptParserTest, ExpectEqSeriesMissingIncBy) {
+  std::string in = R"(
+BUFFER orig_buf DATA_TYPE int32 SIZE 100 FILL 11
+EXPECT orig_buf IDX 0 COUNT 2 EQ_SERIES 1)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("3: missing INC_BY for EXPECT EQ_SERIES command", r.Error());
+}
+
+TEST_F(AmberScriptParserTest, ExpectEqSeriesMissingIncByValue) {
+  std::string in = R"(
+BUFFER orig_buf DATA_TYPE int32 SIZE 100 FILL 11
+EXPECT orig_buf IDX 0 COUNT 2 EQ_SERIES 1 INC_BY)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("3: missing INC_BY value for EXPECT EQ_SERIES command", r.Error());
+}
+
+TEST_F(AmberScriptParserTest, ExpectEqSeriesExtraParameters) {
+  std::string in = R"(
+BUFFER orig_buf DATA_TYPE int32 SIZE 100 FILL 11
+EXPECT orig_buf IDX 0 COUNT 2 EQ_SERIES 1 INC_BY 1 2)";
+
+  Parser parser;
+  Result r = parser.Parse(in);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("3: extra parameters after EXPECT EQ_SERIES command", r.Error());
+}
+
 }  // namespace amberscript
 }  // namespace amber
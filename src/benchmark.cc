@@ -0,0 +1,222 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/benchmark.h"
+
+#include <iomanip>
+#include <thread>
+#include <utility>
+
+namespace amber {
+namespace benchmark {
+namespace {
+
+struct Report {
+  std::string name;
+  uint64_t iterations = 0;
+  double real_ns = 0.0;
+  double cpu_ns = 0.0;
+  double items_per_second = 0.0;
+  double bytes_per_second = 0.0;
+  std::string error;
+};
+
+std::string EscapeJson(const std::string& str) {
+  std::string ret;
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      ret += '\\';
+      ret += c;
+    } else if (c == '\n') {
+      ret += "\\n";
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      ret += ' ';
+    } else {
+      ret += c;
+    }
+  }
+  return ret;
+}
+
+void WriteJson(std::ostream* out, const std::vector<Report>& reports) {
+  *out << "{\n  \"context\": {\n";
+  *out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+  *out << "    \"library_build_type\": \"release\"\n";
+#else
+  *out << "    \"library_build_type\": \"debug\"\n";
+#endif
+  *out << "  },\n  \"benchmarks\": [";
+
+  *out << std::fixed << std::setprecision(3);
+  for (size_t i = 0; i < reports.size(); ++i) {
+    const Report& report = reports[i];
+    const std::string name = EscapeJson(report.name);
+    *out << (i == 0 ? "" : ",") << "\n    {\n";
+    *out << "      \"name\": \"" << name << "\",\n";
+    *out << "      \"run_name\": \"" << name << "\",\n";
+    *out << "      \"run_type\": \"iteration\",\n";
+    *out << "      \"iterations\": " << report.iterations << ",\n";
+    *out << "      \"real_time\": " << report.real_ns << ",\n";
+    *out << "      \"cpu_time\": " << report.cpu_ns << ",\n";
+    *out << "      \"time_unit\": \"ns\"";
+    if (report.bytes_per_second > 0.0)
+      *out << ",\n      \"bytes_per_second\": " << report.bytes_per_second;
+    if (report.items_per_second > 0.0)
+      *out << ",\n      \"items_per_second\": " << report.items_per_second;
+    if (!report.error.empty()) {
+      *out << ",\n      \"error_occurred\": true";
+      *out << ",\n      \"error_message\": \"" << EscapeJson(report.error)
+           << "\"";
+    }
+    *out << "\n    }";
+  }
+  *out << "\n  ]\n}\n";
+}
+
+void WriteTextHeader(std::ostream* out) {
+  *out << std::left << std::setw(40) << "Benchmark" << std::right
+       << std::setw(12) << "Iterations" << std::setw(16) << "Time (ns)"
+       << std::setw(16) << "Items/s" << std::setw(12) << "MB/s" << "\n";
+}
+
+void WriteText(std::ostream* out, const Report& report) {
+  *out << std::left << std::setw(40) << report.name << std::right;
+  if (!report.error.empty()) {
+    *out << "ERROR: " << report.error << "\n";
+    return;
+  }
+  *out << std::fixed << std::setw(12) << report.iterations << std::setw(16)
+       << std::setprecision(1) << report.real_ns << std::setw(16)
+       << std::setprecision(0) << report.items_per_second << std::setw(12)
+       << std::setprecision(2) << report.bytes_per_second / (1024.0 * 1024.0)
+       << "\n";
+}
+
+}  // namespace
+
+State::State(double min_time, uint64_t iterations)
+    : min_time_(min_time), max_iterations_(iterations) {}
+
+State::~State() = default;
+
+bool State::KeepRunning() {
+  auto now = std::chrono::steady_clock::now();
+  std::clock_t cpu_now = std::clock();
+  if (!started_) {
+    started_ = true;
+    start_ = now;
+    cpu_start_ = cpu_now;
+    return !has_error_;
+  }
+
+  ++iterations_;
+  elapsed_ = now - start_;
+  cpu_elapsed_ = cpu_now - cpu_start_;
+  if (has_error_)
+    return false;
+  if (max_iterations_ > 0)
+    return iterations_ < max_iterations_;
+  return GetSeconds() < min_time_;
+}
+
+void State::SetError(const Result& result) {
+  if (has_error_)
+    return;
+
+  has_error_ = true;
+  error_ = result.Error();
+}
+
+double State::GetSeconds() const {
+  return std::chrono::duration<double>(elapsed_).count();
+}
+
+double State::GetCpuSeconds() const {
+  return static_cast<double>(cpu_elapsed_) /
+         static_cast<double>(CLOCKS_PER_SEC);
+}
+
+Runner::Runner() = default;
+
+Runner::~Runner() = default;
+
+void Runner::Add(const std::string& name, std::function<void(State*)> fn) {
+  entries_.push_back({name, std::move(fn)});
+}
+
+bool Runner::Matches(const Entry& entry) const {
+  return filter_.empty() || entry.name.find(filter_) != std::string::npos;
+}
+
+void Runner::List(std::ostream* out) const {
+  for (const auto& entry : entries_) {
+    if (Matches(entry))
+      *out << entry.name << "\n";
+  }
+}
+
+Result Runner::Run(std::ostream* out) {
+  Result result;
+  std::vector<Report> reports;
+  if (!json_output_)
+    WriteTextHeader(out);
+
+  for (const auto& entry : entries_) {
+    if (!Matches(entry))
+      continue;
+
+    State state(min_time_, iterations_);
+    entry.fn(&state);
+
+    Report report;
+    report.name = entry.name;
+    report.iterations = state.GetIterations();
+    if (state.HasError()) {
+      report.error = state.GetError();
+      if (result.IsSuccess())
+        result = Result(entry.name + ": " + report.error);
+    } else if (report.iterations == 0) {
+      report.error = "benchmark did not run any iterations";
+      if (result.IsSuccess())
+        result = Result(entry.name + ": " + report.error);
+    } else {
+      double iterations = static_cast<double>(report.iterations);
+      double seconds = state.GetSeconds();
+      report.real_ns = seconds * 1e9 / iterations;
+      report.cpu_ns = state.GetCpuSeconds() * 1e9 / iterations;
+      if (seconds > 0.0) {
+        report.items_per_second =
+            static_cast<double>(state.GetItemsPerIteration()) * iterations /
+            seconds;
+        report.bytes_per_second =
+            static_cast<double>(state.GetBytesPerIteration()) * iterations /
+            seconds;
+      }
+    }
+
+    if (json_output_)
+      reports.push_back(std::move(report));
+    else
+      WriteText(out, report);
+  }
+
+  if (json_output_)
+    WriteJson(out, reports);
+
+  return result;
+}
+
+}  // namespace benchmark
+}  // namespace amber
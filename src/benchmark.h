@@ -0,0 +1,141 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_BENCHMARK_H_
+#define SRC_BENCHMARK_H_
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "amber/result.h"
+
+namespace amber {
+namespace benchmark {
+
+/// The timing state of a single benchmark. The benchmark does its setup, then
+/// runs the code being measured in a `while (state->KeepRunning())` loop.
+/// Only the time spent inside the loop is measured.
+class State {
+ public:
+  /// Runs until |min_time| seconds have passed, or exactly |iterations|
+  /// times if |iterations| is non-zero.
+  State(double min_time, uint64_t iterations);
+  ~State();
+
+  /// Returns true if the benchmark should run another iteration.
+  bool KeepRunning();
+
+  /// Sets the number of items, or bytes, handled by a single iteration. They
+  /// are used to report the throughput of the benchmark.
+  void SetItemsPerIteration(uint64_t items) { items_per_iteration_ = items; }
+  void SetBytesPerIteration(uint64_t bytes) { bytes_per_iteration_ = bytes; }
+
+  /// Marks the benchmark as failed with |result|. The benchmark stops at the
+  /// next call to KeepRunning().
+  void SetError(const Result& result);
+
+  uint64_t GetIterations() const { return iterations_; }
+  /// Returns the wall clock and processor time spent in the loop.
+  double GetSeconds() const;
+  double GetCpuSeconds() const;
+  uint64_t GetItemsPerIteration() const { return items_per_iteration_; }
+  uint64_t GetBytesPerIteration() const { return bytes_per_iteration_; }
+  bool HasError() const { return has_error_; }
+  const std::string& GetError() const { return error_; }
+
+ private:
+  double min_time_ = 0.0;
+  uint64_t max_iterations_ = 0;
+  uint64_t iterations_ = 0;
+  uint64_t items_per_iteration_ = 0;
+  uint64_t bytes_per_iteration_ = 0;
+  bool started_ = false;
+  bool has_error_ = false;
+  std::string error_;
+  std::chrono::steady_clock::time_point start_;
+  std::chrono::steady_clock::duration elapsed_{};
+  std::clock_t cpu_start_ = 0;
+  std::clock_t cpu_elapsed_ = 0;
+};
+
+/// Runs a set of named benchmarks and reports the results.
+class Runner {
+ public:
+  Runner();
+  ~Runner();
+
+  /// Adds the benchmark |fn| called |name|.
+  void Add(const std::string& name, std::function<void(State*)> fn);
+
+  /// Only run benchmarks whose name contains |filter|.
+  void SetFilter(const std::string& filter) { filter_ = filter; }
+  /// Sets the minimum number of seconds each benchmark runs for.
+  void SetMinTime(double seconds) { min_time_ = seconds; }
+  /// Runs each benchmark exactly |iterations| times instead of for a minimum
+  /// time. Zero restores the time based behaviour.
+  void SetIterations(uint64_t iterations) { iterations_ = iterations; }
+  /// Output JSON in the format written by Google Benchmark instead of a
+  /// text table, so existing tooling can compare runs.
+  void SetJsonOutput(bool json) { json_output_ = json; }
+
+  /// Prints the names of the benchmarks matching the filter to |out|.
+  void List(std::ostream* out) const;
+
+  /// Runs the matching benchmarks and writes the results to |out|. Returns
+  /// the first benchmark failure, or success if all of them ran.
+  Result Run(std::ostream* out);
+
+ private:
+  struct Entry {
+    std::string name;
+    std::function<void(State*)> fn;
+  };
+
+  bool Matches(const Entry& entry) const;
+
+  std::vector<Entry> entries_;
+  std::string filter_;
+  double min_time_ = 0.5;
+  uint64_t iterations_ = 0;
+  bool json_output_ = false;
+};
+
+/// Prevents the compiler from optimizing away the computation of |value|.
+template <typename T>
+void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "g"(&value) : "memory");
+#else
+  static const void* volatile sink;
+  sink = &value;
+#endif
+}
+
+/// Add the benchmarks of each area to |runner|. They are defined in the
+/// matching *_benchmark.cc files.
+void AddBufferBenchmarks(Runner* runner);
+void AddFormatBenchmarks(Runner* runner);
+void AddParserBenchmarks(Runner* runner);
+void AddTokenizerBenchmarks(Runner* runner);
+void AddVerifierBenchmarks(Runner* runner);
+
+}  // namespace benchmark
+}  // namespace amber
+
+#endif  // SRC_BENCHMARK_H_
@@ -0,0 +1,173 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/benchmark_data.h"
+
+#include <cstdio>
+
+namespace amber {
+namespace benchmark {
+namespace {
+
+const char kComputeShader[] = R"(#version 430
+layout(set = 0, binding = 0) buffer block {
+  vec4 data[];
+};
+
+void main() {
+  data[gl_GlobalInvocationID.x] *= 2.0;
+}
+)";
+
+const char kFragmentShader[] = R"(#version 430
+layout(location = 0) in vec4 frag_color;
+layout(location = 0) out vec4 final_color;
+
+void main() {
+  final_color = frag_color;
+}
+)";
+
+// A xorshift generator, so the generated data is the same on every platform.
+class Random {
+ public:
+  explicit Random(uint32_t seed) : state_(seed == 0 ? 1U : seed) {}
+
+  uint32_t Next() {
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 17;
+    state_ ^= state_ << 5;
+    return state_;
+  }
+
+  /// Returns a value in [0, 1) with two decimal places, so it survives a
+  /// round trip through text unchanged.
+  double NextUnit() { return static_cast<double>(Next() % 100) / 100.0; }
+
+ private:
+  uint32_t state_;
+};
+
+void AppendValue(std::string* str, double value) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), " %.2f", value);
+  *str += buf;
+}
+
+}  // namespace
+
+std::string GenerateAmberScript(uint32_t buffer_count,
+                                uint32_t values_per_buffer) {
+  Random random(buffer_count * 31U + values_per_buffer);
+  std::string script = "#!amber\n\nSHADER compute compute_shader GLSL\n";
+  script += kComputeShader;
+  script += "END\n\n";
+
+  std::vector<std::string> expects;
+  for (uint32_t i = 0; i < buffer_count; ++i) {
+    std::string name = "buf" + std::to_string(i);
+    // The DATA block is split over lines, the EXPECT must be a single line.
+    std::string data;
+    std::string values;
+    for (uint32_t v = 0; v < values_per_buffer * 4; ++v) {
+      double value = random.NextUnit();
+      AppendValue(&data, value);
+      AppendValue(&values, value);
+      if (v % 16 == 15)
+        data += "\n";
+    }
+    script += "BUFFER " + name + " DATA_TYPE vec4<float> DATA\n" + data +
+              "\nEND\n";
+    expects.push_back("EXPECT " + name + " IDX 0 TOLERANCE 0.01 EQ" + values +
+                      "\n");
+  }
+
+  script += "\nPIPELINE compute pipeline\n  ATTACH compute_shader\n";
+  for (uint32_t i = 0; i < buffer_count; ++i) {
+    script += "  BIND BUFFER buf" + std::to_string(i) +
+              " AS storage DESCRIPTOR_SET 0 BINDING " + std::to_string(i) +
+              "\n";
+  }
+  script += "END\n\nRUN pipeline " + std::to_string(values_per_buffer) +
+            " 1 1\n\n";
+  for (const auto& expect : expects)
+    script += expect;
+
+  return script;
+}
+
+std::string GenerateVkScript(uint32_t vertex_count, uint32_t command_count) {
+  Random random(vertex_count * 31U + command_count);
+  std::string script = "[vertex shader passthrough]\n\n[fragment shader]\n";
+  script += kFragmentShader;
+
+  script += "\n[vertex data]\n0/R32G32_SFLOAT 1/R8G8B8A8_UNORM\n";
+  for (uint32_t i = 0; i < vertex_count; ++i) {
+    AppendValue(&script, random.NextUnit() * 2.0 - 1.0);
+    AppendValue(&script, random.NextUnit() * 2.0 - 1.0);
+    for (uint32_t c = 0; c < 4; ++c)
+      script += " " + std::to_string(random.Next() % 256);
+    script += "\n";
+  }
+
+  script += "\n[test]\nclear\n";
+  for (uint32_t i = 0; i < command_count; ++i) {
+    std::string offset = std::to_string((i % 64) * 16);
+    std::string values;
+    for (uint32_t c = 0; c < 4; ++c)
+      AppendValue(&values, random.NextUnit());
+
+    switch (i % 4) {
+      case 0:
+        script += "ssbo 0:0 subdata vec4 " + offset + values + "\n";
+        break;
+      case 1:
+        script += "draw arrays TRIANGLE_LIST 0 " +
+                  std::to_string(vertex_count - vertex_count % 3) + "\n";
+        break;
+      case 2:
+        script += "probe rect rgba (0, 0, 250, 250) (" + values + ")\n";
+        break;
+      default:
+        script += "probe ssbo vec4 0:0 " + offset + " ~=" + values + "\n";
+        break;
+    }
+  }
+
+  return script;
+}
+
+std::vector<Value> GenerateFloatValues(size_t count, uint32_t seed) {
+  Random random(seed);
+  std::vector<Value> values(count);
+  for (auto& value : values)
+    value.SetDoubleValue(random.NextUnit());
+  return values;
+}
+
+std::vector<uint8_t> GenerateFramebuffer(uint32_t width,
+                                         uint32_t height,
+                                         const uint8_t texel[4]) {
+  std::vector<uint8_t> data(static_cast<size_t>(width) * height * 4);
+  for (size_t i = 0; i < data.size(); i += 4) {
+    data[i] = texel[0];
+    data[i + 1] = texel[1];
+    data[i + 2] = texel[2];
+    data[i + 3] = texel[3];
+  }
+  return data;
+}
+
+}  // namespace benchmark
+}  // namespace amber
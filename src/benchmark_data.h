@@ -0,0 +1,52 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_BENCHMARK_DATA_H_
+#define SRC_BENCHMARK_DATA_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "amber/value.h"
+
+namespace amber {
+namespace benchmark {
+
+// Generators for the synthetic inputs used by the benchmarks. The output only
+// depends on the arguments, so results are comparable between runs.
+
+/// Returns an AmberScript with a compute pipeline bound to |buffer_count|
+/// vec4<float> buffers of |values_per_buffer| values each. Each buffer is
+/// followed by an EXPECT of its first |values_per_buffer| values after a RUN.
+std::string GenerateAmberScript(uint32_t buffer_count,
+                                uint32_t values_per_buffer);
+
+/// Returns a VkScript with |vertex_count| rows of vertex data and a [test]
+/// section of |command_count| SSBO writes, draws and probes.
+std::string GenerateVkScript(uint32_t vertex_count, uint32_t command_count);
+
+/// Returns |count| float values in [0, 1), generated from |seed|.
+std::vector<Value> GenerateFloatValues(size_t count, uint32_t seed);
+
+/// Returns a |width| by |height| framebuffer of 4 byte texels, every one of
+/// which is |texel|.
+std::vector<uint8_t> GenerateFramebuffer(uint32_t width,
+                                         uint32_t height,
+                                         const uint8_t texel[4]);
+
+}  // namespace benchmark
+}  // namespace amber
+
+#endif  // SRC_BENCHMARK_DATA_H_
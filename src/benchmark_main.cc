@@ -0,0 +1,140 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "src/benchmark.h"
+
+namespace {
+
+const char kUsage[] = R"(Usage: amber_benchmarks [options]
+
+ options:
+  --filter <str>       -- Only run benchmarks whose name contains <str>.
+  --min-time <secs>    -- Run each benchmark for at least <secs> seconds.
+                          Defaults to 0.5.
+  --iterations <n>     -- Run each benchmark exactly <n> times.
+  --json               -- Output JSON in the Google Benchmark format.
+  --out <file>         -- Write the results to <file> instead of stdout.
+  --list               -- List the benchmarks and exit.
+  -h                   -- This help text.
+)";
+
+struct Options {
+  std::string filter;
+  std::string out_file;
+  double min_time = 0.5;
+  uint64_t iterations = 0;
+  bool json = false;
+  bool list = false;
+  bool show_help = false;
+};
+
+bool ParseArgs(const std::vector<std::string>& args, Options* opts) {
+  for (size_t i = 1; i < args.size(); ++i) {
+    const std::string& arg = args[i];
+    if (arg == "--filter" || arg == "--min-time" || arg == "--iterations" ||
+        arg == "--out") {
+      ++i;
+      if (i >= args.size()) {
+        std::cerr << "Missing value for " << arg << " argument." << std::endl;
+        return false;
+      }
+
+      const std::string& value = args[i];
+      if (arg == "--filter") {
+        opts->filter = value;
+      } else if (arg == "--out") {
+        opts->out_file = value;
+      } else if (arg == "--min-time") {
+        opts->min_time = strtod(value.c_str(), nullptr);
+        if (opts->min_time <= 0.0) {
+          std::cerr << "Invalid value for --min-time argument." << std::endl;
+          return false;
+        }
+      } else {
+        opts->iterations = strtoull(value.c_str(), nullptr, 10);
+        if (opts->iterations == 0) {
+          std::cerr << "Invalid value for --iterations argument." << std::endl;
+          return false;
+        }
+      }
+    } else if (arg == "--json") {
+      opts->json = true;
+    } else if (arg == "--list") {
+      opts->list = true;
+    } else if (arg == "-h" || arg == "-help" || arg == "--help") {
+      opts->show_help = true;
+    } else {
+      std::cerr << "Unrecognized option " << arg << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, const char** argv) {
+  std::vector<std::string> args(argv, argv + argc);
+  Options options;
+  if (!ParseArgs(args, &options)) {
+    std::cerr << "Failed to parse arguments." << std::endl;
+    return 1;
+  }
+  if (options.show_help) {
+    std::cout << kUsage;
+    return 0;
+  }
+
+  amber::benchmark::Runner runner;
+  amber::benchmark::AddBufferBenchmarks(&runner);
+  amber::benchmark::AddFormatBenchmarks(&runner);
+  amber::benchmark::AddParserBenchmarks(&runner);
+  amber::benchmark::AddTokenizerBenchmarks(&runner);
+  amber::benchmark::AddVerifierBenchmarks(&runner);
+
+  runner.SetFilter(options.filter);
+  runner.SetMinTime(options.min_time);
+  runner.SetIterations(options.iterations);
+  runner.SetJsonOutput(options.json);
+
+  if (options.list) {
+    runner.List(&std::cout);
+    return 0;
+  }
+
+  std::ofstream out_file;
+  std::ostream* out = &std::cout;
+  if (!options.out_file.empty()) {
+    out_file.open(options.out_file, std::ios::out | std::ios::trunc);
+    if (!out_file.is_open()) {
+      std::cerr << "Unable to open " << options.out_file << std::endl;
+      return 1;
+    }
+    out = &out_file;
+  }
+
+  amber::Result r = runner.Run(out);
+  if (!r.IsSuccess()) {
+    std::cerr << r.Error() << std::endl;
+    return 1;
+  }
+  return 0;
+}
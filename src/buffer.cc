@@ -14,9 +14,14 @@
 
 #include "src/buffer.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstring>
+#include <limits>
+
+#include "src/mapped_file.h"
+#include "src/parallel.h"
 
 namespace amber {
 namespace {
@@ -49,6 +54,39 @@ uint16_t FloatToHexFloat16(const float value) {
       static_cast<uint16_t>(FloatMantissa(*hex) >> 13U));
 }
 
+// Generated data smaller than this is written on the calling thread, below it
+// the cost of starting a thread outweighs the work done on it.
+const size_t kMinGeneratedBytesPerThread = 1 << 20;
+
+// Returns the |index|th value of the SplitMix64 sequence started from |seed|.
+// Each value depends only on |seed| and |index|, so any part of the sequence
+// can be generated independently of the rest.
+uint64_t SplitMix64(uint64_t seed, uint64_t index) {
+  uint64_t x = seed + (index + 1) * 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+// Writes gen(i * |components| + |component|) as a T for each element i in
+// [|begin|, |end|). |ptr| points at the component in element 0 and elements
+// are |stride| bytes apart.
+template <typename T, typename Gen>
+void WriteComponentRange(uint8_t* ptr,
+                         size_t stride,
+                         size_t begin,
+                         size_t end,
+                         size_t components,
+                         size_t component,
+                         const Gen& gen) {
+  ptr += begin * stride;
+  for (size_t i = begin; i < end; ++i) {
+    T value = static_cast<T>(gen(i * components + component));
+    std::memcpy(ptr, &value, sizeof(T));
+    ptr += stride;
+  }
+}
+
 template <typename T>
 T* ValuesAs(uint8_t* values) {
   return reinterpret_cast<T*>(values);
@@ -95,6 +133,98 @@ double CalculateDiff(const Format::Segment* seg,
   return 0.0;
 }
 
+// Writes the components of elements [|begin|, |end|) described by |seg|.
+// Integer components are taken from int_gen() and floating point ones from
+// float_gen(), both called with the index of the component in the buffer.
+template <typename IntGen, typename FloatGen>
+void WriteSegment(const Format::Segment& seg,
+                  uint8_t* ptr,
+                  size_t stride,
+                  size_t begin,
+                  size_t end,
+                  size_t components,
+                  size_t component,
+                  const IntGen& int_gen,
+                  const FloatGen& float_gen) {
+  FormatMode mode = seg.GetFormatMode();
+  uint32_t num_bits = seg.GetNumBits();
+  if (type::Type::IsInt8(mode, num_bits)) {
+    WriteComponentRange<int8_t>(ptr, stride, begin, end, components,
+                                component, int_gen);
+  } else if (type::Type::IsInt16(mode, num_bits)) {
+    WriteComponentRange<int16_t>(ptr, stride, begin, end, components,
+                                 component, int_gen);
+  } else if (type::Type::IsInt32(mode, num_bits)) {
+    WriteComponentRange<int32_t>(ptr, stride, begin, end, components,
+                                 component, int_gen);
+  } else if (type::Type::IsInt64(mode, num_bits)) {
+    WriteComponentRange<int64_t>(ptr, stride, begin, end, components,
+                                 component, int_gen);
+  } else if (type::Type::IsUint8(mode, num_bits)) {
+    WriteComponentRange<uint8_t>(ptr, stride, begin, end, components,
+                                 component, int_gen);
+  } else if (type::Type::IsUint16(mode, num_bits)) {
+    WriteComponentRange<uint16_t>(ptr, stride, begin, end, components,
+                                  component, int_gen);
+  } else if (type::Type::IsUint32(mode, num_bits)) {
+    WriteComponentRange<uint32_t>(ptr, stride, begin, end, components,
+                                  component, int_gen);
+  } else if (type::Type::IsUint64(mode, num_bits)) {
+    WriteComponentRange<uint64_t>(ptr, stride, begin, end, components,
+                                  component, int_gen);
+  } else if (type::Type::IsFloat16(mode, num_bits)) {
+    WriteComponentRange<uint16_t>(
+        ptr, stride, begin, end, components, component, [&](size_t i) {
+          return FloatToHexFloat16(static_cast<float>(float_gen(i)));
+        });
+  } else if (type::Type::IsFloat32(mode, num_bits)) {
+    WriteComponentRange<float>(ptr, stride, begin, end, components,
+                               component, float_gen);
+  } else if (type::Type::IsFloat64(mode, num_bits)) {
+    WriteComponentRange<double>(ptr, stride, begin, end, components,
+                                component, float_gen);
+  } else {
+    assert(false && "Not reached");
+  }
+}
+
+// Fills |data| with |element_count| elements of |format|, generating the
+// components with int_gen() and float_gen() as for WriteSegment(). Padding is
+// left untouched. Large buffers are split across up to |thread_count|
+// threads.
+template <typename IntGen, typename FloatGen>
+void GenerateElements(const Format* format,
+                      uint8_t* data,
+                      size_t element_count,
+                      uint32_t thread_count,
+                      const IntGen& int_gen,
+                      const FloatGen& float_gen) {
+  const auto& segments = format->GetSegments();
+  const size_t stride = format->SizeInBytes();
+  size_t components = 0;
+  for (const auto& seg : segments) {
+    if (!seg.IsPadding())
+      ++components;
+  }
+
+  size_t min_elements =
+      std::max(kMinGeneratedBytesPerThread / std::max(stride, size_t(1)),
+               size_t(1));
+  ParallelFor(thread_count, element_count, min_elements,
+              [&](uint32_t, size_t begin, size_t end) {
+                size_t offset = 0;
+                size_t component = 0;
+                for (const auto& seg : segments) {
+                  if (!seg.IsPadding()) {
+                    WriteSegment(seg, data + offset, stride, begin, end,
+                                 components, component, int_gen, float_gen);
+                    ++component;
+                  }
+                  offset += seg.SizeInBytes();
+                }
+              });
+}
+
 }  // namespace
 
 Buffer::Buffer() = default;
@@ -110,7 +240,7 @@ Result Buffer::CopyTo(Buffer* buffer) const {
     return Result("Buffer::CopyBaseFields() buffers have a different height");
   if (buffer->element_count_ != element_count_)
     return Result("Buffer::CopyBaseFields() buffers have a different size");
-  buffer->bytes_ = bytes_;
+  buffer->storage_ = storage_;
   return {};
 }
 
@@ -123,19 +253,34 @@ Result Buffer::IsEqual(Buffer* buffer) const {
     return Result{"Buffers have a different width"};
   if (buffer->height_ != height_)
     return Result{"Buffers have a different height"};
-  if (buffer->bytes_.size() != bytes_.size())
+  if (buffer->GetRawDataSize() != GetRawDataSize())
     return Result{"Buffers have a different number of values"};
 
+  return IsEqualToData(buffer->GetRawData(), buffer->GetRawDataSize());
+}
+
+Result Buffer::IsEqualToData(const uint8_t* data, size_t size) const {
+  const uint8_t* bytes = GetRawData();
+  if (size != GetRawDataSize()) {
+    return Result{"Buffer has " + std::to_string(GetRawDataSize()) +
+                  " bytes but expected data has " + std::to_string(size)};
+  }
+
+  // The common case is a match, which memcmp checks far faster than a byte
+  // loop. Only count the differences once we know there are some.
+  if (size == 0 || std::memcmp(bytes, data, size) == 0)
+    return {};
+
   uint32_t num_different = 0;
   uint32_t first_different_index = 0;
   uint8_t first_different_left = 0;
   uint8_t first_different_right = 0;
-  for (uint32_t i = 0; i < bytes_.size(); ++i) {
-    if (bytes_[i] != buffer->bytes_[i]) {
+  for (uint32_t i = 0; i < size; ++i) {
+    if (bytes[i] != data[i]) {
       if (num_different == 0) {
         first_different_index = i;
-        first_different_left = bytes_[i];
-        first_different_right = buffer->bytes_[i];
+        first_different_left = bytes[i];
+        first_different_right = data[i];
       }
       num_different++;
     }
@@ -153,11 +298,11 @@ Result Buffer::IsEqual(Buffer* buffer) const {
   return {};
 }
 
-std::vector<double> Buffer::CalculateDiffs(const Buffer* buffer) const {
+std::vector<double> Buffer::CalculateDiffs(const uint8_t* data) const {
   std::vector<double> diffs;
 
   auto* buf_1_ptr = GetValues<uint8_t>();
-  auto* buf_2_ptr = buffer->GetValues<uint8_t>();
+  auto* buf_2_ptr = data;
   const auto& segments = format_->GetSegments();
   for (size_t i = 0; i < ElementCount(); ++i) {
     for (const auto& seg : segments) {
@@ -189,7 +334,19 @@ Result Buffer::CompareRMSE(Buffer* buffer, float tolerance) const {
   if (buffer->ValueCount() != ValueCount())
     return Result{"Buffers have a different number of values"};
 
-  auto diffs = CalculateDiffs(buffer);
+  return CompareRMSEToData(buffer->GetRawData(), buffer->GetRawDataSize(),
+                           tolerance);
+}
+
+Result Buffer::CompareRMSEToData(const uint8_t* data,
+                                 size_t size,
+                                 float tolerance) const {
+  if (size != GetRawDataSize()) {
+    return Result{"Buffer has " + std::to_string(GetRawDataSize()) +
+                  " bytes but expected data has " + std::to_string(size)};
+  }
+
+  auto diffs = CalculateDiffs(data);
   double sum = 0.0;
   for (const auto val : diffs)
     sum += (val * val);
@@ -244,7 +401,8 @@ Result Buffer::SetDataWithOffset(const std::vector<Value>& data,
 
   // Even if the value count doesn't change, the buffer is still resized because
   // this maybe the first time data is set into the buffer.
-  bytes_.resize(GetSizeInBytes());
+  std::vector<uint8_t>* bytes = ValuePtr();
+  bytes->resize(GetSizeInBytes());
 
   // Set the new memory to zero to be on the safe side.
   uint32_t new_space =
@@ -253,12 +411,12 @@ Result Buffer::SetDataWithOffset(const std::vector<Value>& data,
   assert(new_space + offset <= GetSizeInBytes());
 
   if (new_space > 0)
-    memset(bytes_.data() + offset, 0, new_space);
+    memset(bytes->data() + offset, 0, new_space);
 
   if (data.size() > (ElementCount() * format_->InputNeededPerElement()))
     return Result("Mismatched number of items in buffer");
 
-  uint8_t* ptr = bytes_.data() + offset;
+  uint8_t* ptr = bytes->data() + offset;
   const auto& segments = format_->GetSegments();
   for (uint32_t i = 0; i < data.size();) {
     for (const auto& seg : segments) {
@@ -331,13 +489,13 @@ uint32_t Buffer::WriteValueFromComponent(const Value& value,
 
 void Buffer::SetSizeInElements(uint32_t element_count) {
   element_count_ = element_count;
-  bytes_.resize(element_count * format_->SizeInBytes());
+  ValuePtr()->resize(element_count * format_->SizeInBytes());
 }
 
 void Buffer::SetSizeInBytes(uint32_t size_in_bytes) {
   assert(size_in_bytes % format_->SizeInBytes() == 0);
   element_count_ = size_in_bytes / format_->SizeInBytes();
-  bytes_.resize(size_in_bytes);
+  ValuePtr()->resize(size_in_bytes);
 }
 
 void Buffer::SetMaxSizeInBytes(uint32_t max_size_in_bytes) {
@@ -352,12 +510,146 @@ uint32_t Buffer::GetMaxSizeInBytes() const {
 }
 
 Result Buffer::SetDataFromBuffer(const Buffer* src, uint32_t offset) {
-  if (bytes_.size() < offset + src->bytes_.size())
-    bytes_.resize(offset + src->bytes_.size());
+  std::vector<uint8_t>* bytes = ValuePtr();
+  if (bytes->size() < offset + src->GetRawDataSize())
+    bytes->resize(offset + src->GetRawDataSize());
 
-  std::memcpy(bytes_.data() + offset, src->bytes_.data(), src->bytes_.size());
+  if (src->GetRawDataSize() > 0) {
+    std::memcpy(bytes->data() + offset, src->GetRawData(),
+                src->GetRawDataSize());
+  }
   element_count_ =
-      static_cast<uint32_t>(bytes_.size()) / format_->SizeInBytes();
+      static_cast<uint32_t>(bytes->size()) / format_->SizeInBytes();
+  return {};
+}
+
+Result Buffer::SetElementCountFromRawSize(size_t size) {
+  uint32_t element_size = format_->SizeInBytes();
+  if (element_size == 0 || size % element_size != 0) {
+    return Result("data size of " + std::to_string(size) +
+                  " bytes is not a multiple of the element size of " +
+                  std::to_string(element_size) + " bytes");
+  }
+
+  element_count_ = static_cast<uint32_t>(size / element_size);
+  return {};
+}
+
+Result Buffer::SetRawData(std::vector<uint8_t>&& data) {
+  Result r = SetElementCountFromRawSize(data.size());
+  if (!r.IsSuccess())
+    return r;
+
+  storage_.SetBytes(std::move(data));
+  return {};
+}
+
+Result Buffer::SetFillData(uint32_t element_count,
+                           const Value& value,
+                           uint32_t thread_count) {
+  std::vector<uint8_t> bytes(size_t(element_count) * format_->SizeInBytes());
+  uint64_t int_value = value.AsUint64();
+  double float_value = value.AsDouble();
+  GenerateElements(
+      format_, bytes.data(), element_count, thread_count,
+      [&](size_t) { return int_value; }, [&](size_t) { return float_value; });
+
+  element_count_ = element_count;
+  storage_.SetBytes(std::move(bytes));
+  return {};
+}
+
+Result Buffer::SetSeriesData(uint32_t element_count,
+                             const Value& start,
+                             const Value& inc,
+                             uint32_t thread_count) {
+  std::vector<uint8_t> bytes(size_t(element_count) * format_->SizeInBytes());
+  // Each value is computed from its index rather than by repeatedly adding
+  // |inc|, so the elements can be generated in any order.
+  uint64_t int_start = start.AsUint64();
+  uint64_t int_inc = inc.AsUint64();
+  double float_start = start.AsDouble();
+  double float_inc = inc.AsDouble();
+  GenerateElements(
+      format_, bytes.data(), element_count, thread_count,
+      [&](size_t i) { return int_start + static_cast<uint64_t>(i) * int_inc; },
+      [&](size_t i) {
+        return float_start + static_cast<double>(i) * float_inc;
+      });
+
+  element_count_ = element_count;
+  storage_.SetBytes(std::move(bytes));
+  return {};
+}
+
+Result Buffer::SetRandomData(uint32_t element_count,
+                             uint64_t seed,
+                             const Value* min,
+                             const Value* max,
+                             uint32_t thread_count) {
+  bool has_float32 = false;
+  for (const auto& seg : format_->GetSegments()) {
+    if (seg.IsPadding())
+      continue;
+    if (type::Type::IsFloat16(seg.GetFormatMode(), seg.GetNumBits()))
+      return Result("random data is not supported for float16 components");
+    if (type::Type::IsFloat32(seg.GetFormatMode(), seg.GetNumBits()))
+      has_float32 = true;
+  }
+
+  // Integers are uniform over [min, max], or over every value of the type
+  // without a range. Floating point values are uniform over [min, max), or
+  // [0, 1) without a range.
+  uint64_t int_min = min ? min->AsUint64() : 0;
+  uint64_t int_span = min ? max->AsUint64() - int_min : 0;
+  bool full_int_range =
+      !min || int_span == std::numeric_limits<uint64_t>::max();
+  double float_min = min ? min->AsDouble() : 0.0;
+  double float_max = min ? max->AsDouble() : 1.0;
+  double float_span = float_max - float_min;
+  // With float32 components a value just below |float_max| can round up to
+  // it when stored, so such values are replaced by the largest float below
+  // |float_max| to keep the range half open.
+  float float32_max = static_cast<float>(float_max);
+  double float32_limit = static_cast<double>(
+      std::nextafter(float32_max, static_cast<float>(float_min)));
+
+  std::vector<uint8_t> bytes(size_t(element_count) * format_->SizeInBytes());
+  GenerateElements(
+      format_, bytes.data(), element_count, thread_count,
+      [&](size_t i) {
+        uint64_t bits = SplitMix64(seed, static_cast<uint64_t>(i));
+        return full_int_range ? bits : int_min + bits % (int_span + 1);
+      },
+      [&](size_t i) {
+        uint64_t bits = SplitMix64(seed, static_cast<uint64_t>(i));
+        if (!has_float32) {
+          // The top 53 bits give a double uniformly distributed in [0, 1).
+          double unit = static_cast<double>(bits >> 11) / 9007199254740992.0;
+          return float_min + float_span * unit;
+        }
+
+        // The top 24 bits give a value in [0, 1) which is exact as a float.
+        double unit = static_cast<double>(bits >> 40) / 16777216.0;
+        double value = float_min + float_span * unit;
+        if (float_span > 0.0 && static_cast<float>(value) >= float32_max)
+          value = float32_limit;
+        return value;
+      });
+
+  element_count_ = element_count;
+  storage_.SetBytes(std::move(bytes));
+  return {};
+}
+
+Result Buffer::SetMappedData(std::shared_ptr<MappedFile> file, size_t offset) {
+  assert(offset <= file->GetSize());
+  size_t size = file->GetSize() - offset;
+  Result r = SetElementCountFromRawSize(size);
+  if (!r.IsSuccess())
+    return r;
+
+  storage_.SetMappedFile(std::move(file), offset, size);
   return {};
 }
 
@@ -23,10 +23,13 @@
 
 #include "amber/result.h"
 #include "amber/value.h"
+#include "src/buffer_storage.h"
 #include "src/format.h"
 
 namespace amber {
 
+class MappedFile;
+
 /// Types of buffers which can be created.
 enum class BufferType : int8_t {
   /// Unknown buffer type
@@ -175,18 +178,66 @@ class Buffer {
   /// Writes |src| data into buffer at |offset|.
   Result SetDataFromBuffer(const Buffer* src, uint32_t offset);
 
-  /// Returns a pointer to the internal storage of the buffer.
-  std::vector<uint8_t>* ValuePtr() { return &bytes_; }
-  /// Returns a pointer to the internal storage of the buffer.
-  const std::vector<uint8_t>* ValuePtr() const { return &bytes_; }
+  /// Replaces the contents of the buffer with the raw bytes in |data|, which
+  /// are taken without copying. The size of |data| must be a multiple of the
+  /// element size of the format. This requires the format to have been set.
+  Result SetRawData(std::vector<uint8_t>&& data);
+
+  /// Sets the buffer to |element_count| elements with every component set to
+  /// |value|. The value must be floating point for floating point formats and
+  /// integer otherwise. The bytes are written directly, split across up to
+  /// |thread_count| threads for large buffers.
+  Result SetFillData(uint32_t element_count,
+                     const Value& value,
+                     uint32_t thread_count);
+
+  /// Sets the buffer to |element_count| elements where component i is
+  /// |start| + i * |inc|. The values are as for SetFillData().
+  Result SetSeriesData(uint32_t element_count,
+                       const Value& start,
+                       const Value& inc,
+                       uint32_t thread_count);
+
+  /// Sets the buffer to |element_count| elements of pseudo random components.
+  /// Component i depends only on |seed| and i, so the data is reproducible
+  /// and generated in parallel as for SetFillData(). If |min| and |max| are
+  /// given, integers are within [min, max] and floating point values within
+  /// [min, max). Otherwise integers cover the whole type and floating point
+  /// values are within [0, 1).
+  Result SetRandomData(uint32_t element_count,
+                       uint64_t seed,
+                       const Value* min,
+                       const Value* max,
+                       uint32_t thread_count);
+
+  /// Replaces the contents of the buffer with the bytes of |file| starting
+  /// |offset| bytes in. The bytes are read from the mapping and only copied
+  /// if the buffer is written to. The number of bytes must be a multiple of
+  /// the element size of the format. This requires the format to have been
+  /// set.
+  Result SetMappedData(std::shared_ptr<MappedFile> file, size_t offset);
+
+  /// Returns a pointer to the internal storage of the buffer, for writing. If
+  /// the storage is shared with another buffer or a file it is copied first.
+  std::vector<uint8_t>* ValuePtr() { return storage_.GetMutableBytes(); }
+
+  /// Returns a pointer to the bytes of the buffer, for reading.
+  const uint8_t* GetRawData() const { return storage_.GetData(); }
+  /// Returns the number of bytes stored in the buffer. This may differ from
+  /// GetSizeInBytes() when the data has not been set yet.
+  size_t GetRawDataSize() const { return storage_.GetSize(); }
+
+  /// Drops the stored bytes of the buffer, without copying shared storage.
+  void ClearData() { storage_.Clear(); }
 
   /// Returns a casted pointer to the internal storage of the buffer.
   template <typename T>
   const T* GetValues() const {
-    return reinterpret_cast<const T*>(bytes_.data());
+    return reinterpret_cast<const T*>(storage_.GetData());
   }
 
-  /// Copies the buffer values to an other one
+  /// Copies the buffer values to an other one. The bytes are shared between
+  /// the buffers until either of them is written.
   Result CopyTo(Buffer* buffer) const;
 
   /// Succeeds only if both buffer contents are equal
@@ -196,15 +247,31 @@ class Buffer {
   /// less than |tolerance|.
   Result CompareRMSE(Buffer* buffer, float tolerance) const;
 
+  /// Succeeds only if the buffer contents are equal to the |size| bytes at
+  /// |data|.
+  Result IsEqualToData(const uint8_t* data, size_t size) const;
+
+  /// Compare the RMSE of this buffer against the |size| bytes at |data|,
+  /// which are interpreted using this buffer's format. The RMSE must be less
+  /// than |tolerance|.
+  Result CompareRMSEToData(const uint8_t* data,
+                           size_t size,
+                           float tolerance) const;
+
  private:
   uint32_t WriteValueFromComponent(const Value& value,
                                    FormatMode mode,
                                    uint32_t num_bits,
                                    uint8_t* ptr);
 
+  // Sets the element count for |size| bytes of raw data, failing if |size| is
+  // not a whole number of elements.
+  Result SetElementCountFromRawSize(size_t size);
+
   // Calculates the difference between the value stored in this buffer and
-  // those stored in |buffer| and returns all the values.
-  std::vector<double> CalculateDiffs(const Buffer* buffer) const;
+  // those stored in |data| and returns all the values. |data| must be laid
+  // out in this buffer's format.
+  std::vector<double> CalculateDiffs(const uint8_t* data) const;
 
   BufferType buffer_type_ = BufferType::kUnknown;
   std::string name_;
@@ -215,7 +282,7 @@ class Buffer {
   uint32_t width_ = 0;
   uint32_t height_ = 0;
   bool format_is_default_ = false;
-  std::vector<uint8_t> bytes_;
+  BufferStorage storage_;
   Format* format_ = nullptr;
 };
 
@@ -0,0 +1,91 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <vector>
+
+#include "src/benchmark.h"
+#include "src/benchmark_data.h"
+#include "src/buffer.h"
+#include "src/format.h"
+#include "src/type_parser.h"
+
+namespace amber {
+namespace benchmark {
+namespace {
+
+const uint32_t kElementCount = 256 * 1024;
+
+void SetDataWithOffset(State* state) {
+  TypeParser parser;
+  auto type = parser.Parse("R32G32B32A32_SFLOAT");
+  Format fmt(type.get());
+
+  // Written in chunks, as the VkScript "ssbo subdata" command does.
+  const uint32_t kChunks = 64;
+  const uint32_t chunk_bytes = kElementCount / kChunks * fmt.SizeInBytes();
+  auto values = GenerateFloatValues(kElementCount * 4 / kChunks, 1);
+
+  Buffer buffer;
+  buffer.SetFormat(&fmt);
+  while (state->KeepRunning()) {
+    for (uint32_t i = 0; i < kChunks; ++i) {
+      Result r = buffer.SetDataWithOffset(values, i * chunk_bytes);
+      if (!r.IsSuccess()) {
+        state->SetError(r);
+        break;
+      }
+    }
+    DoNotOptimize(buffer.GetValues<uint8_t>());
+  }
+  state->SetItemsPerIteration(kElementCount);
+  state->SetBytesPerIteration(buffer.GetSizeInBytes());
+}
+
+void CompareRMSE(State* state) {
+  TypeParser parser;
+  auto type = parser.Parse("R32_SFLOAT");
+  Format fmt(type.get());
+
+  Buffer expected;
+  expected.SetFormat(&fmt);
+  Buffer actual;
+  actual.SetFormat(&fmt);
+  auto values = GenerateFloatValues(kElementCount, 2);
+  Result r = expected.SetData(values);
+  if (r.IsSuccess())
+    r = actual.SetData(values);
+  if (!r.IsSuccess()) {
+    state->SetError(r);
+    return;
+  }
+
+  while (state->KeepRunning()) {
+    r = actual.CompareRMSE(&expected, 0.1f);
+    if (!r.IsSuccess())
+      state->SetError(r);
+  }
+  state->SetItemsPerIteration(kElementCount);
+  state->SetBytesPerIteration(2 * expected.GetSizeInBytes());
+}
+
+}  // namespace
+
+void AddBufferBenchmarks(Runner* runner) {
+  runner->Add("Buffer/SetDataWithOffset", SetDataWithOffset);
+  runner->Add("Buffer/CompareRMSE", CompareRMSE);
+}
+
+}  // namespace benchmark
+}  // namespace amber
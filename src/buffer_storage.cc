@@ -0,0 +1,75 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/buffer_storage.h"
+
+#include <utility>
+
+#include "src/mapped_file.h"
+
+namespace amber {
+
+BufferStorage::BufferStorage() = default;
+
+BufferStorage::~BufferStorage() = default;
+
+void BufferStorage::SetBytes(std::vector<uint8_t>&& bytes) {
+  file_ = nullptr;
+  bytes_ = std::make_shared<std::vector<uint8_t>>(std::move(bytes));
+}
+
+void BufferStorage::SetMappedFile(std::shared_ptr<MappedFile> file,
+                                  size_t offset,
+                                  size_t size) {
+  bytes_ = nullptr;
+  file_ = std::move(file);
+  file_offset_ = offset;
+  file_size_ = size;
+}
+
+void BufferStorage::Clear() {
+  bytes_ = nullptr;
+  file_ = nullptr;
+}
+
+const uint8_t* BufferStorage::GetData() const {
+  if (file_)
+    return file_->GetData() + file_offset_;
+  return bytes_ ? bytes_->data() : nullptr;
+}
+
+size_t BufferStorage::GetSize() const {
+  if (file_)
+    return file_size_;
+  return bytes_ ? bytes_->size() : 0;
+}
+
+bool BufferStorage::IsShared() const {
+  return file_ != nullptr || (bytes_ && bytes_.use_count() > 1);
+}
+
+std::vector<uint8_t>* BufferStorage::GetMutableBytes() {
+  if (file_) {
+    const uint8_t* data = GetData();
+    bytes_ = std::make_shared<std::vector<uint8_t>>(data, data + file_size_);
+    file_ = nullptr;
+  } else if (!bytes_) {
+    bytes_ = std::make_shared<std::vector<uint8_t>>();
+  } else if (bytes_.use_count() > 1) {
+    bytes_ = std::make_shared<std::vector<uint8_t>>(*bytes_);
+  }
+  return bytes_.get();
+}
+
+}  // namespace amber
@@ -0,0 +1,70 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_BUFFER_STORAGE_H_
+#define SRC_BUFFER_STORAGE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace amber {
+
+class MappedFile;
+
+/// The bytes backing a Buffer. The bytes are either owned on the heap or are
+/// a view into a MappedFile. Copying the storage shares the bytes instead of
+/// duplicating them; a private copy is only made when a shared or mapped
+/// storage is about to be written.
+class BufferStorage {
+ public:
+  BufferStorage();
+  ~BufferStorage();
+
+  /// Replaces the contents with |bytes|, which are taken without copying.
+  void SetBytes(std::vector<uint8_t>&& bytes);
+  /// Replaces the contents with the |size| bytes at |offset| into |file|. The
+  /// file is kept open as long as any storage refers to it.
+  void SetMappedFile(std::shared_ptr<MappedFile> file,
+                     size_t offset,
+                     size_t size);
+  /// Drops the contents, without copying them if they are shared.
+  void Clear();
+
+  /// Returns the bytes for reading. This never copies.
+  const uint8_t* GetData() const;
+  /// Returns the number of bytes stored.
+  size_t GetSize() const;
+
+  /// Returns true if the bytes are a view into a file.
+  bool IsMapped() const { return file_ != nullptr; }
+  /// Returns true if writing would first have to copy the bytes, because they
+  /// are mapped or shared with another storage.
+  bool IsShared() const;
+
+  /// Returns the bytes for writing, copying them first if they are shared.
+  /// The pointer must not be held across copies of this storage.
+  std::vector<uint8_t>* GetMutableBytes();
+
+ private:
+  std::shared_ptr<std::vector<uint8_t>> bytes_;
+  std::shared_ptr<MappedFile> file_;
+  size_t file_offset_ = 0;
+  size_t file_size_ = 0;
+};
+
+}  // namespace amber
+
+#endif  // SRC_BUFFER_STORAGE_H_
@@ -0,0 +1,98 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/buffer_storage.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "src/mapped_file.h"
+
+namespace amber {
+
+using BufferStorageTest = testing::Test;
+
+TEST_F(BufferStorageTest, Empty) {
+  BufferStorage storage;
+  EXPECT_EQ(nullptr, storage.GetData());
+  EXPECT_EQ(0U, storage.GetSize());
+  EXPECT_FALSE(storage.IsShared());
+  EXPECT_FALSE(storage.IsMapped());
+
+  EXPECT_TRUE(storage.GetMutableBytes()->empty());
+}
+
+TEST_F(BufferStorageTest, CopyIsSharedUntilWritten) {
+  BufferStorage storage;
+  storage.SetBytes(std::vector<uint8_t>{1, 2, 3});
+  EXPECT_FALSE(storage.IsShared());
+
+  BufferStorage copy = storage;
+  EXPECT_TRUE(storage.IsShared());
+  EXPECT_TRUE(copy.IsShared());
+  EXPECT_EQ(storage.GetData(), copy.GetData());
+
+  (*copy.GetMutableBytes())[0] = 9;
+  EXPECT_FALSE(storage.IsShared());
+  EXPECT_FALSE(copy.IsShared());
+  EXPECT_NE(storage.GetData(), copy.GetData());
+  EXPECT_EQ(1U, storage.GetData()[0]);
+  EXPECT_EQ(9U, copy.GetData()[0]);
+  EXPECT_EQ(3U, copy.GetSize());
+}
+
+TEST_F(BufferStorageTest, Clear) {
+  BufferStorage storage;
+  storage.SetBytes(std::vector<uint8_t>{1, 2, 3});
+  BufferStorage copy = storage;
+
+  copy.Clear();
+  EXPECT_EQ(0U, copy.GetSize());
+  EXPECT_FALSE(storage.IsShared());
+  EXPECT_EQ(3U, storage.GetSize());
+}
+
+TEST_F(BufferStorageTest, MappedFile) {
+  std::string path = testing::TempDir() + "amber_buffer_storage_test.bin";
+  {
+    std::ofstream out(path, std::ios::out | std::ios::binary);
+    ASSERT_TRUE(out.is_open());
+    out << std::string("\x01\x02\x03\x04", 4);
+  }
+
+  std::unique_ptr<MappedFile> file;
+  Result r = MappedFile::Open(path, &file);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+  const uint8_t* file_data = file->GetData();
+
+  BufferStorage storage;
+  storage.SetMappedFile(std::move(file), 1, 3);
+  EXPECT_TRUE(storage.IsMapped());
+  EXPECT_TRUE(storage.IsShared());
+  EXPECT_EQ(file_data + 1, storage.GetData());
+  EXPECT_EQ(3U, storage.GetSize());
+
+  auto* bytes = storage.GetMutableBytes();
+  EXPECT_FALSE(storage.IsMapped());
+  ASSERT_EQ(3U, bytes->size());
+  EXPECT_EQ(2U, (*bytes)[0]);
+  EXPECT_EQ(4U, (*bytes)[2]);
+
+  std::remove(path.c_str());
+}
+
+}  // namespace amber
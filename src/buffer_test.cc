@@ -124,4 +124,213 @@ TEST_F(BufferTest, SizeMatrixPaddedStd430) {
   EXPECT_EQ(12U * sizeof(int32_t), b.GetSizeInBytes());
 }
 
+
+TEST_F(BufferTest, IsEqualToData) {
+  TypeParser parser;
+  auto type = parser.Parse("R8_UINT");
+  Format fmt(type.get());
+
+  std::vector<Value> values(4);
+  for (size_t i = 0; i < values.size(); ++i)
+    values[i].SetIntValue(i + 1);
+
+  Buffer b(BufferType::kStorage);
+  b.SetFormat(&fmt);
+  ASSERT_TRUE(b.SetData(values).IsSuccess());
+
+  const uint8_t same[] = {1, 2, 3, 4};
+  EXPECT_TRUE(b.IsEqualToData(same, sizeof(same)).IsSuccess());
+
+  const uint8_t different[] = {1, 9, 3, 9};
+  Result r = b.IsEqualToData(different, sizeof(different));
+  EXPECT_EQ(
+      "Buffers have different values. 2 values differed, first difference at "
+      "byte 1 values 2 != 9",
+      r.Error());
+
+  r = b.IsEqualToData(same, 3);
+  EXPECT_EQ("Buffer has 4 bytes but expected data has 3", r.Error());
+}
+
+TEST_F(BufferTest, CompareRMSEToData) {
+  TypeParser parser;
+  auto type = parser.Parse("R32_SFLOAT");
+  Format fmt(type.get());
+
+  std::vector<Value> values(4);
+  for (size_t i = 0; i < values.size(); ++i)
+    values[i].SetDoubleValue(static_cast<double>(i));
+
+  Buffer b(BufferType::kStorage);
+  b.SetFormat(&fmt);
+  ASSERT_TRUE(b.SetData(values).IsSuccess());
+
+  const float expected[] = {0.f, 1.f, 2.f, 6.f};
+  const auto* data = reinterpret_cast<const uint8_t*>(expected);
+  EXPECT_TRUE(b.CompareRMSEToData(data, sizeof(expected), 1.5f).IsSuccess());
+
+  Result r = b.CompareRMSEToData(data, sizeof(expected), 1.0f);
+  EXPECT_EQ(
+      "Root Mean Square Error of 1.500000 is greater than tolerance of "
+      "1.000000",
+      r.Error());
+}
+
+
+TEST_F(BufferTest, SetRawData) {
+  TypeParser parser;
+  auto type = parser.Parse("R16G16_UINT");
+  Format fmt(type.get());
+
+  Buffer b(BufferType::kStorage);
+  b.SetFormat(&fmt);
+
+  std::vector<uint8_t> data = {1, 0, 2, 0, 3, 0, 4, 0};
+  Result r = b.SetRawData(std::move(data));
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+  EXPECT_EQ(2U, b.ElementCount());
+  EXPECT_EQ(4U, b.ValueCount());
+  EXPECT_EQ(8U, b.GetSizeInBytes());
+
+  const auto* values = b.GetValues<uint16_t>();
+  EXPECT_EQ(1U, values[0]);
+  EXPECT_EQ(4U, values[3]);
+
+  std::vector<uint8_t> partial = {1, 2, 3, 4, 5, 6};
+  r = b.SetRawData(std::move(partial));
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ(
+      "data size of 6 bytes is not a multiple of the element size of 4 bytes",
+      r.Error());
+}
+
+
+TEST_F(BufferTest, CopyToSharesDataUntilWritten) {
+  TypeParser parser;
+  auto type = parser.Parse("R8_UINT");
+  Format fmt(type.get());
+
+  Buffer src(BufferType::kStorage);
+  src.SetFormat(&fmt);
+  ASSERT_TRUE(src.SetRawData(std::vector<uint8_t>{1, 2, 3, 4}).IsSuccess());
+
+  Buffer dst(BufferType::kStorage);
+  dst.SetFormat(&fmt);
+  dst.SetElementCount(4);
+  ASSERT_TRUE(src.CopyTo(&dst).IsSuccess());
+  EXPECT_EQ(src.GetRawData(), dst.GetRawData());
+
+  (*dst.ValuePtr())[0] = 9;
+  EXPECT_NE(src.GetRawData(), dst.GetRawData());
+  EXPECT_EQ(1U, src.GetValues<uint8_t>()[0]);
+  EXPECT_EQ(9U, dst.GetValues<uint8_t>()[0]);
+  EXPECT_EQ(2U, dst.GetValues<uint8_t>()[1]);
+}
+
+
+TEST_F(BufferTest, SetFillDataSkipsPadding) {
+  TypeParser parser;
+  auto type = parser.Parse("R32G32B32_SFLOAT");
+  Format fmt(type.get());
+  fmt.SetLayout(Format::Layout::kStd140);
+
+  Buffer b(BufferType::kStorage);
+  b.SetFormat(&fmt);
+
+  Value value;
+  value.SetDoubleValue(1.5);
+  Result r = b.SetFillData(3, value, 1);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+  EXPECT_EQ(3U, b.ElementCount());
+  ASSERT_EQ(48U, b.GetRawDataSize());
+
+  const auto* data = b.GetValues<float>();
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_FLOAT_EQ(1.5f, data[i * 4]);
+    EXPECT_FLOAT_EQ(1.5f, data[i * 4 + 1]);
+    EXPECT_FLOAT_EQ(1.5f, data[i * 4 + 2]);
+    EXPECT_FLOAT_EQ(0.f, data[i * 4 + 3]);
+  }
+}
+
+TEST_F(BufferTest, SetSeriesDataWraps) {
+  TypeParser parser;
+  auto type = parser.Parse("R8_UINT");
+  Format fmt(type.get());
+
+  Buffer b(BufferType::kStorage);
+  b.SetFormat(&fmt);
+
+  Value start;
+  start.SetIntValue(250);
+  Value inc;
+  inc.SetIntValue(3);
+  Result r = b.SetSeriesData(4, start, inc, 1);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  std::vector<uint8_t> expected = {250, 253, 0, 3};
+  const auto* data = b.GetValues<uint8_t>();
+  for (size_t i = 0; i < expected.size(); ++i)
+    EXPECT_EQ(expected[i], data[i]);
+}
+
+TEST_F(BufferTest, GeneratedDataDoesNotDependOnThreadCount) {
+  TypeParser parser;
+  auto type = parser.Parse("R32_UINT");
+  Format fmt(type.get());
+
+  // Large enough to be split across several threads.
+  const uint32_t count = 1 << 20;
+
+  Buffer single(BufferType::kStorage);
+  single.SetFormat(&fmt);
+  ASSERT_TRUE(single.SetRandomData(count, 42, nullptr, nullptr, 1).IsSuccess());
+
+  Buffer threaded(BufferType::kStorage);
+  threaded.SetFormat(&fmt);
+  ASSERT_TRUE(
+      threaded.SetRandomData(count, 42, nullptr, nullptr, 4).IsSuccess());
+  EXPECT_TRUE(single.IsEqual(&threaded).IsSuccess());
+
+  Value start;
+  start.SetIntValue(1);
+  Value inc;
+  inc.SetIntValue(2);
+  ASSERT_TRUE(threaded.SetSeriesData(count, start, inc, 4).IsSuccess());
+  const auto* data = threaded.GetValues<uint32_t>();
+  EXPECT_EQ(1U, data[0]);
+  EXPECT_EQ(2U * (count - 1) + 1, data[count - 1]);
+}
+
+TEST_F(BufferTest, RandomFloatDataExcludesMax) {
+  TypeParser parser;
+  auto type = parser.Parse("R32_SFLOAT");
+  Format fmt(type.get());
+
+  // A range of a few floats, so many of the generated values are close
+  // enough to |max| to round up to it when stored as a float.
+  Value min;
+  min.SetDoubleValue(1.0);
+  Value max;
+  max.SetDoubleValue(1.0000005);
+  const uint32_t count = 1 << 16;
+
+  Buffer b(BufferType::kStorage);
+  b.SetFormat(&fmt);
+  ASSERT_TRUE(b.SetRandomData(count, 7, &min, &max, 1).IsSuccess());
+
+  const auto* data = b.GetValues<float>();
+  for (uint32_t i = 0; i < count; ++i) {
+    ASSERT_LE(1.0f, data[i]);
+    ASSERT_LT(data[i], static_cast<float>(1.0000005));
+  }
+
+  ASSERT_TRUE(b.SetRandomData(count, 7, nullptr, nullptr, 1).IsSuccess());
+  data = b.GetValues<float>();
+  for (uint32_t i = 0; i < count; ++i) {
+    ASSERT_LE(0.0f, data[i]);
+    ASSERT_LT(data[i], 1.0f);
+  }
+}
+
 }  // namespace amber
@@ -42,6 +42,10 @@ CompareBufferCommand* Command::AsCompareBuffer() {
   return static_cast<CompareBufferCommand*>(this);
 }
 
+CompareFileCommand* Command::AsCompareFile() {
+  return static_cast<CompareFileCommand*>(this);
+}
+
 ComputeCommand* Command::AsCompute() {
   return static_cast<ComputeCommand*>(this);
 }
@@ -62,6 +66,10 @@ EntryPointCommand* Command::AsEntryPoint() {
   return static_cast<EntryPointCommand*>(this);
 }
 
+HashBufferCommand* Command::AsHashBuffer() {
+  return static_cast<HashBufferCommand*>(this);
+}
+
 PatchParameterVerticesCommand* Command::AsPatchParameterVertices() {
   return static_cast<PatchParameterVerticesCommand*>(this);
 }
@@ -102,6 +110,16 @@ CompareBufferCommand::CompareBufferCommand(Buffer* buffer_1, Buffer* buffer_2)
 
 CompareBufferCommand::~CompareBufferCommand() = default;
 
+CompareFileCommand::CompareFileCommand(Buffer* buffer, const std::string& path)
+    : Command(Type::kCompareFile), buffer_(buffer), path_(path) {}
+
+CompareFileCommand::~CompareFileCommand() = default;
+
+HashBufferCommand::HashBufferCommand(Buffer* buffer)
+    : Command(Type::kHashBuffer), buffer_(buffer) {}
+
+HashBufferCommand::~HashBufferCommand() = default;
+
 ComputeCommand::ComputeCommand(Pipeline* pipeline)
     : PipelineCommand(Type::kCompute, pipeline) {}
 
@@ -120,6 +138,42 @@ ProbeSSBOCommand::ProbeSSBOCommand(Buffer* buffer)
 
 ProbeSSBOCommand::~ProbeSSBOCommand() = default;
 
+void ProbeSSBOCommand::SetFill(const Value& value, uint32_t count) {
+  value_source_ = ValueSource::kFill;
+  values_.clear();
+  series_start_ = value;
+  if (value.IsInteger())
+    series_inc_.SetIntValue(0);
+  else
+    series_inc_.SetDoubleValue(0.0);
+  generated_count_ = count;
+}
+
+void ProbeSSBOCommand::SetSeries(const Value& start,
+                                 const Value& inc,
+                                 uint32_t count) {
+  value_source_ = ValueSource::kSeries;
+  values_.clear();
+  series_start_ = start;
+  series_inc_ = inc;
+  generated_count_ = count;
+}
+
+Value ProbeSSBOCommand::GetExpectedValue(size_t index) const {
+  if (!HasGeneratedValues())
+    return values_[index];
+
+  Value value;
+  if (series_start_.IsInteger()) {
+    value.SetIntValue(series_start_.AsUint64() +
+                      series_inc_.AsUint64() * static_cast<uint64_t>(index));
+  } else {
+    value.SetDoubleValue(series_start_.AsDouble() +
+                         series_inc_.AsDouble() * static_cast<double>(index));
+  }
+  return value;
+}
+
 BufferCommand::BufferCommand(BufferType type, Pipeline* pipeline)
     : PipelineCommand(Type::kBuffer, pipeline), buffer_type_(type) {}
 
@@ -25,6 +25,7 @@
 #include "amber/value.h"
 #include "src/buffer.h"
 #include "src/command_data.h"
+#include "src/hash.h"
 #include "src/pipeline_data.h"
 
 namespace amber {
@@ -35,11 +36,13 @@ class ClearCommand;
 class ClearDepthCommand;
 class ClearStencilCommand;
 class CompareBufferCommand;
+class CompareFileCommand;
 class ComputeCommand;
 class CopyCommand;
 class DrawArraysCommand;
 class DrawRectCommand;
 class EntryPointCommand;
+class HashBufferCommand;
 class PatchParameterVerticesCommand;
 class Pipeline;
 class ProbeCommand;
@@ -56,10 +59,12 @@ class Command {
     kClearStencil,
     kCompute,
     kCompareBuffer,
+    kCompareFile,
     kCopy,
     kDrawArrays,
     kDrawRect,
     kEntryPoint,
+    kHashBuffer,
     kPatchParameterVertices,
     kPipelineProperties,
     kProbe,
@@ -75,8 +80,10 @@ class Command {
   bool IsDrawRect() const { return command_type_ == Type::kDrawRect; }
   bool IsDrawArrays() const { return command_type_ == Type::kDrawArrays; }
   bool IsCompareBuffer() const { return command_type_ == Type::kCompareBuffer; }
+  bool IsCompareFile() const { return command_type_ == Type::kCompareFile; }
   bool IsCompute() const { return command_type_ == Type::kCompute; }
   bool IsCopy() const { return command_type_ == Type::kCopy; }
+  bool IsHashBuffer() const { return command_type_ == Type::kHashBuffer; }
   bool IsProbe() const { return command_type_ == Type::kProbe; }
   bool IsProbeSSBO() const { return command_type_ == Type::kProbeSSBO; }
   bool IsBuffer() const { return command_type_ == Type::kBuffer; }
@@ -95,11 +102,13 @@ class Command {
   ClearDepthCommand* AsClearDepth();
   ClearStencilCommand* AsClearStencil();
   CompareBufferCommand* AsCompareBuffer();
+  CompareFileCommand* AsCompareFile();
   ComputeCommand* AsCompute();
   CopyCommand* AsCopy();
   DrawArraysCommand* AsDrawArrays();
   DrawRectCommand* AsDrawRect();
   EntryPointCommand* AsEntryPoint();
+  HashBufferCommand* AsHashBuffer();
   PatchParameterVerticesCommand* AsPatchParameterVertices();
   ProbeCommand* AsProbe();
   ProbeSSBOCommand* AsProbeSSBO();
@@ -212,7 +221,7 @@ class DrawArraysCommand : public PipelineCommand {
 /// A command to compare two buffers.
 class CompareBufferCommand : public Command {
  public:
-  enum class Comparator { kEq, kRmse };
+  enum class Comparator { kEq, kRmse, kSsim, kPsnr, kMaxError };
 
   CompareBufferCommand(Buffer* buffer_1, Buffer* buffer_2);
   ~CompareBufferCommand() override;
@@ -223,18 +232,77 @@ class CompareBufferCommand : public Command {
   void SetComparator(Comparator type) { comparator_ = type; }
   Comparator GetComparator() const { return comparator_; }
 
+  /// The RMSE tolerance, or the lowest accepted SSIM or PSNR.
   void SetTolerance(float tolerance) { tolerance_ = tolerance; }
   float GetTolerance() const { return tolerance_; }
 
+  /// The largest accepted absolute error of each of the R, G, B and A
+  /// components, for Comparator::kMaxError.
+  void SetComponentTolerances(const std::vector<float>& tolerances) {
+    component_tolerances_ = tolerances;
+  }
+  const std::vector<float>& GetComponentTolerances() const {
+    return component_tolerances_;
+  }
+
   std::string ToString() const override { return "CompareBufferCommand"; }
 
  private:
   Buffer* buffer_1_;
   Buffer* buffer_2_;
   float tolerance_ = 0.0;
+  std::vector<float> component_tolerances_;
   Comparator comparator_ = Comparator::kEq;
 };
 
+/// A command to compare a buffer against the raw contents of a file.
+class CompareFileCommand : public Command {
+ public:
+  enum class Comparator { kEq, kRmse };
+
+  CompareFileCommand(Buffer* buffer, const std::string& path);
+  ~CompareFileCommand() override;
+
+  Buffer* GetBuffer() const { return buffer_; }
+  const std::string& GetPath() const { return path_; }
+
+  void SetComparator(Comparator type) { comparator_ = type; }
+  Comparator GetComparator() const { return comparator_; }
+
+  void SetTolerance(float tolerance) { tolerance_ = tolerance; }
+  float GetTolerance() const { return tolerance_; }
+
+  std::string ToString() const override { return "CompareFileCommand"; }
+
+ private:
+  Buffer* buffer_;
+  std::string path_;
+  float tolerance_ = 0.0;
+  Comparator comparator_ = Comparator::kEq;
+};
+
+/// A command to compare the hash of a buffer's contents to an expected value.
+class HashBufferCommand : public Command {
+ public:
+  explicit HashBufferCommand(Buffer* buffer);
+  ~HashBufferCommand() override;
+
+  Buffer* GetBuffer() const { return buffer_; }
+
+  void SetHashType(HashType type) { hash_type_ = type; }
+  HashType GetHashType() const { return hash_type_; }
+
+  void SetExpectedHash(uint64_t hash) { expected_hash_ = hash; }
+  uint64_t GetExpectedHash() const { return expected_hash_; }
+
+  std::string ToString() const override { return "HashBufferCommand"; }
+
+ private:
+  Buffer* buffer_;
+  HashType hash_type_ = HashType::kXXH64;
+  uint64_t expected_hash_ = 0;
+};
+
 /// Command to execute a compute command.
 class ComputeCommand : public PipelineCommand {
  public:
@@ -381,6 +449,9 @@ class ProbeSSBOCommand : public Probe {
     kGreaterOrEqual
   };
 
+  /// Where the expected values of the probe come from.
+  enum class ValueSource { kList, kFill, kSeries };
+
   explicit ProbeSSBOCommand(Buffer* buffer);
   ~ProbeSSBOCommand() override;
 
@@ -399,9 +470,35 @@ class ProbeSSBOCommand : public Probe {
   void SetFormat(Format* fmt) { format_ = fmt; }
   Format* GetFormat() const { return format_; }
 
-  void SetValues(std::vector<Value>&& values) { values_ = std::move(values); }
+  void SetValues(std::vector<Value>&& values) {
+    value_source_ = ValueSource::kList;
+    values_ = std::move(values);
+  }
   const std::vector<Value>& GetValues() const { return values_; }
 
+  /// Expect |count| values all equal to |value| instead of a list of values.
+  void SetFill(const Value& value, uint32_t count);
+  /// Expect the |count| values |start|, |start| + |inc|, ... instead of a list
+  /// of values. |start| and |inc| must both be integer or both be float.
+  void SetSeries(const Value& start, const Value& inc, uint32_t count);
+
+  ValueSource GetValueSource() const { return value_source_; }
+  bool HasGeneratedValues() const {
+    return value_source_ != ValueSource::kList;
+  }
+  /// Returns the fill value or the first value of the series.
+  const Value& GetSeriesStart() const { return series_start_; }
+  /// Returns the series increment. This is zero for a fill.
+  const Value& GetSeriesIncrement() const { return series_inc_; }
+
+  /// Returns the number of expected values.
+  size_t GetValueCount() const {
+    return HasGeneratedValues() ? generated_count_ : values_.size();
+  }
+  /// Returns the expected value at |index|. Generated values are computed as
+  /// start + index * increment, so any value can be produced independently.
+  Value GetExpectedValue(size_t index) const;
+
   std::string ToString() const override { return "ProbeSSBOCommand"; }
 
  private:
@@ -410,7 +507,11 @@ class ProbeSSBOCommand : public Probe {
   uint32_t binding_num_ = 0;
   uint32_t offset_ = 0;
   Format* format_;
+  ValueSource value_source_ = ValueSource::kList;
   std::vector<Value> values_;
+  Value series_start_;
+  Value series_inc_;
+  size_t generated_count_ = 0;
 };
 
 /// Command to set the size of a buffer, or update a buffers contents.
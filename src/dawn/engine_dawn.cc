@@ -1501,7 +1501,7 @@ Result EngineDawn::DoBuffer(const BufferCommand* command) {
     amber_buffer->SetDataWithOffset(command->GetValues(), command->GetOffset());
 
     dawn_buffer->SetSubData(0, amber_buffer->GetMaxSizeInBytes(),
-                            amber_buffer->ValuePtr()->data());
+                            amber_buffer->GetRawData());
   }
 
   return {};
@@ -1580,7 +1580,7 @@ Result EngineDawn::AttachBuffersAndTextures(
   if (render_pipeline->pipeline->GetIndexBuffer()) {
     render_pipeline->index_buffer = CreateBufferFromData(
         *device_,
-        render_pipeline->pipeline->GetIndexBuffer()->ValuePtr()->data(),
+        render_pipeline->pipeline->GetIndexBuffer()->GetRawData(),
         render_pipeline->pipeline->GetIndexBuffer()->GetSizeInBytes(),
         ::dawn::BufferUsage::Index);
   }
@@ -1588,7 +1588,7 @@ Result EngineDawn::AttachBuffersAndTextures(
   // Attach vertex buffers
   for (auto& vertex_info : render_pipeline->pipeline->GetVertexBuffers()) {
     render_pipeline->vertex_buffers.emplace_back(CreateBufferFromData(
-        *device_, vertex_info.buffer->ValuePtr()->data(),
+        *device_, vertex_info.buffer->GetRawData(),
         vertex_info.buffer->GetSizeInBytes(), ::dawn::BufferUsage::Vertex));
   }
 
@@ -1645,7 +1645,7 @@ Result EngineDawn::AttachBuffersAndTextures(
     }
 
     render_pipeline->buffers.emplace_back(
-        CreateBufferFromData(*device_, buf_info.buffer->ValuePtr()->data(),
+        CreateBufferFromData(*device_, buf_info.buffer->GetRawData(),
                              buf_info.buffer->GetMaxSizeInBytes(),
                              bufferUsage | ::dawn::BufferUsage::CopySrc |
                                  ::dawn::BufferUsage::CopyDst));
@@ -1745,7 +1745,7 @@ Result EngineDawn::AttachBuffers(ComputePipelineInfo* compute_pipeline) {
     }
 
     compute_pipeline->buffers.emplace_back(
-        CreateBufferFromData(*device_, buf_info.buffer->ValuePtr()->data(),
+        CreateBufferFromData(*device_, buf_info.buffer->GetRawData(),
                              buf_info.buffer->GetMaxSizeInBytes(),
                              bufferUsage | ::dawn::BufferUsage::CopySrc |
                                  ::dawn::BufferUsage::CopyDst));
@@ -28,17 +28,17 @@ DescriptorSetAndBindingParser::~DescriptorSetAndBindingParser() = default;
 Result DescriptorSetAndBindingParser::Parse(const std::string& buffer_id) {
   Tokenizer t(buffer_id);
   auto token = t.NextToken();
-  if (token->IsInteger()) {
-    if (token->AsInt32() < 0) {
+  if (token.IsInteger()) {
+    if (token.AsInt32() < 0) {
       return Result(
           "Descriptor set and binding for a buffer must be non-negative "
           "integer, but you gave: " +
-          token->ToOriginalString());
+          token.ToOriginalString());
     }
 
-    uint32_t val = token->AsUint32();
+    uint32_t val = token.AsUint32();
     token = t.NextToken();
-    if (token->IsEOS() || token->IsEOL()) {
+    if (token.IsEOS() || token.IsEOL()) {
       descriptor_set_ = 0;
       binding_ = val;
       return {};
@@ -49,10 +49,10 @@ Result DescriptorSetAndBindingParser::Parse(const std::string& buffer_id) {
     descriptor_set_ = 0;
   }
 
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("Invalid buffer id: " + buffer_id);
 
-  auto& str = token->AsString();
+  auto& str = token.AsString();
   if (str.size() < 2 || str[0] != ':')
     return Result("Invalid buffer id: " + buffer_id);
 
@@ -70,11 +70,11 @@ Result DescriptorSetAndBindingParser::Parse(const std::string& buffer_id) {
   uint64_t binding_val = strtoul(substr.c_str(), nullptr, 10);
   if (binding_val > std::numeric_limits<uint32_t>::max())
     return Result("binding value too large in probe ssbo command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
   if (static_cast<int32_t>(binding_val) < 0) {
     return Result(
         "Binding for a buffer must be non-negative integer, but you gave: " +
-        token->ToOriginalString());
+        token.ToOriginalString());
   }
 
   binding_ = static_cast<uint32_t>(binding_val);
@@ -62,52 +62,71 @@ void ConvertIDxcBlobToUint32(IDxcBlob* blob,
   memcpy(binaryWords->data(), binaryStr.data(), binaryStr.size());
 }
 
-}  // namespace
-
-Result Compile(const std::string& src,
-               const std::string& entry,
-               const std::string& profile,
-               const std::string& spv_env,
-               std::vector<uint32_t>* generated_binary) {
-  DxcInitThreadMalloc();
-
+// Sets up the DXC allocator and option table. Both are process wide, so this
+// runs once, however many threads compile HLSL. They are kept until exit.
+Result InitDxc() {
+  if (DxcInitThreadMalloc() < 0)
+    return Result("DXC compile failure: DxcInitThreadMalloc");
   if (hlsl::options::initHlslOptTable()) {
     DxcCleanupThreadMalloc();
     return Result("DXC compile failure: initHlslOptTable");
   }
+  return {};
+}
+
+// The DXC instances of a thread. Creating them costs more than compiling a
+// small shader, so they are created by the first compile on each thread and
+// reused by the following ones. They are not shared between threads.
+struct DxcContext {
+  CComPtr<IDxcLibrary> library;
+  CComPtr<IDxcIncludeHandler> include_handler;
+  CComPtr<IDxcCompiler> compiler;
+};
 
-  IDxcLibrary* dxc_lib;
+Result CreateDxcContext(DxcContext* context) {
   if (DxcCreateInstance(CLSID_DxcLibrary, __uuidof(IDxcLibrary),
-                        reinterpret_cast<void**>(&dxc_lib)) < 0) {
-    DxcCleanupThreadMalloc();
+                        reinterpret_cast<void**>(&context->library)) < 0) {
     return Result("DXCCreateInstance for DXCLibrary failed");
   }
-
-  IDxcBlobEncoding* source;
-  if (dxc_lib->CreateBlobWithEncodingOnHeapCopy(
-          src.data(), static_cast<uint32_t>(src.size()), CP_UTF8, &source) <
-      0) {
-    DxcCleanupThreadMalloc();
-    return Result("DXC compile failure: CreateBlobFromFile");
-  }
-
-  IDxcIncludeHandler* include_handler;
-  if (dxc_lib->CreateIncludeHandler(&include_handler) < 0) {
-    DxcCleanupThreadMalloc();
+  if (context->library->CreateIncludeHandler(&context->include_handler) < 0)
     return Result("DXC compile failure: CreateIncludeHandler");
-  }
-
-  IDxcCompiler* compiler;
   if (DxcCreateInstance(CLSID_DxcCompiler, __uuidof(IDxcCompiler),
-                        reinterpret_cast<void**>(&compiler)) < 0) {
-    DxcCleanupThreadMalloc();
+                        reinterpret_cast<void**>(&context->compiler)) < 0) {
     return Result("DXCCreateInstance for DXCCompiler failed");
   }
+  return {};
+}
 
-  IDxcOperationResult* result;
-  std::wstring src_filename =
-      L"amber." + std::wstring(profile.begin(), profile.end());
+// Returns the DXC context of the calling thread in |context|, creating it on
+// first use.
+Result GetDxcContext(DxcContext** context) {
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wexit-time-destructors"
+  static const Result init_result = InitDxc();
+  static thread_local DxcContext thread_context;
+#pragma clang diagnostic pop
+
+  if (!init_result.IsSuccess())
+    return init_result;
+
+  if (!thread_context.compiler) {
+    Result r = CreateDxcContext(&thread_context);
+    if (!r.IsSuccess()) {
+      thread_context = DxcContext();
+      return r;
+    }
+  }
+  *context = &thread_context;
+  return {};
+}
+
+}  // namespace
 
+Result Compile(const std::string& src,
+               const std::string& entry,
+               const std::string& profile,
+               const std::string& spv_env,
+               std::vector<uint32_t>* generated_binary) {
   std::vector<const wchar_t*> dxc_flags(kDxcFlags, &kDxcFlags[kDxcFlagsCount]);
   const wchar_t* target_env = nullptr;
   if (!spv_env.compare("spv1.3") || !spv_env.compare("vulkan1.1")) {
@@ -122,6 +141,23 @@ Result Compile(const std::string& src,
   if (target_env)
     dxc_flags.push_back(target_env);
 
+  DxcContext* context = nullptr;
+  Result r = GetDxcContext(&context);
+  if (!r.IsSuccess())
+    return r;
+
+  CComPtr<IDxcBlobEncoding> source;
+  if (context->library->CreateBlobWithEncodingOnHeapCopy(
+          src.data(), static_cast<uint32_t>(src.size()), CP_UTF8, &source) <
+      0) {
+    return Result("DXC compile failure: CreateBlobFromFile");
+  }
+
+  CComPtr<IDxcOperationResult> result;
+  std::wstring src_filename =
+      L"amber." + std::wstring(profile.begin(), profile.end());
+
+  IDxcCompiler* compiler = context->compiler;
   if (compiler->Compile(source,               /* source text */
                         src_filename.c_str(), /* original file source */
                         std::wstring(entry.begin(), entry.end())
@@ -132,47 +168,34 @@ Result Compile(const std::string& src,
                         dxc_flags.size(), /* argument count */
                         nullptr,          /* defines */
                         0,                /* define count */
-                        include_handler,  /* handler for #include */
+                        context->include_handler, /* handler for #include */
                         &result /* output status */) < 0) {
-    DxcCleanupThreadMalloc();
     return Result("DXC compile failure: Compile");
   }
 
-  // Compilation is done. We can clean up the HlslOptTable.
-  hlsl::options::cleanupHlslOptTable();
-
   // Get compilation results.
   HRESULT result_status;
-  if (result->GetStatus(&result_status) < 0) {
-    DxcCleanupThreadMalloc();
+  if (result->GetStatus(&result_status) < 0)
     return Result("DXC compile failure: GetStatus");
-  }
 
   // Get diagnostics string.
-  IDxcBlobEncoding* error_buffer;
-  if (result->GetErrorBuffer(&error_buffer)) {
-    DxcCleanupThreadMalloc();
+  CComPtr<IDxcBlobEncoding> error_buffer;
+  if (result->GetErrorBuffer(&error_buffer))
     return Result("DXC compile failure: GetErrorBuffer");
-  }
 
   const std::string diagnostics(
       static_cast<char*>(error_buffer->GetBufferPointer()),
       error_buffer->GetBufferSize());
 
-  bool success = true;
-  if (SUCCEEDED(result_status)) {
-    IDxcBlob* compiled_blob;
-    if (result->GetResult(&compiled_blob) < 0) {
-      DxcCleanupThreadMalloc();
-      return Result("DXC compile failure: GetResult");
-    }
-    ConvertIDxcBlobToUint32(compiled_blob, generated_binary);
-  } else {
-    success = false;
-  }
+  if (!SUCCEEDED(result_status))
+    return Result("DXC compile failure: " + diagnostics);
+
+  CComPtr<IDxcBlob> compiled_blob;
+  if (result->GetResult(&compiled_blob) < 0)
+    return Result("DXC compile failure: GetResult");
 
-  DxcCleanupThreadMalloc();
-  return success ? Result() : Result("DXC compile failure: " + diagnostics);
+  ConvertIDxcBlobToUint32(compiled_blob, generated_binary);
+  return {};
 }
 
 }  // namespace dxchelper
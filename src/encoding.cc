@@ -0,0 +1,124 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/encoding.h"
+
+namespace amber {
+namespace {
+
+const uint8_t kInvalidDigit = 0xff;
+
+bool IsSpace(char ch) {
+  return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n' || ch == '\f';
+}
+
+uint8_t Base64Digit(char ch) {
+  if (ch >= 'A' && ch <= 'Z')
+    return static_cast<uint8_t>(ch - 'A');
+  if (ch >= 'a' && ch <= 'z')
+    return static_cast<uint8_t>(ch - 'a' + 26);
+  if (ch >= '0' && ch <= '9')
+    return static_cast<uint8_t>(ch - '0' + 52);
+  if (ch == '+')
+    return 62;
+  if (ch == '/')
+    return 63;
+  return kInvalidDigit;
+}
+
+uint8_t HexDigit(char ch) {
+  if (ch >= '0' && ch <= '9')
+    return static_cast<uint8_t>(ch - '0');
+  if (ch >= 'a' && ch <= 'f')
+    return static_cast<uint8_t>(ch - 'a' + 10);
+  if (ch >= 'A' && ch <= 'F')
+    return static_cast<uint8_t>(ch - 'A' + 10);
+  return kInvalidDigit;
+}
+
+}  // namespace
+
+Result DecodeBase64(const std::string& text, std::vector<uint8_t>* data) {
+  data->clear();
+  data->reserve((text.size() / 4) * 3);
+
+  uint32_t quad = 0;
+  uint32_t quad_size = 0;
+  uint32_t padding = 0;
+  for (const char ch : text) {
+    if (IsSpace(ch))
+      continue;
+
+    if (ch == '=') {
+      // Padding may only fill the last one or two characters of a group.
+      if (quad_size < 2)
+        return Result("invalid base64 padding");
+
+      ++padding;
+      quad <<= 6;
+      ++quad_size;
+    } else {
+      if (padding > 0)
+        return Result("invalid base64 data after padding");
+
+      uint8_t digit = Base64Digit(ch);
+      if (digit == kInvalidDigit)
+        return Result("invalid base64 character: " + std::string(1, ch));
+
+      quad = (quad << 6) | digit;
+      ++quad_size;
+    }
+
+    if (quad_size == 4) {
+      data->push_back(static_cast<uint8_t>(quad >> 16));
+      if (padding < 2)
+        data->push_back(static_cast<uint8_t>(quad >> 8));
+      if (padding < 1)
+        data->push_back(static_cast<uint8_t>(quad));
+
+      quad = 0;
+      quad_size = 0;
+    }
+  }
+
+  if (quad_size != 0)
+    return Result("base64 data is not a multiple of 4 characters");
+
+  return {};
+}
+
+Result DecodeHex(const std::string& text, std::vector<uint8_t>* data) {
+  data->clear();
+  data->reserve(text.size() / 2);
+
+  for (size_t i = 0; i < text.size(); ++i) {
+    if (IsSpace(text[i]))
+      continue;
+
+    if (i + 1 >= text.size() || IsSpace(text[i + 1]))
+      return Result("hex data has an odd number of digits");
+
+    uint8_t high = HexDigit(text[i]);
+    uint8_t low = HexDigit(text[i + 1]);
+    if (high == kInvalidDigit || low == kInvalidDigit)
+      return Result("invalid hex byte: " + text.substr(i, 2));
+
+    data->push_back(static_cast<uint8_t>((high << 4) | low));
+    ++i;
+  }
+
+  return {};
+}
+
+}  // namespace amber
@@ -0,0 +1,36 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_ENCODING_H_
+#define SRC_ENCODING_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "amber/result.h"
+
+namespace amber {
+
+/// Decodes the standard base64 |text| into |data|. Whitespace in |text| is
+/// ignored and the text must be padded to a multiple of 4 characters.
+Result DecodeBase64(const std::string& text, std::vector<uint8_t>* data);
+
+/// Decodes |text|, pairs of hex digits giving one byte each, into |data|.
+/// Whitespace between bytes is ignored.
+Result DecodeHex(const std::string& text, std::vector<uint8_t>* data);
+
+}  // namespace amber
+
+#endif  // SRC_ENCODING_H_
@@ -0,0 +1,120 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/encoding.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace amber {
+namespace {
+
+struct Base64Case {
+  const char* text;
+  const char* expected;
+};
+
+}  // namespace
+
+using EncodingTest = testing::Test;
+
+TEST_F(EncodingTest, DecodeBase64) {
+  // Test vectors from RFC 4648.
+  Base64Case cases[] = {
+      {"", ""},
+      {"Zg==", "f"},
+      {"Zm8=", "fo"},
+      {"Zm9v", "foo"},
+      {"Zm9vYg==", "foob"},
+      {"Zm9vYmE=", "fooba"},
+      {"Zm9vYmFy", "foobar"},
+  };
+
+  for (const auto& c : cases) {
+    std::vector<uint8_t> data;
+    Result r = DecodeBase64(c.text, &data);
+    ASSERT_TRUE(r.IsSuccess()) << c.text << ": " << r.Error();
+    EXPECT_EQ(std::string(c.expected),
+              std::string(data.begin(), data.end()))
+        << c.text;
+  }
+}
+
+TEST_F(EncodingTest, DecodeBase64IgnoresWhitespace) {
+  std::vector<uint8_t> data;
+  Result r = DecodeBase64("  Zm9v\n  YmFy\t\n", &data);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+  EXPECT_EQ("foobar", std::string(data.begin(), data.end()));
+}
+
+TEST_F(EncodingTest, DecodeBase64Binary) {
+  std::vector<uint8_t> data;
+  Result r = DecodeBase64("AAH+/w==", &data);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+  ASSERT_EQ(4U, data.size());
+  EXPECT_EQ(0x00, data[0]);
+  EXPECT_EQ(0x01, data[1]);
+  EXPECT_EQ(0xfe, data[2]);
+  EXPECT_EQ(0xff, data[3]);
+}
+
+TEST_F(EncodingTest, DecodeBase64Errors) {
+  struct {
+    const char* text;
+    const char* error;
+  } cases[] = {
+      {"Zm9", "base64 data is not a multiple of 4 characters"},
+      {"Zm9*", "invalid base64 character: *"},
+      {"Z===", "invalid base64 padding"},
+      {"Zg==Zm9v", "invalid base64 data after padding"},
+  };
+
+  for (const auto& c : cases) {
+    std::vector<uint8_t> data;
+    Result r = DecodeBase64(c.text, &data);
+    ASSERT_FALSE(r.IsSuccess()) << c.text;
+    EXPECT_EQ(c.error, r.Error()) << c.text;
+  }
+}
+
+TEST_F(EncodingTest, DecodeHex) {
+  std::vector<uint8_t> data;
+  Result r = DecodeHex("00 01 7f\n80 Fe ff", &data);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+  std::vector<uint8_t> expected = {0x00, 0x01, 0x7f, 0x80, 0xfe, 0xff};
+  EXPECT_EQ(expected, data);
+}
+
+TEST_F(EncodingTest, DecodeHexPacked) {
+  std::vector<uint8_t> data;
+  Result r = DecodeHex("deadBEEF", &data);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+  std::vector<uint8_t> expected = {0xde, 0xad, 0xbe, 0xef};
+  EXPECT_EQ(expected, data);
+}
+
+TEST_F(EncodingTest, DecodeHexErrors) {
+  std::vector<uint8_t> data;
+  Result r = DecodeHex("00 1", &data);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("hex data has an odd number of digits", r.Error());
+
+  r = DecodeHex("00 1g", &data);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("invalid hex byte: 1g", r.Error());
+}
+
+}  // namespace amber
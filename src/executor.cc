@@ -15,6 +15,7 @@
 #include "src/executor.h"
 
 #include <cassert>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -22,8 +23,38 @@
 #include "src/make_unique.h"
 #include "src/script.h"
 #include "src/shader_compiler.h"
+#include "src/trace.h"
 
 namespace amber {
+namespace {
+
+Buffer* GetProbeBuffer(Command* cmd) {
+  if (cmd->IsProbe())
+    return cmd->AsProbe()->GetBuffer();
+  if (cmd->IsProbeSSBO())
+    return cmd->AsProbeSSBO()->GetBuffer();
+  return nullptr;
+}
+
+// Returns the number of commands, starting at |start|, which are probes of
+// the same kind on the same buffer. Probes only read the buffer, so they all
+// see the same contents and can be verified in one pass.
+size_t FusableProbeCount(const std::vector<std::unique_ptr<Command>>& cmds,
+                         size_t start) {
+  Command* first = cmds[start].get();
+  Buffer* buffer = GetProbeBuffer(first);
+  if (!buffer)
+    return 1;
+
+  size_t end = start + 1;
+  while (end < cmds.size() && cmds[end]->GetType() == first->GetType() &&
+         GetProbeBuffer(cmds[end].get()) == buffer) {
+    ++end;
+  }
+  return end - start;
+}
+
+}  // namespace
 
 Executor::Executor() = default;
 
@@ -32,11 +63,13 @@ Executor::~Executor() = default;
 Result Executor::CompileShaders(const amber::Script* script,
                                 const ShaderMap& shader_map,
                                 Options* options) {
+  TraceScope trace(options->delegate, "compile", "CompileShaders");
+  ShaderCompiler sc(script->GetSpvTargetEnv(),
+                    options->disable_spirv_validation);
+  sc.SetValidationCache(options->validation_cache);
   for (auto& pipeline : script->GetPipelines()) {
     for (auto& shader_info : pipeline->GetShaders()) {
-      ShaderCompiler sc(script->GetSpvTargetEnv(),
-                        options->disable_spirv_validation);
-
+      TraceScope shader_trace(options->delegate, "compile", "CompileShader");
       Result r;
       std::vector<uint32_t> data;
       std::tie(r, data) = sc.Compile(&shader_info, shader_map);
@@ -54,6 +87,8 @@ Result Executor::Execute(Engine* engine,
                          const ShaderMap& shader_map,
                          Options* options) {
   engine->SetEngineData(script->GetEngineData());
+  verifier_.SetThreadCount(options->verifier_thread_count);
+  verifier_.SetDelegate(options->delegate);
 
   if (!script->GetPipelines().empty()) {
     Result r = CompileShaders(script, shader_map, options);
@@ -81,19 +116,65 @@ Result Executor::Execute(Engine* engine,
     return {};
 
   // Process Commands
-  for (const auto& cmd : script->GetCommands()) {
-    if (options->delegate && options->delegate->LogExecuteCalls()) {
-      options->delegate->Log(std::to_string(cmd->GetLine()) + ": " +
-                             cmd->ToString());
+  return ExecuteCommands(engine, script->GetCommands(), options->delegate);
+}
+
+Result Executor::ExecuteCommands(
+    Engine* engine,
+    const std::vector<std::unique_ptr<Command>>& cmds,
+    Delegate* delegate) {
+  const bool log_execute_calls = delegate && delegate->LogExecuteCalls();
+
+  for (size_t i = 0; i < cmds.size();) {
+    size_t count = log_execute_calls ? 1 : FusableProbeCount(cmds, i);
+    if (count > 1) {
+      Result r = ExecuteProbes(cmds, i, count);
+      if (!r.IsSuccess())
+        return r;
+
+      i += count;
+      continue;
     }
 
+    const auto& cmd = cmds[i];
+    if (log_execute_calls)
+      delegate->Log(std::to_string(cmd->GetLine()) + ": " + cmd->ToString());
+
     Result r = ExecuteCommand(engine, cmd.get());
     if (!r.IsSuccess())
       return r;
+
+    ++i;
   }
   return {};
 }
 
+Result Executor::ExecuteProbes(
+    const std::vector<std::unique_ptr<Command>>& cmds,
+    size_t start,
+    size_t count) {
+  Buffer* buffer = GetProbeBuffer(cmds[start].get());
+  assert(buffer);
+
+  if (cmds[start]->IsProbe()) {
+    std::vector<const ProbeCommand*> probes;
+    for (size_t i = start; i < start + count; ++i)
+      probes.push_back(cmds[i]->AsProbe());
+
+    return verifier_.ProbeBatch(
+        probes, buffer->GetFormat(), buffer->GetElementStride(),
+        buffer->GetRowStride(), buffer->GetWidth(), buffer->GetHeight(),
+        buffer->GetRawData());
+  }
+
+  std::vector<const ProbeSSBOCommand*> probes;
+  for (size_t i = start; i < start + count; ++i)
+    probes.push_back(cmds[i]->AsProbeSSBO());
+
+  return verifier_.ProbeSSBOBatch(probes, buffer->ElementCount(),
+                                  buffer->GetRawData());
+}
+
 Result Executor::ExecuteCommand(Engine* engine, Command* cmd) {
   if (cmd->IsProbe()) {
     auto* buffer = cmd->AsProbe()->GetBuffer();
@@ -102,7 +183,7 @@ Result Executor::ExecuteCommand(Engine* engine, Command* cmd) {
     Format* fmt = buffer->GetFormat();
     return verifier_.Probe(cmd->AsProbe(), fmt, buffer->GetElementStride(),
                            buffer->GetRowStride(), buffer->GetWidth(),
-                           buffer->GetHeight(), buffer->ValuePtr()->data());
+                           buffer->GetHeight(), buffer->GetRawData());
   }
   if (cmd->IsProbeSSBO()) {
     auto probe_ssbo = cmd->AsProbeSSBO();
@@ -111,7 +192,7 @@ Result Executor::ExecuteCommand(Engine* engine, Command* cmd) {
     assert(buffer);
 
     return verifier_.ProbeSSBO(probe_ssbo, buffer->ElementCount(),
-                               buffer->ValuePtr()->data());
+                               buffer->GetRawData());
   }
   if (cmd->IsClear())
     return engine->DoClear(cmd->AsClear());
@@ -130,8 +211,16 @@ Result Executor::ExecuteCommand(Engine* engine, Command* cmd) {
         return buffer_1->CompareRMSE(buffer_2, compare->GetTolerance());
       case CompareBufferCommand::Comparator::kEq:
         return buffer_1->IsEqual(buffer_2);
+      case CompareBufferCommand::Comparator::kSsim:
+      case CompareBufferCommand::Comparator::kPsnr:
+      case CompareBufferCommand::Comparator::kMaxError:
+        return verifier_.CompareImages(compare);
     }
   }
+  if (cmd->IsCompareFile())
+    return verifier_.ProbeFile(cmd->AsCompareFile());
+  if (cmd->IsHashBuffer())
+    return verifier_.ProbeHash(cmd->AsHashBuffer());
   if (cmd->IsCopy()) {
     auto copy = cmd->AsCopy();
     auto buffer_from = copy->GetBufferFrom();
@@ -152,11 +241,10 @@ Result Executor::ExecuteCommand(Engine* engine, Command* cmd) {
     return engine->DoBuffer(cmd->AsBuffer());
   if (cmd->IsRepeat()) {
     for (uint32_t i = 0; i < cmd->AsRepeat()->GetCount(); ++i) {
-      for (const auto& sub_cmd : cmd->AsRepeat()->GetCommands()) {
-        Result r = ExecuteCommand(engine, sub_cmd.get());
-        if (!r.IsSuccess())
-          return r;
-      }
+      Result r =
+          ExecuteCommands(engine, cmd->AsRepeat()->GetCommands(), nullptr);
+      if (!r.IsSuccess())
+        return r;
     }
     return {};
   }
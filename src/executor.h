@@ -15,6 +15,9 @@
 #ifndef SRC_EXECUTOR_H_
 #define SRC_EXECUTOR_H_
 
+#include <memory>
+#include <vector>
+
 #include "amber/amber.h"
 #include "amber/result.h"
 #include "src/engine.h"
@@ -43,6 +46,17 @@ class Executor {
                         const ShaderMap& shader_map,
                         Options* options);
   Result ExecuteCommand(Engine* engine, Command* cmd);
+  // Executes |cmds| in order. Runs of probes on the same buffer are verified
+  // together with ExecuteProbes(). If |delegate| wants execute calls logged
+  // every command is logged and executed on its own.
+  Result ExecuteCommands(Engine* engine,
+                         const std::vector<std::unique_ptr<Command>>& cmds,
+                         Delegate* delegate);
+  // Verifies the |count| probes of |cmds| starting at |start|. All of the
+  // probes must be of the same kind and probe the same buffer.
+  Result ExecuteProbes(const std::vector<std::unique_ptr<Command>>& cmds,
+                       size_t start,
+                       size_t count);
 
   Verifier verifier_;
 };
@@ -81,8 +81,12 @@ uint32_t Format::SizeInBytes() const {
 }
 
 bool Format::Equal(const Format* b) const {
+  // Formats registered with a Script are interned, so equal formats from the
+  // same script are usually the same object.
+  if (this == b)
+    return true;
   return format_type_ == b->format_type_ && layout_ == b->layout_ &&
-         type_->Equal(b->type_);
+         (type_ == b->type_ || type_->Equal(b->type_));
 }
 
 uint32_t Format::InputNeededPerElement() const {
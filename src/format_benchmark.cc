@@ -0,0 +1,96 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/benchmark.h"
+#include "src/format.h"
+#include "src/type.h"
+#include "src/type_parser.h"
+
+namespace amber {
+namespace benchmark {
+namespace {
+
+const char* const kFormatNames[] = {
+    "R8G8B8A8_UNORM",      "B8G8R8A8_UNORM",      "R16G16_SFLOAT",
+    "R32G32B32_SFLOAT",    "R32G32B32A32_SFLOAT", "A2B10G10R10_UINT_PACK32",
+    "D24_UNORM_S8_UINT",   "R64G64_SFLOAT",       "R32G32B32_UINT",
+    "B10G11R11_UFLOAT_PACK32"};
+
+// Builds formats with std140 and std430 layouts, which computes their
+// segments and padding.
+void FormatLayout(State* state) {
+  TypeParser parser;
+  std::vector<std::unique_ptr<type::Type>> types;
+  for (const char* name : kFormatNames)
+    types.push_back(parser.Parse(name));
+
+  // Matrices and arrays, which need the most padding under std140.
+  for (uint32_t columns = 2; columns <= 4; ++columns) {
+    auto mat = type::Number::Float(32);
+    mat->SetRowCount(3);
+    mat->SetColumnCount(columns);
+    types.push_back(std::move(mat));
+  }
+  auto array = type::Number::Float(32);
+  array->SetRowCount(3);
+  array->SetIsSizedArray(16);
+  types.push_back(std::move(array));
+
+  for (const auto& type : types) {
+    if (!type) {
+      state->SetError(Result("unable to create format type"));
+      return;
+    }
+  }
+
+  while (state->KeepRunning()) {
+    uint32_t size = 0;
+    for (const auto& type : types) {
+      Format std430(type.get());
+      std430.SetLayout(Format::Layout::kStd430);
+      size += std430.SizeInBytes();
+
+      Format std140(type.get());
+      std140.SetLayout(Format::Layout::kStd140);
+      size += std140.SizeInBytes();
+    }
+    DoNotOptimize(size);
+  }
+  state->SetItemsPerIteration(2 * types.size());
+}
+
+void FormatParse(State* state) {
+  TypeParser parser;
+  while (state->KeepRunning()) {
+    for (const char* name : kFormatNames) {
+      auto type = parser.Parse(name);
+      DoNotOptimize(type);
+    }
+  }
+  state->SetItemsPerIteration(sizeof(kFormatNames) / sizeof(kFormatNames[0]));
+}
+
+}  // namespace
+
+void AddFormatBenchmarks(Runner* runner) {
+  runner->Add("Format/Layout", FormatLayout);
+  runner->Add("Format/Parse", FormatParse);
+}
+
+}  // namespace benchmark
+}  // namespace amber
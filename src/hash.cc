@@ -0,0 +1,216 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/hash.h"
+
+#include <cstring>
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif  // defined(__SSE4_2__)
+
+namespace amber {
+namespace {
+
+const uint64_t kPrime64_1 = 0x9E3779B185EBCA87ULL;
+const uint64_t kPrime64_2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t kPrime64_3 = 0x165667B19E3779F9ULL;
+const uint64_t kPrime64_4 = 0x85EBCA77C2B2AE63ULL;
+const uint64_t kPrime64_5 = 0x27D4EB2F165667C5ULL;
+
+// Reflected form of the Castagnoli polynomial.
+const uint32_t kCRC32CPolynomial = 0x82F63B78;
+
+// The data is read in host byte order. Like the rest of amber this assumes a
+// little endian host.
+uint64_t Read64(const uint8_t* p) {
+  uint64_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+uint32_t Read32(const uint8_t* p) {
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+uint64_t RotateLeft(uint64_t v, uint32_t bits) {
+  return (v << bits) | (v >> (64 - bits));
+}
+
+uint64_t XXH64Round(uint64_t acc, uint64_t input) {
+  acc += input * kPrime64_2;
+  acc = RotateLeft(acc, 31);
+  return acc * kPrime64_1;
+}
+
+uint64_t XXH64MergeRound(uint64_t acc, uint64_t val) {
+  acc ^= XXH64Round(0, val);
+  return acc * kPrime64_1 + kPrime64_4;
+}
+
+#if !defined(__SSE4_2__)
+// Tables for the slicing-by-8 CRC, which consumes 8 bytes per step.
+struct CRC32CTables {
+  CRC32CTables() {
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t crc = i;
+      for (uint32_t k = 0; k < 8; ++k)
+        crc = (crc >> 1) ^ ((crc & 1) ? kCRC32CPolynomial : 0);
+      table[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+      for (uint32_t t = 1; t < 8; ++t) {
+        table[t][i] =
+            (table[t - 1][i] >> 8) ^ table[0][table[t - 1][i] & 0xff];
+      }
+    }
+  }
+
+  uint32_t table[8][256];
+};
+
+const CRC32CTables& GetCRC32CTables() {
+  static const CRC32CTables tables;
+  return tables;
+}
+#endif  // !defined(__SSE4_2__)
+
+}  // namespace
+
+uint64_t XXH64(const void* data, size_t size, uint64_t seed) {
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+  const uint8_t* end = p + size;
+  uint64_t h64 = 0;
+
+  if (size >= 32) {
+    // Four independent accumulators so the stripes pipeline well.
+    uint64_t v1 = seed + kPrime64_1 + kPrime64_2;
+    uint64_t v2 = seed + kPrime64_2;
+    uint64_t v3 = seed;
+    uint64_t v4 = seed - kPrime64_1;
+
+    const uint8_t* limit = end - 32;
+    do {
+      v1 = XXH64Round(v1, Read64(p));
+      v2 = XXH64Round(v2, Read64(p + 8));
+      v3 = XXH64Round(v3, Read64(p + 16));
+      v4 = XXH64Round(v4, Read64(p + 24));
+      p += 32;
+    } while (p <= limit);
+
+    h64 = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) +
+          RotateLeft(v4, 18);
+    h64 = XXH64MergeRound(h64, v1);
+    h64 = XXH64MergeRound(h64, v2);
+    h64 = XXH64MergeRound(h64, v3);
+    h64 = XXH64MergeRound(h64, v4);
+  } else {
+    h64 = seed + kPrime64_5;
+  }
+
+  h64 += static_cast<uint64_t>(size);
+
+  while (p + 8 <= end) {
+    h64 ^= XXH64Round(0, Read64(p));
+    h64 = RotateLeft(h64, 27) * kPrime64_1 + kPrime64_4;
+    p += 8;
+  }
+  if (p + 4 <= end) {
+    h64 ^= static_cast<uint64_t>(Read32(p)) * kPrime64_1;
+    h64 = RotateLeft(h64, 23) * kPrime64_2 + kPrime64_3;
+    p += 4;
+  }
+  while (p < end) {
+    h64 ^= static_cast<uint64_t>(*p) * kPrime64_5;
+    h64 = RotateLeft(h64, 11) * kPrime64_1;
+    ++p;
+  }
+
+  h64 ^= h64 >> 33;
+  h64 *= kPrime64_2;
+  h64 ^= h64 >> 29;
+  h64 *= kPrime64_3;
+  h64 ^= h64 >> 32;
+  return h64;
+}
+
+uint32_t CRC32C(const void* data, size_t size, uint32_t crc) {
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+  const uint8_t* end = p + size;
+  crc = ~crc;
+
+#if defined(__SSE4_2__)
+  uint64_t crc64 = crc;
+  while (p + 8 <= end) {
+    crc64 = _mm_crc32_u64(crc64, Read64(p));
+    p += 8;
+  }
+  crc = static_cast<uint32_t>(crc64);
+  while (p < end) {
+    crc = _mm_crc32_u8(crc, *p);
+    ++p;
+  }
+#else   // defined(__SSE4_2__)
+  const auto& t = GetCRC32CTables().table;
+  while (p + 8 <= end) {
+    uint64_t v = Read64(p) ^ crc;
+    crc = t[7][v & 0xff] ^ t[6][(v >> 8) & 0xff] ^ t[5][(v >> 16) & 0xff] ^
+          t[4][(v >> 24) & 0xff] ^ t[3][(v >> 32) & 0xff] ^
+          t[2][(v >> 40) & 0xff] ^ t[1][(v >> 48) & 0xff] ^ t[0][v >> 56];
+    p += 8;
+  }
+  while (p < end) {
+    crc = (crc >> 8) ^ t[0][(crc ^ *p) & 0xff];
+    ++p;
+  }
+#endif  // defined(__SSE4_2__)
+
+  return ~crc;
+}
+
+uint64_t HashData(HashType type, const void* data, size_t size) {
+  switch (type) {
+    case HashType::kXXH64:
+      return XXH64(data, size);
+    case HashType::kCRC32C:
+      return CRC32C(data, size);
+  }
+  return 0;
+}
+
+std::string HashTypeToName(HashType type) {
+  switch (type) {
+    case HashType::kXXH64:
+      return "xxh64";
+    case HashType::kCRC32C:
+      return "crc32c";
+  }
+  return "";
+}
+
+bool NameToHashType(const std::string& name, HashType* type) {
+  if (name == "xxh64") {
+    *type = HashType::kXXH64;
+    return true;
+  }
+  if (name == "crc32c") {
+    *type = HashType::kCRC32C;
+    return true;
+  }
+  return false;
+}
+
+}  // namespace amber
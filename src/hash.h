@@ -0,0 +1,51 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_HASH_H_
+#define SRC_HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace amber {
+
+/// The content hashes which can be computed over buffer data.
+enum class HashType : uint8_t {
+  /// 64 bit xxHash, seed 0.
+  kXXH64 = 0,
+  /// 32 bit CRC using the Castagnoli polynomial.
+  kCRC32C,
+};
+
+/// Returns the 64 bit xxHash of the |size| bytes at |data| using |seed|.
+uint64_t XXH64(const void* data, size_t size, uint64_t seed = 0);
+
+/// Returns the CRC32C of the |size| bytes at |data|. The result of a previous
+/// call can be passed as |crc| to continue the checksum over more data.
+uint32_t CRC32C(const void* data, size_t size, uint32_t crc = 0);
+
+/// Returns the |type| hash of the |size| bytes at |data|.
+uint64_t HashData(HashType type, const void* data, size_t size);
+
+/// Returns the script name of |type|, e.g. "xxh64".
+std::string HashTypeToName(HashType type);
+
+/// Converts the script |name| of a hash into |type|. Returns false if |name|
+/// is not a known hash.
+bool NameToHashType(const std::string& name, HashType* type);
+
+}  // namespace amber
+
+#endif  // SRC_HASH_H_
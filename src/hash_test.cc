@@ -0,0 +1,75 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/hash.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace amber {
+
+using HashTest = testing::Test;
+
+TEST_F(HashTest, XXH64) {
+  EXPECT_EQ(0xEF46DB3751D8E999ULL, XXH64("", 0));
+  EXPECT_EQ(0xD24EC4F1A98C6E5BULL, XXH64("a", 1));
+  EXPECT_EQ(0x44BC2CF5AD770999ULL, XXH64("abc", 3));
+
+  std::string str = "Nobody inspects the spammish repetition";
+  EXPECT_EQ(0xFBCEA83C8A378BF1ULL, XXH64(str.data(), str.size()));
+}
+
+TEST_F(HashTest, CRC32C) {
+  EXPECT_EQ(0U, CRC32C("", 0));
+  EXPECT_EQ(0xE3069283U, CRC32C("123456789", 9));
+
+  // Test vectors from RFC 3720, B.4.
+  std::vector<uint8_t> data(32, 0);
+  EXPECT_EQ(0x8A9136AAU, CRC32C(data.data(), data.size()));
+
+  data.assign(32, 0xff);
+  EXPECT_EQ(0x62A8AB43U, CRC32C(data.data(), data.size()));
+
+  for (uint8_t i = 0; i < 32; ++i)
+    data[i] = i;
+  EXPECT_EQ(0x46DD794EU, CRC32C(data.data(), data.size()));
+}
+
+TEST_F(HashTest, CRC32CContinues) {
+  std::string str = "123456789";
+  uint32_t crc = CRC32C(str.data(), 4);
+  EXPECT_EQ(0xE3069283U, CRC32C(str.data() + 4, str.size() - 4, crc));
+}
+
+TEST_F(HashTest, HashData) {
+  EXPECT_EQ(0x44BC2CF5AD770999ULL, HashData(HashType::kXXH64, "abc", 3));
+  EXPECT_EQ(0xE3069283ULL, HashData(HashType::kCRC32C, "123456789", 9));
+}
+
+TEST_F(HashTest, Names) {
+  HashType type = HashType::kXXH64;
+  ASSERT_TRUE(NameToHashType("crc32c", &type));
+  EXPECT_EQ(HashType::kCRC32C, type);
+  EXPECT_EQ("crc32c", HashTypeToName(type));
+
+  ASSERT_TRUE(NameToHashType("xxh64", &type));
+  EXPECT_EQ(HashType::kXXH64, type);
+  EXPECT_EQ("xxh64", HashTypeToName(type));
+
+  EXPECT_FALSE(NameToHashType("md5", &type));
+}
+
+}  // namespace amber
@@ -0,0 +1,434 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/image_converter.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace amber {
+namespace {
+
+const uint8_t kBitsPerByte = 8;
+
+// Convert float |value| whose size is 16 bits to 32 bits float
+// based on IEEE-754.
+float HexFloat16ToFloat(const uint8_t* value) {
+  uint32_t sign = (static_cast<uint32_t>(value[1]) & 0x80) << 24U;
+  uint32_t exponent = (((static_cast<uint32_t>(value[1]) & 0x7c) >> 2U) + 112U)
+                      << 23U;
+  uint32_t mantissa = ((static_cast<uint32_t>(value[1]) & 0x3) << 8U |
+                       static_cast<uint32_t>(value[0]))
+                      << 13U;
+
+  uint32_t hex = sign | exponent | mantissa;
+  float* hex_float = reinterpret_cast<float*>(&hex);
+  return *hex_float;
+}
+
+// Convert float |value| whose size is 11 bits to 32 bits float
+// based on IEEE-754.
+float HexFloat11ToFloat(const uint8_t* value) {
+  uint32_t exponent = (((static_cast<uint32_t>(value[1]) << 2U) |
+                        ((static_cast<uint32_t>(value[0]) & 0xc0) >> 6U)) +
+                       112U)
+                      << 23U;
+  uint32_t mantissa = (static_cast<uint32_t>(value[0]) & 0x3f) << 17U;
+
+  uint32_t hex = exponent | mantissa;
+  float* hex_float = reinterpret_cast<float*>(&hex);
+  return *hex_float;
+}
+
+// Convert float |value| whose size is 10 bits to 32 bits float
+// based on IEEE-754.
+float HexFloat10ToFloat(const uint8_t* value) {
+  uint32_t exponent = (((static_cast<uint32_t>(value[1]) << 3U) |
+                        ((static_cast<uint32_t>(value[0]) & 0xe0) >> 5U)) +
+                       112U)
+                      << 23U;
+  uint32_t mantissa = (static_cast<uint32_t>(value[0]) & 0x1f) << 18U;
+
+  uint32_t hex = exponent | mantissa;
+  float* hex_float = reinterpret_cast<float*>(&hex);
+  return *hex_float;
+}
+
+// Where one component of a source texel lives and which RGBA output channels
+// it feeds.
+struct ComponentPlan {
+  uint32_t channels[3];
+  uint32_t channel_count;
+  uint8_t bit_offset;
+  uint32_t num_bits;
+  FormatMode mode;
+};
+
+double UnsignedNormalizer(uint32_t num_bits) {
+  return static_cast<double>((uint64_t(1) << num_bits) - 1);
+}
+
+// Decodes the component described by |plan| out of |texel|.
+double DecodeComponent(const uint8_t* texel, const ComponentPlan& plan) {
+  uint8_t raw[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+  CopyBitsOfMemoryToBuffer(raw, texel, plan.bit_offset, plan.num_bits);
+
+  switch (plan.mode) {
+    case FormatMode::kSFloat:
+    case FormatMode::kUFloat: {
+      if (plan.num_bits == 32) {
+        float value = 0;
+        std::memcpy(&value, raw, sizeof(value));
+        return static_cast<double>(value);
+      }
+      if (plan.num_bits == 64) {
+        double value = 0;
+        std::memcpy(&value, raw, sizeof(value));
+        return value;
+      }
+      return static_cast<double>(
+          HexFloatToFloat(raw, static_cast<uint8_t>(plan.num_bits)));
+    }
+    case FormatMode::kSInt:
+    case FormatMode::kSNorm:
+    case FormatMode::kSScaled: {
+      uint64_t bits = 0;
+      std::memcpy(&bits, raw, sizeof(bits));
+      if (plan.num_bits < 64 && ((bits >> (plan.num_bits - 1)) & 1U) != 0)
+        bits |= ~uint64_t(0) << plan.num_bits;
+
+      double value = static_cast<double>(static_cast<int64_t>(bits));
+      if (plan.mode == FormatMode::kSNorm) {
+        // The most negative value maps to -1 as well as its successor.
+        value = std::max(value / UnsignedNormalizer(plan.num_bits - 1), -1.0);
+      }
+      return value;
+    }
+    case FormatMode::kUNorm:
+    case FormatMode::kSRGB:
+    case FormatMode::kUInt:
+    case FormatMode::kUScaled:
+      break;
+  }
+
+  uint64_t bits = 0;
+  std::memcpy(&bits, raw, sizeof(bits));
+  double value = static_cast<double>(bits);
+  if (plan.mode == FormatMode::kUNorm || plan.mode == FormatMode::kSRGB)
+    value /= UnsignedNormalizer(plan.num_bits);
+  return value;
+}
+
+// Appends the component |name| stored at |bit_offset| to |plan|. Depth is
+// replicated into R, G and B so depth attachments show up as a grey scale
+// image. Stencil and unused components are skipped.
+void AddComponent(FormatComponentType name,
+                  FormatMode mode,
+                  uint32_t bit_offset,
+                  uint32_t num_bits,
+                  std::vector<ComponentPlan>* plan) {
+  ComponentPlan component;
+  component.channel_count = 1;
+  component.bit_offset = static_cast<uint8_t>(bit_offset);
+  component.num_bits = num_bits;
+  component.mode = mode;
+
+  switch (name) {
+    case FormatComponentType::kR:
+      component.channels[0] = 0;
+      break;
+    case FormatComponentType::kG:
+      component.channels[0] = 1;
+      break;
+    case FormatComponentType::kB:
+      component.channels[0] = 2;
+      break;
+    case FormatComponentType::kA:
+      component.channels[0] = 3;
+      break;
+    case FormatComponentType::kD:
+      component.channels[0] = 0;
+      component.channels[1] = 1;
+      component.channels[2] = 2;
+      component.channel_count = 3;
+      break;
+    case FormatComponentType::kX:
+    case FormatComponentType::kS:
+      return;
+  }
+  plan->push_back(component);
+}
+
+// Builds the list of components to decode from each texel of |format|.
+std::vector<ComponentPlan> BuildComponentPlan(const Format* format) {
+  std::vector<ComponentPlan> plan;
+
+  // A packed format is a single segment, the components come from the type.
+  // The first component named holds the most significant bits.
+  const type::Type* type = format->GetType();
+  if (type->IsList() && type->AsList()->IsPacked()) {
+    const auto& members = type->AsList()->Members();
+    uint32_t bit_offset = 0;
+    for (auto it = members.rbegin(); it != members.rend(); ++it) {
+      AddComponent(it->name, it->mode, bit_offset, it->num_bits, &plan);
+      bit_offset += it->num_bits;
+    }
+    return plan;
+  }
+
+  uint32_t bit_offset = 0;
+  for (const auto& seg : format->GetSegments()) {
+    if (!seg.IsPadding()) {
+      AddComponent(seg.GetName(), seg.GetFormatMode(), bit_offset,
+                   seg.GetNumBits(), &plan);
+    }
+    bit_offset += seg.GetNumBits();
+  }
+  return plan;
+}
+
+// True if texels of |type| are already laid out as |output|. sRGB attachments
+// keep their encoded values, so they match as well.
+bool MatchesOutputLayout(FormatType type, ImageDataFormat output) {
+  switch (output) {
+    case ImageDataFormat::kB8G8R8A8Unorm:
+      return type == FormatType::kB8G8R8A8_UNORM ||
+             type == FormatType::kB8G8R8A8_SRGB;
+    case ImageDataFormat::kR8G8B8A8Unorm:
+      return type == FormatType::kR8G8B8A8_UNORM ||
+             type == FormatType::kR8G8B8A8_SRGB;
+    case ImageDataFormat::kR16G16B16A16Unorm:
+      return type == FormatType::kR16G16B16A16_UNORM;
+    case ImageDataFormat::kR32G32B32A32Sfloat:
+      return type == FormatType::kR32G32B32A32_SFLOAT;
+  }
+  return false;
+}
+
+// True if |type| is an 8-bit four component format in the opposite red/blue
+// order from the 8-bit |output|.
+bool IsSwizzledByteLayout(FormatType type, ImageDataFormat output) {
+  if (output == ImageDataFormat::kB8G8R8A8Unorm) {
+    return type == FormatType::kR8G8B8A8_UNORM ||
+           type == FormatType::kR8G8B8A8_SRGB;
+  }
+  if (output == ImageDataFormat::kR8G8B8A8Unorm) {
+    return type == FormatType::kB8G8R8A8_UNORM ||
+           type == FormatType::kB8G8R8A8_SRGB;
+  }
+  return false;
+}
+
+double Clamp01(double value) {
+  // NaN compares false and falls through to 0.
+  if (value >= 1.0)
+    return 1.0;
+  if (value > 0.0)
+    return value;
+  return 0.0;
+}
+
+void EncodePixel(const double* rgba, ImageDataFormat output, uint8_t* dst) {
+  switch (output) {
+    case ImageDataFormat::kB8G8R8A8Unorm:
+      dst[0] = static_cast<uint8_t>(Clamp01(rgba[2]) * 255.0 + 0.5);
+      dst[1] = static_cast<uint8_t>(Clamp01(rgba[1]) * 255.0 + 0.5);
+      dst[2] = static_cast<uint8_t>(Clamp01(rgba[0]) * 255.0 + 0.5);
+      dst[3] = static_cast<uint8_t>(Clamp01(rgba[3]) * 255.0 + 0.5);
+      return;
+    case ImageDataFormat::kR8G8B8A8Unorm:
+      for (size_t i = 0; i < 4; ++i)
+        dst[i] = static_cast<uint8_t>(Clamp01(rgba[i]) * 255.0 + 0.5);
+      return;
+    case ImageDataFormat::kR16G16B16A16Unorm:
+      for (size_t i = 0; i < 4; ++i) {
+        uint16_t value =
+            static_cast<uint16_t>(Clamp01(rgba[i]) * 65535.0 + 0.5);
+        std::memcpy(dst + i * sizeof(value), &value, sizeof(value));
+      }
+      return;
+    case ImageDataFormat::kR32G32B32A32Sfloat:
+      for (size_t i = 0; i < 4; ++i) {
+        float value = static_cast<float>(rgba[i]);
+        std::memcpy(dst + i * sizeof(value), &value, sizeof(value));
+      }
+      return;
+  }
+}
+
+}  // namespace
+
+// Copy [src_bit_offset, src_bit_offset + bits) bits of |src| to
+// [0, bits) of |dst|.
+void CopyBitsOfMemoryToBuffer(uint8_t* dst,
+                              const uint8_t* src,
+                              uint8_t src_bit_offset,
+                              uint32_t bits) {
+  while (src_bit_offset > static_cast<uint8_t>(7)) {
+    ++src;
+    src_bit_offset = static_cast<uint8_t>(src_bit_offset - kBitsPerByte);
+  }
+
+  // Number of bytes greater than or equal to |(src_bit_offset + bits) / 8|.
+  const uint8_t size_in_bytes =
+      static_cast<uint8_t>((src_bit_offset + bits + 7) / kBitsPerByte);
+  assert(size_in_bytes <= static_cast<uint8_t>(kBitsPerByte));
+
+  uint64_t data = 0;
+  uint8_t* ptr = reinterpret_cast<uint8_t*>(&data);
+  for (uint8_t i = 0; i < size_in_bytes; ++i) {
+    ptr[i] = src[i];
+  }
+
+  data >>= src_bit_offset;
+  if (bits != 64)
+    data &= (1ULL << bits) - 1ULL;
+
+  std::memcpy(dst, &data, static_cast<size_t>((bits + 7) / kBitsPerByte));
+}
+
+// Convert float |value| whose size is |bits| bits to 32 bits float
+// based on IEEE-754.
+// See https://www.khronos.org/opengl/wiki/Small_Float_Formats
+// and https://en.wikipedia.org/wiki/IEEE_754.
+//
+//    Sign Exponent Mantissa Exponent-Bias
+// 16    1        5       10            15
+// 11    0        5        6            15
+// 10    0        5        5            15
+// 32    1        8       23           127
+// 64    1       11       52          1023
+//
+// 11 and 10 bits floats are always positive.
+// 14 bits float is used only RGB9_E5 format in OpenGL but it does not exist
+// in Vulkan.
+float HexFloatToFloat(const uint8_t* value, uint8_t bits) {
+  switch (bits) {
+    case 10:
+      return HexFloat10ToFloat(value);
+    case 11:
+      return HexFloat11ToFloat(value);
+    case 16:
+      return HexFloat16ToFloat(value);
+  }
+
+  assert(false && "Invalid bits");
+  return 0;
+}
+
+// This is based on "18.3. sRGB transfer functions" of
+// https://www.khronos.org/registry/DataFormat/specs/1.2/dataformat.1.2.html
+double SRGBToLinearValue(double sRGB) {
+  if (sRGB <= 0.04045)
+    return sRGB / 12.92;
+
+  return pow((sRGB + 0.055) / 1.055, 2.4);
+}
+
+uint32_t ImageDataFormatSizeInBytes(ImageDataFormat format) {
+  switch (format) {
+    case ImageDataFormat::kB8G8R8A8Unorm:
+    case ImageDataFormat::kR8G8B8A8Unorm:
+      return 4;
+    case ImageDataFormat::kR16G16B16A16Unorm:
+      return 8;
+    case ImageDataFormat::kR32G32B32A32Sfloat:
+      return 16;
+  }
+  return 0;
+}
+
+Result ConvertImage(const Format* format,
+                    const uint8_t* data,
+                    uint32_t width,
+                    uint32_t height,
+                    uint32_t row_stride,
+                    ImageDataFormat output,
+                    std::vector<uint8_t>* out) {
+  out->clear();
+  if (!format || format->GetSegments().empty())
+    return Result("ConvertImage missing image format");
+  if (!data)
+    return Result("ConvertImage missing image data");
+
+  const size_t texel_size = format->SizeInBytes();
+  if (size_t(row_stride) < texel_size * width)
+    return Result("ConvertImage row stride is smaller than a row of texels");
+
+  const size_t pixel_size = ImageDataFormatSizeInBytes(output);
+  const size_t out_row_size = pixel_size * width;
+  out->resize(out_row_size * height);
+  uint8_t* dst = out->data();
+
+  FormatType type = format->GetFormatType();
+  if (MatchesOutputLayout(type, output)) {
+    if (row_stride == out_row_size) {
+      std::memcpy(dst, data, out_row_size * height);
+    } else {
+      for (uint32_t y = 0; y < height; ++y) {
+        std::memcpy(dst + y * out_row_size, data + size_t(y) * row_stride,
+                    out_row_size);
+      }
+    }
+    return {};
+  }
+
+  if (IsSwizzledByteLayout(type, output)) {
+    for (uint32_t y = 0; y < height; ++y) {
+      const uint8_t* src_row = data + size_t(y) * row_stride;
+      uint8_t* dst_row = dst + y * out_row_size;
+      for (size_t x = 0; x < out_row_size; x += 4) {
+        dst_row[x] = src_row[x + 2];
+        dst_row[x + 1] = src_row[x + 1];
+        dst_row[x + 2] = src_row[x];
+        dst_row[x + 3] = src_row[x + 3];
+      }
+    }
+    return {};
+  }
+
+  std::vector<ComponentPlan> plan = BuildComponentPlan(format);
+  if (plan.empty()) {
+    out->clear();
+    return Result("ConvertImage format has no color or depth components");
+  }
+
+  bool has_alpha = false;
+  for (const auto& component : plan) {
+    if (component.channels[0] == 3)
+      has_alpha = true;
+  }
+
+  for (uint32_t y = 0; y < height; ++y) {
+    const uint8_t* texel = data + size_t(y) * row_stride;
+    uint8_t* dst_pixel = dst + y * out_row_size;
+    for (uint32_t x = 0; x < width; ++x) {
+      double rgba[4] = {0.0, 0.0, 0.0, has_alpha ? 0.0 : 1.0};
+      for (const auto& component : plan) {
+        double value = DecodeComponent(texel, component);
+        for (uint32_t i = 0; i < component.channel_count; ++i)
+          rgba[component.channels[i]] = value;
+      }
+      EncodePixel(rgba, output, dst_pixel);
+
+      texel += texel_size;
+      dst_pixel += pixel_size;
+    }
+  }
+  return {};
+}
+
+}  // namespace amber
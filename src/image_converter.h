@@ -0,0 +1,63 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_IMAGE_CONVERTER_H_
+#define SRC_IMAGE_CONVERTER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "amber/amber.h"
+#include "amber/result.h"
+#include "src/format.h"
+
+namespace amber {
+
+/// Copy [src_bit_offset, src_bit_offset + bits) bits of |src| to
+/// [0, bits) of |dst|.
+void CopyBitsOfMemoryToBuffer(uint8_t* dst,
+                              const uint8_t* src,
+                              uint8_t src_bit_offset,
+                              uint32_t bits);
+
+/// Convert float |value| whose size is |bits| bits to 32 bits float
+/// based on IEEE-754. |bits| must be 10, 11 or 16.
+float HexFloatToFloat(const uint8_t* value, uint8_t bits);
+
+/// Converts an sRGB encoded value in [0, 1] to a linear value.
+double SRGBToLinearValue(double sRGB);
+
+/// Returns the number of bytes used by one pixel of |format|.
+uint32_t ImageDataFormatSizeInBytes(ImageDataFormat format);
+
+/// Converts the |width| x |height| image at |data|, whose texels are laid out
+/// as |format| with |row_stride| bytes between rows, into tightly packed
+/// |output| pixels stored in |out|.
+///
+/// Missing color components are zero and a missing alpha is one. Normalized
+/// components are scaled into [0, 1] or [-1, 1]; sRGB components keep their
+/// encoded value so the output looks like the attachment did. Integer
+/// components are passed through as their numeric value. All values are
+/// clamped to [0, 1] before being written to a normalized output.
+Result ConvertImage(const Format* format,
+                    const uint8_t* data,
+                    uint32_t width,
+                    uint32_t height,
+                    uint32_t row_stride,
+                    ImageDataFormat output,
+                    std::vector<uint8_t>* out);
+
+}  // namespace amber
+
+#endif  // SRC_IMAGE_CONVERTER_H_
@@ -0,0 +1,187 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/image_converter.h"
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/format.h"
+#include "src/type_parser.h"
+
+namespace amber {
+
+using ImageConverterTest = testing::Test;
+
+TEST_F(ImageConverterTest, SameLayoutIsCopied) {
+  TypeParser parser;
+  auto type = parser.Parse("B8G8R8A8_UNORM");
+  Format fmt(type.get());
+
+  // Two rows of two pixels with four bytes of row padding.
+  std::vector<uint8_t> data = {1,  2,  3,  4,  5,  6,  7,  8,  0, 0, 0, 0,
+                               11, 12, 13, 14, 15, 16, 17, 18, 0, 0, 0, 0};
+  std::vector<uint8_t> out;
+  Result r = ConvertImage(&fmt, data.data(), 2, 2, 12,
+                          ImageDataFormat::kB8G8R8A8Unorm, &out);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  std::vector<uint8_t> expected = {1,  2,  3,  4,  5,  6,  7,  8,
+                                   11, 12, 13, 14, 15, 16, 17, 18};
+  EXPECT_EQ(expected, out);
+}
+
+TEST_F(ImageConverterTest, SwizzlesRedAndBlue) {
+  TypeParser parser;
+  auto type = parser.Parse("R8G8B8A8_UNORM");
+  Format fmt(type.get());
+
+  std::vector<uint8_t> data = {1, 2, 3, 4, 5, 6, 7, 8};
+  std::vector<uint8_t> out;
+  Result r = ConvertImage(&fmt, data.data(), 2, 1, 8,
+                          ImageDataFormat::kB8G8R8A8Unorm, &out);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  std::vector<uint8_t> expected = {3, 2, 1, 4, 7, 6, 5, 8};
+  EXPECT_EQ(expected, out);
+}
+
+TEST_F(ImageConverterTest, FloatToUnorm8) {
+  TypeParser parser;
+  auto type = parser.Parse("R32G32B32A32_SFLOAT");
+  Format fmt(type.get());
+
+  float data[4] = {1.0f, 0.5f, -2.0f, 4.0f};
+  std::vector<uint8_t> out;
+  Result r = ConvertImage(&fmt, reinterpret_cast<const uint8_t*>(data), 1, 1,
+                          16, ImageDataFormat::kR8G8B8A8Unorm, &out);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  std::vector<uint8_t> expected = {255, 128, 0, 255};
+  EXPECT_EQ(expected, out);
+}
+
+TEST_F(ImageConverterTest, HalfFloatToFloat) {
+  TypeParser parser;
+  auto type = parser.Parse("R16G16_SFLOAT");
+  Format fmt(type.get());
+
+  // 2.5 and -1.0 as half floats.
+  uint8_t data[4] = {0x00, 0x41, 0x00, 0xbc};
+  std::vector<uint8_t> out;
+  Result r = ConvertImage(&fmt, data, 1, 1, 4,
+                          ImageDataFormat::kR32G32B32A32Sfloat, &out);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+  ASSERT_EQ(16U, out.size());
+
+  float pixel[4];
+  std::memcpy(pixel, out.data(), sizeof(pixel));
+  EXPECT_FLOAT_EQ(2.5f, pixel[0]);
+  EXPECT_FLOAT_EQ(-1.0f, pixel[1]);
+  EXPECT_FLOAT_EQ(0.0f, pixel[2]);
+  EXPECT_FLOAT_EQ(1.0f, pixel[3]);
+}
+
+TEST_F(ImageConverterTest, PackedToUnorm16) {
+  TypeParser parser;
+  auto type = parser.Parse("A2B10G10R10_UNORM_PACK32");
+  Format fmt(type.get());
+
+  // R = 1023, G = 0, B = 1023, A = 0.
+  uint32_t texel = 1023U | (1023U << 20U);
+  uint8_t data[4];
+  std::memcpy(data, &texel, sizeof(texel));
+
+  std::vector<uint8_t> out;
+  Result r = ConvertImage(&fmt, data, 1, 1, 4,
+                          ImageDataFormat::kR16G16B16A16Unorm, &out);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+  ASSERT_EQ(8U, out.size());
+
+  uint16_t pixel[4];
+  std::memcpy(pixel, out.data(), sizeof(pixel));
+  EXPECT_EQ(65535U, pixel[0]);
+  EXPECT_EQ(0U, pixel[1]);
+  EXPECT_EQ(65535U, pixel[2]);
+  EXPECT_EQ(0U, pixel[3]);
+}
+
+TEST_F(ImageConverterTest, SnormAndMissingComponents) {
+  TypeParser parser;
+  auto type = parser.Parse("R8G8_SNORM");
+  Format fmt(type.get());
+
+  uint8_t data[4] = {0x7f, 0x80, 0x00, 0xc1};
+  std::vector<uint8_t> out;
+  Result r = ConvertImage(&fmt, data, 2, 1, 4,
+                          ImageDataFormat::kR32G32B32A32Sfloat, &out);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+  ASSERT_EQ(32U, out.size());
+
+  float pixels[8];
+  std::memcpy(pixels, out.data(), sizeof(pixels));
+  EXPECT_FLOAT_EQ(1.0f, pixels[0]);
+  EXPECT_FLOAT_EQ(-1.0f, pixels[1]);
+  EXPECT_FLOAT_EQ(0.0f, pixels[2]);
+  EXPECT_FLOAT_EQ(1.0f, pixels[3]);
+  EXPECT_FLOAT_EQ(0.0f, pixels[4]);
+  EXPECT_FLOAT_EQ(-63.0f / 127.0f, pixels[5]);
+}
+
+TEST_F(ImageConverterTest, DepthIsGreyScale) {
+  TypeParser parser;
+  auto type = parser.Parse("D32_SFLOAT");
+  Format fmt(type.get());
+
+  float data = 0.5f;
+  std::vector<uint8_t> out;
+  Result r = ConvertImage(&fmt, reinterpret_cast<const uint8_t*>(&data), 1, 1,
+                          4, ImageDataFormat::kB8G8R8A8Unorm, &out);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  std::vector<uint8_t> expected = {128, 128, 128, 255};
+  EXPECT_EQ(expected, out);
+}
+
+TEST_F(ImageConverterTest, RowStrideTooSmall) {
+  TypeParser parser;
+  auto type = parser.Parse("R8G8B8A8_UNORM");
+  Format fmt(type.get());
+
+  std::vector<uint8_t> data(8);
+  std::vector<uint8_t> out;
+  Result r = ConvertImage(&fmt, data.data(), 2, 1, 4,
+                          ImageDataFormat::kB8G8R8A8Unorm, &out);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("ConvertImage row stride is smaller than a row of texels",
+            r.Error());
+}
+
+TEST_F(ImageConverterTest, HexFloatToFloat) {
+  uint8_t half[2] = {0x00, 0x3c};
+  EXPECT_FLOAT_EQ(1.0f, HexFloatToFloat(half, 16));
+
+  // 11 bit float 1.0: exponent 15, mantissa 0.
+  uint8_t f11[2] = {0xc0, 0x03};
+  EXPECT_FLOAT_EQ(1.0f, HexFloatToFloat(f11, 11));
+}
+
+TEST_F(ImageConverterTest, SRGBToLinearValue) {
+  EXPECT_DOUBLE_EQ(0.0, SRGBToLinearValue(0.0));
+  EXPECT_DOUBLE_EQ(1.0, SRGBToLinearValue(1.0));
+  EXPECT_NEAR(0.214041, SRGBToLinearValue(0.5), 0.000001);
+}
+
+}  // namespace amber
@@ -0,0 +1,217 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/image_metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "src/image_converter.h"
+#include "src/parallel.h"
+
+namespace amber {
+namespace {
+
+const uint32_t kTileSize = 8;
+const uint32_t kComponents = 4;
+const uint32_t kColorComponents = 3;
+
+// The stabilising constants of SSIM for a dynamic range of 1.
+const double kSSIMC1 = 0.01 * 0.01;
+const double kSSIMC2 = 0.03 * 0.03;
+
+// Sums over one row of tiles, kept apart so they can be added up in the same
+// order whatever the thread count.
+struct TileRowSums {
+  double squared_error = 0.0;
+  double ssim = 0.0;
+  double max_abs_error[4] = {0.0, 0.0, 0.0, 0.0};
+};
+
+// Converts both images to R32G32B32A32_SFLOAT.
+Result ConvertPair(const Format* format,
+                   const uint8_t* image_1,
+                   const uint8_t* image_2,
+                   uint32_t width,
+                   uint32_t height,
+                   std::vector<uint8_t>* out_1,
+                   std::vector<uint8_t>* out_2) {
+  if (width == 0 || height == 0)
+    return Result("image has no pixels");
+  if (!format)
+    return Result("missing image format");
+
+  uint32_t row_stride = width * format->SizeInBytes();
+  Result r = ConvertImage(format, image_1, width, height, row_stride,
+                          ImageDataFormat::kR32G32B32A32Sfloat, out_1);
+  if (!r.IsSuccess())
+    return r;
+  return ConvertImage(format, image_2, width, height, row_stride,
+                      ImageDataFormat::kR32G32B32A32Sfloat, out_2);
+}
+
+void SumTileRow(const float* pixels_1,
+                const float* pixels_2,
+                uint32_t width,
+                uint32_t y_begin,
+                uint32_t y_end,
+                TileRowSums* sums) {
+  for (uint32_t x_begin = 0; x_begin < width; x_begin += kTileSize) {
+    uint32_t x_end = std::min(width, x_begin + kTileSize);
+
+    double sum_1[kColorComponents] = {0.0, 0.0, 0.0};
+    double sum_2[kColorComponents] = {0.0, 0.0, 0.0};
+    double sum_11[kColorComponents] = {0.0, 0.0, 0.0};
+    double sum_22[kColorComponents] = {0.0, 0.0, 0.0};
+    double sum_12[kColorComponents] = {0.0, 0.0, 0.0};
+
+    for (uint32_t y = y_begin; y < y_end; ++y) {
+      size_t row = size_t(y) * width;
+      for (uint32_t x = x_begin; x < x_end; ++x) {
+        const float* p1 = pixels_1 + (row + x) * kComponents;
+        const float* p2 = pixels_2 + (row + x) * kComponents;
+        for (uint32_t c = 0; c < kComponents; ++c) {
+          double a = static_cast<double>(p1[c]);
+          double b = static_cast<double>(p2[c]);
+          double diff = std::fabs(a - b);
+          // NaN or infinite texels are as different as it gets. Left as NaN
+          // they would drop out of the max and pass every threshold.
+          if (!std::isfinite(diff))
+            diff = std::numeric_limits<double>::infinity();
+          sums->max_abs_error[c] = std::max(sums->max_abs_error[c], diff);
+          if (c == kColorComponents)
+            continue;
+
+          sums->squared_error += diff * diff;
+          sum_1[c] += a;
+          sum_2[c] += b;
+          sum_11[c] += a * a;
+          sum_22[c] += b * b;
+          sum_12[c] += a * b;
+        }
+      }
+    }
+
+    double count = static_cast<double>((x_end - x_begin) * (y_end - y_begin));
+    for (uint32_t c = 0; c < kColorComponents; ++c) {
+      double mean_1 = sum_1[c] / count;
+      double mean_2 = sum_2[c] / count;
+      double var_1 = sum_11[c] / count - mean_1 * mean_1;
+      double var_2 = sum_22[c] / count - mean_2 * mean_2;
+      double covar = sum_12[c] / count - mean_1 * mean_2;
+      double numerator =
+          (2.0 * mean_1 * mean_2 + kSSIMC1) * (2.0 * covar + kSSIMC2);
+      double denominator = (mean_1 * mean_1 + mean_2 * mean_2 + kSSIMC1) *
+                           (var_1 + var_2 + kSSIMC2);
+      sums->ssim += numerator / denominator;
+    }
+  }
+}
+
+}  // namespace
+
+Result ComputeImageMetrics(const Format* format,
+                           const uint8_t* image_1,
+                           const uint8_t* image_2,
+                           uint32_t width,
+                           uint32_t height,
+                           uint32_t thread_count,
+                           ImageMetrics* metrics) {
+  std::vector<uint8_t> converted_1;
+  std::vector<uint8_t> converted_2;
+  Result r = ConvertPair(format, image_1, image_2, width, height, &converted_1,
+                         &converted_2);
+  if (!r.IsSuccess())
+    return r;
+
+  const float* pixels_1 = reinterpret_cast<const float*>(converted_1.data());
+  const float* pixels_2 = reinterpret_cast<const float*>(converted_2.data());
+
+  uint32_t tile_rows = (height + kTileSize - 1) / kTileSize;
+  std::vector<TileRowSums> rows(tile_rows);
+  ParallelFor(thread_count, tile_rows, 1,
+              [&](uint32_t, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                  uint32_t y_begin = static_cast<uint32_t>(i) * kTileSize;
+                  uint32_t y_end = std::min(height, y_begin + kTileSize);
+                  SumTileRow(pixels_1, pixels_2, width, y_begin, y_end,
+                             &rows[i]);
+                }
+              });
+
+  *metrics = ImageMetrics();
+  double squared_error = 0.0;
+  double ssim = 0.0;
+  for (const auto& row : rows) {
+    squared_error += row.squared_error;
+    ssim += row.ssim;
+    for (uint32_t c = 0; c < kComponents; ++c) {
+      metrics->max_abs_error[c] =
+          std::max(metrics->max_abs_error[c], row.max_abs_error[c]);
+    }
+  }
+
+  uint32_t tiles_per_row = (width + kTileSize - 1) / kTileSize;
+  metrics->mse = squared_error / (static_cast<double>(width) * height *
+                                  kColorComponents);
+  metrics->psnr = metrics->mse > 0.0
+                      ? 10.0 * std::log10(1.0 / metrics->mse)
+                      : std::numeric_limits<double>::infinity();
+  metrics->ssim = ssim / (static_cast<double>(tiles_per_row) * tile_rows *
+                          kColorComponents);
+  return {};
+}
+
+Result MakeDifferenceHeatmap(const Format* format,
+                             const uint8_t* image_1,
+                             const uint8_t* image_2,
+                             uint32_t width,
+                             uint32_t height,
+                             std::vector<uint8_t>* out) {
+  std::vector<uint8_t> converted_1;
+  std::vector<uint8_t> converted_2;
+  Result r = ConvertPair(format, image_1, image_2, width, height, &converted_1,
+                         &converted_2);
+  if (!r.IsSuccess())
+    return r;
+
+  const float* pixels_1 = reinterpret_cast<const float*>(converted_1.data());
+  const float* pixels_2 = reinterpret_cast<const float*>(converted_2.data());
+
+  size_t pixel_count = size_t(width) * height;
+  out->resize(pixel_count * kComponents);
+  for (size_t i = 0; i < pixel_count; ++i) {
+    double diff = 0.0;
+    for (uint32_t c = 0; c < kComponents; ++c) {
+      double d = std::fabs(static_cast<double>(pixels_1[i * kComponents + c]) -
+                           static_cast<double>(pixels_2[i * kComponents + c]));
+      // NaN fails every comparison and shows up as the largest difference.
+      if (!(d <= 1.0))
+        d = 1.0;
+      diff = std::max(diff, d);
+    }
+
+    uint8_t* pixel = out->data() + i * kComponents;
+    // The square root stretches small differences so they stay visible.
+    double t = std::sqrt(diff);
+    pixel[0] = static_cast<uint8_t>(t * 255.0 + 0.5);
+    pixel[1] = 0;
+    pixel[2] = diff > 0.0 ? static_cast<uint8_t>((1.0 - t) * 255.0 + 0.5) : 0;
+    pixel[3] = 255;
+  }
+  return {};
+}
+
+}  // namespace amber
@@ -0,0 +1,68 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_IMAGE_METRICS_H_
+#define SRC_IMAGE_METRICS_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "amber/result.h"
+#include "src/format.h"
+
+namespace amber {
+
+/// Similarity measures between two images of the same format and size.
+/// Components are compared after conversion by ConvertImage(), so normalized
+/// formats are compared in [0, 1].
+struct ImageMetrics {
+  /// The largest absolute difference of each of the R, G, B and A components.
+  /// Infinite when a component is NaN or infinite in either image.
+  double max_abs_error[4] = {0.0, 0.0, 0.0, 0.0};
+  /// The mean squared error of the R, G and B components.
+  double mse = 0.0;
+  /// The peak signal to noise ratio in dB for a peak value of 1. Infinite
+  /// when the images are identical.
+  double psnr = 0.0;
+  /// The mean structural similarity of the R, G and B components over
+  /// non-overlapping 8x8 tiles. 1 when the images are identical, NaN when a
+  /// texel is not finite, so threshold checks must be written to fail on NaN.
+  double ssim = 0.0;
+};
+
+/// Compares the |width| x |height| images at |image_1| and |image_2|, whose
+/// tightly packed texels are laid out as |format|, and stores the result in
+/// |metrics|. Rows of tiles are split across up to |thread_count| threads;
+/// the result does not depend on the thread count.
+Result ComputeImageMetrics(const Format* format,
+                           const uint8_t* image_1,
+                           const uint8_t* image_2,
+                           uint32_t width,
+                           uint32_t height,
+                           uint32_t thread_count,
+                           ImageMetrics* metrics);
+
+/// Builds a R8G8B8A8 heatmap of the differences between the images, as for
+/// ComputeImageMetrics(), into |out|. Identical pixels are black, others run
+/// from blue for tiny differences to red for the largest possible one.
+Result MakeDifferenceHeatmap(const Format* format,
+                             const uint8_t* image_1,
+                             const uint8_t* image_2,
+                             uint32_t width,
+                             uint32_t height,
+                             std::vector<uint8_t>* out);
+
+}  // namespace amber
+
+#endif  // SRC_IMAGE_METRICS_H_
@@ -0,0 +1,206 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/image_metrics.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/format.h"
+#include "src/type_parser.h"
+
+namespace amber {
+namespace {
+
+// A 16x16 R8G8B8A8 gradient.
+std::vector<uint8_t> MakeGradient() {
+  std::vector<uint8_t> data;
+  for (uint32_t y = 0; y < 16; ++y) {
+    for (uint32_t x = 0; x < 16; ++x) {
+      data.push_back(static_cast<uint8_t>(x * 16));
+      data.push_back(static_cast<uint8_t>(y * 16));
+      data.push_back(static_cast<uint8_t>((x + y) * 8));
+      data.push_back(255);
+    }
+  }
+  return data;
+}
+
+}  // namespace
+
+using ImageMetricsTest = testing::Test;
+
+TEST_F(ImageMetricsTest, Identical) {
+  TypeParser parser;
+  auto type = parser.Parse("R8G8B8A8_UNORM");
+  Format fmt(type.get());
+
+  std::vector<uint8_t> image = MakeGradient();
+  ImageMetrics metrics;
+  Result r = ComputeImageMetrics(&fmt, image.data(), image.data(), 16, 16, 1,
+                                 &metrics);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  EXPECT_DOUBLE_EQ(0.0, metrics.mse);
+  EXPECT_TRUE(std::isinf(metrics.psnr));
+  EXPECT_NEAR(1.0, metrics.ssim, 1e-9);
+  for (uint32_t c = 0; c < 4; ++c)
+    EXPECT_DOUBLE_EQ(0.0, metrics.max_abs_error[c]);
+}
+
+TEST_F(ImageMetricsTest, SinglePixelDifference) {
+  TypeParser parser;
+  auto type = parser.Parse("R8G8B8A8_UNORM");
+  Format fmt(type.get());
+
+  std::vector<uint8_t> image_1 = MakeGradient();
+  std::vector<uint8_t> image_2 = image_1;
+  // Green of pixel (3, 2) is off by 51, 0.2 once normalized.
+  const size_t green = (2 * 16 + 3) * 4 + 1;
+  image_2[green] = static_cast<uint8_t>(image_2[green] + 51);
+
+  ImageMetrics metrics;
+  Result r = ComputeImageMetrics(&fmt, image_1.data(), image_2.data(), 16, 16,
+                                 1, &metrics);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  EXPECT_DOUBLE_EQ(0.0, metrics.max_abs_error[0]);
+  EXPECT_NEAR(0.2, metrics.max_abs_error[1], 1e-6);
+  EXPECT_DOUBLE_EQ(0.0, metrics.max_abs_error[2]);
+  EXPECT_DOUBLE_EQ(0.0, metrics.max_abs_error[3]);
+
+  double mse = 0.2 * 0.2 / (16.0 * 16.0 * 3.0);
+  EXPECT_NEAR(mse, metrics.mse, 1e-9);
+  EXPECT_NEAR(10.0 * std::log10(1.0 / mse), metrics.psnr, 1e-4);
+  EXPECT_LT(metrics.ssim, 1.0);
+  EXPECT_GT(metrics.ssim, 0.9);
+}
+
+TEST_F(ImageMetricsTest, ThreadCountDoesNotChangeResult) {
+  TypeParser parser;
+  auto type = parser.Parse("R8G8B8A8_UNORM");
+  Format fmt(type.get());
+
+  std::vector<uint8_t> image_1 = MakeGradient();
+  std::vector<uint8_t> image_2 = image_1;
+  for (size_t i = 0; i < image_2.size(); i += 7)
+    image_2[i] = static_cast<uint8_t>(image_2[i] ^ 0x15);
+
+  ImageMetrics single;
+  ImageMetrics threaded;
+  ASSERT_TRUE(ComputeImageMetrics(&fmt, image_1.data(), image_2.data(), 16, 16,
+                                  1, &single)
+                  .IsSuccess());
+  ASSERT_TRUE(ComputeImageMetrics(&fmt, image_1.data(), image_2.data(), 16, 16,
+                                  4, &threaded)
+                  .IsSuccess());
+
+  EXPECT_EQ(single.mse, threaded.mse);
+  EXPECT_EQ(single.ssim, threaded.ssim);
+  EXPECT_EQ(single.psnr, threaded.psnr);
+}
+
+TEST_F(ImageMetricsTest, StructureChangeLowersSSIM) {
+  TypeParser parser;
+  auto type = parser.Parse("R8G8B8A8_UNORM");
+  Format fmt(type.get());
+
+  std::vector<uint8_t> image_1 = MakeGradient();
+  // The same mean brightness shift on every pixel keeps the structure, a
+  // flipped image does not.
+  std::vector<uint8_t> shifted = image_1;
+  std::vector<uint8_t> flipped = image_1;
+  for (size_t i = 0; i < shifted.size(); ++i) {
+    if (i % 4 != 3)
+      shifted[i] = static_cast<uint8_t>(std::min(255, shifted[i] + 4));
+  }
+  for (uint32_t y = 0; y < 16; ++y) {
+    for (uint32_t x = 0; x < 16 * 4; ++x)
+      flipped[y * 64 + x] = image_1[(15 - y) * 64 + x];
+  }
+
+  ImageMetrics shifted_metrics;
+  ImageMetrics flipped_metrics;
+  ASSERT_TRUE(ComputeImageMetrics(&fmt, image_1.data(), shifted.data(), 16, 16,
+                                  1, &shifted_metrics)
+                  .IsSuccess());
+  ASSERT_TRUE(ComputeImageMetrics(&fmt, image_1.data(), flipped.data(), 16, 16,
+                                  1, &flipped_metrics)
+                  .IsSuccess());
+  EXPECT_GT(shifted_metrics.ssim, flipped_metrics.ssim);
+}
+
+TEST_F(ImageMetricsTest, NonFiniteTexelsFail) {
+  TypeParser parser;
+  auto type = parser.Parse("R32G32B32A32_SFLOAT");
+  Format fmt(type.get());
+
+  const float values[] = {std::numeric_limits<float>::quiet_NaN(),
+                          std::numeric_limits<float>::infinity()};
+  for (float value : values) {
+    std::vector<float> image_1(16 * 4, 0.5f);
+    std::vector<float> image_2 = image_1;
+    image_2[5 * 4] = value;
+
+    ImageMetrics metrics;
+    Result r = ComputeImageMetrics(
+        &fmt, reinterpret_cast<const uint8_t*>(image_1.data()),
+        reinterpret_cast<const uint8_t*>(image_2.data()), 4, 4, 1, &metrics);
+    ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+    EXPECT_TRUE(std::isinf(metrics.max_abs_error[0]));
+    EXPECT_DOUBLE_EQ(0.0, metrics.max_abs_error[1]);
+    EXPECT_TRUE(std::isinf(metrics.mse));
+    EXPECT_FALSE(metrics.psnr >= 0.0);
+    EXPECT_FALSE(metrics.ssim >= 0.0);
+  }
+}
+
+TEST_F(ImageMetricsTest, NoPixels) {
+  TypeParser parser;
+  auto type = parser.Parse("R8G8B8A8_UNORM");
+  Format fmt(type.get());
+
+  uint8_t pixel[4] = {0, 0, 0, 0};
+  ImageMetrics metrics;
+  Result r = ComputeImageMetrics(&fmt, pixel, pixel, 0, 1, 1, &metrics);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("image has no pixels", r.Error());
+}
+
+TEST_F(ImageMetricsTest, Heatmap) {
+  TypeParser parser;
+  auto type = parser.Parse("R8G8B8A8_UNORM");
+  Format fmt(type.get());
+
+  uint8_t image_1[12] = {0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255};
+  uint8_t image_2[12] = {0, 0, 0, 255, 1, 0, 0, 255, 255, 0, 0, 255};
+  std::vector<uint8_t> heatmap;
+  Result r = MakeDifferenceHeatmap(&fmt, image_1, image_2, 3, 1, &heatmap);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+  ASSERT_EQ(12U, heatmap.size());
+
+  // Identical is black, a tiny difference is mostly blue and the largest
+  // difference is red.
+  EXPECT_EQ(0U, heatmap[0]);
+  EXPECT_EQ(0U, heatmap[2]);
+  EXPECT_LT(heatmap[4], heatmap[6]);
+  EXPECT_EQ(255U, heatmap[8]);
+  EXPECT_EQ(0U, heatmap[10]);
+  EXPECT_EQ(255U, heatmap[11]);
+}
+
+}  // namespace amber
@@ -0,0 +1,85 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/mapped_file.h"
+
+#include <utility>
+
+#include "src/platform.h"
+
+#if AMBER_PLATFORM_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+namespace amber {
+
+MappedFile::MappedFile(const std::string& path) : path_(path) {}
+
+MappedFile::~MappedFile() {
+#if AMBER_PLATFORM_POSIX
+  if (is_mapped_)
+    munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+}
+
+// static
+Result MappedFile::Open(const std::string& path,
+                        std::unique_ptr<MappedFile>* file) {
+  std::unique_ptr<MappedFile> mapped(new MappedFile(path));
+
+#if AMBER_PLATFORM_POSIX
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return Result("unable to open file: " + path);
+
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    close(fd);
+    return Result("unable to read size of file: " + path);
+  }
+
+  mapped->size_ = static_cast<size_t>(info.st_size);
+  // mmap rejects zero length mappings, an empty file is just an empty view.
+  if (mapped->size_ > 0) {
+    void* ptr = mmap(nullptr, mapped->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (ptr == MAP_FAILED) {
+      close(fd);
+      return Result("unable to map file: " + path);
+    }
+    mapped->data_ = static_cast<const uint8_t*>(ptr);
+    mapped->is_mapped_ = true;
+  }
+  close(fd);
+#else
+  std::ifstream in(path, std::ios::in | std::ios::binary);
+  if (!in.is_open())
+    return Result("unable to open file: " + path);
+
+  mapped->contents_.assign(std::istreambuf_iterator<char>(in),
+                           std::istreambuf_iterator<char>());
+  mapped->data_ = mapped->contents_.data();
+  mapped->size_ = mapped->contents_.size();
+#endif
+
+  *file = std::move(mapped);
+  return {};
+}
+
+}  // namespace amber
@@ -0,0 +1,55 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_MAPPED_FILE_H_
+#define SRC_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "amber/result.h"
+
+namespace amber {
+
+/// A read-only view of the contents of a file. On POSIX platforms the file is
+/// memory mapped, so the contents are paged in on demand and never copied.
+/// Elsewhere the contents are read into memory.
+class MappedFile {
+ public:
+  /// Opens |path| and stores the resulting mapping in |file|.
+  static Result Open(const std::string& path,
+                     std::unique_ptr<MappedFile>* file);
+
+  ~MappedFile();
+
+  const std::string& GetPath() const { return path_; }
+  const uint8_t* GetData() const { return data_; }
+  size_t GetSize() const { return size_; }
+
+ private:
+  explicit MappedFile(const std::string& path);
+
+  std::string path_;
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  bool is_mapped_ = false;
+  std::vector<uint8_t> contents_;
+};
+
+}  // namespace amber
+
+#endif  // SRC_MAPPED_FILE_H_
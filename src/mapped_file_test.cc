@@ -0,0 +1,74 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/mapped_file.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace amber {
+
+using MappedFileTest = testing::Test;
+
+TEST_F(MappedFileTest, Open) {
+  std::string path = testing::TempDir() + "amber_mapped_file_test.bin";
+  {
+    std::ofstream out(path, std::ios::out | std::ios::binary);
+    ASSERT_TRUE(out.is_open());
+    out << std::string("\x01\x02\x00\xff", 4);
+  }
+
+  std::unique_ptr<MappedFile> file;
+  Result r = MappedFile::Open(path, &file);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+  ASSERT_EQ(4U, file->GetSize());
+  EXPECT_EQ(path, file->GetPath());
+  EXPECT_EQ(0x01, file->GetData()[0]);
+  EXPECT_EQ(0x02, file->GetData()[1]);
+  EXPECT_EQ(0x00, file->GetData()[2]);
+  EXPECT_EQ(0xff, file->GetData()[3]);
+
+  file = nullptr;
+  std::remove(path.c_str());
+}
+
+TEST_F(MappedFileTest, OpenEmpty) {
+  std::string path = testing::TempDir() + "amber_mapped_file_empty_test.bin";
+  {
+    std::ofstream out(path, std::ios::out | std::ios::binary);
+    ASSERT_TRUE(out.is_open());
+  }
+
+  std::unique_ptr<MappedFile> file;
+  Result r = MappedFile::Open(path, &file);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+  EXPECT_EQ(0U, file->GetSize());
+
+  file = nullptr;
+  std::remove(path.c_str());
+}
+
+TEST_F(MappedFileTest, OpenMissing) {
+  std::string path = testing::TempDir() + "amber_mapped_file_missing.bin";
+
+  std::unique_ptr<MappedFile> file;
+  Result r = MappedFile::Open(path, &file);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ("unable to open file: " + path, r.Error());
+}
+
+}  // namespace amber
@@ -0,0 +1,65 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/parallel.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace amber {
+
+uint32_t ParallelChunkCount(uint32_t thread_count,
+                            size_t count,
+                            size_t min_items_per_chunk) {
+  if (thread_count <= 1 || count == 0)
+    return 1;
+
+  size_t max_chunks = count / std::max(min_items_per_chunk, size_t(1));
+  return static_cast<uint32_t>(
+      std::max(size_t(1), std::min(static_cast<size_t>(thread_count),
+                                   max_chunks)));
+}
+
+void ParallelFor(uint32_t thread_count,
+                 size_t count,
+                 size_t min_items_per_chunk,
+                 const std::function<void(uint32_t, size_t, size_t)>& fn) {
+  uint32_t chunks =
+      ParallelChunkCount(thread_count, count, min_items_per_chunk);
+  if (chunks == 1) {
+    fn(0, 0, count);
+    return;
+  }
+
+  size_t per_chunk = count / chunks;
+  size_t remainder = count % chunks;
+
+  // The first |remainder| chunks take one extra item each.
+  std::vector<size_t> bounds(chunks + 1, 0);
+  for (uint32_t i = 0; i < chunks; ++i)
+    bounds[i + 1] = bounds[i] + per_chunk + (i < remainder ? 1 : 0);
+
+  std::vector<std::thread> workers;
+  workers.reserve(chunks - 1);
+  for (uint32_t i = 1; i < chunks; ++i)
+    workers.emplace_back(fn, i, bounds[i], bounds[i + 1]);
+
+  fn(0, bounds[0], bounds[1]);
+
+  for (auto& worker : workers)
+    worker.join();
+}
+
+}  // namespace amber
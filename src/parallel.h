@@ -0,0 +1,43 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_PARALLEL_H_
+#define SRC_PARALLEL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace amber {
+
+/// Returns the number of chunks ParallelFor() will split |count| items into
+/// when given |thread_count| threads and at least |min_items_per_chunk| items
+/// per chunk. Always returns at least 1.
+uint32_t ParallelChunkCount(uint32_t thread_count,
+                            size_t count,
+                            size_t min_items_per_chunk);
+
+/// Splits [0, |count|) into ParallelChunkCount() contiguous chunks and calls
+/// |fn| with (chunk index, begin, end) for each of them. Chunk 0 runs on the
+/// calling thread, the others on worker threads. Chunks are ordered, so chunk
+/// |i| always covers lower indices than chunk |i + 1|. Returns once all the
+/// chunks have completed.
+void ParallelFor(uint32_t thread_count,
+                 size_t count,
+                 size_t min_items_per_chunk,
+                 const std::function<void(uint32_t, size_t, size_t)>& fn);
+
+}  // namespace amber
+
+#endif  // SRC_PARALLEL_H_
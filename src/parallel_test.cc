@@ -0,0 +1,71 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/parallel.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace amber {
+
+using ParallelTest = testing::Test;
+
+TEST_F(ParallelTest, ChunkCount) {
+  EXPECT_EQ(1U, ParallelChunkCount(0, 100, 1));
+  EXPECT_EQ(1U, ParallelChunkCount(1, 100, 1));
+  EXPECT_EQ(1U, ParallelChunkCount(8, 0, 1));
+  EXPECT_EQ(8U, ParallelChunkCount(8, 100, 1));
+  EXPECT_EQ(4U, ParallelChunkCount(8, 100, 25));
+  EXPECT_EQ(1U, ParallelChunkCount(8, 100, 1000));
+}
+
+TEST_F(ParallelTest, SingleThread) {
+  std::vector<size_t> calls;
+  ParallelFor(1, 10, 1, [&calls](uint32_t chunk, size_t begin, size_t end) {
+    calls.push_back(chunk);
+    calls.push_back(begin);
+    calls.push_back(end);
+  });
+
+  ASSERT_EQ(3U, calls.size());
+  EXPECT_EQ(0U, calls[0]);
+  EXPECT_EQ(0U, calls[1]);
+  EXPECT_EQ(10U, calls[2]);
+}
+
+TEST_F(ParallelTest, CoversRangeInOrder) {
+  const uint32_t kThreads = 4;
+  std::vector<size_t> begins(kThreads, 0);
+  std::vector<size_t> ends(kThreads, 0);
+  std::vector<uint32_t> hits(103, 0);
+
+  ParallelFor(kThreads, hits.size(), 1,
+              [&](uint32_t chunk, size_t begin, size_t end) {
+                begins[chunk] = begin;
+                ends[chunk] = end;
+                for (size_t i = begin; i < end; ++i)
+                  hits[i] += 1;
+              });
+
+  EXPECT_EQ(0U, begins[0]);
+  for (uint32_t i = 1; i < kThreads; ++i)
+    EXPECT_EQ(ends[i - 1], begins[i]);
+  EXPECT_EQ(hits.size(), ends[kThreads - 1]);
+
+  for (size_t i = 0; i < hits.size(); ++i)
+    EXPECT_EQ(1U, hits[i]) << "index " << i;
+}
+
+}  // namespace amber
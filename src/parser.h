@@ -15,6 +15,7 @@
 #ifndef SRC_PARSER_H_
 #define SRC_PARSER_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
@@ -33,6 +34,10 @@ class Parser {
   /// completes correctly.
   virtual Result Parse(const std::string& data) = 0;
 
+  /// Sets the number of threads used to generate the contents of large
+  /// buffers. A value of 0 or 1 generates them on the calling thread.
+  void SetThreadCount(uint32_t count) { thread_count_ = count; }
+
   /// Retrieve the script which is generated by the parser.
   std::unique_ptr<Script> GetScript() { return std::move(script_); }
 
@@ -40,6 +45,7 @@ class Parser {
   Parser();
 
   std::unique_ptr<Script> script_;
+  uint32_t thread_count_ = 1;
 };
 
 }  // namespace amber
@@ -0,0 +1,56 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "src/amberscript/parser.h"
+#include "src/benchmark.h"
+#include "src/benchmark_data.h"
+#include "src/vkscript/parser.h"
+
+namespace amber {
+namespace benchmark {
+namespace {
+
+void ParseAmberScript(State* state) {
+  std::string script = GenerateAmberScript(16, 1024);
+  while (state->KeepRunning()) {
+    amberscript::Parser parser;
+    Result r = parser.Parse(script);
+    if (!r.IsSuccess())
+      state->SetError(r);
+  }
+  state->SetBytesPerIteration(script.size());
+}
+
+void ParseVkScript(State* state) {
+  std::string script = GenerateVkScript(16 * 1024, 4096);
+  while (state->KeepRunning()) {
+    vkscript::Parser parser;
+    Result r = parser.Parse(script);
+    if (!r.IsSuccess())
+      state->SetError(r);
+  }
+  state->SetBytesPerIteration(script.size());
+}
+
+}  // namespace
+
+void AddParserBenchmarks(Runner* runner) {
+  runner->Add("Parser/AmberScript", ParseAmberScript);
+  runner->Add("Parser/VkScript", ParseVkScript);
+}
+
+}  // namespace benchmark
+}  // namespace amber
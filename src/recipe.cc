@@ -31,6 +31,13 @@ std::vector<ShaderInfo> Recipe::GetShaderInfo() const {
   return impl_->GetShaderInfo();
 }
 
+std::vector<std::vector<std::string>> Recipe::GetShaderOptimizations(
+    const std::string& shader_name) const {
+  if (!impl_)
+    return {};
+  return impl_->GetShaderOptimizations(shader_name);
+}
+
 std::vector<std::string> Recipe::GetRequiredFeatures() const {
   return impl_ ? impl_->GetRequiredFeatures() : std::vector<std::string>();
 }
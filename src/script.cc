@@ -14,7 +14,51 @@
 
 #include "src/script.h"
 
+#include <algorithm>
+
 namespace amber {
+namespace {
+
+// Returns a key which is equal for two types exactly when they have the same
+// structure. Unlike type::Type::Equal this includes the vector, matrix and
+// array dimensions.
+std::string TypeKey(const type::Type* type) {
+  std::string key = std::to_string(type->RowCount()) + "x" +
+                    std::to_string(type->ColumnCount());
+  if (type->IsArray())
+    key += "[" + std::to_string(type->ArraySize()) + "]";
+
+  if (type->IsNumber()) {
+    const auto* number = type->AsNumber();
+    key += " n" + std::to_string(static_cast<int>(number->GetFormatMode())) +
+           ":" + std::to_string(number->NumBits());
+  } else if (type->IsList()) {
+    const auto* list = type->AsList();
+    key += " l" + std::to_string(list->PackSizeInBits()) + "(";
+    for (const auto& member : list->Members()) {
+      key += std::to_string(static_cast<int>(member.name)) + "," +
+             std::to_string(static_cast<int>(member.mode)) + "," +
+             std::to_string(member.num_bits) + ";";
+    }
+    key += ")";
+  } else if (type->IsStruct()) {
+    const auto* st = type->AsStruct();
+    key += " s";
+    if (st->HasStride())
+      key += std::to_string(st->StrideInBytes());
+    key += "{";
+    for (const auto& member : st->Members()) {
+      key += std::to_string(member.offset_in_bytes) + "," +
+             std::to_string(member.array_stride_in_bytes) + "," +
+             std::to_string(member.matrix_stride_in_bytes) + ":" +
+             TypeKey(member.type) + ";";
+    }
+    key += "}";
+  }
+  return key;
+}
+
+}  // namespace
 
 Script::Script() = default;
 
@@ -26,14 +70,34 @@ std::vector<ShaderInfo> Script::GetShaderInfo() const {
     // TODO(dsinclair): The name returned should be the
     // `pipeline_name + shader_name` instead of just shader name when we have
     // pipelines everywhere
-
-    // TODO(dsinclair): The optimization passes should be retrieved from the
-    // pipeline and returned here instead of an empty array.
+    auto optimizations = GetShaderOptimizations(shader->GetName());
     ret.emplace_back(ShaderInfo{shader->GetFormat(),
                                 shader->GetType(),
                                 shader->GetName(),
                                 shader->GetData(),
-                                {}});
+                                optimizations.empty()
+                                    ? std::vector<std::string>()
+                                    : std::move(optimizations[0])});
+  }
+  return ret;
+}
+
+std::vector<std::vector<std::string>> Script::GetShaderOptimizations(
+    const std::string& shader_name) const {
+  std::vector<std::vector<std::string>> ret;
+  const Shader* shader = GetShader(shader_name);
+  if (!shader)
+    return ret;
+
+  for (const auto& pipeline : pipelines_) {
+    for (const auto& info : pipeline->GetShaders()) {
+      if (info.GetShader() != shader)
+        continue;
+
+      const auto& passes = info.GetShaderOptimizations();
+      if (std::find(ret.begin(), ret.end(), passes) == ret.end())
+        ret.push_back(passes);
+    }
   }
   return ret;
 }
@@ -89,4 +153,26 @@ bool Script::IsKnownFeature(const std::string& name) const {
          name == "VariablePointerFeatures.variablePointersStorageBuffer";
 }
 
+Format* Script::RegisterFormat(std::unique_ptr<Format> fmt) {
+  auto key = std::make_tuple(static_cast<const type::Type*>(fmt->GetType()),
+                             fmt->GetLayout(), fmt->GetFormatType());
+  auto it = interned_formats_.find(key);
+  if (it != interned_formats_.end())
+    return it->second;
+
+  formats_.push_back(std::move(fmt));
+  interned_formats_[key] = formats_.back().get();
+  return formats_.back().get();
+}
+
+type::Type* Script::RegisterType(std::unique_ptr<type::Type> type) {
+  auto& interned = interned_types_[TypeKey(type.get())];
+  if (interned)
+    return interned;
+
+  types_.push_back(std::move(type));
+  interned = types_.back().get();
+  return interned;
+}
+
 }  // namespace amber
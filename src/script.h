@@ -19,6 +19,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -44,6 +45,11 @@ class Script : public RecipeImpl {
   /// Retrieves information on the shaders in the given script.
   std::vector<ShaderInfo> GetShaderInfo() const override;
 
+  /// Returns the distinct optimization passes of the pipelines attaching the
+  /// shader |shader_name|.
+  std::vector<std::vector<std::string>> GetShaderOptimizations(
+      const std::string& shader_name) const override;
+
   /// Returns required features in the given recipe.
   std::vector<std::string> GetRequiredFeatures() const override {
     return engine_info_.required_features;
@@ -171,17 +177,18 @@ class Script : public RecipeImpl {
   /// Retrieves the SPIR-V target environment.
   const std::string& GetSpvTargetEnv() const { return spv_env_; }
 
-  /// Assign ownership of the format to the script.
-  Format* RegisterFormat(std::unique_ptr<Format> fmt) {
-    formats_.push_back(std::move(fmt));
-    return formats_.back().get();
-  }
+  /// Assign ownership of the format to the script. Formats are interned, if
+  /// the script already holds a format with the same type, layout and format
+  /// type then |fmt| is destroyed and that format is returned. The type of
+  /// |fmt| should be registered first, so equal formats share a type. The
+  /// returned format must not be changed.
+  Format* RegisterFormat(std::unique_ptr<Format> fmt);
 
-  /// Assigns ownership of the type to the script.
-  type::Type* RegisterType(std::unique_ptr<type::Type> type) {
-    types_.push_back(std::move(type));
-    return types_.back().get();
-  }
+  /// Assigns ownership of the type to the script. Types are interned, if the
+  /// script already holds a type of the same structure then |type| is
+  /// destroyed and that type is returned. The returned type must not be
+  /// changed.
+  type::Type* RegisterType(std::unique_ptr<type::Type> type);
 
  private:
   struct {
@@ -201,6 +208,9 @@ class Script : public RecipeImpl {
   std::vector<std::unique_ptr<Pipeline>> pipelines_;
   std::vector<std::unique_ptr<type::Type>> types_;
   std::vector<std::unique_ptr<Format>> formats_;
+  std::map<std::string, type::Type*> interned_types_;
+  std::map<std::tuple<const type::Type*, Format::Layout, FormatType>, Format*>
+      interned_formats_;
 };
 
 }  // namespace amber
@@ -14,11 +14,14 @@
 
 #include "src/script.h"
 
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "src/make_unique.h"
 #include "src/shader.h"
+#include "src/type_parser.h"
 
 namespace amber {
 namespace {
@@ -64,6 +67,44 @@ TEST_F(ScriptTest, GetShaderInfo) {
   EXPECT_TRUE(info[1].optimizations.empty());
 }
 
+TEST_F(ScriptTest, GetShaderInfoOptimizations) {
+  ScriptProxy sp;
+
+  auto shader = MakeUnique<Shader>(kShaderTypeCompute);
+  shader->SetName("Shader1");
+  shader->SetFormat(kShaderFormatGlsl);
+  Shader* shader_ptr = shader.get();
+  sp.AddShader(std::move(shader));
+
+  std::vector<std::vector<std::string>> optimizations = {
+      {"--eliminate-dead-code-aggressive"},
+      {"--inline-entry-points-exhaustive"},
+      {"--eliminate-dead-code-aggressive"}};
+  for (size_t i = 0; i < optimizations.size(); ++i) {
+    auto pipeline = MakeUnique<Pipeline>(PipelineType::kCompute);
+    pipeline->SetName("pipeline" + std::to_string(i));
+    Result r = pipeline->AddShader(shader_ptr, kShaderTypeCompute);
+    ASSERT_TRUE(r.IsSuccess()) << r.Error();
+    r = pipeline->SetShaderOptimizations(shader_ptr, optimizations[i]);
+    ASSERT_TRUE(r.IsSuccess()) << r.Error();
+    ASSERT_TRUE(sp.AddPipeline(std::move(pipeline)).IsSuccess());
+  }
+
+  // The shader is listed once, with the optimizations of the first pipeline.
+  auto info = sp.GetShaderInfo();
+  ASSERT_EQ(1U, info.size());
+  EXPECT_EQ("Shader1", info[0].shader_name);
+  EXPECT_EQ(optimizations[0], info[0].optimizations);
+
+  // Each distinct set is listed once.
+  auto sets = sp.GetShaderOptimizations("Shader1");
+  ASSERT_EQ(2U, sets.size());
+  EXPECT_EQ(optimizations[0], sets[0]);
+  EXPECT_EQ(optimizations[1], sets[1]);
+
+  EXPECT_TRUE(sp.GetShaderOptimizations("Unknown").empty());
+}
+
 TEST_F(ScriptTest, GetShaderInfoNoShaders) {
   ScriptProxy sp;
   auto info = sp.GetShaderInfo();
@@ -306,4 +347,50 @@ TEST_F(ScriptTest,
             s.GetRequiredInstanceExtensions()[0]);
 }
 
+TEST_F(ScriptTest, RegisterTypeInternsEqualTypes) {
+  Script s;
+  TypeParser parser;
+  auto* a = s.RegisterType(parser.Parse("R32G32B32A32_SFLOAT"));
+  auto* b = s.RegisterType(parser.Parse("R32G32B32A32_SFLOAT"));
+  auto* c = s.RegisterType(parser.Parse("R32G32B32A32_UINT"));
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+}
+
+TEST_F(ScriptTest, RegisterTypeKeepsDimensionsApart) {
+  Script s;
+  auto* scalar = s.RegisterType(type::Number::Float(32));
+
+  auto vec = type::Number::Float(32);
+  vec->SetRowCount(4);
+  auto* vec4 = s.RegisterType(std::move(vec));
+
+  auto arr = type::Number::Float(32);
+  arr->SetIsSizedArray(4);
+  auto* array = s.RegisterType(std::move(arr));
+
+  EXPECT_NE(scalar, vec4);
+  EXPECT_NE(scalar, array);
+  EXPECT_NE(vec4, array);
+  EXPECT_EQ(4U, vec4->RowCount());
+  EXPECT_TRUE(array->IsSizedArray());
+}
+
+TEST_F(ScriptTest, RegisterFormatInternsEqualFormats) {
+  Script s;
+  TypeParser parser;
+  auto* type = s.RegisterType(parser.Parse("R32G32_SINT"));
+  auto* a = s.RegisterFormat(MakeUnique<Format>(type));
+  auto* b = s.RegisterFormat(MakeUnique<Format>(
+      s.RegisterType(parser.Parse("R32G32_SINT"))));
+  EXPECT_EQ(a, b);
+
+  auto std140 = MakeUnique<Format>(type);
+  std140->SetLayout(Format::Layout::kStd140);
+  auto* c = s.RegisterFormat(std::move(std140));
+  EXPECT_NE(a, c);
+  EXPECT_EQ(Format::Layout::kStd140, c->GetLayout());
+  EXPECT_FALSE(a->Equal(c));
+}
+
 }  // namespace amber
@@ -15,8 +15,12 @@
 #include "src/shader_compiler.h"
 
 #include <algorithm>
+#include <array>
 #include <cstdlib>
 #include <iterator>
+#include <map>
+#include <memory>
+#include <set>
 #include <string>
 #include <utility>
 
@@ -43,7 +47,148 @@
 #include "src/clspv_helper.h"
 #endif  // AMBER_ENABLE_CLSPV
 
+#include "src/hash.h"
+#include "src/make_unique.h"
+
 namespace amber {
+namespace {
+
+#if AMBER_ENABLE_SPIRV_TOOLS || AMBER_ENABLE_SHADERC
+// The compiler objects for one SPIR-V environment. Creating them costs more
+// than compiling a typical test shader, so they are kept for the life of the
+// thread and shared by every shader and script compiled on it.
+struct CompilerContext {
+#if AMBER_ENABLE_SPIRV_TOOLS
+  spv_target_env target_env = SPV_ENV_UNIVERSAL_1_0;
+  std::unique_ptr<spvtools::SpirvTools> tools;
+  // Optimizers keyed by the optimization flags registered on them.
+  std::map<std::vector<std::string>, std::unique_ptr<spvtools::Optimizer>>
+      optimizers;
+  // Messages from |tools| and |optimizers|, cleared before each compile.
+  std::string errors;
+  // Seed of the validation keys of this environment, see GetValidationSeed.
+  uint64_t validation_seed = 0;
+  // Keys of the modules which passed validation on this thread.
+  std::set<uint64_t> validated;
+#endif  // AMBER_ENABLE_SPIRV_TOOLS
+
+#if AMBER_ENABLE_SHADERC
+  // Created by the first GLSL compile, along with |glsl_options|.
+  std::unique_ptr<shaderc::Compiler> glsl_compiler;
+  shaderc::CompileOptions glsl_options;
+#endif  // AMBER_ENABLE_SHADERC
+};
+
+#if AMBER_ENABLE_SPIRV_TOOLS
+spvtools::MessageConsumer MakeMessageConsumer(std::string* spv_errors) {
+  return [spv_errors](spv_message_level_t level, const char*,
+                      const spv_position_t& position, const char* message) {
+    switch (level) {
+      case SPV_MSG_FATAL:
+      case SPV_MSG_INTERNAL_ERROR:
+      case SPV_MSG_ERROR:
+        *spv_errors += "error: line " + std::to_string(position.index) +
+                       ": " + message + "\n";
+        break;
+      case SPV_MSG_WARNING:
+        *spv_errors += "warning: line " + std::to_string(position.index) +
+                       ": " + message + "\n";
+        break;
+      case SPV_MSG_INFO:
+        *spv_errors += "info: line " + std::to_string(position.index) +
+                       ": " + message + "\n";
+        break;
+      case SPV_MSG_DEBUG:
+        break;
+    }
+  };
+}
+
+// Describes the spvtools::ValidatorOptions used by Compile(). Must change
+// whenever those options do, so modules validated with the old options are
+// validated again.
+const char kValidatorOptions[] = "default";
+
+// Returns the seed of the validation keys for |spv_env|. The SPIRV-Tools
+// version is part of it, since a newer validator may reject a module which
+// an older one accepted.
+uint64_t GetValidationSeed(const std::string& spv_env) {
+  std::string seed = spv_env + ":" + kValidatorOptions + ":" +
+                     spvSoftwareVersionString();
+  return XXH64(seed.data(), seed.size());
+}
+#endif  // AMBER_ENABLE_SPIRV_TOOLS
+
+// Returns the compiler context for |spv_env| on the calling thread in
+// |context|, creating it on first use.
+Result GetCompilerContext(const std::string& spv_env,
+                          CompilerContext** context) {
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wexit-time-destructors"
+  static thread_local std::map<std::string, std::unique_ptr<CompilerContext>>
+      contexts;
+#pragma clang diagnostic pop
+
+  auto& entry = contexts[spv_env];
+  if (!entry) {
+    auto created = MakeUnique<CompilerContext>();
+#if AMBER_ENABLE_SPIRV_TOOLS
+    if (!spv_env.empty() &&
+        !spvParseTargetEnv(spv_env.c_str(), &created->target_env)) {
+      return Result("Unable to parse SPIR-V target environment");
+    }
+    created->tools = MakeUnique<spvtools::SpirvTools>(created->target_env);
+    created->tools->SetMessageConsumer(MakeMessageConsumer(&created->errors));
+    created->validation_seed = GetValidationSeed(spv_env);
+#endif  // AMBER_ENABLE_SPIRV_TOOLS
+    entry = std::move(created);
+  }
+
+  *context = entry.get();
+  return {};
+}
+#endif  // AMBER_ENABLE_SPIRV_TOOLS || AMBER_ENABLE_SHADERC
+
+// Returns a table of the value of each hex digit, indexed by character, with
+// -1 for all other characters.
+const int8_t* GetHexDigitTable() {
+  static const std::array<int8_t, 256> table = [] {
+    std::array<int8_t, 256> values;
+    values.fill(-1);
+    for (int8_t i = 0; i < 10; ++i)
+      values[static_cast<size_t>('0' + i)] = i;
+    for (int8_t i = 0; i < 6; ++i) {
+      values[static_cast<size_t>('a' + i)] = static_cast<int8_t>(10 + i);
+      values[static_cast<size_t>('A' + i)] = static_cast<int8_t>(10 + i);
+    }
+    return values;
+  }();
+  return table.data();
+}
+
+bool IsHexSeparator(char c) {
+  return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' ||
+         c == '\f';
+}
+
+// Returns a failure of |message| prefixed with the line and column of |pos|
+// in |data|.
+Result HexError(const std::string& data,
+                size_t pos,
+                const std::string& message) {
+  size_t line = 1;
+  size_t line_start = 0;
+  for (size_t i = 0; i < pos && i < data.size(); ++i) {
+    if (data[i] == '\n') {
+      ++line;
+      line_start = i + 1;
+    }
+  }
+  return Result("line " + std::to_string(line) + ", column " +
+                std::to_string(pos - line_start + 1) + ": " + message);
+}
+
+}  // namespace
 
 ShaderCompiler::ShaderCompiler() = default;
 
@@ -69,39 +214,14 @@ std::pair<Result, std::vector<uint32_t>> ShaderCompiler::Compile(
   }
 
 #if AMBER_ENABLE_SPIRV_TOOLS
-  std::string spv_errors;
-
-  spv_target_env target_env = SPV_ENV_UNIVERSAL_1_0;
-  if (!spv_env_.empty()) {
-    if (!spvParseTargetEnv(spv_env_.c_str(), &target_env))
-      return {Result("Unable to parse SPIR-V target environment"), {}};
-  }
-
-  auto msg_consumer = [&spv_errors](spv_message_level_t level, const char*,
-                                    const spv_position_t& position,
-                                    const char* message) {
-    switch (level) {
-      case SPV_MSG_FATAL:
-      case SPV_MSG_INTERNAL_ERROR:
-      case SPV_MSG_ERROR:
-        spv_errors += "error: line " + std::to_string(position.index) + ": " +
-                      message + "\n";
-        break;
-      case SPV_MSG_WARNING:
-        spv_errors += "warning: line " + std::to_string(position.index) + ": " +
-                      message + "\n";
-        break;
-      case SPV_MSG_INFO:
-        spv_errors += "info: line " + std::to_string(position.index) + ": " +
-                      message + "\n";
-        break;
-      case SPV_MSG_DEBUG:
-        break;
-    }
-  };
-
-  spvtools::SpirvTools tools(target_env);
-  tools.SetMessageConsumer(msg_consumer);
+  CompilerContext* context = nullptr;
+  Result context_result = GetCompilerContext(spv_env_, &context);
+  if (!context_result.IsSuccess())
+    return {context_result, {}};
+
+  std::string& spv_errors = context->errors;
+  spv_errors.clear();
+  spvtools::SpirvTools& tools = *context->tools;
 #endif  // AMBER_ENABLE_SPIRV_TOOLS
 
   std::vector<uint32_t> results;
@@ -109,7 +229,7 @@ std::pair<Result, std::vector<uint32_t>> ShaderCompiler::Compile(
   if (shader->GetFormat() == kShaderFormatSpirvHex) {
     Result r = ParseHex(shader->GetData(), &results);
     if (!r.IsSuccess())
-      return {Result("Unable to parse shader hex."), {}};
+      return {Result("Unable to parse shader hex: " + r.Error()), {}};
 
 #if AMBER_ENABLE_SHADERC
   } else if (shader->GetFormat() == kShaderFormatGlsl) {
@@ -149,22 +269,37 @@ std::pair<Result, std::vector<uint32_t>> ShaderCompiler::Compile(
   // when not using SPIRV-Tools support.
   if (!disable_spirv_validation_) {
 #if AMBER_ENABLE_SPIRV_TOOLS
-    spvtools::ValidatorOptions options;
-    if (!tools.Validate(results.data(), results.size(), options))
-      return {Result("Invalid shader: " + spv_errors), {}};
+    // Modules which passed validation before, on this thread or in the
+    // |validation_cache_|, are not validated again.
+    const uint64_t key =
+        XXH64(results.data(), results.size() * sizeof(uint32_t),
+              context->validation_seed);
+    if (context->validated.count(key) == 0 &&
+        (!validation_cache_ || !validation_cache_->IsValidated(key))) {
+      spvtools::ValidatorOptions options;
+      if (!tools.Validate(results.data(), results.size(), options))
+        return {Result("Invalid shader: " + spv_errors), {}};
+    }
+    context->validated.insert(key);
+    if (validation_cache_)
+      validation_cache_->AddValidated(key);
 #endif  // AMBER_ENABLE_SPIRV_TOOLS
   }
 
 #if AMBER_ENABLE_SPIRV_TOOLS
   // Optimize the shader if any optimizations were specified.
-  if (!shader_info->GetShaderOptimizations().empty()) {
-    spvtools::Optimizer optimizer(target_env);
-    optimizer.SetMessageConsumer(msg_consumer);
-    if (!optimizer.RegisterPassesFromFlags(
-            shader_info->GetShaderOptimizations())) {
-      return {Result("Invalid optimizations: " + spv_errors), {}};
+  const auto& optimizations = shader_info->GetShaderOptimizations();
+  if (!optimizations.empty()) {
+    auto& optimizer = context->optimizers[optimizations];
+    if (!optimizer) {
+      optimizer = MakeUnique<spvtools::Optimizer>(context->target_env);
+      optimizer->SetMessageConsumer(MakeMessageConsumer(&spv_errors));
+      if (!optimizer->RegisterPassesFromFlags(optimizations)) {
+        optimizer.reset();
+        return {Result("Invalid optimizations: " + spv_errors), {}};
+      }
     }
-    if (!optimizer.Run(results.data(), results.size(), &results))
+    if (!optimizer->Run(results.data(), results.size(), &results))
       return {Result("Optimizations failed: " + spv_errors), {}};
   }
 #endif  // AMBER_ENABLE_SPIRV_TOOLS
@@ -174,46 +309,106 @@ std::pair<Result, std::vector<uint32_t>> ShaderCompiler::Compile(
 
 Result ShaderCompiler::ParseHex(const std::string& data,
                                 std::vector<uint32_t>* result) const {
-  size_t used = 0;
-  const char* str = data.c_str();
-  uint8_t converted = 0;
-  uint32_t tmp = 0;
-  while (used < data.length()) {
-    char* new_pos = nullptr;
-    uint64_t v = static_cast<uint64_t>(std::strtol(str, &new_pos, 16));
-
-    ++converted;
-
-    // TODO(dsinclair): Is this actually right?
-    tmp = tmp | (static_cast<uint32_t>(v) << (8 * (converted - 1)));
-    if (converted == 4) {
-      result->push_back(tmp);
-      tmp = 0;
-      converted = 0;
+  const int8_t* digits = GetHexDigitTable();
+  const char* str = data.data();
+  const size_t size = data.size();
+
+  // The numbers are bytes, unless the first one has more than two digits, in
+  // which case they are all 32-bit words. The first word of SPIR-V is the
+  // magic number, so a word stream always starts with a long number.
+  bool is_word_stream = false;
+  bool seen_number = false;
+  size_t count = result->size();
+  uint32_t word = 0;
+  uint32_t bytes = 0;
+
+  size_t pos = 0;
+  while (pos < size) {
+    if (IsHexSeparator(str[pos])) {
+      ++pos;
+      continue;
     }
 
-    used += static_cast<size_t>(new_pos - str);
-    str = new_pos;
+    const size_t start = pos;
+    if (str[pos] == '0' && pos + 1 < size &&
+        (str[pos + 1] == 'x' || str[pos + 1] == 'X')) {
+      pos += 2;
+    }
+
+    uint32_t value = 0;
+    size_t num_digits = 0;
+    while (pos < size) {
+      int8_t digit = digits[static_cast<uint8_t>(str[pos])];
+      if (digit < 0)
+        break;
+      value = (value << 4) | static_cast<uint32_t>(digit);
+      ++num_digits;
+      ++pos;
+    }
+    if (pos < size && !IsHexSeparator(str[pos])) {
+      return HexError(data, pos,
+                      std::string("invalid character '") + str[pos] + "'");
+    }
+    if (num_digits == 0)
+      return HexError(data, start, "expected a hex number");
+
+    if (!seen_number) {
+      seen_number = true;
+      is_word_stream = num_digits > 2;
+      // Every number takes at least one digit and one separator, so this is
+      // the most words the rest of |data| can hold.
+      const size_t remaining = size - start + 1;
+      result->resize(count + remaining / (is_word_stream ? 2 : 8));
+    }
+
+    if (is_word_stream) {
+      if (num_digits > 8)
+        return HexError(data, start, "a word has more than 8 hex digits");
+      (*result)[count++] = value;
+      continue;
+    }
+
+    if (num_digits > 2)
+      return HexError(data, start, "a byte has more than 2 hex digits");
+
+    // Bytes are packed into words least significant first, the order of
+    // SPIR-V written out on a little endian machine.
+    word |= value << (8 * bytes);
+    if (++bytes == 4) {
+      (*result)[count++] = word;
+      word = 0;
+      bytes = 0;
+    }
   }
+  if (bytes != 0)
+    return HexError(data, size, "the data ends in the middle of a word");
+
+  result->resize(count);
   return {};
 }
 
 #if AMBER_ENABLE_SHADERC
 Result ShaderCompiler::CompileGlsl(const Shader* shader,
                                    std::vector<uint32_t>* result) const {
-  shaderc::Compiler compiler;
-  shaderc::CompileOptions options;
-
-  uint32_t env = 0u;
-  uint32_t env_version = 0u;
-  uint32_t spirv_version = 0u;
-  auto r = ParseSpvEnv(spv_env_, &env, &env_version, &spirv_version);
+  CompilerContext* context = nullptr;
+  Result r = GetCompilerContext(spv_env_, &context);
   if (!r.IsSuccess())
     return r;
 
-  options.SetTargetEnvironment(static_cast<shaderc_target_env>(env),
-                               env_version);
-  options.SetTargetSpirv(static_cast<shaderc_spirv_version>(spirv_version));
+  if (!context->glsl_compiler) {
+    uint32_t env = 0u;
+    uint32_t env_version = 0u;
+    uint32_t spirv_version = 0u;
+    r = ParseSpvEnv(spv_env_, &env, &env_version, &spirv_version);
+    if (!r.IsSuccess())
+      return r;
+
+    context->glsl_options.SetTargetEnvironment(
+        static_cast<shaderc_target_env>(env), env_version);
+    context->glsl_options.SetTargetSpirv(
+        static_cast<shaderc_spirv_version>(spirv_version));
+    context->glsl_compiler = MakeUnique<shaderc::Compiler>();
+  }
 
   shaderc_shader_kind kind;
   if (shader->GetType() == kShaderTypeCompute)
@@ -232,7 +427,8 @@ Result ShaderCompiler::CompileGlsl(const Shader* shader,
     return Result("Unknown shader type");
 
   shaderc::SpvCompilationResult module =
-      compiler.CompileGlslToSpv(shader->GetData(), kind, "-", options);
+      context->glsl_compiler->CompileGlslToSpv(shader->GetData(), kind, "-",
+                                               context->glsl_options);
 
   if (module.GetCompilationStatus() != shaderc_compilation_status_success)
     return Result(module.GetErrorMessage());
@@ -45,6 +45,10 @@ class ShaderCompiler {
       Pipeline::ShaderInfo* shader_info,
       const ShaderMap& shader_map) const;
 
+  /// Sets the cache of modules known to pass validation. Validated modules
+  /// are added to it. Ownership stays with the caller.
+  void SetValidationCache(ValidationCache* cache) { validation_cache_ = cache; }
+
  private:
   Result ParseHex(const std::string& data, std::vector<uint32_t>* result) const;
   Result CompileGlsl(const Shader* shader, std::vector<uint32_t>* result) const;
@@ -54,6 +58,7 @@ class ShaderCompiler {
 
   std::string spv_env_;
   bool disable_spirv_validation_ = false;
+  ValidationCache* validation_cache_ = nullptr;
 };
 
 // Parses the SPIR-V environment string, and returns the corresponding
@@ -15,6 +15,8 @@
 #include "src/shader_compiler.h"
 
 #include <algorithm>
+#include <cstdio>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -150,22 +152,6 @@ TEST_F(ShaderCompilerTest, InvalidSpirvHex) {
             r.Error());
 }
 
-TEST_F(ShaderCompilerTest, InvalidHex) {
-  Shader shader(kShaderTypeVertex);
-  shader.SetName("BadTestShader");
-  shader.SetFormat(kShaderFormatSpirvHex);
-  shader.SetData("aaaaaaaaaa");
-
-  ShaderCompiler sc;
-  Result r;
-  std::vector<uint32_t> binary;
-  Pipeline::ShaderInfo shader_info(&shader, kShaderTypeCompute);
-  std::tie(r, binary) = sc.Compile(&shader_info, ShaderMap());
-  ASSERT_FALSE(r.IsSuccess());
-  EXPECT_EQ("Invalid shader: error: line 0: Invalid SPIR-V magic number.\n",
-            r.Error());
-}
-
 TEST_F(ShaderCompilerTest, OptimizeShader) {
   const std::string spirv = R"(
 OpCapability Shader
@@ -218,6 +204,124 @@ OpFunctionEnd
   std::tie(r, opt_binary) = sc.Compile(&optimized, ShaderMap());
   ASSERT_TRUE(r.IsSuccess());
   EXPECT_NE(opt_binary.size(), unopt_binary.size());
+
+  // The second compile reuses the optimizer built by the first.
+  std::vector<uint32_t> reopt_binary;
+  std::tie(r, reopt_binary) = sc.Compile(&optimized, ShaderMap());
+  ASSERT_TRUE(r.IsSuccess());
+  EXPECT_EQ(opt_binary, reopt_binary);
+}
+
+TEST_F(ShaderCompilerTest, ReusedCompilerReportsOnlyItsOwnErrors) {
+  std::string contents = kHexShader;
+  contents[3] = '0';
+
+  Shader bad_shader(kShaderTypeVertex);
+  bad_shader.SetName("BadTestShader");
+  bad_shader.SetFormat(kShaderFormatSpirvHex);
+  bad_shader.SetData(contents);
+
+  Shader good_shader(kShaderTypeVertex);
+  good_shader.SetName("TestShader");
+  good_shader.SetFormat(kShaderFormatSpirvAsm);
+  good_shader.SetData(kPassThroughShader);
+
+  ShaderCompiler sc;
+  Result r;
+  std::vector<uint32_t> binary;
+  Pipeline::ShaderInfo bad_info(&bad_shader, kShaderTypeCompute);
+  Pipeline::ShaderInfo good_info(&good_shader, kShaderTypeCompute);
+  for (int i = 0; i < 2; ++i) {
+    std::tie(r, binary) = sc.Compile(&bad_info, ShaderMap());
+    ASSERT_FALSE(r.IsSuccess());
+    EXPECT_EQ("Invalid shader: error: line 0: Invalid SPIR-V magic number.\n",
+              r.Error());
+
+    std::tie(r, binary) = sc.Compile(&good_info, ShaderMap());
+    ASSERT_TRUE(r.IsSuccess()) << r.Error();
+  }
+}
+
+class TestValidationCache : public ValidationCache {
+ public:
+  explicit TestValidationCache(bool validates_all)
+      : validates_all_(validates_all) {}
+  ~TestValidationCache() override = default;
+
+  bool IsValidated(uint64_t key) override {
+    return validates_all_ || keys_.count(key) > 0;
+  }
+  void AddValidated(uint64_t key) override { keys_.insert(key); }
+
+  const std::set<uint64_t>& GetKeys() const { return keys_; }
+
+ private:
+  bool validates_all_ = false;
+  std::set<uint64_t> keys_;
+};
+
+TEST_F(ShaderCompilerTest, ValidationCacheRecordsValidShader) {
+  Shader shader(kShaderTypeVertex);
+  shader.SetName("TestShader");
+  shader.SetFormat(kShaderFormatSpirvAsm);
+  shader.SetData(kPassThroughShader);
+
+  TestValidationCache cache(false);
+  ShaderCompiler sc;
+  sc.SetValidationCache(&cache);
+
+  Result r;
+  std::vector<uint32_t> binary;
+  Pipeline::ShaderInfo shader_info(&shader, kShaderTypeCompute);
+  for (int i = 0; i < 2; ++i) {
+    std::tie(r, binary) = sc.Compile(&shader_info, ShaderMap());
+    ASSERT_TRUE(r.IsSuccess()) << r.Error();
+  }
+  EXPECT_EQ(1U, cache.GetKeys().size());
+}
+
+TEST_F(ShaderCompilerTest, ValidationCacheDoesNotRecordInvalidShader) {
+  std::string contents = kHexShader;
+  contents[3] = '0';
+
+  Shader shader(kShaderTypeVertex);
+  shader.SetName("BadTestShader");
+  shader.SetFormat(kShaderFormatSpirvHex);
+  shader.SetData(contents);
+
+  TestValidationCache cache(false);
+  ShaderCompiler sc;
+  sc.SetValidationCache(&cache);
+
+  Result r;
+  std::vector<uint32_t> binary;
+  Pipeline::ShaderInfo shader_info(&shader, kShaderTypeCompute);
+  std::tie(r, binary) = sc.Compile(&shader_info, ShaderMap());
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_TRUE(cache.GetKeys().empty());
+}
+
+TEST_F(ShaderCompilerTest, ValidationCacheSkipsKnownShader) {
+  // This shader would fail validation, but the cache reports every module as
+  // validated already.
+  std::string contents = kHexShader;
+  contents[3] = '0';
+
+  Shader shader(kShaderTypeVertex);
+  shader.SetName("BadTestShader");
+  shader.SetFormat(kShaderFormatSpirvHex);
+  shader.SetData(contents);
+
+  TestValidationCache cache(true);
+  ShaderCompiler sc;
+  sc.SetValidationCache(&cache);
+
+  Result r;
+  std::vector<uint32_t> binary;
+  Pipeline::ShaderInfo shader_info(&shader, kShaderTypeCompute);
+  std::tie(r, binary) = sc.Compile(&shader_info, ShaderMap());
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+  EXPECT_FALSE(binary.empty());
 }
 #endif  // AMBER_ENABLE_SPIRV_TOOLS
 
@@ -237,6 +341,91 @@ TEST_F(ShaderCompilerTest, CompilesSpirvHex) {
   EXPECT_EQ(0x07230203, binary[0]);  // Verify SPIR-V header present.
 }
 
+TEST_F(ShaderCompilerTest, CompilesSpirvHexWords) {
+  Shader byte_shader(kShaderTypeVertex);
+  byte_shader.SetName("TestShader");
+  byte_shader.SetFormat(kShaderFormatSpirvHex);
+  byte_shader.SetData(kHexShader);
+
+  ShaderCompiler sc;
+  Result r;
+  std::vector<uint32_t> byte_binary;
+  Pipeline::ShaderInfo byte_info(&byte_shader, kShaderTypeCompute);
+  std::tie(r, byte_binary) = sc.Compile(&byte_info, ShaderMap());
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  std::string words;
+  for (uint32_t word : byte_binary) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "0x%08x\n", word);
+    words += buf;
+  }
+
+  Shader word_shader(kShaderTypeVertex);
+  word_shader.SetName("TestShader");
+  word_shader.SetFormat(kShaderFormatSpirvHex);
+  word_shader.SetData(words);
+
+  std::vector<uint32_t> word_binary;
+  Pipeline::ShaderInfo word_info(&word_shader, kShaderTypeCompute);
+  std::tie(r, word_binary) = sc.Compile(&word_info, ShaderMap());
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+  EXPECT_EQ(byte_binary, word_binary);
+}
+
+TEST_F(ShaderCompilerTest, SpirvHexAllowsTrailingWhitespace) {
+  Shader shader(kShaderTypeVertex);
+  shader.SetName("TestShader");
+  shader.SetFormat(kShaderFormatSpirvHex);
+  shader.SetData(std::string(kHexShader) + "  \n\t\n");
+
+  ShaderCompiler sc;
+  Result r;
+  std::vector<uint32_t> binary;
+  Pipeline::ShaderInfo shader_info(&shader, kShaderTypeCompute);
+  std::tie(r, binary) = sc.Compile(&shader_info, ShaderMap());
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+  EXPECT_EQ(0x07230203, binary[0]);  // Verify SPIR-V header present.
+}
+
+TEST_F(ShaderCompilerTest, InvalidHex) {
+  struct {
+    const char* data;
+    const char* error;
+  } cases[] = {
+      {"aaaaaaaaaa",
+       "Unable to parse shader hex: line 1, column 1: a word has more than 8 "
+       "hex digits"},
+      {"0x03 0x02\n  0x2g 0x07",
+       "Unable to parse shader hex: line 2, column 6: invalid character 'g'"},
+      {"0x03 0x02, 0x23 0x07",
+       "Unable to parse shader hex: line 1, column 10: invalid character ','"},
+      {"0x03 0x002 0x23 0x07",
+       "Unable to parse shader hex: line 1, column 6: a byte has more than 2 "
+       "hex digits"},
+      {"0x03 0x",
+       "Unable to parse shader hex: line 1, column 6: expected a hex number"},
+      {"0x03 0x02 0x23",
+       "Unable to parse shader hex: line 1, column 15: the data ends in the "
+       "middle of a word"},
+  };
+
+  for (const auto& c : cases) {
+    Shader shader(kShaderTypeVertex);
+    shader.SetName("BadTestShader");
+    shader.SetFormat(kShaderFormatSpirvHex);
+    shader.SetData(c.data);
+
+    ShaderCompiler sc;
+    Result r;
+    std::vector<uint32_t> binary;
+    Pipeline::ShaderInfo shader_info(&shader, kShaderTypeCompute);
+    std::tie(r, binary) = sc.Compile(&shader_info, ShaderMap());
+    ASSERT_FALSE(r.IsSuccess()) << c.data;
+    EXPECT_EQ(c.error, r.Error()) << c.data;
+  }
+}
+
 TEST_F(ShaderCompilerTest, FailsOnInvalidShader) {
   std::string contents = "Just Random\nText()\nThat doesn't work.";
 
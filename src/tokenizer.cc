@@ -14,19 +14,28 @@
 
 #include "src/tokenizer.h"
 
+#include <algorithm>
 #include <cctype>
 #include <cstdlib>
+#include <cstring>
 #include <limits>
 #include <sstream>
-
-#include "src/make_unique.h"
+#include <utility>
 
 namespace amber {
 
 Token::Token(TokenType type) : type_(type) {}
 
+Token::Token(const Token&) = default;
+
+Token::Token(Token&&) = default;
+
 Token::~Token() = default;
 
+Token& Token::operator=(const Token&) = default;
+
+Token& Token::operator=(Token&&) = default;
+
 Result Token::ConvertToDouble() {
   if (IsDouble())
     return {};
@@ -52,41 +61,49 @@ Result Token::ConvertToDouble() {
   return {};
 }
 
-Tokenizer::Tokenizer(const std::string& data) : data_(data) {}
+Tokenizer::Tokenizer(const std::string& data)
+    : data_(data.c_str()), size_(data.size()) {}
+
+Tokenizer::Tokenizer(std::string&& data)
+    : owned_data_(std::move(data)),
+      data_(owned_data_.c_str()),
+      size_(owned_data_.size()) {}
+
+Tokenizer::Tokenizer(const char* data, size_t size)
+    : data_(data), size_(size) {}
 
 Tokenizer::~Tokenizer() = default;
 
-std::unique_ptr<Token> Tokenizer::NextToken() {
+Token Tokenizer::NextToken() {
   SkipWhitespace();
-  if (current_position_ >= data_.length())
-    return MakeUnique<Token>(TokenType::kEOS);
+  if (current_position_ >= size_)
+    return Token(TokenType::kEOS);
 
   if (data_[current_position_] == '#') {
     SkipComment();
     SkipWhitespace();
   }
-  if (current_position_ >= data_.length())
-    return MakeUnique<Token>(TokenType::kEOS);
+  if (current_position_ >= size_)
+    return Token(TokenType::kEOS);
 
   if (data_[current_position_] == '\n') {
     ++current_line_;
     ++current_position_;
-    return MakeUnique<Token>(TokenType::kEOL);
+    return Token(TokenType::kEOL);
   }
 
   // If the current position is a , ( or ) then handle it specially as we don't
   // want to consume any other characters.
   if (data_[current_position_] == ',' || data_[current_position_] == '(' ||
       data_[current_position_] == ')') {
-    auto tok = MakeUnique<Token>(TokenType::kString);
-    std::string str(1, data_[current_position_]);
-    tok->SetStringValue(str);
+    Token tok(TokenType::kString);
+    tok.SetStringValue(std::string(1, data_[current_position_]));
     ++current_position_;
     return tok;
   }
 
   size_t end_pos = current_position_;
-  while (end_pos < data_.length()) {
+  while (end_pos < size_) {
     if (data_[end_pos] == ' ' || data_[end_pos] == '\r' ||
         data_[end_pos] == '\n' || data_[end_pos] == ')' ||
         data_[end_pos] == ',' || data_[end_pos] == '(') {
@@ -95,28 +112,28 @@ std::unique_ptr<Token> Tokenizer::NextToken() {
     ++end_pos;
   }
 
-  std::string tok_str =
-      data_.substr(current_position_, end_pos - current_position_);
+  // The token is read in place from |data_|, only strings are copied out.
+  const char* tok_str = data_ + current_position_;
+  const size_t tok_len = end_pos - current_position_;
   current_position_ = end_pos;
 
   // Check for "NaN" explicitly.
   bool is_nan =
-      (tok_str.size() == 3 && std::tolower(tok_str[0]) == 'n' &&
+      (tok_len == 3 && std::tolower(tok_str[0]) == 'n' &&
        std::tolower(tok_str[1]) == 'a' && std::tolower(tok_str[2]) == 'n');
 
   // Starts with an alpha is a string.
   if (!is_nan && !std::isdigit(tok_str[0]) &&
-      !(tok_str[0] == '-' && tok_str.size() >= 2 && std::isdigit(tok_str[1])) &&
-      !(tok_str[0] == '.' && tok_str.size() >= 2 && std::isdigit(tok_str[1]))) {
+      !(tok_str[0] == '-' && tok_len >= 2 && std::isdigit(tok_str[1])) &&
+      !(tok_str[0] == '.' && tok_len >= 2 && std::isdigit(tok_str[1]))) {
     // If we've got a continuation, skip over the end of line and get the next
     // token.
-    if (tok_str == "\\") {
-      if ((current_position_ < data_.length() &&
-           data_[current_position_] == '\n')) {
+    if (tok_len == 1 && tok_str[0] == '\\') {
+      if (current_position_ < size_ && data_[current_position_] == '\n') {
         ++current_line_;
         ++current_position_;
         return NextToken();
-      } else if (current_position_ + 1 < data_.length() &&
+      } else if (current_position_ + 1 < size_ &&
                  data_[current_position_] == '\r' &&
                  data_[current_position_ + 1] == '\n') {
         ++current_line_;
@@ -125,69 +142,81 @@ std::unique_ptr<Token> Tokenizer::NextToken() {
       }
     }
 
-    auto tok = MakeUnique<Token>(TokenType::kString);
-    tok->SetStringValue(tok_str);
+    Token tok(TokenType::kString);
+    tok.SetStringValue(std::string(tok_str, tok_len));
     return tok;
   }
 
   // Handle hex strings
-  if (!is_nan && tok_str.size() > 2 && tok_str[0] == '0' && tok_str[1] == 'x') {
-    auto tok = MakeUnique<Token>(TokenType::kHex);
-    tok->SetStringValue(tok_str);
+  if (!is_nan && tok_len > 2 && tok_str[0] == '0' && tok_str[1] == 'x') {
+    Token tok(TokenType::kHex);
+    tok.SetStringValue(std::string(tok_str, tok_len));
     return tok;
   }
 
-  bool is_double = false;
-  if (is_nan) {
-    is_double = true;
-  } else {
-    for (const char ch : tok_str) {
-      if (ch == '.') {
-        is_double = true;
-        break;
-      }
-    }
-  }
+  bool is_double = is_nan || std::memchr(tok_str, '.', tok_len) != nullptr;
 
-  std::unique_ptr<Token> tok;
+  Token tok(is_double ? TokenType::kDouble : TokenType::kInteger);
 
+  // The numbers are parsed straight out of |data_|. None of the characters
+  // which end a token can continue a number, except for the "nan(...)" form
+  // accepted by strtod, and the end of a range within a larger string. Only
+  // those cases need to parse a copy of the token.
   char* final_pos = nullptr;
   if (is_double) {
-    tok = MakeUnique<Token>(TokenType::kDouble);
-
-    double val = strtod(tok_str.c_str(), &final_pos);
-    tok->SetDoubleValue(val);
+    double val = strtod(tok_str, &final_pos);
+    if (final_pos > tok_str + tok_len) {
+      std::string copy(tok_str, tok_len);
+      char* copy_pos = nullptr;
+      val = strtod(copy.c_str(), &copy_pos);
+      final_pos = const_cast<char*>(tok_str) + (copy_pos - copy.c_str());
+    }
+    tok.SetDoubleValue(val);
   } else {
-    tok = MakeUnique<Token>(TokenType::kInteger);
-
-    uint64_t val = uint64_t(std::strtoull(tok_str.c_str(), &final_pos, 10));
-    tok->SetUint64Value(static_cast<uint64_t>(val));
+    uint64_t val = uint64_t(std::strtoull(tok_str, &final_pos, 10));
+    if (final_pos > tok_str + tok_len) {
+      std::string copy(tok_str, tok_len);
+      char* copy_pos = nullptr;
+      val = uint64_t(std::strtoull(copy.c_str(), &copy_pos, 10));
+      final_pos = const_cast<char*>(tok_str) + (copy_pos - copy.c_str());
+    }
+    tok.SetUint64Value(static_cast<uint64_t>(val));
   }
-  if (tok_str.size() > 1 && tok_str[0] == '-')
-    tok->SetNegative();
+  if (tok_len > 1 && tok_str[0] == '-')
+    tok.SetNegative();
 
-  tok->SetOriginalString(
-      tok_str.substr(0, static_cast<size_t>(final_pos - tok_str.c_str())));
+  auto diff = size_t(final_pos - tok_str);
+  tok.SetOriginalString(std::string(tok_str, diff));
 
   // If the number isn't the whole token then move back so we can then parse
   // the string portion.
-  auto diff = size_t(final_pos - tok_str.c_str());
   if (diff > 0)
-    current_position_ -= tok_str.length() - diff;
+    current_position_ -= tok_len - diff;
 
   return tok;
 }
 
 std::string Tokenizer::ExtractToNext(const std::string& str) {
-  size_t pos = data_.find(str, current_position_);
-  std::string ret;
-  if (pos == std::string::npos) {
-    ret = data_.substr(current_position_);
-    current_position_ = data_.length();
-  } else {
-    ret = data_.substr(current_position_, pos - current_position_);
-    current_position_ = pos;
-  }
+  return ExtractTo(Find(str, current_position_));
+}
+
+size_t Tokenizer::Find(const std::string& str, size_t pos) const {
+  if (pos > size_)
+    return std::string::npos;
+
+  const char* end = data_ + size_;
+  const char* found = std::search(data_ + pos, end, str.begin(), str.end());
+  if (found == end && !str.empty())
+    return std::string::npos;
+  return static_cast<size_t>(found - data_);
+}
+
+std::string Tokenizer::ExtractTo(size_t pos) {
+  if (pos == std::string::npos)
+    pos = size_;
+
+  std::string ret(data_ + current_position_, pos - current_position_);
+  current_position_ = pos;
 
   // Account for any new lines in the extracted text so our current line
   // number stays correct.
@@ -205,15 +234,13 @@ bool Tokenizer::IsWhitespace(char ch) {
 }
 
 void Tokenizer::SkipWhitespace() {
-  while (current_position_ < data_.size() &&
-         IsWhitespace(data_[current_position_])) {
+  while (current_position_ < size_ && IsWhitespace(data_[current_position_])) {
     ++current_position_;
   }
 }
 
 void Tokenizer::SkipComment() {
-  while (current_position_ < data_.length() &&
-         data_[current_position_] != '\n') {
+  while (current_position_ < size_ && data_[current_position_] != '\n') {
     ++current_position_;
   }
 }
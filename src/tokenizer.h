@@ -16,7 +16,6 @@
 #define SRC_TOKENIZER_H_
 
 #include <cstdlib>
-#include <memory>
 #include <string>
 
 #include "amber/result.h"
@@ -32,12 +31,18 @@ enum class TokenType : uint8_t {
   kHex,
 };
 
-/// A token read from the input source.
+/// A token read from the input source. Tokens are small values which are
+/// returned by value from the Tokenizer.
 class Token {
  public:
   explicit Token(TokenType type);
+  Token(const Token&);
+  Token(Token&&);
   ~Token();
 
+  Token& operator=(const Token&);
+  Token& operator=(Token&&);
+
   bool IsHex() const { return type_ == TokenType::kHex; }
   bool IsInteger() const { return type_ == TokenType::kInteger; }
   bool IsDouble() const { return type_ == TokenType::kDouble; }
@@ -99,10 +104,18 @@ class Token {
 /// Splits the provided input into a stream of tokens.
 class Tokenizer {
  public:
+  /// Tokenizes |data| in place. |data| is not copied and must outlive the
+  /// tokenizer.
   explicit Tokenizer(const std::string& data);
+  /// Tokenizes |data|, which is moved into the tokenizer.
+  explicit Tokenizer(std::string&& data);
+  /// Tokenizes the |size| characters at |data| in place. They are not copied
+  /// and must outlive the tokenizer. |data| must be part of a NUL terminated
+  /// string, such as a std::string.
+  Tokenizer(const char* data, size_t size);
   ~Tokenizer();
 
-  std::unique_ptr<Token> NextToken();
+  Token NextToken();
   std::string ExtractToNext(const std::string& str);
 
   void SetCurrentLine(size_t line) { current_line_ = line; }
@@ -110,10 +123,16 @@ class Tokenizer {
 
  private:
   bool IsWhitespace(char ch);
+  size_t Find(const std::string& str, size_t pos) const;
+  std::string ExtractTo(size_t pos);
   void SkipWhitespace();
   void SkipComment();
 
-  std::string data_;
+  // Only used when the tokenizer was given ownership of the input. Must be
+  // declared before |data_|, which may refer to it.
+  std::string owned_data_;
+  const char* data_ = nullptr;
+  size_t size_ = 0;
   size_t current_position_ = 0;
   size_t current_line_ = 1;
 };
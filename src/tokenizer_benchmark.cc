@@ -0,0 +1,69 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "src/benchmark.h"
+#include "src/benchmark_data.h"
+#include "src/tokenizer.h"
+
+namespace amber {
+namespace benchmark {
+namespace {
+
+void TokenizeScript(State* state) {
+  std::string script = GenerateAmberScript(16, 1024);
+
+  uint64_t tokens = 0;
+  while (state->KeepRunning()) {
+    Tokenizer tokenizer(script);
+    tokens = 0;
+    for (auto token = tokenizer.NextToken(); !token.IsEOS();
+         token = tokenizer.NextToken()) {
+      ++tokens;
+    }
+    DoNotOptimize(tokens);
+  }
+  state->SetItemsPerIteration(tokens);
+  state->SetBytesPerIteration(script.size());
+}
+
+void TokenizeNumbers(State* state) {
+  std::string data;
+  for (uint32_t i = 0; i < 100000; ++i)
+    data += std::to_string(i * 7919U) + (i % 2 ? " " : ".25\n");
+
+  uint64_t tokens = 0;
+  while (state->KeepRunning()) {
+    Tokenizer tokenizer(data);
+    tokens = 0;
+    for (auto token = tokenizer.NextToken(); !token.IsEOS();
+         token = tokenizer.NextToken()) {
+      ++tokens;
+    }
+    DoNotOptimize(tokens);
+  }
+  state->SetItemsPerIteration(tokens);
+  state->SetBytesPerIteration(data.size());
+}
+
+}  // namespace
+
+void AddTokenizerBenchmarks(Runner* runner) {
+  runner->Add("Tokenizer/Script", TokenizeScript);
+  runner->Add("Tokenizer/Numbers", TokenizeNumbers);
+}
+
+}  // namespace benchmark
+}  // namespace amber
@@ -0,0 +1,59 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_TRACE_H_
+#define SRC_TRACE_H_
+
+#include <cstdint>
+
+#include "amber/amber.h"
+
+namespace amber {
+
+/// Reports the time spent in the enclosing scope as a trace span through a
+/// delegate. Without a delegate, or when the delegate is not tracing, the
+/// only cost is checking the delegate on construction.
+class TraceScope {
+ public:
+  /// |category| and |name| must outlive the scope, string literals are
+  /// expected.
+  TraceScope(Delegate* delegate, const char* category, const char* name)
+      : category_(category), name_(name) {
+    if (delegate && delegate->IsTracing()) {
+      delegate_ = delegate;
+      start_ns_ = delegate->GetTimestampNs();
+    }
+  }
+  ~TraceScope() { End(); }
+
+  /// Ends the span before the end of the scope. Later calls do nothing.
+  void End() {
+    if (!delegate_)
+      return;
+
+    delegate_->TraceSpan(category_, name_, start_ns_,
+                         delegate_->GetTimestampNs());
+    delegate_ = nullptr;
+  }
+
+ private:
+  Delegate* delegate_ = nullptr;
+  const char* category_;
+  const char* name_;
+  uint64_t start_ns_ = 0;
+};
+
+}  // namespace amber
+
+#endif  // SRC_TRACE_H_
@@ -0,0 +1,103 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/trace.h"
+
+#include <string>
+#include <vector>
+
+#include "amber/recipe.h"
+#include "gtest/gtest.h"
+
+namespace amber {
+namespace {
+
+class TracingDelegate : public Delegate {
+ public:
+  void Log(const std::string&) override {}
+  bool LogGraphicsCalls() const override { return false; }
+  bool LogGraphicsCallsTime() const override { return false; }
+  uint64_t GetTimestampNs() const override { return ++now_; }
+  bool LogExecuteCalls() const override { return false; }
+
+  bool IsTracing() const override { return tracing_; }
+  void TraceSpan(const char* category,
+                 const char* name,
+                 uint64_t start_ns,
+                 uint64_t end_ns) override {
+    spans.push_back(std::string(category) + "/" + name + " " +
+                    std::to_string(start_ns) + "-" + std::to_string(end_ns));
+  }
+
+  bool tracing_ = true;
+  std::vector<std::string> spans;
+
+ private:
+  mutable uint64_t now_ = 0;
+};
+
+}  // namespace
+
+using TraceTest = testing::Test;
+
+TEST_F(TraceTest, ReportsScope) {
+  TracingDelegate delegate;
+  {
+    TraceScope outer(&delegate, "test", "Outer");
+    TraceScope inner(&delegate, "test", "Inner");
+  }
+
+  ASSERT_EQ(2U, delegate.spans.size());
+  EXPECT_EQ("test/Inner 2-3", delegate.spans[0]);
+  EXPECT_EQ("test/Outer 1-4", delegate.spans[1]);
+}
+
+TEST_F(TraceTest, EndReportsOnce) {
+  TracingDelegate delegate;
+  {
+    TraceScope trace(&delegate, "test", "Early");
+    trace.End();
+    trace.End();
+  }
+
+  ASSERT_EQ(1U, delegate.spans.size());
+  EXPECT_EQ("test/Early 1-2", delegate.spans[0]);
+}
+
+TEST_F(TraceTest, DisabledReportsNothing) {
+  TracingDelegate delegate;
+  delegate.tracing_ = false;
+  {
+    TraceScope trace(&delegate, "test", "Disabled");
+  }
+  EXPECT_TRUE(delegate.spans.empty());
+
+  // A missing delegate is fine too.
+  TraceScope trace(nullptr, "test", "NoDelegate");
+  trace.End();
+}
+
+TEST_F(TraceTest, ParseReportsSpan) {
+  TracingDelegate delegate;
+  Amber amber(&delegate);
+  Recipe recipe;
+  Result r =
+      amber.Parse("#!amber\nBUFFER buf DATA_TYPE int32 SIZE 1 FILL 0", &recipe);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  ASSERT_EQ(1U, delegate.spans.size());
+  EXPECT_EQ(0U, delegate.spans[0].find("parse/Parse "));
+}
+
+}  // namespace amber
@@ -1215,6 +1215,25 @@ TEST_F(TypeParserTest, Formats) {
   }
 }  // NOLINT(readability/fn_size)
 
+TEST_F(TypeParserTest, NameToFormatTypeUnknown) {
+  const char* names[] = {"",
+                         "AAAA",
+                         "A1R5G5B5",
+                         "A1R5G5B5_UNORM_PACK1",
+                         "R8_UINT_",
+                         "r8_uint",
+                         "X8_D24_UNORM_PACK32X",
+                         "ZZZZZZZZ"};
+  for (const char* name : names) {
+    EXPECT_EQ(FormatType::kUnknown, TypeParser::NameToFormatType(name))
+        << name;
+  }
+  EXPECT_EQ(FormatType::kA1R5G5B5_UNORM_PACK16,
+            TypeParser::NameToFormatType("A1R5G5B5_UNORM_PACK16"));
+  EXPECT_EQ(FormatType::kX8_D24_UNORM_PACK32,
+            TypeParser::NameToFormatType("X8_D24_UNORM_PACK32"));
+}
+
 TEST_F(TypeParserTest, InvalidFormat) {
   TypeParser parser;
   auto type = parser.Parse("BLAH_BLAH_BLAH");
@@ -14,130 +14,39 @@
 
 #include "src/verifier.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstring>
+#include <memory>
+#include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "src/command.h"
+#include "src/hash.h"
+#include "src/image_converter.h"
+#include "src/image_metrics.h"
+#include "src/mapped_file.h"
+#include "src/parallel.h"
+#include "src/trace.h"
 
 namespace amber {
 namespace {
 
-const uint8_t kBitsPerByte = 8;
 const double kEpsilon = 0.000001;
 const double kDefaultTexelTolerance = 0.002;
 
-// Copy [src_bit_offset, src_bit_offset + bits) bits of |src| to
-// [0, bits) of |dst|.
-void CopyBitsOfMemoryToBuffer(uint8_t* dst,
-                              const uint8_t* src,
-                              uint8_t src_bit_offset,
-                              uint32_t bits) {
-  while (src_bit_offset > static_cast<uint8_t>(7)) {
-    ++src;
-    src_bit_offset = static_cast<uint8_t>(src_bit_offset - kBitsPerByte);
-  }
-
-  // Number of bytes greater than or equal to |(src_bit_offset + bits) / 8|.
-  const uint8_t size_in_bytes =
-      static_cast<uint8_t>((src_bit_offset + bits + 7) / kBitsPerByte);
-  assert(size_in_bytes <= static_cast<uint8_t>(kBitsPerByte));
-
-  uint64_t data = 0;
-  uint8_t* ptr = reinterpret_cast<uint8_t*>(&data);
-  for (uint8_t i = 0; i < size_in_bytes; ++i) {
-    ptr[i] = src[i];
-  }
-
-  data >>= src_bit_offset;
-  if (bits != 64)
-    data &= (1ULL << bits) - 1ULL;
-
-  std::memcpy(dst, &data, static_cast<size_t>((bits + 7) / kBitsPerByte));
-}
-
-// Convert float |value| whose size is 16 bits to 32 bits float
-// based on IEEE-754.
-float HexFloat16ToFloat(const uint8_t* value) {
-  uint32_t sign = (static_cast<uint32_t>(value[1]) & 0x80) << 24U;
-  uint32_t exponent = (((static_cast<uint32_t>(value[1]) & 0x7c) >> 2U) + 112U)
-                      << 23U;
-  uint32_t mantissa = ((static_cast<uint32_t>(value[1]) & 0x3) << 8U |
-                       static_cast<uint32_t>(value[0]))
-                      << 13U;
-
-  uint32_t hex = sign | exponent | mantissa;
-  float* hex_float = reinterpret_cast<float*>(&hex);
-  return *hex_float;
-}
-
-// Convert float |value| whose size is 11 bits to 32 bits float
-// based on IEEE-754.
-float HexFloat11ToFloat(const uint8_t* value) {
-  uint32_t exponent = (((static_cast<uint32_t>(value[1]) << 2U) |
-                        ((static_cast<uint32_t>(value[0]) & 0xc0) >> 6U)) +
-                       112U)
-                      << 23U;
-  uint32_t mantissa = (static_cast<uint32_t>(value[0]) & 0x3f) << 17U;
-
-  uint32_t hex = exponent | mantissa;
-  float* hex_float = reinterpret_cast<float*>(&hex);
-  return *hex_float;
-}
-
-// Convert float |value| whose size is 10 bits to 32 bits float
-// based on IEEE-754.
-float HexFloat10ToFloat(const uint8_t* value) {
-  uint32_t exponent = (((static_cast<uint32_t>(value[1]) << 3U) |
-                        ((static_cast<uint32_t>(value[0]) & 0xe0) >> 5U)) +
-                       112U)
-                      << 23U;
-  uint32_t mantissa = (static_cast<uint32_t>(value[0]) & 0x1f) << 18U;
-
-  uint32_t hex = exponent | mantissa;
-  float* hex_float = reinterpret_cast<float*>(&hex);
-  return *hex_float;
-}
-
-// Convert float |value| whose size is |bits| bits to 32 bits float
-// based on IEEE-754.
-// See https://www.khronos.org/opengl/wiki/Small_Float_Formats
-// and https://en.wikipedia.org/wiki/IEEE_754.
-//
-//    Sign Exponent Mantissa Exponent-Bias
-// 16    1        5       10            15
-// 11    0        5        6            15
-// 10    0        5        5            15
-// 32    1        8       23           127
-// 64    1       11       52          1023
-//
-// 11 and 10 bits floats are always positive.
-// 14 bits float is used only RGB9_E5 format in OpenGL but it does not exist
-// in Vulkan.
-float HexFloatToFloat(const uint8_t* value, uint8_t bits) {
-  switch (bits) {
-    case 10:
-      return HexFloat10ToFloat(value);
-    case 11:
-      return HexFloat11ToFloat(value);
-    case 16:
-      return HexFloat16ToFloat(value);
-  }
-
-  assert(false && "Invalid bits");
-  return 0;
-}
+// The smallest amount of work handed to a single verification thread. Below
+// this the cost of starting the thread outweighs the work done on it.
+const size_t kMinTexelsPerThread = 16384;
+const size_t kMinSSBOValuesPerThread = 65536;
 
-// This is based on "18.3. sRGB transfer functions" of
-// https://www.khronos.org/registry/DataFormat/specs/1.2/dataformat.1.2.html
-double SRGBToLinearValue(double sRGB) {
-  if (sRGB <= 0.04045)
-    return sRGB / 12.92;
-
-  return pow((sRGB + 0.055) / 1.055, 2.4);
-}
+// Generated expectations are compared in blocks of this many values. A block
+// is compared without an early exit so the loop can be vectorised, and only a
+// block holding a mismatch is scanned again to find the failing value.
+const size_t kGeneratedBlockSize = 256;
 
 // It returns true if the difference is within the given error.
 // If |is_tolerance_percent| is true, the actual tolerance will be
@@ -440,26 +349,39 @@ std::vector<double> GetTexelInRGBA(const std::vector<double>& texel,
   return texel_in_rgba;
 }
 
-}  // namespace
-
-Verifier::Verifier() = default;
-
-Verifier::~Verifier() = default;
-
-Result Verifier::Probe(const ProbeCommand* command,
-                       const Format* fmt,
-                       uint32_t texel_stride,
-                       uint32_t row_stride,
-                       uint32_t frame_width,
-                       uint32_t frame_height,
-                       const void* buf) {
-  if (!command)
-    return Result("Verifier::Probe given ProbeCommand is nullptr");
-  if (!fmt)
-    return Result("Verifier::Probe given texel's Format is nullptr");
-  if (!buf)
-    return Result("Verifier::Probe given buffer to probe is nullptr");
-
+// The area of the framebuffer covered by a probe.
+struct ProbeRect {
+  uint32_t x = 0;
+  uint32_t y = 0;
+  uint32_t width = 1;
+  uint32_t height = 1;
+};
+
+// Failures found while probing a range of texels.
+struct TexelFailures {
+  uint32_t count = 0;
+  uint32_t first_i = 0;
+  uint32_t first_j = 0;
+  std::vector<double> values;
+};
+
+// Per probe information used while verifying a batch of probes.
+struct ProbeState {
+  ProbeRect rect;
+  double tolerance[4] = {0, 0, 0, 0};
+  bool is_tolerance_percent[4] = {false, false, false, false};
+  bool valid = false;
+  Result result;
+};
+
+// Calculates the framebuffer area covered by |command| into |rect|. Returns a
+// failure if the area, or the given strides, do not fit the framebuffer.
+Result GetProbeRect(const ProbeCommand* command,
+                    uint32_t texel_stride,
+                    uint32_t row_stride,
+                    uint32_t frame_width,
+                    uint32_t frame_height,
+                    ProbeRect* rect) {
   uint32_t x = 0;
   uint32_t y = 0;
   uint32_t width = 1;
@@ -502,107 +424,210 @@ Result Verifier::Probe(const ProbeCommand* command,
                   std::to_string(texel_stride) + " bytes each");
   }
 
-  double tolerance[4] = {0, 0, 0, 0};
-  bool is_tolerance_percent[4] = {0, 0, 0, 0};
-  SetupToleranceForTexels(command, tolerance, is_tolerance_percent);
+  rect->x = x;
+  rect->y = y;
+  rect->width = width;
+  rect->height = height;
+  return {};
+}
 
-  const uint8_t* ptr = static_cast<const uint8_t*>(buf);
-  uint32_t count_of_invalid_pixels = 0;
-  uint32_t first_invalid_i = 0;
-  uint32_t first_invalid_j = 0;
-  std::vector<double> failure_values;
-  for (uint32_t j = 0; j < height; ++j) {
-    const uint8_t* p = ptr + row_stride * (j + y) + texel_stride * x;
-    for (uint32_t i = 0; i < width; ++i) {
-      auto actual_texel_values =
-          GetActualValuesFromTexel(p + texel_stride * i, fmt);
-      ScaleTexelValuesIfNeeded(&actual_texel_values, fmt);
-      if (!IsTexelEqualToExpected(actual_texel_values, fmt, command, tolerance,
-                                  is_tolerance_percent)) {
-        if (!count_of_invalid_pixels) {
-          failure_values = GetTexelInRGBA(actual_texel_values, fmt);
-          first_invalid_i = i;
-          first_invalid_j = j;
-        }
-        ++count_of_invalid_pixels;
-      }
-    }
+// Builds the failure report for |command| from the |failures| found in
+// |rect|.
+Result TexelFailureResult(const ProbeCommand* command,
+                          const Format* fmt,
+                          const ProbeRect& rect,
+                          const TexelFailures& failures) {
+  float scale = fmt->IsNormalized() ? 255.f : 1.f;
+  std::string reason =
+      "Line " + std::to_string(command->GetLine()) +
+      ": Probe failed at: " + std::to_string(rect.x + failures.first_i) +
+      ", " + std::to_string(failures.first_j + rect.y) + "\n" +
+      "  Expected: " + std::to_string(command->GetR() * scale) + ", " +
+      std::to_string(command->GetG() * scale) + ", " +
+      std::to_string(command->GetB() * scale);
+
+  if (command->IsRGBA()) {
+    reason += ", " + std::to_string(command->GetA() * scale);
   }
 
-  if (count_of_invalid_pixels) {
-    float scale = fmt->IsNormalized() ? 255.f : 1.f;
-    std::string reason =
-        "Line " + std::to_string(command->GetLine()) +
-        ": Probe failed at: " + std::to_string(x + first_invalid_i) + ", " +
-        std::to_string(first_invalid_j + y) + "\n" +
-        "  Expected: " + std::to_string(command->GetR() * scale) + ", " +
-        std::to_string(command->GetG() * scale) + ", " +
-        std::to_string(command->GetB() * scale);
-
-    if (command->IsRGBA()) {
-      reason += ", " + std::to_string(command->GetA() * scale);
-    }
+  const auto& failure_values = failures.values;
+  reason +=
+      "\n    Actual: " +
+      std::to_string(static_cast<float>(failure_values[0]) * scale) + ", " +
+      std::to_string(static_cast<float>(failure_values[1]) * scale) + ", " +
+      std::to_string(static_cast<float>(failure_values[2]) * scale);
 
+  if (command->IsRGBA()) {
     reason +=
-        "\n    Actual: " +
-        std::to_string(static_cast<float>(failure_values[0]) * scale) + ", " +
-        std::to_string(static_cast<float>(failure_values[1]) * scale) + ", " +
-        std::to_string(static_cast<float>(failure_values[2]) * scale);
-
-    if (command->IsRGBA()) {
-      reason +=
-          ", " + std::to_string(static_cast<float>(failure_values[3]) * scale);
-    }
+        ", " + std::to_string(static_cast<float>(failure_values[3]) * scale);
+  }
+
+  reason +=
+      "\nProbe failed in " + std::to_string(failures.count) + " pixels";
+
+  return Result(reason);
+}
+
+Result SSBOValueFailure(const ProbeSSBOCommand* command,
+                        const Result& failure,
+                        size_t index) {
+  return Result("Line " + std::to_string(command->GetLine()) +
+                ": Verifier failed: " + failure.Error() + ", at index " +
+                std::to_string(index));
+}
 
-    reason += "\nProbe failed in " + std::to_string(count_of_invalid_pixels) +
-              " pixels";
+// Returns the index of the first of the generated expected values [|begin|,
+// |end|) of |command| which does not match |memory|, or |end| if they all
+// match. |memory| holds tightly packed values of type T starting at value
+// |begin|. The comparisons mirror CheckValue for kEqual and kFuzzyEqual.
+template <typename T>
+size_t FindGeneratedMismatch(const ProbeSSBOCommand* command,
+                             const uint8_t* memory,
+                             size_t begin,
+                             size_t end) {
+  const T* ptr = reinterpret_cast<const T*>(memory);
+  const Value& start = command->GetSeriesStart();
+  const Value& inc = command->GetSeriesIncrement();
+  const bool is_integer = start.IsInteger();
+  const uint64_t int_start = start.AsUint64();
+  const uint64_t int_inc = inc.AsUint64();
+  const double float_start = start.AsDouble();
+  const double float_inc = inc.AsDouble();
+
+  const bool exact =
+      is_integer &&
+      command->GetComparator() == ProbeSSBOCommand::Comparator::kEqual;
+  double tolerance = kEpsilon;
+  bool is_tolerance_percent = true;
+  if (command->GetComparator() == ProbeSSBOCommand::Comparator::kFuzzyEqual &&
+      command->HasTolerances()) {
+    tolerance = command->GetTolerances()[0].value;
+    is_tolerance_percent = command->GetTolerances()[0].is_percent;
+  }
+
+  auto is_mismatch = [&](size_t i) {
+    const T expected =
+        is_integer
+            ? static_cast<T>(int_start + int_inc * static_cast<uint64_t>(i))
+            : static_cast<T>(float_start +
+                             float_inc * static_cast<double>(i));
+    const T actual = ptr[i - begin];
+    if (exact)
+      return static_cast<uint64_t>(actual) != static_cast<uint64_t>(expected);
+    return !IsEqualWithTolerance(static_cast<double>(actual),
+                                 static_cast<double>(expected), tolerance,
+                                 is_tolerance_percent);
+  };
+
+  for (size_t block = begin; block < end; block += kGeneratedBlockSize) {
+    const size_t block_end = std::min(end, block + kGeneratedBlockSize);
+    size_t mismatches = 0;
+    for (size_t i = block; i < block_end; ++i)
+      mismatches += is_mismatch(i) ? 1U : 0U;
+    if (mismatches == 0)
+      continue;
 
-    return Result(reason);
+    for (size_t i = block; i < block_end; ++i) {
+      if (is_mismatch(i))
+        return i;
+    }
   }
+  return end;
+}
 
-  return {};
+template <typename T>
+Result CheckGeneratedValues(const ProbeSSBOCommand* command,
+                            const uint8_t* ptr,
+                            size_t begin,
+                            size_t end) {
+  size_t i = FindGeneratedMismatch<T>(command, ptr, begin, end);
+  if (i == end)
+    return {};
+
+  Result r = CheckValue<T>(command, ptr + (i - begin) * sizeof(T),
+                           command->GetExpectedValue(i));
+  return SSBOValueFailure(command, r, i);
 }
 
-Result Verifier::ProbeSSBO(const ProbeSSBOCommand* command,
-                           uint32_t buffer_element_count,
-                           const void* buffer) {
-  const auto& values = command->GetValues();
-  if (!buffer) {
-    if (values.empty())
-      return {};
-    return Result(
-        "Verifier::ProbeSSBO actual data is empty while expected "
-        "data is not");
+// Checks the generated expected values [|begin|, |end|) of |command| against
+// |ptr| with a typed loop. This only handles EQ comparisons of formats whose
+// components all share one type with no padding, so memory is a flat array
+// of that type. Returns false if the format or comparator is not handled.
+bool ProbeGeneratedSSBOValues(const ProbeSSBOCommand* command,
+                              const uint8_t* ptr,
+                              size_t begin,
+                              size_t end,
+                              Result* result) {
+  const auto comp = command->GetComparator();
+  if (comp != ProbeSSBOCommand::Comparator::kEqual &&
+      comp != ProbeSSBOCommand::Comparator::kFuzzyEqual) {
+    return false;
   }
 
-  auto* fmt = command->GetFormat();
-  size_t elem_count = values.size() / fmt->InputNeededPerElement();
-  size_t offset = static_cast<size_t>(command->GetOffset());
-  size_t size_in_bytes = buffer_element_count * fmt->SizeInBytes();
-  if ((elem_count * fmt->SizeInBytes()) + offset > size_in_bytes) {
-    return Result("Line " + std::to_string(command->GetLine()) +
-                  ": Verifier::ProbeSSBO request to access to byte " +
-                  std::to_string((elem_count * fmt->SizeInBytes()) + offset) +
-                  " would read outside buffer of size " +
-                  std::to_string(size_in_bytes) + " bytes");
+  const auto& segments = command->GetFormat()->GetSegments();
+  if (segments.empty())
+    return false;
+  for (const auto& seg : segments) {
+    if (seg.IsPadding() || seg.GetFormatMode() != segments[0].GetFormatMode() ||
+        seg.GetNumBits() != segments[0].GetNumBits()) {
+      return false;
+    }
   }
 
-  if (offset % fmt->SizeInBytes() != 0) {
-    return Result("Line " + std::to_string(command->GetLine()) +
-                  ": Verifier::ProbeSSBO given offset (" +
-                  std::to_string(offset) + ") " +
-                  "is not multiple of element size (" +
-                  std::to_string(fmt->SizeInBytes()) + ")");
+  FormatMode mode = segments[0].GetFormatMode();
+  uint32_t num_bits = segments[0].GetNumBits();
+  if (type::Type::IsInt8(mode, num_bits))
+    *result = CheckGeneratedValues<int8_t>(command, ptr, begin, end);
+  else if (type::Type::IsUint8(mode, num_bits))
+    *result = CheckGeneratedValues<uint8_t>(command, ptr, begin, end);
+  else if (type::Type::IsInt16(mode, num_bits))
+    *result = CheckGeneratedValues<int16_t>(command, ptr, begin, end);
+  else if (type::Type::IsUint16(mode, num_bits))
+    *result = CheckGeneratedValues<uint16_t>(command, ptr, begin, end);
+  else if (type::Type::IsInt32(mode, num_bits))
+    *result = CheckGeneratedValues<int32_t>(command, ptr, begin, end);
+  else if (type::Type::IsUint32(mode, num_bits))
+    *result = CheckGeneratedValues<uint32_t>(command, ptr, begin, end);
+  else if (type::Type::IsInt64(mode, num_bits))
+    *result = CheckGeneratedValues<int64_t>(command, ptr, begin, end);
+  else if (type::Type::IsUint64(mode, num_bits))
+    *result = CheckGeneratedValues<uint64_t>(command, ptr, begin, end);
+  else if (type::Type::IsFloat32(mode, num_bits))
+    *result = CheckGeneratedValues<float>(command, ptr, begin, end);
+  else if (type::Type::IsFloat64(mode, num_bits))
+    *result = CheckGeneratedValues<double>(command, ptr, begin, end);
+  else
+    return false;
+
+  return true;
+}
+
+// Checks the expected values [|begin|, |end|) of |command| against |ptr|.
+// |begin| must be the first value of an element and |ptr| must point at the
+// start of that element. Returns the failure for the first mismatching value.
+Result ProbeSSBOValues(const ProbeSSBOCommand* command,
+                       const uint8_t* ptr,
+                       size_t begin,
+                       size_t end) {
+  Result generated_result;
+  if (command->HasGeneratedValues() &&
+      ProbeGeneratedSSBOValues(command, ptr, begin, end, &generated_result)) {
+    return generated_result;
   }
 
-  auto& segments = fmt->GetSegments();
+  const auto& segments = command->GetFormat()->GetSegments();
+  // Listed values are checked in place, only generated ones are built.
+  const bool generated = command->HasGeneratedValues();
+  const auto& values = command->GetValues();
+  Value generated_value;
 
-  const uint8_t* ptr = static_cast<const uint8_t*>(buffer) + offset;
-  for (size_t i = 0, k = 0; i < values.size(); ++i, ++k) {
+  for (size_t i = begin, k = 0; i < end; ++i, ++k) {
     if (k >= segments.size())
       k = 0;
 
-    const auto& value = values[i];
+    if (generated)
+      generated_value = command->GetExpectedValue(i);
+    const Value& value = generated ? generated_value : values[i];
     auto segment = segments[k];
     // Skip over any padding bytes.
     while (segment.IsPadding()) {
@@ -640,15 +665,453 @@ Result Verifier::ProbeSSBO(const ProbeSSBOCommand* command,
     else
       return Result("Unknown datum type");
 
+    if (!r.IsSuccess())
+      return SSBOValueFailure(command, r, i);
+
+    ptr += segment.SizeInBytes();
+  }
+
+  return {};
+}
+
+// Checks that the values of |command| lie within the |buffer_element_count|
+// elements at |buffer|, and start on an element boundary.
+Result CheckSSBOProbeRange(const ProbeSSBOCommand* command,
+                           uint32_t buffer_element_count,
+                           const void* buffer) {
+  const size_t value_count = command->GetValueCount();
+  if (!buffer) {
+    if (value_count == 0)
+      return {};
+    return Result(
+        "Verifier::ProbeSSBO actual data is empty while expected "
+        "data is not");
+  }
+
+  auto* fmt = command->GetFormat();
+  size_t elem_count = value_count / fmt->InputNeededPerElement();
+  size_t offset = static_cast<size_t>(command->GetOffset());
+  size_t size_in_bytes = buffer_element_count * fmt->SizeInBytes();
+  if ((elem_count * fmt->SizeInBytes()) + offset > size_in_bytes) {
+    return Result("Line " + std::to_string(command->GetLine()) +
+                  ": Verifier::ProbeSSBO request to access to byte " +
+                  std::to_string((elem_count * fmt->SizeInBytes()) + offset) +
+                  " would read outside buffer of size " +
+                  std::to_string(size_in_bytes) + " bytes");
+  }
+
+  if (offset % fmt->SizeInBytes() != 0) {
+    return Result("Line " + std::to_string(command->GetLine()) +
+                  ": Verifier::ProbeSSBO given offset (" +
+                  std::to_string(offset) + ") " +
+                  "is not multiple of element size (" +
+                  std::to_string(fmt->SizeInBytes()) + ")");
+  }
+  return {};
+}
+
+}  // namespace
+
+Verifier::Verifier() = default;
+
+Verifier::~Verifier() = default;
+
+Result Verifier::Probe(const ProbeCommand* command,
+                       const Format* fmt,
+                       uint32_t texel_stride,
+                       uint32_t row_stride,
+                       uint32_t frame_width,
+                       uint32_t frame_height,
+                       const void* buf) {
+  if (!command)
+    return Result("Verifier::Probe given ProbeCommand is nullptr");
+
+  return ProbeBatch({command}, fmt, texel_stride, row_stride, frame_width,
+                    frame_height, buf);
+}
+
+Result Verifier::ProbeBatch(const std::vector<const ProbeCommand*>& commands,
+                            const Format* fmt,
+                            uint32_t texel_stride,
+                            uint32_t row_stride,
+                            uint32_t frame_width,
+                            uint32_t frame_height,
+                            const void* buf) {
+  TraceScope trace(delegate_, "verify", "ProbeBatch");
+  for (const auto* command : commands) {
+    if (!command)
+      return Result("Verifier::Probe given ProbeCommand is nullptr");
+  }
+  if (!fmt)
+    return Result("Verifier::Probe given texel's Format is nullptr");
+  if (!buf)
+    return Result("Verifier::Probe given buffer to probe is nullptr");
+
+  std::vector<ProbeState> probes(commands.size());
+  uint32_t min_y = frame_height;
+  uint32_t max_y = 0;
+  for (size_t p = 0; p < commands.size(); ++p) {
+    ProbeState& probe = probes[p];
+    probe.result = GetProbeRect(commands[p], texel_stride, row_stride,
+                                frame_width, frame_height, &probe.rect);
+    if (!probe.result.IsSuccess())
+      continue;
+
+    probe.valid = true;
+    SetupToleranceForTexels(commands[p], probe.tolerance,
+                            probe.is_tolerance_percent);
+    min_y = std::min(min_y, probe.rect.y);
+    max_y = std::max(max_y, probe.rect.y + probe.rect.height);
+  }
+
+  // Sweep the rows in order, visiting each probe while a row crosses its
+  // rectangle. A texel covered by several probes is only decoded once.
+  std::vector<size_t> by_y;
+  size_t max_width = 1;
+  for (size_t p = 0; p < probes.size(); ++p) {
+    if (!probes[p].valid)
+      continue;
+
+    by_y.push_back(p);
+    max_width = std::max(max_width, static_cast<size_t>(probes[p].rect.width));
+  }
+  std::stable_sort(by_y.begin(), by_y.end(), [&probes](size_t a, size_t b) {
+    return probes[a].rect.y < probes[b].rect.y;
+  });
+
+  const uint8_t* ptr = static_cast<const uint8_t*>(buf);
+  size_t rows = max_y > min_y ? max_y - min_y : 0;
+
+  // Each chunk of rows records its own failures. The chunks are merged in row
+  // order so the report matches a single threaded probe.
+  size_t min_rows = std::max(size_t(1), kMinTexelsPerThread / max_width);
+  std::vector<std::vector<TexelFailures>> chunk_failures(
+      ParallelChunkCount(thread_count_, rows, min_rows),
+      std::vector<TexelFailures>(probes.size()));
+  ParallelFor(
+      thread_count_, rows, min_rows,
+      [&](uint32_t chunk, size_t row_begin, size_t row_end) {
+        std::vector<TexelFailures>& failures = chunk_failures[chunk];
+        std::vector<size_t> active;
+        std::vector<std::vector<double>> row_cache;
+        std::vector<bool> is_cached;
+        size_t next = 0;
+
+        for (uint32_t j = static_cast<uint32_t>(min_y + row_begin);
+             j < min_y + row_end; ++j) {
+          while (next < by_y.size() && probes[by_y[next]].rect.y <= j) {
+            active.push_back(by_y[next]);
+            ++next;
+          }
+          active.erase(std::remove_if(active.begin(), active.end(),
+                                      [&probes, j](size_t p) {
+                                        const auto& rect = probes[p].rect;
+                                        return rect.y + rect.height <= j;
+                                      }),
+                       active.end());
+          if (active.empty())
+            continue;
+
+          const bool use_cache = active.size() > 1;
+          if (use_cache)
+            is_cached.assign(frame_width, false);
+          if (use_cache && row_cache.size() < frame_width)
+            row_cache.resize(frame_width);
+
+          const uint8_t* row = ptr + row_stride * j;
+          for (size_t p : active) {
+            const ProbeState& probe = probes[p];
+            for (uint32_t i = probe.rect.x;
+                 i < probe.rect.x + probe.rect.width; ++i) {
+              std::vector<double> decoded;
+              if (!use_cache || !is_cached[i]) {
+                decoded = GetActualValuesFromTexel(row + texel_stride * i, fmt);
+                ScaleTexelValuesIfNeeded(&decoded, fmt);
+                if (use_cache) {
+                  row_cache[i] = std::move(decoded);
+                  is_cached[i] = true;
+                }
+              }
+              const std::vector<double>& actual_texel_values =
+                  use_cache ? row_cache[i] : decoded;
+
+              if (!IsTexelEqualToExpected(actual_texel_values, fmt,
+                                          commands[p], probe.tolerance,
+                                          probe.is_tolerance_percent)) {
+                TexelFailures& failure = failures[p];
+                if (!failure.count) {
+                  failure.values = GetTexelInRGBA(actual_texel_values, fmt);
+                  failure.first_i = i - probe.rect.x;
+                  failure.first_j = j - probe.rect.y;
+                }
+                ++failure.count;
+              }
+            }
+          }
+        }
+      });
+
+  // Report the first probe, in the given order, which failed.
+  for (size_t p = 0; p < probes.size(); ++p) {
+    if (!probes[p].valid)
+      return probes[p].result;
+
+    TexelFailures merged;
+    for (auto& failures : chunk_failures) {
+      TexelFailures& failure = failures[p];
+      if (!failure.count)
+        continue;
+
+      if (!merged.count) {
+        merged.values = std::move(failure.values);
+        merged.first_i = failure.first_i;
+        merged.first_j = failure.first_j;
+      }
+      merged.count += failure.count;
+    }
+
+    if (merged.count)
+      return TexelFailureResult(commands[p], fmt, probes[p].rect, merged);
+  }
+
+  return {};
+}
+
+Result Verifier::ProbeSSBO(const ProbeSSBOCommand* command,
+                           uint32_t buffer_element_count,
+                           const void* buffer) {
+  TraceScope trace(delegate_, "verify", "ProbeSSBO");
+  Result r = CheckSSBOProbeRange(command, buffer_element_count, buffer);
+  if (!r.IsSuccess())
+    return r;
+
+  const size_t value_count = command->GetValueCount();
+  if (value_count == 0)
+    return {};
+
+  // Split on element boundaries so every range starts at the first segment of
+  // the format. The first failing range holds the first failing value.
+  auto* fmt = command->GetFormat();
+  const uint8_t* ptr =
+      static_cast<const uint8_t*>(buffer) + command->GetOffset();
+  size_t values_per_elem = std::max(1U, fmt->InputNeededPerElement());
+  size_t total_elems = (value_count + values_per_elem - 1) / values_per_elem;
+  size_t min_elems =
+      std::max(size_t(1), kMinSSBOValuesPerThread / values_per_elem);
+  std::vector<Result> chunk_results(
+      ParallelChunkCount(thread_count_, total_elems, min_elems));
+  ParallelFor(thread_count_, total_elems, min_elems,
+              [&](uint32_t chunk, size_t elem_begin, size_t elem_end) {
+                chunk_results[chunk] = ProbeSSBOValues(
+                    command, ptr + elem_begin * fmt->SizeInBytes(),
+                    elem_begin * values_per_elem,
+                    std::min(elem_end * values_per_elem, value_count));
+              });
+
+  for (const auto& chunk_result : chunk_results) {
+    if (!chunk_result.IsSuccess())
+      return chunk_result;
+  }
+
+  return {};
+}
+
+Result Verifier::ProbeSSBOBatch(
+    const std::vector<const ProbeSSBOCommand*>& commands,
+    uint32_t buffer_element_count,
+    const void* buffer) {
+  // A single probe can still be split across threads.
+  if (commands.size() == 1)
+    return ProbeSSBO(commands[0], buffer_element_count, buffer);
+
+  TraceScope trace(delegate_, "verify", "ProbeSSBOBatch");
+  // The first failure in the order given, and the index of its command.
+  Result failure;
+  size_t failure_index = commands.size();
+
+  // Each probe has a cursor at its next unchecked element. The cursors are
+  // kept in a heap ordered by the byte offset of that element, so the buffer
+  // is walked once from front to back, with overlapping probes interleaved.
+  struct Cursor {
+    size_t index;
+    size_t position;
+    size_t elem;
+    size_t total_elems;
+  };
+  auto later = [](const Cursor& a, const Cursor& b) {
+    return a.position > b.position ||
+           (a.position == b.position && a.index > b.index);
+  };
+  std::vector<Cursor> heap;
+  for (size_t i = 0; i < commands.size(); ++i) {
+    Result r = CheckSSBOProbeRange(commands[i], buffer_element_count, buffer);
     if (!r.IsSuccess()) {
-      return Result("Line " + std::to_string(command->GetLine()) +
-                    ": Verifier failed: " + r.Error() + ", at index " +
-                    std::to_string(i));
+      if (i < failure_index) {
+        failure = r;
+        failure_index = i;
+      }
+      continue;
     }
 
-    ptr += segment.SizeInBytes();
+    size_t values_per_elem =
+        std::max(1U, commands[i]->GetFormat()->InputNeededPerElement());
+    size_t total_elems =
+        (commands[i]->GetValueCount() + values_per_elem - 1) / values_per_elem;
+    if (total_elems > 0)
+      heap.push_back({i, commands[i]->GetOffset(), 0, total_elems});
+  }
+  std::make_heap(heap.begin(), heap.end(), later);
+
+  const uint8_t* data = static_cast<const uint8_t*>(buffer);
+  while (!heap.empty()) {
+    std::pop_heap(heap.begin(), heap.end(), later);
+    Cursor cursor = heap.back();
+    heap.pop_back();
+
+    // A probe after an earlier failure can not change the result.
+    if (cursor.index > failure_index)
+      continue;
+
+    // Check the elements which start before the next cursor, or at least one.
+    const auto* command = commands[cursor.index];
+    const auto* fmt = command->GetFormat();
+    size_t elem_size = fmt->SizeInBytes();
+    size_t count = 1;
+    if (heap.empty()) {
+      count = cursor.total_elems - cursor.elem;
+    } else if (heap.front().position > cursor.position) {
+      count = (heap.front().position - cursor.position + elem_size - 1) /
+              elem_size;
+    }
+    count = std::min(count, cursor.total_elems - cursor.elem);
+
+    size_t values_per_elem = std::max(1U, fmt->InputNeededPerElement());
+    Result r = ProbeSSBOValues(
+        command, data + cursor.position, cursor.elem * values_per_elem,
+        std::min((cursor.elem + count) * values_per_elem,
+                 command->GetValueCount()));
+    if (!r.IsSuccess()) {
+      failure = r;
+      failure_index = cursor.index;
+      continue;
+    }
+
+    cursor.elem += count;
+    cursor.position += count * elem_size;
+    if (cursor.elem < cursor.total_elems) {
+      heap.push_back(cursor);
+      std::push_heap(heap.begin(), heap.end(), later);
+    }
+  }
+
+  return failure;
+}
+
+Result Verifier::ProbeHash(const HashBufferCommand* command) {
+  TraceScope trace(delegate_, "verify", "ProbeHash");
+  const auto* buffer = command->GetBuffer();
+  uint64_t hash = HashData(command->GetHashType(), buffer->GetRawData(),
+                           buffer->GetRawDataSize());
+  if (hash == command->GetExpectedHash())
+    return {};
+
+  std::stringstream reason;
+  reason << "Line " << command->GetLine() << ": Verifier failed: "
+         << HashTypeToName(command->GetHashType()) << " of buffer "
+         << buffer->GetName() << " is 0x" << std::hex << hash
+         << ", expected 0x" << command->GetExpectedHash();
+  return Result(reason.str());
+}
+
+Result Verifier::ProbeFile(const CompareFileCommand* command) {
+  TraceScope trace(delegate_, "verify", "ProbeFile");
+  std::unique_ptr<MappedFile> file;
+  Result r = MappedFile::Open(command->GetPath(), &file);
+  if (!r.IsSuccess()) {
+    return Result("Line " + std::to_string(command->GetLine()) + ": " +
+                  r.Error());
+  }
+
+  const auto* buffer = command->GetBuffer();
+  switch (command->GetComparator()) {
+    case CompareFileCommand::Comparator::kRmse:
+      r = buffer->CompareRMSEToData(file->GetData(), file->GetSize(),
+                                    command->GetTolerance());
+      break;
+    case CompareFileCommand::Comparator::kEq:
+      r = buffer->IsEqualToData(file->GetData(), file->GetSize());
+      break;
+  }
+  if (!r.IsSuccess()) {
+    return Result("Line " + std::to_string(command->GetLine()) +
+                  ": Verifier failed: buffer " + buffer->GetName() +
+                  " does not match " + command->GetPath() + ": " + r.Error());
+  }
+  return {};
+}
+
+Result Verifier::CompareImages(const CompareBufferCommand* command) {
+  TraceScope trace(delegate_, "verify", "CompareImages");
+  const auto* buffer_1 = command->GetBuffer1();
+  const auto* buffer_2 = command->GetBuffer2();
+  const std::string prefix = "Line " + std::to_string(command->GetLine()) +
+                             ": Verifier failed: buffer " +
+                             buffer_1->GetName() + " vs " +
+                             buffer_2->GetName() + ": ";
+
+  uint32_t width = buffer_1->GetWidth();
+  uint32_t height = buffer_1->GetHeight();
+  if (width == 0 || height == 0) {
+    width = buffer_1->ElementCount();
+    height = 1;
   }
 
+  size_t size = size_t(width) * height * buffer_1->GetFormat()->SizeInBytes();
+  if (buffer_1->GetRawDataSize() < size || buffer_2->GetRawDataSize() < size)
+    return Result(prefix + "buffer is smaller than the image");
+
+  ImageMetrics metrics;
+  Result r = ComputeImageMetrics(buffer_1->GetFormat(),
+                                 buffer_1->GetRawData(), buffer_2->GetRawData(),
+                                 width, height, thread_count_, &metrics);
+  if (!r.IsSuccess())
+    return Result(prefix + r.Error());
+
+  const double threshold = static_cast<double>(command->GetTolerance());
+  switch (command->GetComparator()) {
+    case CompareBufferCommand::Comparator::kSsim:
+      if (!(metrics.ssim >= threshold)) {
+        return Result(prefix + "SSIM of " + std::to_string(metrics.ssim) +
+                      " is less than threshold of " +
+                      std::to_string(threshold));
+      }
+      break;
+    case CompareBufferCommand::Comparator::kPsnr:
+      if (!(metrics.psnr >= threshold)) {
+        return Result(prefix + "PSNR of " + std::to_string(metrics.psnr) +
+                      " dB is less than threshold of " +
+                      std::to_string(threshold) + " dB");
+      }
+      break;
+    case CompareBufferCommand::Comparator::kMaxError: {
+      const char* names = "RGBA";
+      const auto& tolerances = command->GetComponentTolerances();
+      for (size_t i = 0; i < 4 && i < tolerances.size(); ++i) {
+        const double tolerance = static_cast<double>(tolerances[i]);
+        if (!(metrics.max_abs_error[i] <= tolerance)) {
+          return Result(prefix + "maximum error of component " + names[i] +
+                        " is " + std::to_string(metrics.max_abs_error[i]) +
+                        ", greater than tolerance of " +
+                        std::to_string(tolerances[i]));
+        }
+      }
+      break;
+    }
+    case CompareBufferCommand::Comparator::kEq:
+    case CompareBufferCommand::Comparator::kRmse:
+      assert(false && "Not an image comparator");
+      break;
+  }
   return {};
 }
 
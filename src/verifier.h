@@ -17,6 +17,7 @@
 
 #include <vector>
 
+#include "amber/amber.h"
 #include "amber/result.h"
 #include "src/command.h"
 #include "src/format.h"
@@ -30,6 +31,16 @@ class Verifier {
   Verifier();
   ~Verifier();
 
+  /// Sets the number of threads used to verify large probes. Rows of a
+  /// framebuffer, or elements of a SSBO, are split across the threads. A
+  /// value of 0 or 1 verifies everything on the calling thread. The reported
+  /// results are the same regardless of the thread count.
+  void SetThreadCount(uint32_t count) { thread_count_ = count; }
+  uint32_t GetThreadCount() const { return thread_count_; }
+
+  /// Sets the delegate which the time spent verifying is traced through.
+  void SetDelegate(Delegate* delegate) { delegate_ = delegate; }
+
   /// Check |command| against |buf|. The result will be success if the probe
   /// passes correctly.
   Result Probe(const ProbeCommand* command,
@@ -40,11 +51,50 @@ class Verifier {
                uint32_t frame_height,
                const void* buf);
 
+  /// Check all of |commands| against |buf| in a single pass over the rows
+  /// of the frame. Each of |commands| must probe the frame described by the
+  /// remaining parameters. The result is the failure of the first command, in
+  /// the order given, which does not pass, or success if all of them pass.
+  Result ProbeBatch(const std::vector<const ProbeCommand*>& commands,
+                    const Format* texel_format,
+                    uint32_t texel_stride,
+                    uint32_t row_stride,
+                    uint32_t frame_width,
+                    uint32_t frame_height,
+                    const void* buf);
+
   /// Check |command| against |cpu_memory|. The result will be success if the
   /// probe passes correctly.
   Result ProbeSSBO(const ProbeSSBOCommand* command,
                    uint32_t buffer_element_count,
                    const void* buffer);
+
+  /// Check the hash of the contents of the buffer in |command| against the
+  /// expected hash. The result will be success if the hashes match.
+  Result ProbeHash(const HashBufferCommand* command);
+
+  /// Compare the contents of the buffer in |command| against the contents of
+  /// the file in |command|. The file is mapped rather than read so large
+  /// expected results do not need to be loaded into memory.
+  Result ProbeFile(const CompareFileCommand* command);
+
+  /// Compare the two buffers of |command| as images, using its SSIM, PSNR or
+  /// maximum error comparator. Buffers without a width and height are
+  /// compared as a single row of texels.
+  Result CompareImages(const CompareBufferCommand* command);
+
+  /// Check all of |commands| against |buffer| in a single front to back walk
+  /// of the buffer, interleaving the elements of overlapping probes. The
+  /// result is the failure of the first command, in the order given, which
+  /// does not pass, or success if all of them pass. Commands after a failing
+  /// one are not checked any further.
+  Result ProbeSSBOBatch(const std::vector<const ProbeSSBOCommand*>& commands,
+                        uint32_t buffer_element_count,
+                        const void* buffer);
+
+ private:
+  uint32_t thread_count_ = 1;
+  Delegate* delegate_ = nullptr;
 };
 
 }  // namespace amber
@@ -0,0 +1,103 @@
+// Copyright 2020 The Amber Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "src/benchmark.h"
+#include "src/benchmark_data.h"
+#include "src/command.h"
+#include "src/format.h"
+#include "src/pipeline.h"
+#include "src/type_parser.h"
+#include "src/verifier.h"
+
+namespace amber {
+namespace benchmark {
+namespace {
+
+const uint32_t kFrameSize = 1024;
+
+void ProbeWholeWindow(State* state) {
+  TypeParser parser;
+  auto type = parser.Parse("B8G8R8A8_UNORM");
+  Format fmt(type.get());
+
+  Pipeline pipeline(PipelineType::kGraphics);
+  auto color_buf = pipeline.GenerateDefaultColorAttachmentBuffer();
+
+  ProbeCommand probe(color_buf.get());
+  probe.SetWholeWindow();
+  probe.SetProbeRect();
+  probe.SetIsRGBA();
+  probe.SetB(0.5f);
+  probe.SetG(0.25f);
+  probe.SetR(0.2f);
+  probe.SetA(0.8f);
+
+  const uint8_t texel[4] = {128, 64, 51, 204};
+  auto frame = GenerateFramebuffer(kFrameSize, kFrameSize, texel);
+
+  Verifier verifier;
+  while (state->KeepRunning()) {
+    Result r = verifier.Probe(&probe, &fmt, 4, kFrameSize * 4, kFrameSize,
+                              kFrameSize, frame.data());
+    if (!r.IsSuccess())
+      state->SetError(r);
+  }
+  state->SetItemsPerIteration(kFrameSize * kFrameSize);
+  state->SetBytesPerIteration(frame.size());
+}
+
+void ProbeSSBOFuzzy(State* state) {
+  const uint32_t kCount = 1024 * 1024;
+
+  Pipeline pipeline(PipelineType::kGraphics);
+  auto color_buf = pipeline.GenerateDefaultColorAttachmentBuffer();
+
+  TypeParser parser;
+  auto type = parser.Parse("R32_SFLOAT");
+  Format fmt(type.get());
+
+  auto values = GenerateFloatValues(kCount, 3);
+  std::vector<float> ssbo(kCount);
+  for (size_t i = 0; i < kCount; ++i)
+    ssbo[i] = values[i].AsFloat();
+
+  ProbeSSBOCommand probe(color_buf.get());
+  probe.SetFormat(&fmt);
+  probe.SetComparator(ProbeSSBOCommand::Comparator::kFuzzyEqual);
+  probe.SetTolerances({Probe::Tolerance(false, 0.01)});
+  probe.SetValues(std::move(values));
+
+  Verifier verifier;
+  while (state->KeepRunning()) {
+    Result r = verifier.ProbeSSBO(&probe, kCount, ssbo.data());
+    if (!r.IsSuccess())
+      state->SetError(r);
+  }
+  state->SetItemsPerIteration(kCount);
+  state->SetBytesPerIteration(kCount * sizeof(float));
+}
+
+}  // namespace
+
+void AddVerifierBenchmarks(Runner* runner) {
+  runner->Add("Verifier/Probe", ProbeWholeWindow);
+  runner->Add("Verifier/ProbeSSBO", ProbeSSBOFuzzy);
+}
+
+}  // namespace benchmark
+}  // namespace amber
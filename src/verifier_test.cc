@@ -14,7 +14,12 @@
 
 #include "src/verifier.h"
 
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -1520,4 +1525,605 @@ TEST_F(VerifierTest, ProbeSSBOWithPadding) {
   EXPECT_TRUE(r.IsSuccess()) << r.Error();
 }
 
+
+TEST_F(VerifierTest, ProbeFrameBufferMultiThreadedMatchesSingleThreaded) {
+  Pipeline pipeline(PipelineType::kGraphics);
+  auto color_buf = pipeline.GenerateDefaultColorAttachmentBuffer();
+
+  ProbeCommand probe(color_buf.get());
+  probe.SetWholeWindow();
+  probe.SetProbeRect();
+  probe.SetIsRGBA();
+  probe.SetR(0.0f);
+  probe.SetG(0.0f);
+  probe.SetB(0.0f);
+  probe.SetA(0.0f);
+
+  const uint32_t kWidth = 256;
+  const uint32_t kHeight = 256;
+  std::vector<uint8_t> frame_buffer(kWidth * kHeight * 4, 0);
+  // Failures in several row ranges so more than one thread finds some.
+  frame_buffer[(100 * kWidth + 7) * 4] = 255;
+  frame_buffer[(101 * kWidth + 3) * 4] = 255;
+  frame_buffer[(200 * kWidth + 9) * 4 + 1] = 255;
+  frame_buffer[(255 * kWidth + 255) * 4 + 3] = 255;
+
+  Verifier serial;
+  Result expected = serial.Probe(&probe, GetColorFormat(), 4, kWidth * 4,
+                                 kWidth, kHeight, frame_buffer.data());
+  EXPECT_EQ(
+      "Line 1: Probe failed at: 7, 100\n  Expected: 0.000000, 0.000000, "
+      "0.000000, 0.000000\n    Actual: 0.000000, 0.000000, 255.000000, "
+      "0.000000\nProbe failed in 4 pixels",
+      expected.Error());
+
+  Verifier parallel;
+  parallel.SetThreadCount(4);
+  Result r = parallel.Probe(&probe, GetColorFormat(), 4, kWidth * 4, kWidth,
+                            kHeight, frame_buffer.data());
+  EXPECT_EQ(expected.Error(), r.Error());
+}
+
+TEST_F(VerifierTest, ProbeSSBOMultiThreadedMatchesSingleThreaded) {
+  Pipeline pipeline(PipelineType::kGraphics);
+  auto color_buf = pipeline.GenerateDefaultColorAttachmentBuffer();
+
+  ProbeSSBOCommand probe_ssbo(color_buf.get());
+
+  TypeParser parser;
+  auto type = parser.Parse("R32G32B32_SFLOAT");
+  Format fmt(type.get());
+
+  probe_ssbo.SetFormat(&fmt);
+  probe_ssbo.SetComparator(ProbeSSBOCommand::Comparator::kEqual);
+
+  // vec3 data is padded out to 4 floats per element.
+  const size_t kElements = 100000;
+  std::vector<Value> values(kElements * 3);
+  std::vector<float> ssbo(kElements * 4, 0.0f);
+  for (size_t i = 0; i < kElements; ++i) {
+    for (size_t c = 0; c < 3; ++c) {
+      values[i * 3 + c].SetDoubleValue(static_cast<double>(i + c));
+      ssbo[i * 4 + c] = static_cast<float>(i + c);
+    }
+  }
+  probe_ssbo.SetValues(std::move(values));
+
+  Verifier parallel;
+  parallel.SetThreadCount(4);
+  Result r = parallel.ProbeSSBO(&probe_ssbo, kElements, ssbo.data());
+  EXPECT_TRUE(r.IsSuccess()) << r.Error();
+
+  ssbo[60000 * 4 + 2] = 1.0f;
+  ssbo[90000 * 4 + 1] = 1.0f;
+
+  Verifier serial;
+  Result expected = serial.ProbeSSBO(&probe_ssbo, kElements, ssbo.data());
+  EXPECT_EQ(
+      "Line 1: Verifier failed: 1.000000 == 60002.000000, at index 180002",
+      expected.Error());
+
+  r = parallel.ProbeSSBO(&probe_ssbo, kElements, ssbo.data());
+  EXPECT_EQ(expected.Error(), r.Error());
+}
+
+TEST_F(VerifierTest, ProbeSSBOFill) {
+  Pipeline pipeline(PipelineType::kGraphics);
+  auto color_buf = pipeline.GenerateDefaultColorAttachmentBuffer();
+
+  ProbeSSBOCommand probe_ssbo(color_buf.get());
+
+  TypeParser parser;
+  auto type = parser.Parse("R32_UINT");
+  Format fmt(type.get());
+
+  Value fill;
+  fill.SetIntValue(7);
+  probe_ssbo.SetFormat(&fmt);
+  probe_ssbo.SetFill(fill, 1000);
+  EXPECT_EQ(1000U, probe_ssbo.GetValueCount());
+
+  std::vector<uint32_t> ssbo(1000, 7);
+
+  Verifier verifier;
+  Result r = verifier.ProbeSSBO(&probe_ssbo, 1000, ssbo.data());
+  EXPECT_TRUE(r.IsSuccess()) << r.Error();
+
+  ssbo[500] = 8;
+  ssbo[900] = 9;
+  r = verifier.ProbeSSBO(&probe_ssbo, 1000, ssbo.data());
+  EXPECT_EQ("Line 1: Verifier failed: 8 == 7, at index 500", r.Error());
+}
+
+TEST_F(VerifierTest, ProbeSSBOSeries) {
+  Pipeline pipeline(PipelineType::kGraphics);
+  auto color_buf = pipeline.GenerateDefaultColorAttachmentBuffer();
+
+  ProbeSSBOCommand probe_ssbo(color_buf.get());
+
+  TypeParser parser;
+  auto type = parser.Parse("R32_SINT");
+  Format fmt(type.get());
+
+  Value start;
+  start.SetIntValue(10);
+  Value inc;
+  inc.SetIntValue(static_cast<uint64_t>(-2));
+  probe_ssbo.SetFormat(&fmt);
+  probe_ssbo.SetSeries(start, inc, 1000);
+
+  std::vector<int32_t> ssbo(1000);
+  for (size_t i = 0; i < ssbo.size(); ++i)
+    ssbo[i] = 10 - 2 * static_cast<int32_t>(i);
+
+  Verifier verifier;
+  Result r = verifier.ProbeSSBO(&probe_ssbo, 1000, ssbo.data());
+  EXPECT_TRUE(r.IsSuccess()) << r.Error();
+
+  ssbo[700] = 0;
+  r = verifier.ProbeSSBO(&probe_ssbo, 1000, ssbo.data());
+  EXPECT_EQ("Line 1: Verifier failed: 0 == -1390, at index 700", r.Error());
+}
+
+TEST_F(VerifierTest, ProbeSSBOSeriesWithTolerance) {
+  Pipeline pipeline(PipelineType::kGraphics);
+  auto color_buf = pipeline.GenerateDefaultColorAttachmentBuffer();
+
+  ProbeSSBOCommand probe_ssbo(color_buf.get());
+
+  TypeParser parser;
+  auto type = parser.Parse("R32_SFLOAT");
+  Format fmt(type.get());
+
+  Value start;
+  start.SetDoubleValue(0.5);
+  Value inc;
+  inc.SetDoubleValue(0.25);
+  probe_ssbo.SetFormat(&fmt);
+  probe_ssbo.SetComparator(ProbeSSBOCommand::Comparator::kFuzzyEqual);
+  probe_ssbo.SetTolerances({Probe::Tolerance{false, 0.1}});
+  probe_ssbo.SetSeries(start, inc, 4);
+
+  float ssbo[4] = {0.55f, 0.8f, 0.95f, 1.3f};
+
+  Verifier verifier;
+  Result r = verifier.ProbeSSBO(&probe_ssbo, 4, ssbo);
+  EXPECT_TRUE(r.IsSuccess()) << r.Error();
+
+  ssbo[3] = 1.45f;
+  r = verifier.ProbeSSBO(&probe_ssbo, 4, ssbo);
+  EXPECT_EQ("Line 1: Verifier failed: 1.450000 ~= 1.250000, at index 3",
+            r.Error());
+}
+
+TEST_F(VerifierTest, ProbeSSBOSeriesWithPadding) {
+  Pipeline pipeline(PipelineType::kGraphics);
+  auto color_buf = pipeline.GenerateDefaultColorAttachmentBuffer();
+
+  ProbeSSBOCommand probe_ssbo(color_buf.get());
+
+  TypeParser parser;
+  auto type = parser.Parse("R32G32B32_SFLOAT");
+  Format fmt(type.get());
+
+  Value start;
+  start.SetDoubleValue(0.0);
+  Value inc;
+  inc.SetDoubleValue(1.0);
+  probe_ssbo.SetFormat(&fmt);
+  probe_ssbo.SetSeries(start, inc, 6);
+
+  // vec3 data is padded out to 4 floats per element.
+  float ssbo[8] = {0.f, 1.f, 2.f, -1.f, 3.f, 4.f, 5.f, -1.f};
+
+  Verifier verifier;
+  Result r = verifier.ProbeSSBO(&probe_ssbo, 2, ssbo);
+  EXPECT_TRUE(r.IsSuccess()) << r.Error();
+
+  ssbo[5] = 8.f;
+  r = verifier.ProbeSSBO(&probe_ssbo, 2, ssbo);
+  EXPECT_EQ("Line 1: Verifier failed: 8.000000 == 4.000000, at index 4",
+            r.Error());
+}
+
+TEST_F(VerifierTest, ProbeSSBOFillMultiThreadedMatchesSingleThreaded) {
+  Pipeline pipeline(PipelineType::kGraphics);
+  auto color_buf = pipeline.GenerateDefaultColorAttachmentBuffer();
+
+  ProbeSSBOCommand probe_ssbo(color_buf.get());
+
+  TypeParser parser;
+  auto type = parser.Parse("R8_UINT");
+  Format fmt(type.get());
+
+  const size_t kValues = 1000000;
+  Value fill;
+  fill.SetIntValue(3);
+  probe_ssbo.SetFormat(&fmt);
+  probe_ssbo.SetFill(fill, kValues);
+
+  std::vector<uint8_t> ssbo(kValues, 3);
+
+  Verifier parallel;
+  parallel.SetThreadCount(4);
+  Result r = parallel.ProbeSSBO(&probe_ssbo, kValues, ssbo.data());
+  EXPECT_TRUE(r.IsSuccess()) << r.Error();
+
+  ssbo[600000] = 4;
+  ssbo[900000] = 5;
+
+  Verifier serial;
+  Result expected = serial.ProbeSSBO(&probe_ssbo, kValues, ssbo.data());
+  EXPECT_EQ("Line 1: Verifier failed: 4 == 3, at index 600000",
+            expected.Error());
+
+  r = parallel.ProbeSSBO(&probe_ssbo, kValues, ssbo.data());
+  EXPECT_EQ(expected.Error(), r.Error());
+}
+
+TEST_F(VerifierTest, ProbeBatchReportsFirstFailingCommand) {
+  Pipeline pipeline(PipelineType::kGraphics);
+  auto color_buf = pipeline.GenerateDefaultColorAttachmentBuffer();
+
+  // 4x4 frame, black except for a red texel at (2, 1).
+  uint8_t frame_buffer[4][4][4] = {};
+  frame_buffer[1][2][2] = 255;
+  frame_buffer[1][2][3] = 255;
+
+  ProbeCommand whole(color_buf.get());
+  whole.SetLine(10);
+  whole.SetWholeWindow();
+  whole.SetProbeRect();
+  whole.SetIsRGBA();
+  whole.SetA(1.0f);
+
+  ProbeCommand red(color_buf.get());
+  red.SetLine(11);
+  red.SetX(2.0f);
+  red.SetY(1.0f);
+  red.SetIsRGBA();
+  red.SetR(1.0f);
+  red.SetA(1.0f);
+
+  ProbeCommand black(color_buf.get());
+  black.SetLine(12);
+  black.SetProbeRect();
+  black.SetX(1.0f);
+  black.SetY(0.0f);
+  black.SetWidth(3.0f);
+  black.SetHeight(3.0f);
+
+  Verifier verifier;
+  Result r = verifier.ProbeBatch({&red}, GetColorFormat(), 4, 16, 4, 4,
+                                 static_cast<const void*>(frame_buffer));
+  EXPECT_TRUE(r.IsSuccess()) << r.Error();
+
+  // The second and third probes both fail, only the second is reported.
+  r = verifier.ProbeBatch({&red, &whole, &black}, GetColorFormat(), 4, 16, 4,
+                          4, static_cast<const void*>(frame_buffer));
+  EXPECT_EQ(
+      "Line 10: Probe failed at: 0, 0\n  Expected: 0.000000, 0.000000, "
+      "0.000000, 255.000000\n    Actual: 0.000000, 0.000000, 0.000000, "
+      "0.000000\nProbe failed in 16 pixels",
+      r.Error());
+
+  r = verifier.ProbeBatch({&red, &black}, GetColorFormat(), 4, 16, 4, 4,
+                          static_cast<const void*>(frame_buffer));
+  EXPECT_EQ(
+      "Line 12: Probe failed at: 2, 1\n  Expected: 0.000000, 0.000000, "
+      "0.000000\n    Actual: 255.000000, 0.000000, 0.000000\nProbe failed "
+      "in 1 pixels",
+      r.Error());
+
+  // Each probe reports the same failure on its own.
+  Result single = verifier.Probe(&black, GetColorFormat(), 4, 16, 4, 4,
+                                 static_cast<const void*>(frame_buffer));
+  EXPECT_EQ(r.Error(), single.Error());
+}
+
+TEST_F(VerifierTest, ProbeBatchOutOfFrameAfterFailure) {
+  Pipeline pipeline(PipelineType::kGraphics);
+  auto color_buf = pipeline.GenerateDefaultColorAttachmentBuffer();
+
+  uint8_t frame_buffer[2][2][4] = {};
+
+  ProbeCommand failing(color_buf.get());
+  failing.SetLine(3);
+  failing.SetX(1.0f);
+  failing.SetY(1.0f);
+  failing.SetR(1.0f);
+
+  ProbeCommand outside(color_buf.get());
+  outside.SetLine(4);
+  outside.SetX(5.0f);
+  outside.SetY(0.0f);
+
+  Verifier verifier;
+  Result r = verifier.ProbeBatch({&outside, &failing}, GetColorFormat(), 4, 8,
+                                 2, 2, static_cast<const void*>(frame_buffer));
+  EXPECT_EQ(
+      "Line 4: Verifier::Probe Position(5, 0) is out of framebuffer scope "
+      "(2,2)",
+      r.Error());
+
+  r = verifier.ProbeBatch({&failing, &outside}, GetColorFormat(), 4, 8, 2, 2,
+                          static_cast<const void*>(frame_buffer));
+  EXPECT_EQ(
+      "Line 3: Probe failed at: 1, 1\n  Expected: 255.000000, 0.000000, "
+      "0.000000\n    Actual: 0.000000, 0.000000, 0.000000\nProbe failed "
+      "in 1 pixels",
+      r.Error());
+}
+
+TEST_F(VerifierTest, ProbeSSBOBatchReportsFirstFailingCommand) {
+  Pipeline pipeline(PipelineType::kGraphics);
+  auto color_buf = pipeline.GenerateDefaultColorAttachmentBuffer();
+
+  TypeParser parser;
+  auto type = parser.Parse("R32_UINT");
+  Format fmt(type.get());
+
+  const uint32_t ssbo[4] = {1, 2, 3, 4};
+
+  ProbeSSBOCommand high(color_buf.get());
+  high.SetLine(7);
+  high.SetFormat(&fmt);
+  high.SetOffset(12);
+  std::vector<Value> high_values(1);
+  high_values[0].SetIntValue(5);
+  high.SetValues(std::move(high_values));
+
+  ProbeSSBOCommand low(color_buf.get());
+  low.SetLine(8);
+  low.SetFormat(&fmt);
+  low.SetOffset(0);
+  std::vector<Value> low_values(2);
+  low_values[0].SetIntValue(1);
+  low_values[1].SetIntValue(3);
+  low.SetValues(std::move(low_values));
+
+  Verifier verifier;
+  Result r = verifier.ProbeSSBOBatch({&high, &low}, 4, ssbo);
+  EXPECT_EQ("Line 7: Verifier failed: 4 == 5, at index 0", r.Error());
+
+  r = verifier.ProbeSSBOBatch({&low, &high}, 4, ssbo);
+  EXPECT_EQ("Line 8: Verifier failed: 2 == 3, at index 1", r.Error());
+}
+
+TEST_F(VerifierTest, ProbeSSBOBatchOverlappingFormats) {
+  Pipeline pipeline(PipelineType::kGraphics);
+  auto color_buf = pipeline.GenerateDefaultColorAttachmentBuffer();
+
+  TypeParser parser;
+  auto uint_type = parser.Parse("R32_UINT");
+  Format uint_fmt(uint_type.get());
+  auto vec2_type = parser.Parse("R32G32_UINT");
+  Format vec2_fmt(vec2_type.get());
+
+  const uint32_t ssbo[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+
+  // Covers the whole buffer as vec2 values.
+  ProbeSSBOCommand whole(color_buf.get());
+  whole.SetLine(1);
+  whole.SetFormat(&vec2_fmt);
+  std::vector<Value> whole_values(8);
+  for (size_t i = 0; i < whole_values.size(); ++i)
+    whole_values[i].SetIntValue(i);
+  whole.SetValues(std::move(whole_values));
+
+  // Overlaps the middle of |whole| as single values.
+  ProbeSSBOCommand middle(color_buf.get());
+  middle.SetLine(2);
+  middle.SetFormat(&uint_fmt);
+  middle.SetOffset(8);
+  std::vector<Value> middle_values(3);
+  for (size_t i = 0; i < middle_values.size(); ++i)
+    middle_values[i].SetIntValue(i + 2);
+  middle.SetValues(std::move(middle_values));
+
+  // Reads past the end of the buffer.
+  ProbeSSBOCommand outside(color_buf.get());
+  outside.SetLine(3);
+  outside.SetFormat(&uint_fmt);
+  outside.SetOffset(28);
+  std::vector<Value> outside_values(2);
+  outside.SetValues(std::move(outside_values));
+
+  Verifier verifier;
+  Result r = verifier.ProbeSSBOBatch({&whole, &middle}, 8, ssbo);
+  EXPECT_TRUE(r.IsSuccess()) << r.Error();
+
+  r = verifier.ProbeSSBOBatch({&outside, &whole, &middle}, 8, ssbo);
+  EXPECT_EQ(
+      "Line 3: Verifier::ProbeSSBO request to access to byte 36 would read "
+      "outside buffer of size 32 bytes",
+      r.Error());
+
+  const uint32_t bad[8] = {0, 1, 2, 3, 9, 5, 6, 7};
+  r = verifier.ProbeSSBOBatch({&middle, &whole}, 8, bad);
+  EXPECT_EQ("Line 2: Verifier failed: 9 == 4, at index 2", r.Error());
+  r = verifier.ProbeSSBOBatch({&whole, &middle}, 8, bad);
+  EXPECT_EQ("Line 1: Verifier failed: 9 == 4, at index 4", r.Error());
+}
+
+TEST_F(VerifierTest, ProbeHash) {
+  TypeParser parser;
+  auto type = parser.Parse("R8_UINT");
+  Format fmt(type.get());
+
+  Buffer buffer;
+  buffer.SetName("buf");
+  buffer.SetFormat(&fmt);
+  std::vector<Value> values(9);
+  for (size_t i = 0; i < values.size(); ++i)
+    values[i].SetIntValue('1' + i);
+  ASSERT_TRUE(buffer.SetData(values).IsSuccess());
+
+  HashBufferCommand hash(&buffer);
+  hash.SetLine(5);
+  hash.SetHashType(HashType::kCRC32C);
+  hash.SetExpectedHash(0xE3069283);
+
+  Verifier verifier;
+  Result r = verifier.ProbeHash(&hash);
+  EXPECT_TRUE(r.IsSuccess()) << r.Error();
+
+  hash.SetExpectedHash(0x1234);
+  r = verifier.ProbeHash(&hash);
+  EXPECT_EQ(
+      "Line 5: Verifier failed: crc32c of buffer buf is 0xe3069283, expected "
+      "0x1234",
+      r.Error());
+}
+
+
+TEST_F(VerifierTest, ProbeFile) {
+  TypeParser parser;
+  auto type = parser.Parse("R8_UINT");
+  Format fmt(type.get());
+
+  Buffer buffer;
+  buffer.SetName("buf");
+  buffer.SetFormat(&fmt);
+  std::vector<Value> values(4);
+  for (size_t i = 0; i < values.size(); ++i)
+    values[i].SetIntValue(i);
+  ASSERT_TRUE(buffer.SetData(values).IsSuccess());
+
+  std::string path = testing::TempDir() + "amber_verifier_probe_file.bin";
+  {
+    std::ofstream out(path, std::ios::out | std::ios::binary);
+    ASSERT_TRUE(out.is_open());
+    out << std::string("\x00\x01\x02\x03", 4);
+  }
+
+  CompareFileCommand cmd(&buffer, path);
+  cmd.SetLine(7);
+
+  Verifier verifier;
+  Result r = verifier.ProbeFile(&cmd);
+  EXPECT_TRUE(r.IsSuccess()) << r.Error();
+
+  cmd.SetComparator(CompareFileCommand::Comparator::kRmse);
+  cmd.SetTolerance(0.0f);
+  r = verifier.ProbeFile(&cmd);
+  EXPECT_TRUE(r.IsSuccess()) << r.Error();
+
+  {
+    std::ofstream out(path, std::ios::out | std::ios::binary);
+    ASSERT_TRUE(out.is_open());
+    out << std::string("\x00\x01\x02", 3);
+  }
+  cmd.SetComparator(CompareFileCommand::Comparator::kEq);
+  r = verifier.ProbeFile(&cmd);
+  EXPECT_EQ("Line 7: Verifier failed: buffer buf does not match " + path +
+                ": Buffer has 4 bytes but expected data has 3",
+            r.Error());
+
+  std::remove(path.c_str());
+
+  r = verifier.ProbeFile(&cmd);
+  EXPECT_EQ("Line 7: unable to open file: " + path, r.Error());
+}
+
+TEST_F(VerifierTest, CompareImages) {
+  TypeParser parser;
+  auto type = parser.Parse("R8G8B8A8_UNORM");
+  Format fmt(type.get());
+
+  std::vector<uint8_t> data(16 * 16 * 4);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<uint8_t>(i * 7);
+
+  Buffer buffer_1;
+  buffer_1.SetName("buf_1");
+  buffer_1.SetFormat(&fmt);
+  buffer_1.SetWidth(16);
+  buffer_1.SetHeight(16);
+  ASSERT_TRUE(buffer_1.SetRawData(std::vector<uint8_t>(data)).IsSuccess());
+
+  data[(5 * 16 + 5) * 4 + 2] += 10;
+  Buffer buffer_2;
+  buffer_2.SetName("buf_2");
+  buffer_2.SetFormat(&fmt);
+  buffer_2.SetWidth(16);
+  buffer_2.SetHeight(16);
+  ASSERT_TRUE(buffer_2.SetRawData(std::move(data)).IsSuccess());
+
+  CompareBufferCommand cmd(&buffer_1, &buffer_2);
+  cmd.SetLine(3);
+
+  Verifier verifier;
+  cmd.SetComparator(CompareBufferCommand::Comparator::kSsim);
+  cmd.SetTolerance(0.9f);
+  Result r = verifier.CompareImages(&cmd);
+  EXPECT_TRUE(r.IsSuccess()) << r.Error();
+
+  cmd.SetComparator(CompareBufferCommand::Comparator::kPsnr);
+  cmd.SetTolerance(40.0f);
+  r = verifier.CompareImages(&cmd);
+  EXPECT_TRUE(r.IsSuccess()) << r.Error();
+
+  cmd.SetTolerance(100.0f);
+  r = verifier.CompareImages(&cmd);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ(0U, r.Error().find("Line 3: Verifier failed: buffer buf_1 vs "
+                               "buf_2: PSNR of "))
+      << r.Error();
+
+  cmd.SetComparator(CompareBufferCommand::Comparator::kMaxError);
+  cmd.SetComponentTolerances({0.0f, 0.0f, 0.05f, 0.0f});
+  r = verifier.CompareImages(&cmd);
+  EXPECT_TRUE(r.IsSuccess()) << r.Error();
+
+  cmd.SetComponentTolerances({0.05f, 0.05f, 0.01f, 0.05f});
+  r = verifier.CompareImages(&cmd);
+  ASSERT_FALSE(r.IsSuccess());
+  EXPECT_EQ(0U, r.Error().find("Line 3: Verifier failed: buffer buf_1 vs "
+                               "buf_2: maximum error of component B is "))
+      << r.Error();
+}
+
+TEST_F(VerifierTest, CompareImagesNonFinite) {
+  TypeParser parser;
+  auto type = parser.Parse("R32G32B32A32_SFLOAT");
+  Format fmt(type.get());
+
+  std::vector<float> values(4 * 4 * 4, 0.5f);
+  std::vector<uint8_t> data(values.size() * sizeof(float));
+  memcpy(data.data(), values.data(), data.size());
+
+  Buffer buffer_1;
+  buffer_1.SetName("buf_1");
+  buffer_1.SetFormat(&fmt);
+  buffer_1.SetWidth(4);
+  buffer_1.SetHeight(4);
+  ASSERT_TRUE(buffer_1.SetRawData(std::vector<uint8_t>(data)).IsSuccess());
+
+  values[5 * 4] = std::numeric_limits<float>::quiet_NaN();
+  memcpy(data.data(), values.data(), data.size());
+  Buffer buffer_2;
+  buffer_2.SetName("buf_2");
+  buffer_2.SetFormat(&fmt);
+  buffer_2.SetWidth(4);
+  buffer_2.SetHeight(4);
+  ASSERT_TRUE(buffer_2.SetRawData(std::move(data)).IsSuccess());
+
+  CompareBufferCommand cmd(&buffer_1, &buffer_2);
+  Verifier verifier;
+
+  // A NaN texel fails every comparator instead of slipping through.
+  cmd.SetComparator(CompareBufferCommand::Comparator::kSsim);
+  cmd.SetTolerance(0.5f);
+  EXPECT_FALSE(verifier.CompareImages(&cmd).IsSuccess());
+
+  cmd.SetComparator(CompareBufferCommand::Comparator::kPsnr);
+  cmd.SetTolerance(10.0f);
+  EXPECT_FALSE(verifier.CompareImages(&cmd).IsSuccess());
+
+  cmd.SetComparator(CompareBufferCommand::Comparator::kMaxError);
+  cmd.SetComponentTolerances({1.0f, 1.0f, 1.0f, 1.0f});
+  EXPECT_FALSE(verifier.CompareImages(&cmd).IsSuccess());
+}
+
 }  // namespace amber
@@ -54,7 +54,19 @@ CommandParser::CommandParser(Script* script,
                              const std::string& data)
     : script_(script),
       pipeline_(pipeline),
-      tokenizer_(MakeUnique<Tokenizer>(data)) {
+      // The parser may outlive |data|, so the tokenizer keeps its own copy.
+      tokenizer_(MakeUnique<Tokenizer>(std::string(data))) {
+  tokenizer_->SetCurrentLine(current_line);
+}
+
+CommandParser::CommandParser(Script* script,
+                             Pipeline* pipeline,
+                             size_t current_line,
+                             const char* data,
+                             size_t size)
+    : script_(script),
+      pipeline_(pipeline),
+      tokenizer_(MakeUnique<Tokenizer>(data, size)) {
   tokenizer_->SetCurrentLine(current_line);
 }
 
@@ -84,26 +96,26 @@ Result CommandParser::ParseBoolean(const std::string& str, bool* result) {
 }
 
 Result CommandParser::Parse() {
-  for (auto token = tokenizer_->NextToken(); !token->IsEOS();
+  for (auto token = tokenizer_->NextToken(); !token.IsEOS();
        token = tokenizer_->NextToken()) {
-    if (token->IsEOL())
+    if (token.IsEOL())
       continue;
 
-    if (!token->IsString()) {
+    if (!token.IsString()) {
       return Result(make_error(
           "Command not recognized. Received something other then a string: " +
-          token->ToOriginalString()));
+          token.ToOriginalString()));
     }
 
-    std::string cmd_name = token->AsString();
+    std::string cmd_name = token.AsString();
     Result r;
     if (cmd_name == "draw") {
       token = tokenizer_->NextToken();
-      if (!token->IsString())
+      if (!token.IsString())
         return Result(make_error("Invalid draw command in test: " +
-                                 token->ToOriginalString()));
+                                 token.ToOriginalString()));
 
-      cmd_name = token->AsString();
+      cmd_name = token.AsString();
       if (cmd_name == "rect")
         r = ProcessDrawRect();
       else if (cmd_name == "arrays")
@@ -125,9 +137,9 @@ Result CommandParser::Parse() {
       r = ProcessTolerance();
     } else if (cmd_name == "relative") {
       token = tokenizer_->NextToken();
-      if (!token->IsString() || token->AsString() != "probe")
+      if (!token.IsString() || token.AsString() != "probe")
         return Result(make_error("relative must be used with probe: " +
-                                 token->ToOriginalString()));
+                                 token.ToOriginalString()));
 
       r = ProcessProbe(true);
     } else if (cmd_name == "compute") {
@@ -137,18 +149,18 @@ Result CommandParser::Parse() {
       std::string shader_name = cmd_name;
       if (cmd_name == "tessellation") {
         token = tokenizer_->NextToken();
-        if (!token->IsString() || (token->AsString() != "control" &&
-                                   token->AsString() != "evaluation")) {
+        if (!token.IsString() || (token.AsString() != "control" &&
+                                   token.AsString() != "evaluation")) {
           return Result(
               make_error("Tessellation entrypoint must have "
                          "<evaluation|control> in name: " +
-                         token->ToOriginalString()));
+                         token.ToOriginalString()));
         }
-        shader_name += " " + token->AsString();
+        shader_name += " " + token.AsString();
       }
 
       token = tokenizer_->NextToken();
-      if (!token->IsString() || token->AsString() != "entrypoint")
+      if (!token.IsString() || token.AsString() != "entrypoint")
         return Result(make_error("Unknown command: " + shader_name));
 
       r = ProcessEntryPoint(shader_name);
@@ -262,8 +274,8 @@ Result CommandParser::ProcessDrawRect() {
   }
 
   auto token = tokenizer_->NextToken();
-  while (token->IsString()) {
-    std::string str = token->AsString();
+  while (token.IsString()) {
+    std::string str = token.AsString();
     if (str != "ortho" && str != "patch")
       return Result("Unknown parameter to draw rect: " + str);
 
@@ -275,33 +287,33 @@ Result CommandParser::ProcessDrawRect() {
     token = tokenizer_->NextToken();
   }
 
-  Result r = token->ConvertToDouble();
+  Result r = token.ConvertToDouble();
   if (!r.IsSuccess())
     return r;
-  cmd->SetX(token->AsFloat());
+  cmd->SetX(token.AsFloat());
 
   token = tokenizer_->NextToken();
-  r = token->ConvertToDouble();
+  r = token.ConvertToDouble();
   if (!r.IsSuccess())
     return r;
-  cmd->SetY(token->AsFloat());
+  cmd->SetY(token.AsFloat());
 
   token = tokenizer_->NextToken();
-  r = token->ConvertToDouble();
+  r = token.ConvertToDouble();
   if (!r.IsSuccess())
     return r;
-  cmd->SetWidth(token->AsFloat());
+  cmd->SetWidth(token.AsFloat());
 
   token = tokenizer_->NextToken();
-  r = token->ConvertToDouble();
+  r = token.ConvertToDouble();
   if (!r.IsSuccess())
     return r;
-  cmd->SetHeight(token->AsFloat());
+  cmd->SetHeight(token.AsFloat());
 
   token = tokenizer_->NextToken();
-  if (!token->IsEOS() && !token->IsEOL())
+  if (!token.IsEOS() && !token.IsEOL())
     return Result("Extra parameter to draw rect command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   commands_.push_back(std::move(cmd));
   return {};
@@ -312,10 +324,10 @@ Result CommandParser::ProcessDrawArrays() {
   cmd->SetLine(tokenizer_->GetCurrentLine());
 
   auto token = tokenizer_->NextToken();
-  while (token->IsString()) {
-    std::string str = token->AsString();
+  while (token.IsString()) {
+    std::string str = token.AsString();
     if (str != "indexed" && str != "instanced") {
-      Topology topo = NameToTopology(token->AsString());
+      Topology topo = NameToTopology(token.AsString());
       if (topo != Topology::kUnknown) {
         cmd->SetTopology(topo);
 
@@ -337,32 +349,32 @@ Result CommandParser::ProcessDrawArrays() {
   if (cmd->GetTopology() == Topology::kUnknown)
     return Result("Missing draw arrays topology");
 
-  if (!token->IsInteger())
+  if (!token.IsInteger())
     return Result("Missing integer first vertex value for draw arrays: " +
-                  token->ToOriginalString());
-  cmd->SetFirstVertexIndex(token->AsUint32());
+                  token.ToOriginalString());
+  cmd->SetFirstVertexIndex(token.AsUint32());
 
   token = tokenizer_->NextToken();
-  if (!token->IsInteger())
+  if (!token.IsInteger())
     return Result("Missing integer vertex count value for draw arrays: " +
-                  token->ToOriginalString());
-  cmd->SetVertexCount(token->AsUint32());
+                  token.ToOriginalString());
+  cmd->SetVertexCount(token.AsUint32());
 
   token = tokenizer_->NextToken();
   if (cmd->IsInstanced()) {
-    if (!token->IsEOL() && !token->IsEOS()) {
-      if (!token->IsInteger())
+    if (!token.IsEOL() && !token.IsEOS()) {
+      if (!token.IsInteger())
         return Result("Invalid instance count for draw arrays: " +
-                      token->ToOriginalString());
+                      token.ToOriginalString());
 
-      cmd->SetInstanceCount(token->AsUint32());
+      cmd->SetInstanceCount(token.AsUint32());
     }
     token = tokenizer_->NextToken();
   }
 
-  if (!token->IsEOL() && !token->IsEOS())
+  if (!token.IsEOL() && !token.IsEOS())
     return Result("Extra parameter to draw arrays command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   commands_.push_back(std::move(cmd));
   return {};
@@ -375,30 +387,30 @@ Result CommandParser::ProcessCompute() {
   auto token = tokenizer_->NextToken();
 
   // Compute can start a compute line or an entryp oint line ...
-  if (token->IsString() && token->AsString() == "entrypoint")
+  if (token.IsString() && token.AsString() == "entrypoint")
     return ProcessEntryPoint("compute");
 
-  if (!token->IsInteger())
+  if (!token.IsInteger())
     return Result("Missing integer value for compute X entry: " +
-                  token->ToOriginalString());
-  cmd->SetX(token->AsUint32());
+                  token.ToOriginalString());
+  cmd->SetX(token.AsUint32());
 
   token = tokenizer_->NextToken();
-  if (!token->IsInteger())
+  if (!token.IsInteger())
     return Result("Missing integer value for compute Y entry: " +
-                  token->ToOriginalString());
-  cmd->SetY(token->AsUint32());
+                  token.ToOriginalString());
+  cmd->SetY(token.AsUint32());
 
   token = tokenizer_->NextToken();
-  if (!token->IsInteger())
+  if (!token.IsInteger())
     return Result("Missing integer value for compute Z entry: " +
-                  token->ToOriginalString());
-  cmd->SetZ(token->AsUint32());
+                  token.ToOriginalString());
+  cmd->SetZ(token.AsUint32());
 
   token = tokenizer_->NextToken();
-  if (!token->IsEOS() && !token->IsEOL())
+  if (!token.IsEOS() && !token.IsEOL())
     return Result("Extra parameter to compute command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   commands_.push_back(std::move(cmd));
   return {};
@@ -409,62 +421,62 @@ Result CommandParser::ProcessClear() {
 
   auto token = tokenizer_->NextToken();
   std::string cmd_suffix = "";
-  if (token->IsString()) {
-    std::string str = token->AsString();
+  if (token.IsString()) {
+    std::string str = token.AsString();
     cmd_suffix = str + " ";
     if (str == "depth") {
       cmd = MakeUnique<ClearDepthCommand>(pipeline_);
       cmd->SetLine(tokenizer_->GetCurrentLine());
 
       token = tokenizer_->NextToken();
-      Result r = token->ConvertToDouble();
+      Result r = token.ConvertToDouble();
       if (!r.IsSuccess())
         return r;
 
-      cmd->AsClearDepth()->SetValue(token->AsFloat());
+      cmd->AsClearDepth()->SetValue(token.AsFloat());
     } else if (str == "stencil") {
       cmd = MakeUnique<ClearStencilCommand>(pipeline_);
       cmd->SetLine(tokenizer_->GetCurrentLine());
 
       token = tokenizer_->NextToken();
-      if (token->IsEOL() || token->IsEOS())
+      if (token.IsEOL() || token.IsEOS())
         return Result("Missing stencil value for clear stencil command: " +
-                      token->ToOriginalString());
-      if (!token->IsInteger())
+                      token.ToOriginalString());
+      if (!token.IsInteger())
         return Result("Invalid stencil value for clear stencil command: " +
-                      token->ToOriginalString());
+                      token.ToOriginalString());
 
-      cmd->AsClearStencil()->SetValue(token->AsUint32());
+      cmd->AsClearStencil()->SetValue(token.AsUint32());
     } else if (str == "color") {
       cmd = MakeUnique<ClearColorCommand>(pipeline_);
       cmd->SetLine(tokenizer_->GetCurrentLine());
 
       token = tokenizer_->NextToken();
-      Result r = token->ConvertToDouble();
+      Result r = token.ConvertToDouble();
       if (!r.IsSuccess())
         return r;
-      cmd->AsClearColor()->SetR(token->AsFloat());
+      cmd->AsClearColor()->SetR(token.AsFloat());
 
       token = tokenizer_->NextToken();
-      r = token->ConvertToDouble();
+      r = token.ConvertToDouble();
       if (!r.IsSuccess())
         return r;
-      cmd->AsClearColor()->SetG(token->AsFloat());
+      cmd->AsClearColor()->SetG(token.AsFloat());
 
       token = tokenizer_->NextToken();
-      r = token->ConvertToDouble();
+      r = token.ConvertToDouble();
       if (!r.IsSuccess())
         return r;
-      cmd->AsClearColor()->SetB(token->AsFloat());
+      cmd->AsClearColor()->SetB(token.AsFloat());
 
       token = tokenizer_->NextToken();
-      r = token->ConvertToDouble();
+      r = token.ConvertToDouble();
       if (!r.IsSuccess())
         return r;
-      cmd->AsClearColor()->SetA(token->AsFloat());
+      cmd->AsClearColor()->SetA(token.AsFloat());
     } else {
       return Result("Extra parameter to clear command: " +
-                    token->ToOriginalString());
+                    token.ToOriginalString());
     }
 
     token = tokenizer_->NextToken();
@@ -472,9 +484,9 @@ Result CommandParser::ProcessClear() {
     cmd = MakeUnique<ClearCommand>(pipeline_);
     cmd->SetLine(tokenizer_->GetCurrentLine());
   }
-  if (!token->IsEOS() && !token->IsEOL())
+  if (!token.IsEOS() && !token.IsEOL())
     return Result("Extra parameter to clear " + cmd_suffix +
-                  "command: " + token->ToOriginalString());
+                  "command: " + token.ToOriginalString());
 
   commands_.push_back(std::move(cmd));
   return {};
@@ -488,27 +500,27 @@ Result CommandParser::ParseValues(const std::string& name,
   uint32_t row_index = 0;
   auto token = tokenizer_->NextToken();
   size_t seen = 0;
-  while (!token->IsEOL() && !token->IsEOS()) {
+  while (!token.IsEOL() && !token.IsEOS()) {
     Value v;
 
     if ((fmt->IsFloat32() || fmt->IsFloat64())) {
-      if (!token->IsInteger() && !token->IsDouble()) {
+      if (!token.IsInteger() && !token.IsDouble()) {
         return Result(std::string("Invalid value provided to ") + name +
-                      " command: " + token->ToOriginalString());
+                      " command: " + token.ToOriginalString());
       }
 
-      Result r = token->ConvertToDouble();
+      Result r = token.ConvertToDouble();
       if (!r.IsSuccess())
         return r;
 
-      v.SetDoubleValue(token->AsDouble());
+      v.SetDoubleValue(token.AsDouble());
     } else {
-      if (!token->IsInteger()) {
+      if (!token.IsInteger()) {
         return Result(std::string("Invalid value provided to ") + name +
-                      " command: " + token->ToOriginalString());
+                      " command: " + token.ToOriginalString());
       }
 
-      v.SetIntValue(token->AsUint64());
+      v.SetIntValue(token.AsUint64());
     }
 
     values->push_back(v);
@@ -535,16 +547,16 @@ Result CommandParser::ProcessSSBO() {
   cmd->SetLine(tokenizer_->GetCurrentLine());
 
   auto token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return Result("Missing binding and size values for ssbo command");
-  if (!token->IsInteger())
+  if (!token.IsInteger())
     return Result("Invalid binding value for ssbo command");
 
-  uint32_t val = token->AsUint32();
+  uint32_t val = token.AsUint32();
 
   token = tokenizer_->NextToken();
-  if (token->IsString() && token->AsString() != "subdata") {
-    auto& str = token->AsString();
+  if (token.IsString() && token.AsString() != "subdata") {
+    auto& str = token.AsString();
     if (str.size() >= 2 && str[0] == ':') {
       cmd->SetDescriptorSet(val);
 
@@ -556,7 +568,7 @@ Result CommandParser::ProcessSSBO() {
       cmd->SetBinding(static_cast<uint32_t>(binding_val));
     } else {
       return Result("Invalid value for ssbo command: " +
-                    token->ToOriginalString());
+                    token.ToOriginalString());
     }
 
     token = tokenizer_->NextToken();
@@ -580,45 +592,44 @@ Result CommandParser::ProcessSSBO() {
     cmd->SetBuffer(buffer);
   }
 
-  if (token->IsString() && token->AsString() == "subdata") {
+  if (token.IsString() && token.AsString() == "subdata") {
     cmd->SetIsSubdata();
 
     token = tokenizer_->NextToken();
-    if (!token->IsString())
+    if (!token.IsString())
       return Result("Invalid type for ssbo command: " +
-                    token->ToOriginalString());
+                    token.ToOriginalString());
 
     DatumTypeParser tp;
-    auto type = tp.Parse(token->AsString());
+    auto type = tp.Parse(token.AsString());
     if (!type)
-      return Result("Invalid type provided: " + token->AsString());
+      return Result("Invalid type provided: " + token.AsString());
 
-    auto fmt = MakeUnique<Format>(type.get());
+    auto* fmt = script_->RegisterFormat(
+        MakeUnique<Format>(script_->RegisterType(std::move(type))));
     auto* buf = cmd->GetBuffer();
     if (buf->FormatIsDefault() || !buf->GetFormat()) {
-      buf->SetFormat(fmt.get());
-      script_->RegisterFormat(std::move(fmt));
-      script_->RegisterType(std::move(type));
-    } else if (!buf->GetFormat()->Equal(fmt.get())) {
+      buf->SetFormat(fmt);
+    } else if (!buf->GetFormat()->Equal(fmt)) {
       return Result("probe ssbo format does not match buffer format");
     }
 
     token = tokenizer_->NextToken();
-    if (!token->IsInteger()) {
+    if (!token.IsInteger()) {
       return Result("Invalid offset for ssbo command: " +
-                    token->ToOriginalString());
+                    token.ToOriginalString());
     }
-    if (token->AsInt32() < 0) {
+    if (token.AsInt32() < 0) {
       return Result("offset for SSBO must be positive, got: " +
-                    std::to_string(token->AsInt32()));
+                    std::to_string(token.AsInt32()));
     }
-    if ((token->AsUint32() % buf->GetFormat()->SizeInBytes()) != 0) {
+    if ((token.AsUint32() % buf->GetFormat()->SizeInBytes()) != 0) {
       return Result(
           "offset for SSBO must be a multiple of the data size expected " +
           std::to_string(buf->GetFormat()->SizeInBytes()));
     }
 
-    cmd->SetOffset(token->AsUint32());
+    cmd->SetOffset(token.AsUint32());
 
     std::vector<Value> values;
     Result r = ParseValues("ssbo", buf->GetFormat(), &values);
@@ -630,25 +641,23 @@ Result CommandParser::ProcessSSBO() {
     cmd->SetValues(std::move(values));
 
   } else {
-    if (token->IsEOL() || token->IsEOS())
+    if (token.IsEOL() || token.IsEOS())
       return Result("Missing size value for ssbo command: " +
-                    token->ToOriginalString());
-    if (!token->IsInteger())
+                    token.ToOriginalString());
+    if (!token.IsInteger())
       return Result("Invalid size value for ssbo command: " +
-                    token->ToOriginalString());
+                    token.ToOriginalString());
 
     // Resize the buffer so we'll correctly create the descriptor sets.
     auto* buf = cmd->GetBuffer();
-    buf->SetElementCount(token->AsUint32());
+    buf->SetElementCount(token.AsUint32());
 
     // Set a default format into the buffer if needed.
     if (!buf->GetFormat()) {
       TypeParser parser;
       auto type = parser.Parse("R8_SINT");
-      auto fmt = MakeUnique<Format>(type.get());
-      buf->SetFormat(fmt.get());
-      script_->RegisterFormat(std::move(fmt));
-      script_->RegisterType(std::move(type));
+      buf->SetFormat(script_->RegisterFormat(
+          MakeUnique<Format>(script_->RegisterType(std::move(type)))));
 
       // This has to come after the SetFormat() call because SetFormat() resets
       // the value back to false.
@@ -656,9 +665,9 @@ Result CommandParser::ProcessSSBO() {
     }
 
     token = tokenizer_->NextToken();
-    if (!token->IsEOS() && !token->IsEOL())
+    if (!token.IsEOS() && !token.IsEOL())
       return Result("Extra parameter for ssbo command: " +
-                    token->ToOriginalString());
+                    token.ToOriginalString());
   }
 
   commands_.push_back(std::move(cmd));
@@ -667,35 +676,35 @@ Result CommandParser::ProcessSSBO() {
 
 Result CommandParser::ProcessUniform() {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return Result("Missing binding and size values for uniform command: " +
-                  token->ToOriginalString());
-  if (!token->IsString())
+                  token.ToOriginalString());
+  if (!token.IsString())
     return Result("Invalid type value for uniform command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   std::unique_ptr<BufferCommand> cmd;
   bool is_ubo = false;
-  if (token->AsString() == "ubo") {
+  if (token.AsString() == "ubo") {
     cmd = MakeUnique<BufferCommand>(BufferCommand::BufferType::kUniform,
                                     pipeline_);
     cmd->SetLine(tokenizer_->GetCurrentLine());
 
     token = tokenizer_->NextToken();
-    if (!token->IsInteger()) {
+    if (!token.IsInteger()) {
       return Result("Invalid binding value for uniform ubo command: " +
-                    token->ToOriginalString());
+                    token.ToOriginalString());
     }
 
-    uint32_t val = token->AsUint32();
+    uint32_t val = token.AsUint32();
 
     token = tokenizer_->NextToken();
-    if (!token->IsString()) {
+    if (!token.IsString()) {
       return Result("Invalid type value for uniform ubo command: " +
-                    token->ToOriginalString());
+                    token.ToOriginalString());
     }
 
-    auto& str = token->AsString();
+    auto& str = token.AsString();
     if (str.size() >= 2 && str[0] == ':') {
       cmd->SetDescriptorSet(val);
 
@@ -703,14 +712,14 @@ Result CommandParser::ProcessUniform() {
       uint64_t binding_val = strtoul(substr.c_str(), nullptr, 10);
       if (binding_val > std::numeric_limits<uint32_t>::max())
         return Result("binding value too large in uniform ubo command: " +
-                      token->ToOriginalString());
+                      token.ToOriginalString());
 
       cmd->SetBinding(static_cast<uint32_t>(binding_val));
 
       token = tokenizer_->NextToken();
-      if (!token->IsString()) {
+      if (!token.IsString()) {
         return Result("Invalid type value for uniform ubo command: " +
-                      token->ToOriginalString());
+                      token.ToOriginalString());
       }
     } else {
       cmd->SetBinding(val);
@@ -745,40 +754,39 @@ Result CommandParser::ProcessUniform() {
   }
 
   DatumTypeParser tp;
-  auto type = tp.Parse(token->AsString());
+  auto type = tp.Parse(token.AsString());
   if (!type)
-    return Result("Invalid type provided: " + token->AsString());
+    return Result("Invalid type provided: " + token.AsString());
 
-  auto fmt = MakeUnique<Format>(type.get());
+  auto new_fmt = MakeUnique<Format>(script_->RegisterType(std::move(type)));
 
   // uniform is always std140.
   if (is_ubo)
-    fmt->SetLayout(Format::Layout::kStd140);
+    new_fmt->SetLayout(Format::Layout::kStd140);
 
+  auto* fmt = script_->RegisterFormat(std::move(new_fmt));
   auto* buf = cmd->GetBuffer();
   if (buf->FormatIsDefault() || !buf->GetFormat()) {
-    buf->SetFormat(fmt.get());
-    script_->RegisterFormat(std::move(fmt));
-    script_->RegisterType(std::move(type));
-  } else if (!buf->GetFormat()->Equal(fmt.get())) {
+    buf->SetFormat(fmt);
+  } else if (!buf->GetFormat()->Equal(fmt)) {
     return Result("probe ssbo format does not match buffer format");
   }
 
   token = tokenizer_->NextToken();
-  if (!token->IsInteger()) {
+  if (!token.IsInteger()) {
     return Result("Invalid offset value for uniform command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
   }
-  if (token->AsInt32() < 0) {
+  if (token.AsInt32() < 0) {
     return Result("offset for uniform must be positive, got: " +
-                  std::to_string(token->AsInt32()));
+                  std::to_string(token.AsInt32()));
   }
 
   auto buf_size = static_cast<int32_t>(buf->GetFormat()->SizeInBytes());
-  if (token->AsInt32() % buf_size != 0)
+  if (token.AsInt32() % buf_size != 0)
     return Result("offset for uniform must be multiple of data size");
 
-  cmd->SetOffset(token->AsUint32());
+  cmd->SetOffset(token.AsUint32());
 
   std::vector<Value> values;
   Result r = ParseValues("uniform", buf->GetFormat(), &values);
@@ -801,23 +809,23 @@ Result CommandParser::ProcessTolerance() {
 
   auto token = tokenizer_->NextToken();
   size_t found_tokens = 0;
-  while (!token->IsEOL() && !token->IsEOS() && found_tokens < 4) {
-    if (token->IsString() && token->AsString() == ",") {
+  while (!token.IsEOL() && !token.IsEOS() && found_tokens < 4) {
+    if (token.IsString() && token.AsString() == ",") {
       token = tokenizer_->NextToken();
       continue;
     }
 
-    if (token->IsInteger() || token->IsDouble()) {
-      Result r = token->ConvertToDouble();
+    if (token.IsInteger() || token.IsDouble()) {
+      Result r = token.ConvertToDouble();
       if (!r.IsSuccess())
         return r;
-      double value = token->AsDouble();
+      double value = token.AsDouble();
 
       token = tokenizer_->NextToken();
-      if (token->IsString() && token->AsString() != ",") {
-        if (token->AsString() != "%")
+      if (token.IsString() && token.AsString() != ",") {
+        if (token.AsString() != "%")
           return Result("Invalid value for tolerance command: " +
-                        token->ToOriginalString());
+                        token.ToOriginalString());
 
         current_tolerances_.push_back(Probe::Tolerance{true, value});
         token = tokenizer_->NextToken();
@@ -826,7 +834,7 @@ Result CommandParser::ProcessTolerance() {
       }
     } else {
       return Result("Invalid value for tolerance command: " +
-                    token->ToOriginalString());
+                    token.ToOriginalString());
     }
 
     ++found_tokens;
@@ -836,9 +844,9 @@ Result CommandParser::ProcessTolerance() {
   if (found_tokens != 1 && found_tokens != 4)
     return Result("Invalid number of tolerance parameters provided");
 
-  if (!token->IsEOS() && !token->IsEOL())
+  if (!token.IsEOS() && !token.IsEOL())
     return Result("Extra parameter for tolerance command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   return {};
 }
@@ -848,25 +856,25 @@ Result CommandParser::ProcessPatch() {
   cmd->SetLine(tokenizer_->GetCurrentLine());
 
   auto token = tokenizer_->NextToken();
-  if (!token->IsString() || token->AsString() != "parameter")
+  if (!token.IsString() || token.AsString() != "parameter")
     return Result("Missing parameter flag to patch command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   token = tokenizer_->NextToken();
-  if (!token->IsString() || token->AsString() != "vertices")
+  if (!token.IsString() || token.AsString() != "vertices")
     return Result("Missing vertices flag to patch command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   token = tokenizer_->NextToken();
-  if (!token->IsInteger())
+  if (!token.IsInteger())
     return Result("Invalid count parameter for patch parameter vertices: " +
-                  token->ToOriginalString());
-  cmd->SetControlPointCount(token->AsUint32());
+                  token.ToOriginalString());
+  cmd->SetControlPointCount(token.AsUint32());
 
   token = tokenizer_->NextToken();
-  if (!token->IsEOS() && !token->IsEOL())
+  if (!token.IsEOS() && !token.IsEOL())
     return Result("Extra parameter for patch parameter vertices command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   commands_.push_back(std::move(cmd));
   return {};
@@ -877,20 +885,20 @@ Result CommandParser::ProcessEntryPoint(const std::string& name) {
   cmd->SetLine(tokenizer_->GetCurrentLine());
 
   auto token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return Result("Missing entrypoint name");
 
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("Entrypoint name must be a string: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   cmd->SetShaderType(ShaderNameToType(name));
-  cmd->SetEntryPointName(token->AsString());
+  cmd->SetEntryPointName(token.AsString());
 
   token = tokenizer_->NextToken();
-  if (!token->IsEOS() && !token->IsEOL())
+  if (!token.IsEOS() && !token.IsEOL())
     return Result("Extra parameter for entrypoint command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   commands_.push_back(std::move(cmd));
 
@@ -899,12 +907,12 @@ Result CommandParser::ProcessEntryPoint(const std::string& name) {
 
 Result CommandParser::ProcessProbe(bool relative) {
   auto token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("Invalid token in probe command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   // The SSBO syntax is different from probe or probe all so handle specially.
-  if (token->AsString() == "ssbo")
+  if (token.AsString() == "ssbo")
     return ProcessProbeSSBO();
 
   if (pipeline_->GetColorAttachments().empty())
@@ -924,28 +932,28 @@ Result CommandParser::ProcessProbe(bool relative) {
     cmd->SetRelative();
 
   bool is_rect = false;
-  if (token->AsString() == "rect") {
+  if (token.AsString() == "rect") {
     is_rect = true;
     cmd->SetProbeRect();
 
     token = tokenizer_->NextToken();
-    if (!token->IsString())
+    if (!token.IsString())
       return Result("Invalid token in probe command: " +
-                    token->ToOriginalString());
-  } else if (token->AsString() == "all") {
+                    token.ToOriginalString());
+  } else if (token.AsString() == "all") {
     cmd->SetWholeWindow();
     cmd->SetProbeRect();
 
     token = tokenizer_->NextToken();
-    if (!token->IsString())
+    if (!token.IsString())
       return Result("Invalid token in probe command: " +
-                    token->ToOriginalString());
+                    token.ToOriginalString());
   }
 
-  std::string format = token->AsString();
+  std::string format = token.AsString();
   if (format != "rgba" && format != "rgb")
     return Result("Invalid format specified to probe command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   if (format == "rgba")
     cmd->SetIsRGBA();
@@ -953,47 +961,47 @@ Result CommandParser::ProcessProbe(bool relative) {
   token = tokenizer_->NextToken();
   if (!cmd->IsWholeWindow()) {
     bool got_rect_open_bracket = false;
-    if (token->IsOpenBracket()) {
+    if (token.IsOpenBracket()) {
       got_rect_open_bracket = true;
       token = tokenizer_->NextToken();
     }
 
-    Result r = token->ConvertToDouble();
+    Result r = token.ConvertToDouble();
     if (!r.IsSuccess())
       return r;
-    cmd->SetX(token->AsFloat());
+    cmd->SetX(token.AsFloat());
 
     token = tokenizer_->NextToken();
-    if (token->IsComma())
+    if (token.IsComma())
       token = tokenizer_->NextToken();
 
-    r = token->ConvertToDouble();
+    r = token.ConvertToDouble();
     if (!r.IsSuccess())
       return r;
-    cmd->SetY(token->AsFloat());
+    cmd->SetY(token.AsFloat());
 
     if (is_rect) {
       token = tokenizer_->NextToken();
-      if (token->IsComma())
+      if (token.IsComma())
         token = tokenizer_->NextToken();
 
-      r = token->ConvertToDouble();
+      r = token.ConvertToDouble();
       if (!r.IsSuccess())
         return r;
-      cmd->SetWidth(token->AsFloat());
+      cmd->SetWidth(token.AsFloat());
 
       token = tokenizer_->NextToken();
-      if (token->IsComma())
+      if (token.IsComma())
         token = tokenizer_->NextToken();
 
-      r = token->ConvertToDouble();
+      r = token.ConvertToDouble();
       if (!r.IsSuccess())
         return r;
-      cmd->SetHeight(token->AsFloat());
+      cmd->SetHeight(token.AsFloat());
     }
 
     token = tokenizer_->NextToken();
-    if (token->IsCloseBracket()) {
+    if (token.IsCloseBracket()) {
       // Close bracket without an open
       if (!got_rect_open_bracket)
         return Result("Missing open bracket for probe command");
@@ -1006,47 +1014,47 @@ Result CommandParser::ProcessProbe(bool relative) {
   }
 
   bool got_color_open_bracket = false;
-  if (token->IsOpenBracket()) {
+  if (token.IsOpenBracket()) {
     got_color_open_bracket = true;
     token = tokenizer_->NextToken();
   }
 
-  Result r = token->ConvertToDouble();
+  Result r = token.ConvertToDouble();
   if (!r.IsSuccess())
     return r;
-  cmd->SetR(token->AsFloat());
+  cmd->SetR(token.AsFloat());
 
   token = tokenizer_->NextToken();
-  if (token->IsComma())
+  if (token.IsComma())
     token = tokenizer_->NextToken();
 
-  r = token->ConvertToDouble();
+  r = token.ConvertToDouble();
   if (!r.IsSuccess())
     return r;
-  cmd->SetG(token->AsFloat());
+  cmd->SetG(token.AsFloat());
 
   token = tokenizer_->NextToken();
-  if (token->IsComma())
+  if (token.IsComma())
     token = tokenizer_->NextToken();
 
-  r = token->ConvertToDouble();
+  r = token.ConvertToDouble();
   if (!r.IsSuccess())
     return r;
-  cmd->SetB(token->AsFloat());
+  cmd->SetB(token.AsFloat());
 
   if (format == "rgba") {
     token = tokenizer_->NextToken();
-    if (token->IsComma())
+    if (token.IsComma())
       token = tokenizer_->NextToken();
 
-    r = token->ConvertToDouble();
+    r = token.ConvertToDouble();
     if (!r.IsSuccess())
       return r;
-    cmd->SetA(token->AsFloat());
+    cmd->SetA(token.AsFloat());
   }
 
   token = tokenizer_->NextToken();
-  if (token->IsCloseBracket()) {
+  if (token.IsCloseBracket()) {
     if (!got_color_open_bracket) {
       // Close without an open.
       return Result("Missing open bracket for probe command");
@@ -1057,9 +1065,9 @@ Result CommandParser::ProcessProbe(bool relative) {
     return Result("Missing close bracket for probe command");
   }
 
-  if (!token->IsEOS() && !token->IsEOL())
+  if (!token.IsEOS() && !token.IsEOL())
     return Result("Extra parameter to probe command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   commands_.push_back(std::move(cmd));
   return {};
@@ -1067,14 +1075,14 @@ Result CommandParser::ProcessProbe(bool relative) {
 
 Result CommandParser::ProcessTopology() {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOS() || token->IsEOL())
+  if (token.IsEOS() || token.IsEOL())
     return Result("Missing value for topology command");
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("Invalid value for topology command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   Topology topology = Topology::kPatchList;
-  std::string topo = token->AsString();
+  std::string topo = token.AsString();
 
   if (topo == "VK_PRIMITIVE_TOPOLOGY_PATCH_LIST")
     topology = Topology::kPatchList;
@@ -1100,12 +1108,12 @@ Result CommandParser::ProcessTopology() {
     topology = Topology::kTriangleStripWithAdjacency;
   else
     return Result("Unknown value for topology command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   token = tokenizer_->NextToken();
-  if (!token->IsEOS() && !token->IsEOL())
+  if (!token.IsEOS() && !token.IsEOL())
     return Result("Extra parameter for topology command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   pipeline_data_.SetTopology(topology);
   return {};
@@ -1113,14 +1121,14 @@ Result CommandParser::ProcessTopology() {
 
 Result CommandParser::ProcessPolygonMode() {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOS() || token->IsEOL())
+  if (token.IsEOS() || token.IsEOL())
     return Result("Missing value for polygonMode command");
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("Invalid value for polygonMode command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   PolygonMode mode = PolygonMode::kFill;
-  std::string m = token->AsString();
+  std::string m = token.AsString();
   if (m == "VK_POLYGON_MODE_FILL")
     mode = PolygonMode::kFill;
   else if (m == "VK_POLYGON_MODE_LINE")
@@ -1129,12 +1137,12 @@ Result CommandParser::ProcessPolygonMode() {
     mode = PolygonMode::kPoint;
   else
     return Result("Unknown value for polygonMode command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   token = tokenizer_->NextToken();
-  if (!token->IsEOS() && !token->IsEOL())
+  if (!token.IsEOS() && !token.IsEOL())
     return Result("Extra parameter for polygonMode command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   pipeline_data_.SetPolygonMode(mode);
   return {};
@@ -1142,14 +1150,14 @@ Result CommandParser::ProcessPolygonMode() {
 
 Result CommandParser::ProcessLogicOp() {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOS() || token->IsEOL())
+  if (token.IsEOS() || token.IsEOL())
     return Result("Missing value for logicOp command");
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("Invalid value for logicOp command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   LogicOp op = LogicOp::kClear;
-  std::string name = token->AsString();
+  std::string name = token.AsString();
   if (name == "VK_LOGIC_OP_CLEAR")
     op = LogicOp::kClear;
   else if (name == "VK_LOGIC_OP_AND")
@@ -1184,12 +1192,12 @@ Result CommandParser::ProcessLogicOp() {
     op = LogicOp::kSet;
   else
     return Result("Unknown value for logicOp command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   token = tokenizer_->NextToken();
-  if (!token->IsEOS() && !token->IsEOL())
+  if (!token.IsEOS() && !token.IsEOL())
     return Result("Extra parameter for logicOp command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   pipeline_data_.SetLogicOp(op);
   return {};
@@ -1197,15 +1205,15 @@ Result CommandParser::ProcessLogicOp() {
 
 Result CommandParser::ProcessCullMode() {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOS() || token->IsEOL())
+  if (token.IsEOS() || token.IsEOL())
     return Result("Missing value for cullMode command");
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("Invalid value for cullMode command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   CullMode mode = CullMode::kNone;
-  while (!token->IsEOS() && !token->IsEOL()) {
-    std::string name = token->AsString();
+  while (!token.IsEOS() && !token.IsEOL()) {
+    std::string name = token.AsString();
 
     if (name == "|") {
       // We treat everything as an |.
@@ -1225,7 +1233,7 @@ Result CommandParser::ProcessCullMode() {
       // Do nothing ...
     } else {
       return Result("Unknown value for cullMode command: " +
-                    token->ToOriginalString());
+                    token.ToOriginalString());
     }
 
     token = tokenizer_->NextToken();
@@ -1237,26 +1245,26 @@ Result CommandParser::ProcessCullMode() {
 
 Result CommandParser::ProcessFrontFace() {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOS() || token->IsEOL())
+  if (token.IsEOS() || token.IsEOL())
     return Result("Missing value for frontFace command");
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("Invalid value for frontFace command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   FrontFace face = FrontFace::kCounterClockwise;
-  std::string f = token->AsString();
+  std::string f = token.AsString();
   if (f == "VK_FRONT_FACE_COUNTER_CLOCKWISE")
     face = FrontFace::kCounterClockwise;
   else if (f == "VK_FRONT_FACE_CLOCKWISE")
     face = FrontFace::kClockwise;
   else
     return Result("Unknown value for frontFace command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   token = tokenizer_->NextToken();
-  if (!token->IsEOS() && !token->IsEOL())
+  if (!token.IsEOS() && !token.IsEOL())
     return Result("Extra parameter for frontFace command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   pipeline_data_.SetFrontFace(face);
   return {};
@@ -1265,20 +1273,20 @@ Result CommandParser::ProcessFrontFace() {
 Result CommandParser::ProcessBooleanPipelineData(const std::string& name,
                                                  bool* value) {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOS() || token->IsEOL())
+  if (token.IsEOS() || token.IsEOL())
     return Result("Missing value for " + name + " command");
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("Invalid value for " + name +
-                  " command: " + token->ToOriginalString());
+                  " command: " + token.ToOriginalString());
 
-  Result r = ParseBoolean(token->AsString(), value);
+  Result r = ParseBoolean(token.AsString(), value);
   if (!r.IsSuccess())
     return r;
 
   token = tokenizer_->NextToken();
-  if (!token->IsEOS() && !token->IsEOL())
+  if (!token.IsEOS() && !token.IsEOL())
     return Result("Extra parameter for " + name +
-                  " command: " + token->ToOriginalString());
+                  " command: " + token.ToOriginalString());
 
   return {};
 }
@@ -1388,19 +1396,19 @@ Result CommandParser::ProcessFloatPipelineData(const std::string& name,
   assert(value);
 
   auto token = tokenizer_->NextToken();
-  if (token->IsEOS() || token->IsEOL())
+  if (token.IsEOS() || token.IsEOL())
     return Result("Missing value for " + name + " command");
 
-  Result r = token->ConvertToDouble();
+  Result r = token.ConvertToDouble();
   if (!r.IsSuccess())
     return r;
 
-  *value = token->AsFloat();
+  *value = token.AsFloat();
 
   token = tokenizer_->NextToken();
-  if (!token->IsEOS() && !token->IsEOL())
+  if (!token.IsEOS() && !token.IsEOL())
     return Result("Extra parameter for " + name +
-                  " command: " + token->ToOriginalString());
+                  " command: " + token.ToOriginalString());
 
   return {};
 }
@@ -1516,20 +1524,20 @@ Result CommandParser::ParseBlendFactorName(const std::string& name,
 Result CommandParser::ParseBlendFactor(const std::string& name,
                                        BlendFactor* factor) {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return Result(std::string("Missing parameter for ") + name + " command");
-  if (!token->IsString())
+  if (!token.IsString())
     return Result(std::string("Invalid parameter for ") + name +
-                  " command: " + token->ToOriginalString());
+                  " command: " + token.ToOriginalString());
 
-  Result r = ParseBlendFactorName(token->AsString(), factor);
+  Result r = ParseBlendFactorName(token.AsString(), factor);
   if (!r.IsSuccess())
     return r;
 
   token = tokenizer_->NextToken();
-  if (!token->IsEOS() && !token->IsEOL())
+  if (!token.IsEOS() && !token.IsEOL())
     return Result(std::string("Extra parameter for ") + name +
-                  " command: " + token->ToOriginalString());
+                  " command: " + token.ToOriginalString());
 
   return {};
 }
@@ -1689,20 +1697,20 @@ Result CommandParser::ParseBlendOpName(const std::string& name, BlendOp* op) {
 
 Result CommandParser::ParseBlendOp(const std::string& name, BlendOp* op) {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return Result(std::string("Missing parameter for ") + name + " command");
-  if (!token->IsString())
+  if (!token.IsString())
     return Result(std::string("Invalid parameter for ") + name +
-                  " command: " + token->ToOriginalString());
+                  " command: " + token.ToOriginalString());
 
-  Result r = ParseBlendOpName(token->AsString(), op);
+  Result r = ParseBlendOpName(token.AsString(), op);
   if (!r.IsSuccess())
     return r;
 
   token = tokenizer_->NextToken();
-  if (!token->IsEOS() && !token->IsEOL())
+  if (!token.IsEOS() && !token.IsEOL())
     return Result(std::string("Extra parameter for ") + name +
-                  " command: " + token->ToOriginalString());
+                  " command: " + token.ToOriginalString());
 
   return {};
 }
@@ -1729,20 +1737,20 @@ Result CommandParser::ProcessAlphaBlendOp() {
 
 Result CommandParser::ParseCompareOp(const std::string& name, CompareOp* op) {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return Result(std::string("Missing parameter for ") + name + " command");
-  if (!token->IsString())
+  if (!token.IsString())
     return Result(std::string("Invalid parameter for ") + name +
-                  " command: " + token->ToOriginalString());
+                  " command: " + token.ToOriginalString());
 
-  Result r = ParseCompareOpName(token->AsString(), op);
+  Result r = ParseCompareOpName(token.AsString(), op);
   if (!r.IsSuccess())
     return r;
 
   token = tokenizer_->NextToken();
-  if (!token->IsEOS() && !token->IsEOL())
+  if (!token.IsEOS() && !token.IsEOL())
     return Result(std::string("Extra parameter for ") + name +
-                  " command: " + token->ToOriginalString());
+                  " command: " + token.ToOriginalString());
 
   return {};
 }
@@ -1805,20 +1813,20 @@ Result CommandParser::ProcessBackCompareOp() {
 
 Result CommandParser::ParseStencilOp(const std::string& name, StencilOp* op) {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return Result(std::string("Missing parameter for ") + name + " command");
-  if (!token->IsString())
+  if (!token.IsString())
     return Result(std::string("Invalid parameter for ") + name +
-                  " command: " + token->ToOriginalString());
+                  " command: " + token.ToOriginalString());
 
-  Result r = ParseStencilOpName(token->AsString(), op);
+  Result r = ParseStencilOpName(token.AsString(), op);
   if (!r.IsSuccess())
     return r;
 
   token = tokenizer_->NextToken();
-  if (!token->IsEOS() && !token->IsEOL())
+  if (!token.IsEOS() && !token.IsEOL())
     return Result(std::string("Extra parameter for ") + name +
-                  " command: " + token->ToOriginalString());
+                  " command: " + token.ToOriginalString());
 
   return {};
 }
@@ -1927,51 +1935,51 @@ Result CommandParser::ProcessBackWriteMask() {
 
 Result CommandParser::ProcessFrontReference() {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return Result("Missing parameter for front.reference command");
-  if (!token->IsInteger())
+  if (!token.IsInteger())
     return Result("Invalid parameter for front.reference command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
-  pipeline_data_.SetFrontReference(token->AsUint32());
+  pipeline_data_.SetFrontReference(token.AsUint32());
 
   token = tokenizer_->NextToken();
-  if (!token->IsEOS() && !token->IsEOL())
+  if (!token.IsEOS() && !token.IsEOL())
     return Result("Extra parameter for front.reference command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   return {};
 }
 
 Result CommandParser::ProcessBackReference() {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return Result("Missing parameter for back.reference command");
-  if (!token->IsInteger())
+  if (!token.IsInteger())
     return Result("Invalid parameter for back.reference command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
-  pipeline_data_.SetBackReference(token->AsUint32());
+  pipeline_data_.SetBackReference(token.AsUint32());
 
   token = tokenizer_->NextToken();
-  if (!token->IsEOS() && !token->IsEOL())
+  if (!token.IsEOS() && !token.IsEOL())
     return Result("Extra parameter for back.reference command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   return {};
 }
 
 Result CommandParser::ProcessColorWriteMask() {
   auto token = tokenizer_->NextToken();
-  if (token->IsEOS() || token->IsEOL())
+  if (token.IsEOS() || token.IsEOL())
     return Result("Missing parameter for colorWriteMask command");
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("Invalid parameter for colorWriteMask command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   uint8_t mask = 0;
-  while (!token->IsEOS() && !token->IsEOL()) {
-    std::string name = token->AsString();
+  while (!token.IsEOS() && !token.IsEOL()) {
+    std::string name = token.AsString();
 
     if (name == "|") {
       // We treat everything as an |.
@@ -2019,29 +2027,29 @@ Result CommandParser::ProcessProbeSSBO() {
   size_t cur_line = tokenizer_->GetCurrentLine();
 
   auto token = tokenizer_->NextToken();
-  if (token->IsEOL() || token->IsEOS())
+  if (token.IsEOL() || token.IsEOS())
     return Result("Missing values for probe ssbo command");
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("Invalid type for probe ssbo command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   DatumTypeParser tp;
-  auto type = tp.Parse(token->AsString());
+  auto type = tp.Parse(token.AsString());
   if (!type)
-    return Result("Invalid type provided: " + token->AsString());
+    return Result("Invalid type provided: " + token.AsString());
 
   token = tokenizer_->NextToken();
-  if (!token->IsInteger())
+  if (!token.IsInteger())
     return Result("Invalid binding value for probe ssbo command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
-  uint32_t val = token->AsUint32();
+  uint32_t val = token.AsUint32();
 
   uint32_t set = 0;
   uint32_t binding = 0;
   token = tokenizer_->NextToken();
-  if (token->IsString()) {
-    auto& str = token->AsString();
+  if (token.IsString()) {
+    auto& str = token.AsString();
     if (str.size() >= 2 && str[0] == ':') {
       set = val;
 
@@ -2049,12 +2057,12 @@ Result CommandParser::ProcessProbeSSBO() {
       uint64_t binding_val = strtoul(substr.c_str(), nullptr, 10);
       if (binding_val > std::numeric_limits<uint32_t>::max())
         return Result("binding value too large in probe ssbo command: " +
-                      token->ToOriginalString());
+                      token.ToOriginalString());
 
       binding = static_cast<uint32_t>(binding_val);
     } else {
       return Result("Invalid value for probe ssbo command: " +
-                    token->ToOriginalString());
+                    token.ToOriginalString());
     }
 
     token = tokenizer_->NextToken();
@@ -2069,36 +2077,34 @@ Result CommandParser::ProcessProbeSSBO() {
                   std::to_string(binding));
   }
 
-  auto fmt = MakeUnique<Format>(type.get());
+  auto* fmt = script_->RegisterFormat(
+      MakeUnique<Format>(script_->RegisterType(std::move(type))));
   if (buffer->FormatIsDefault() || !buffer->GetFormat()) {
-    buffer->SetFormat(fmt.get());
-  } else if (buffer->GetFormat() && !buffer->GetFormat()->Equal(fmt.get())) {
+    buffer->SetFormat(fmt);
+  } else if (buffer->GetFormat() && !buffer->GetFormat()->Equal(fmt)) {
     return Result("probe format does not match buffer format");
   }
 
   auto cmd = MakeUnique<ProbeSSBOCommand>(buffer);
   cmd->SetLine(cur_line);
   cmd->SetTolerances(current_tolerances_);
-  cmd->SetFormat(fmt.get());
+  cmd->SetFormat(fmt);
   cmd->SetDescriptorSet(set);
   cmd->SetBinding(binding);
 
-  script_->RegisterFormat(std::move(fmt));
-  script_->RegisterType(std::move(type));
-
-  if (!token->IsInteger())
+  if (!token.IsInteger())
     return Result("Invalid offset for probe ssbo command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
-  cmd->SetOffset(token->AsUint32());
+  cmd->SetOffset(token.AsUint32());
 
   token = tokenizer_->NextToken();
-  if (!token->IsString())
+  if (!token.IsString())
     return Result("Invalid comparator for probe ssbo command: " +
-                  token->ToOriginalString());
+                  token.ToOriginalString());
 
   ProbeSSBOCommand::Comparator comp = ProbeSSBOCommand::Comparator::kEqual;
-  Result r = ParseComparator(token->AsString(), &comp);
+  Result r = ParseComparator(token.AsString(), &comp);
   if (!r.IsSuccess())
     return r;
 
@@ -41,6 +41,13 @@ class CommandParser {
                 Pipeline* pipeline,
                 size_t current_line,
                 const std::string& data);
+  /// Parses the |size| characters at |data| in place. They must be part of a
+  /// NUL terminated string which outlives the parser.
+  CommandParser(Script* script,
+                Pipeline* pipeline,
+                size_t current_line,
+                const char* data,
+                size_t size);
   ~CommandParser();
 
   Result Parse();
@@ -133,7 +133,7 @@ Result Parser::ProcessShaderBlock(const SectionParser::Section& section) {
   // Generate a unique name for the shader.
   shader->SetName("vk_shader_" + std::to_string(script_->GetShaders().size()));
   shader->SetFormat(section.format);
-  shader->SetData(section.contents);
+  shader->SetData(section.Contents());
 
   Result r = script_->GetPipeline(kDefaultPipelineName)
                  ->AddShader(shader.get(), shader->GetType());
@@ -148,65 +148,63 @@ Result Parser::ProcessShaderBlock(const SectionParser::Section& section) {
 }
 
 Result Parser::ProcessRequireBlock(const SectionParser::Section& section) {
-  Tokenizer tokenizer(section.contents);
+  Tokenizer tokenizer(section.data, section.size);
   tokenizer.SetCurrentLine(section.starting_line_number + 1);
 
-  for (auto token = tokenizer.NextToken(); !token->IsEOS();
+  for (auto token = tokenizer.NextToken(); !token.IsEOS();
        token = tokenizer.NextToken()) {
-    if (token->IsEOL())
+    if (token.IsEOL())
       continue;
-    if (!token->IsString()) {
+    if (!token.IsString()) {
       return Result(make_error(
           tokenizer,
-          "Invalid token in requirements block: " + token->ToOriginalString()));
+          "Invalid token in requirements block: " + token.ToOriginalString()));
     }
 
-    std::string str = token->AsString();
+    std::string str = token.AsString();
     if (script_->IsKnownFeature(str)) {
       script_->AddRequiredFeature(str);
     } else if (str == Pipeline::kGeneratedColorBuffer) {
       token = tokenizer.NextToken();
-      if (!token->IsString())
+      if (!token.IsString())
         return Result(make_error(tokenizer, "Missing framebuffer format"));
 
       TypeParser type_parser;
-      auto type = type_parser.Parse(token->AsString());
+      auto type = type_parser.Parse(token.AsString());
       if (type == nullptr) {
         return Result(
             make_error(tokenizer, "Failed to parse framebuffer format: " +
-                                      token->ToOriginalString()));
+                                      token.ToOriginalString()));
       }
 
-      auto fmt = MakeUnique<Format>(type.get());
+      auto* fmt = script_->RegisterFormat(
+          MakeUnique<Format>(script_->RegisterType(std::move(type))));
       script_->GetPipeline(kDefaultPipelineName)
           ->GetColorAttachments()[0]
-          .buffer->SetFormat(fmt.get());
-      script_->RegisterFormat(std::move(fmt));
-      script_->RegisterType(std::move(type));
+          .buffer->SetFormat(fmt);
 
     } else if (str == "depthstencil") {
       token = tokenizer.NextToken();
-      if (!token->IsString())
+      if (!token.IsString())
         return Result(make_error(tokenizer, "Missing depthStencil format"));
 
       TypeParser type_parser;
-      auto type = type_parser.Parse(token->AsString());
+      auto type = type_parser.Parse(token.AsString());
       if (type == nullptr) {
         return Result(
             make_error(tokenizer, "Failed to parse depthstencil format: " +
-                                      token->ToOriginalString()));
+                                      token.ToOriginalString()));
       }
 
       auto* pipeline = script_->GetPipeline(kDefaultPipelineName);
       if (pipeline->GetDepthBuffer().buffer != nullptr)
         return Result("Only one depthstencil command allowed");
 
-      auto fmt = MakeUnique<Format>(type.get());
+      auto* fmt = script_->RegisterFormat(
+          MakeUnique<Format>(script_->RegisterType(std::move(type))));
       // Generate and add a depth buffer
       auto depth_buf = pipeline->GenerateDefaultDepthAttachmentBuffer();
-      depth_buf->SetFormat(fmt.get());
-      script_->RegisterFormat(std::move(fmt));
-      script_->RegisterType(std::move(type));
+      depth_buf->SetFormat(fmt);
 
       Result r = pipeline->SetDepthBuffer(depth_buf.get());
       if (!r.IsSuccess())
@@ -218,37 +216,37 @@ Result Parser::ProcessRequireBlock(const SectionParser::Section& section) {
 
     } else if (str == "fence_timeout") {
       token = tokenizer.NextToken();
-      if (!token->IsInteger())
+      if (!token.IsInteger())
         return Result(make_error(tokenizer, "Missing fence_timeout value"));
 
-      script_->GetEngineData().fence_timeout_ms = token->AsUint32();
+      script_->GetEngineData().fence_timeout_ms = token.AsUint32();
 
     } else if (str == "fbsize") {
       auto* pipeline = script_->GetPipeline(kDefaultPipelineName);
 
       token = tokenizer.NextToken();
-      if (token->IsEOL() || token->IsEOS()) {
+      if (token.IsEOL() || token.IsEOS()) {
         return Result(make_error(
             tokenizer, "Missing width and height for fbsize command"));
       }
-      if (!token->IsInteger()) {
+      if (!token.IsInteger()) {
         return Result(
             make_error(tokenizer, "Invalid width for fbsize command"));
       }
 
-      pipeline->SetFramebufferWidth(token->AsUint32());
+      pipeline->SetFramebufferWidth(token.AsUint32());
 
       token = tokenizer.NextToken();
-      if (token->IsEOL() || token->IsEOS()) {
+      if (token.IsEOL() || token.IsEOS()) {
         return Result(
             make_error(tokenizer, "Missing height for fbsize command"));
       }
-      if (!token->IsInteger()) {
+      if (!token.IsInteger()) {
         return Result(
             make_error(tokenizer, "Invalid height for fbsize command"));
       }
 
-      pipeline->SetFramebufferHeight(token->AsUint32());
+      pipeline->SetFramebufferHeight(token.AsUint32());
 
     } else {
       auto it = std::find_if(str.begin(), str.end(),
@@ -262,10 +260,10 @@ Result Parser::ProcessRequireBlock(const SectionParser::Section& section) {
     }
 
     token = tokenizer.NextToken();
-    if (!token->IsEOS() && !token->IsEOL()) {
+    if (!token.IsEOS() && !token.IsEOL()) {
       return Result(make_error(
           tokenizer, "Failed to parse requirements block: invalid token: " +
-                         token->ToOriginalString()));
+                         token.ToOriginalString()));
     }
   }
   return {};
@@ -274,37 +272,36 @@ Result Parser::ProcessRequireBlock(const SectionParser::Section& section) {
 Result Parser::ProcessIndicesBlock(const SectionParser::Section& section) {
   std::vector<Value> indices;
 
-  Tokenizer tokenizer(section.contents);
+  Tokenizer tokenizer(section.data, section.size);
   tokenizer.SetCurrentLine(section.starting_line_number);
-  for (auto token = tokenizer.NextToken(); !token->IsEOS();
+  for (auto token = tokenizer.NextToken(); !token.IsEOS();
        token = tokenizer.NextToken()) {
-    if (token->IsEOL())
+    if (token.IsEOL())
       continue;
 
-    if (!token->IsInteger())
+    if (!token.IsInteger())
       return Result(make_error(tokenizer, "Invalid value in indices block: " +
-                                              token->ToOriginalString()));
-    if (token->AsUint64() >
+                                              token.ToOriginalString()));
+    if (token.AsUint64() >
         static_cast<uint64_t>(std::numeric_limits<uint16_t>::max())) {
       return Result(make_error(tokenizer, "Value too large in indices block: " +
-                                              token->ToOriginalString()));
+                                              token.ToOriginalString()));
     }
 
     indices.push_back(Value());
-    indices.back().SetIntValue(token->AsUint16());
+    indices.back().SetIntValue(token.AsUint16());
   }
 
   if (!indices.empty()) {
     TypeParser parser;
     auto type = parser.Parse("R32_UINT");
-    auto fmt = MakeUnique<Format>(type.get());
+    auto* fmt = script_->RegisterFormat(
+        MakeUnique<Format>(script_->RegisterType(std::move(type))));
     auto b = MakeUnique<Buffer>(BufferType::kIndex);
     auto* buf = b.get();
     b->SetName("indices");
-    b->SetFormat(fmt.get());
+    b->SetFormat(fmt);
     b->SetData(std::move(indices));
-    script_->RegisterFormat(std::move(fmt));
-    script_->RegisterType(std::move(type));
 
     Result r = script_->AddBuffer(std::move(b));
     if (!r.IsSuccess())
@@ -317,16 +314,16 @@ Result Parser::ProcessIndicesBlock(const SectionParser::Section& section) {
 }
 
 Result Parser::ProcessVertexDataBlock(const SectionParser::Section& section) {
-  Tokenizer tokenizer(section.contents);
+  Tokenizer tokenizer(section.data, section.size);
   tokenizer.SetCurrentLine(section.starting_line_number);
 
   // Skip blank and comment lines
   auto token = tokenizer.NextToken();
-  while (token->IsEOL())
+  while (token.IsEOL())
     token = tokenizer.NextToken();
 
   // Skip empty vertex data blocks
-  if (token->IsEOS())
+  if (token.IsEOS())
     return {};
 
   // Process the header line.
@@ -335,28 +332,28 @@ Result Parser::ProcessVertexDataBlock(const SectionParser::Section& section) {
     Format* format;
   };
   std::vector<Header> headers;
-  while (!token->IsEOL() && !token->IsEOS()) {
+  while (!token.IsEOL() && !token.IsEOS()) {
     // Because of the way the tokenizer works we'll see a number then a string
     // the string will start with a slash which we have to remove.
-    if (!token->IsInteger()) {
+    if (!token.IsInteger()) {
       return Result(
           make_error(tokenizer, "Unable to process vertex data header: " +
-                                    token->ToOriginalString()));
+                                    token.ToOriginalString()));
     }
 
-    uint8_t loc = token->AsUint8();
+    uint8_t loc = token.AsUint8();
 
     token = tokenizer.NextToken();
-    if (!token->IsString()) {
+    if (!token.IsString()) {
       return Result(
           make_error(tokenizer, "Unable to process vertex data header: " +
-                                    token->ToOriginalString()));
+                                    token.ToOriginalString()));
     }
 
-    std::string fmt_name = token->AsString();
+    std::string fmt_name = token.AsString();
     if (fmt_name.size() < 2)
       return Result(make_error(tokenizer, "Vertex data format too short: " +
-                                              token->ToOriginalString()));
+                                              token.ToOriginalString()));
 
     TypeParser parser;
     auto type = parser.Parse(fmt_name.substr(1, fmt_name.length()));
@@ -366,10 +363,9 @@ Result Parser::ProcessVertexDataBlock(const SectionParser::Section& section) {
                                     fmt_name.substr(1, fmt_name.length())));
     }
 
-    auto fmt = MakeUnique<Format>(type.get());
-    headers.push_back({loc, fmt.get()});
-    script_->RegisterFormat(std::move(fmt));
-    script_->RegisterType(std::move(type));
+    auto* fmt = script_->RegisterFormat(
+        MakeUnique<Format>(script_->RegisterType(std::move(type))));
+    headers.push_back({loc, fmt});
 
     token = tokenizer.NextToken();
   }
@@ -379,8 +375,8 @@ Result Parser::ProcessVertexDataBlock(const SectionParser::Section& section) {
   values.resize(headers.size());
 
   // Process data lines
-  for (; !token->IsEOS(); token = tokenizer.NextToken()) {
-    if (token->IsEOL())
+  for (; !token.IsEOS(); token = tokenizer.NextToken()) {
+    if (token.IsEOL())
       continue;
 
     for (size_t j = 0; j < headers.size(); ++j) {
@@ -389,14 +385,14 @@ Result Parser::ProcessVertexDataBlock(const SectionParser::Section& section) {
 
       auto* type = header.format->GetType();
       if (type->IsList() && type->AsList()->IsPacked()) {
-        if (!token->IsHex()) {
+        if (!token.IsHex()) {
           return Result(
               make_error(tokenizer, "Invalid packed value in Vertex Data: " +
-                                        token->ToOriginalString()));
+                                        token.ToOriginalString()));
         }
 
         Value v;
-        v.SetIntValue(token->AsHex());
+        v.SetIntValue(token.AsHex());
         value_data.push_back(v);
       } else {
         auto& segs = header.format->GetSegments();
@@ -404,7 +400,7 @@ Result Parser::ProcessVertexDataBlock(const SectionParser::Section& section) {
           if (seg.IsPadding())
             continue;
 
-          if (token->IsEOS() || token->IsEOL()) {
+          if (token.IsEOS() || token.IsEOL()) {
             return Result(make_error(tokenizer,
                                      "Too few cells in given vertex data row"));
           }
@@ -412,16 +408,16 @@ Result Parser::ProcessVertexDataBlock(const SectionParser::Section& section) {
           Value v;
           if (seg.GetFormatMode() == FormatMode::kUFloat ||
               seg.GetFormatMode() == FormatMode::kSFloat) {
-            Result r = token->ConvertToDouble();
+            Result r = token.ConvertToDouble();
             if (!r.IsSuccess())
               return r;
 
-            v.SetDoubleValue(token->AsDouble());
-          } else if (token->IsInteger()) {
-            v.SetIntValue(token->AsUint64());
+            v.SetDoubleValue(token.AsDouble());
+          } else if (token.IsInteger()) {
+            v.SetIntValue(token.AsUint64());
           } else {
             return Result(make_error(tokenizer, "Invalid vertex data value: " +
-                                                    token->ToOriginalString()));
+                                                    token.ToOriginalString()));
           }
 
           value_data.push_back(v);
@@ -452,7 +448,7 @@ Result Parser::ProcessVertexDataBlock(const SectionParser::Section& section) {
 Result Parser::ProcessTestBlock(const SectionParser::Section& section) {
   auto* pipeline = script_->GetPipeline(kDefaultPipelineName);
   CommandParser cp(script_.get(), pipeline, section.starting_line_number + 1,
-                   section.contents);
+                   section.data, section.size);
   Result r = cp.Parse();
   if (!r.IsSuccess())
     return r;
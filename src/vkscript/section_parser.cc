@@ -14,9 +14,8 @@
 
 #include "src/vkscript/section_parser.h"
 
+#include <algorithm>
 #include <cassert>
-#include <iostream>
-#include <sstream>
 #include <string>
 
 #include "src/make_unique.h"
@@ -129,31 +128,30 @@ void SectionParser::AddSection(NodeType section_type,
                                ShaderType shader_type,
                                ShaderFormat fmt,
                                size_t line_count,
-                               const std::string& contents) {
+                               const char* data,
+                               size_t size) {
   if (section_type == NodeType::kComment)
     return;
 
   if (fmt == kShaderFormatDefault) {
     sections_.push_back({section_type, shader_type, kShaderFormatSpirvAsm,
-                         line_count, kPassThroughShader});
+                         line_count, kPassThroughShader,
+                         sizeof(kPassThroughShader) - 1});
     return;
   }
 
-  size_t size = contents.size();
   while (size > 0) {
-    if (contents[size - 1] == '\n' || contents[size - 1] == '\r') {
+    if (data[size - 1] == '\n' || data[size - 1] == '\r') {
       --size;
       continue;
     }
     break;
   }
 
-  sections_.push_back(
-      {section_type, shader_type, fmt, line_count, contents.substr(0, size)});
+  sections_.push_back({section_type, shader_type, fmt, line_count, data, size});
 }
 
 Result SectionParser::SplitSections(const std::string& data) {
-  std::stringstream ss(data);
   size_t line_count = 0;
   size_t section_start = 0;
   bool in_section = false;
@@ -161,14 +159,26 @@ Result SectionParser::SplitSections(const std::string& data) {
   NodeType current_type = NodeType::kComment;
   ShaderType current_shader = kShaderTypeVertex;
   ShaderFormat current_fmt = kShaderFormatText;
-  std::string section_contents;
-
-  for (std::string line; std::getline(ss, line);) {
+  // The text of the current section runs from |contents_start| to the start
+  // of the next section header, or the end of |data|.
+  size_t contents_start = 0;
+
+  size_t pos = 0;
+  while (pos < data.size()) {
+    size_t line_end = data.find('\n', pos);
+    if (line_end == std::string::npos)
+      line_end = data.size();
+    const size_t next_line = std::min(line_end + 1, data.size());
+    const char* line = data.data() + pos;
+    const size_t line_size = line_end - pos;
     ++line_count;
 
     if (!in_section) {
-      if (line.empty() || line[0] == '#' || line == "\r")
+      if (line_size == 0 || line[0] == '#' ||
+          (line_size == 1 && line[0] == '\r')) {
+        pos = next_line;
         continue;
+      }
 
       if (line[0] != '[')
         return Result(std::to_string(line_count) + ": Invalid character");
@@ -177,33 +187,28 @@ Result SectionParser::SplitSections(const std::string& data) {
       in_section = true;
     }
 
-    if (line.empty()) {
-      section_contents += "\n";
-      continue;
-    }
-
-    if (line[0] == '[') {
+    if (line_size > 0 && line[0] == '[') {
       AddSection(current_type, current_shader, current_fmt, section_start,
-                 section_contents);
+                 data.data() + contents_start, pos - contents_start);
       section_start = line_count;
-      section_contents = "";
+      contents_start = next_line;
 
-      size_t name_end = line.rfind("]");
+      std::string header(line, line_size);
+      size_t name_end = header.rfind("]");
       if (name_end == std::string::npos)
         return Result(std::to_string(line_count) + ": Missing section close");
 
-      std::string name = line.substr(1, name_end - 1);
+      std::string name = header.substr(1, name_end - 1);
 
       Result r =
           NameToNodeType(name, &current_type, &current_shader, &current_fmt);
       if (!r.IsSuccess())
         return Result(std::to_string(line_count) + ": " + r.Error());
-    } else {
-      section_contents += line + "\n";
     }
+    pos = next_line;
   }
   AddSection(current_type, current_shader, current_fmt, section_start,
-             section_contents);
+             data.data() + contents_start, data.size() - contents_start);
 
   return {};
 }
@@ -44,7 +44,13 @@ class SectionParser {
     ShaderType shader_type;  // Only valid when section_type == kShader
     ShaderFormat format;
     size_t starting_line_number;
-    std::string contents;
+    /// The text of the section is the |size| characters at |data|. They point
+    /// into the string given to Parse(), which must outlive the section.
+    const char* data;
+    size_t size;
+
+    /// Returns a copy of the text of the section.
+    std::string Contents() const { return std::string(data, size); }
   };
 
   static bool HasShader(const NodeType type);
@@ -52,6 +58,8 @@ class SectionParser {
   SectionParser();
   ~SectionParser();
 
+  /// Splits |data| into sections. The sections refer to |data| rather than
+  /// copying it.
   Result Parse(const std::string& data);
   const std::vector<Section>& Sections() const { return sections_; }
 
@@ -72,7 +80,8 @@ class SectionParser {
                   ShaderType shader_type,
                   ShaderFormat fmt,
                   size_t starting_line_number,
-                  const std::string& contents);
+                  const char* data,
+                  size_t size);
   Result NameToNodeType(const std::string& name,
                         NodeType* section_type,
                         ShaderType* shader_type,
@@ -48,7 +48,7 @@ void main() {
   EXPECT_EQ(NodeType::kShader, sections[0].section_type);
   EXPECT_EQ(kShaderTypeVertex, sections[0].shader_type);
   EXPECT_EQ(kShaderFormatGlsl, sections[0].format);
-  EXPECT_EQ(shader, sections[0].contents);
+  EXPECT_EQ(shader, sections[0].Contents());
 }
 
 TEST_F(SectionParserTest, ParseShaderGlslVertexPassthrough) {
@@ -63,7 +63,7 @@ TEST_F(SectionParserTest, ParseShaderGlslVertexPassthrough) {
   EXPECT_EQ(NodeType::kShader, sections[0].section_type);
   EXPECT_EQ(kShaderTypeVertex, sections[0].shader_type);
   EXPECT_EQ(kShaderFormatSpirvAsm, sections[0].format);
-  EXPECT_EQ(kPassThroughShader, sections[0].contents);
+  EXPECT_EQ(kPassThroughShader, sections[0].Contents());
 }
 
 TEST_F(SectionParserTest, SectionParserMultipleSections) {
@@ -100,29 +100,29 @@ test body.)";
   EXPECT_EQ(NodeType::kShader, sections[0].section_type);
   EXPECT_EQ(kShaderTypeVertex, sections[0].shader_type);
   EXPECT_EQ(kShaderFormatSpirvAsm, sections[0].format);
-  EXPECT_EQ(kPassThroughShader, sections[0].contents);
+  EXPECT_EQ(kPassThroughShader, sections[0].Contents());
 
   // fragment shader
   EXPECT_EQ(NodeType::kShader, sections[1].section_type);
   EXPECT_EQ(kShaderTypeFragment, sections[1].shader_type);
   EXPECT_EQ(kShaderFormatGlsl, sections[1].format);
-  EXPECT_EQ("#version 430\nvoid main() {}", sections[1].contents);
+  EXPECT_EQ("#version 430\nvoid main() {}", sections[1].Contents());
 
   // geometry shader
   EXPECT_EQ(NodeType::kShader, sections[2].section_type);
   EXPECT_EQ(kShaderTypeGeometry, sections[2].shader_type);
   EXPECT_EQ(kShaderFormatGlsl, sections[2].format);
-  EXPECT_EQ("float4 main() {}", sections[2].contents);
+  EXPECT_EQ("float4 main() {}", sections[2].Contents());
 
   // indices
   EXPECT_EQ(NodeType::kIndices, sections[3].section_type);
   EXPECT_EQ(kShaderFormatText, sections[3].format);
-  EXPECT_EQ("1 2 3 4\n5 6 7 8", sections[3].contents);
+  EXPECT_EQ("1 2 3 4\n5 6 7 8", sections[3].Contents());
 
   // test
   EXPECT_EQ(NodeType::kTest, sections[4].section_type);
   EXPECT_EQ(kShaderFormatText, sections[4].format);
-  EXPECT_EQ("test body.", sections[4].contents);
+  EXPECT_EQ("test body.", sections[4].Contents());
 }
 
 TEST_F(SectionParserTest, SkipCommentLinesOutsideSections) {
@@ -137,7 +137,7 @@ TEST_F(SectionParserTest, SkipCommentLinesOutsideSections) {
   EXPECT_EQ(NodeType::kShader, sections[0].section_type);
   EXPECT_EQ(kShaderTypeVertex, sections[0].shader_type);
   EXPECT_EQ(kShaderFormatGlsl, sections[0].format);
-  EXPECT_EQ("", sections[0].contents);
+  EXPECT_EQ("", sections[0].Contents());
 }
 
 TEST_F(SectionParserTest, SkipBlankLinesOutsideSections) {
@@ -152,7 +152,7 @@ TEST_F(SectionParserTest, SkipBlankLinesOutsideSections) {
   EXPECT_EQ(NodeType::kShader, sections[0].section_type);
   EXPECT_EQ(kShaderTypeVertex, sections[0].shader_type);
   EXPECT_EQ(kShaderFormatGlsl, sections[0].format);
-  EXPECT_EQ("", sections[0].contents);
+  EXPECT_EQ("", sections[0].Contents());
 }
 
 TEST_F(SectionParserTest, UnknownTextOutsideSection) {
@@ -297,5 +297,25 @@ TEST_F(SectionParserTest, HasNoShader) {
   }
 }
 
+TEST_F(SectionParserTest, SectionsReferToInput) {
+  std::string input = R"([vertex shader]
+#version 430
+
+[fragment shader]
+#version 450
+)";
+
+  SectionParser p;
+  Result r = p.SplitSectionsForTesting(input);
+  ASSERT_TRUE(r.IsSuccess()) << r.Error();
+
+  auto sections = p.Sections();
+  ASSERT_EQ(2U, sections.size());
+  EXPECT_EQ(input.data() + input.find("#version 430"), sections[0].data);
+  EXPECT_EQ("#version 430", sections[0].Contents());
+  EXPECT_EQ(input.data() + input.find("#version 450"), sections[1].data);
+  EXPECT_EQ("#version 450", sections[1].Contents());
+}
+
 }  // namespace vkscript
 }  // namespace amber
@@ -48,11 +48,11 @@ Result BufferDescriptor::CreateResourceIfNeeded() {
         "only when |transfer_buffer| is empty");
   }
 
-  if (amber_buffer_ && amber_buffer_->ValuePtr()->empty())
+  if (amber_buffer_ && amber_buffer_->GetRawDataSize() == 0)
     return {};
 
   uint32_t size_in_bytes =
-      amber_buffer_ ? static_cast<uint32_t>(amber_buffer_->ValuePtr()->size())
+      amber_buffer_ ? static_cast<uint32_t>(amber_buffer_->GetRawDataSize())
                     : 0;
   transfer_buffer_ = MakeUnique<TransferBuffer>(device_, size_in_bytes);
 
@@ -72,9 +72,10 @@ void BufferDescriptor::RecordCopyDataToResourceIfNeeded(
   if (!transfer_buffer_)
     return;
 
-  if (amber_buffer_ && !amber_buffer_->ValuePtr()->empty()) {
-    transfer_buffer_->UpdateMemoryWithRawData(*amber_buffer_->ValuePtr());
-    amber_buffer_->ValuePtr()->clear();
+  if (amber_buffer_ && amber_buffer_->GetRawDataSize() != 0) {
+    transfer_buffer_->UpdateMemoryWithRawData(amber_buffer_->GetRawData(),
+                                              amber_buffer_->GetRawDataSize());
+    amber_buffer_->ClearData();
   }
 
   transfer_buffer_->CopyToDevice(command);
@@ -107,7 +108,7 @@ Result BufferDescriptor::MoveResourceToBufferOutput() {
           "no host accessible memory pointer");
     }
 
-    if (!amber_buffer_->ValuePtr()->empty()) {
+    if (amber_buffer_->GetRawDataSize() != 0) {
       return Result(
           "Vulkan: BufferDescriptor::MoveResourceToBufferOutput() "
           "output buffer is not empty");
@@ -16,6 +16,7 @@
 
 #include <cassert>
 
+#include "src/trace.h"
 #include "src/vulkan/command_pool.h"
 #include "src/vulkan/device.h"
 
@@ -78,6 +79,7 @@ Result CommandBuffer::SubmitAndReset(uint32_t timeout_ms) {
     return Result("Vulkan::Calling vkResetFences Fail");
   }
 
+  TraceScope submit_trace(device_->GetDelegate(), "vulkan", "QueueSubmit");
   VkSubmitInfo submit_info = VkSubmitInfo();
   submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
   submit_info.commandBufferCount = 1;
@@ -86,7 +88,9 @@ Result CommandBuffer::SubmitAndReset(uint32_t timeout_ms) {
                                         fence_) != VK_SUCCESS) {
     return Result("Vulkan::Calling vkQueueSubmit Fail");
   }
+  submit_trace.End();
 
+  TraceScope wait_trace(device_->GetDelegate(), "vulkan", "WaitForFences");
   VkResult r = device_->GetPtrs()->vkWaitForFences(
       device_->GetVkDevice(), 1, &fence_, VK_TRUE,
       static_cast<uint64_t>(timeout_ms) * 1000ULL * 1000ULL /* nanosecond */);
@@ -94,6 +98,7 @@ Result CommandBuffer::SubmitAndReset(uint32_t timeout_ms) {
     return Result("Vulkan::Calling vkWaitForFences Timeout");
   if (r != VK_SUCCESS)
     return Result("Vulkan::Calling vkWaitForFences Fail");
+  wait_trace.End();
 
   if (device_->GetPtrs()->vkResetCommandBuffer(command_, 0) != VK_SUCCESS)
     return Result("Vulkan::Calling vkResetCommandBuffer Fail");
@@ -77,6 +77,9 @@ class Device {
   /// Returns the pointers to the Vulkan API methods.
   const VulkanPtrs* GetPtrs() const { return &ptrs_; }
 
+  /// Returns the delegate given to Initialize(), which may be null.
+  Delegate* GetDelegate() const { return delegate_; }
+
  private:
   Result LoadVulkanPointers(PFN_vkGetInstanceProcAddr, Delegate* delegate);
 
@@ -87,6 +90,7 @@ class Device {
   VkDevice device_ = VK_NULL_HANDLE;
   VkQueue queue_ = VK_NULL_HANDLE;
   uint32_t queue_family_index_ = 0;
+  Delegate* delegate_ = nullptr;
 
   VulkanPtrs ptrs_;
 };
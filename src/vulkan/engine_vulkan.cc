@@ -19,7 +19,9 @@
 #include <utility>
 
 #include "amber/amber_vulkan.h"
+#include "src/hash.h"
 #include "src/make_unique.h"
+#include "src/trace.h"
 #include "src/type_parser.h"
 #include "src/vulkan/compute_pipeline.h"
 #include "src/vulkan/graphics_pipeline.h"
@@ -76,17 +78,12 @@ bool AreAllExtensionsSupported(
 EngineVulkan::EngineVulkan() : Engine() {}
 
 EngineVulkan::~EngineVulkan() {
-  for (auto it = pipeline_map_.begin(); it != pipeline_map_.end(); ++it) {
-    auto& info = it->second;
-
-    for (auto mod_it = info.shader_info.begin();
-         mod_it != info.shader_info.end(); ++mod_it) {
-      auto vk_device = device_->GetVkDevice();
-      if (vk_device != VK_NULL_HANDLE &&
-          mod_it->second.shader != VK_NULL_HANDLE) {
-        device_->GetPtrs()->vkDestroyShaderModule(
-            vk_device, mod_it->second.shader, nullptr);
-      }
+  // The pipelines only borrow their shader modules from |shader_modules_|.
+  for (auto it = shader_modules_.begin(); it != shader_modules_.end(); ++it) {
+    auto vk_device = device_->GetVkDevice();
+    if (vk_device != VK_NULL_HANDLE && it->second.module != VK_NULL_HANDLE) {
+      device_->GetPtrs()->vkDestroyShaderModule(vk_device, it->second.module,
+                                                nullptr);
     }
   }
 }
@@ -138,6 +135,8 @@ Result EngineVulkan::Initialize(
 }
 
 Result EngineVulkan::CreatePipeline(amber::Pipeline* pipeline) {
+  TraceScope trace(device_->GetDelegate(), "vulkan", "CreatePipeline");
+
   // Create the pipeline data early so we can access them as needed.
   pipeline_map_[pipeline] = PipelineInfo();
   auto& info = pipeline_map_[pipeline];
@@ -260,17 +259,10 @@ Result EngineVulkan::SetShader(amber::Pipeline* pipeline,
   if (it != info.shader_info.end())
     return Result("Vulkan::Setting Duplicated Shader Types Fail");
 
-  VkShaderModuleCreateInfo create_info = VkShaderModuleCreateInfo();
-  create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-  create_info.codeSize = data.size() * sizeof(uint32_t);
-  create_info.pCode = data.data();
-
   VkShaderModule shader;
-  if (device_->GetPtrs()->vkCreateShaderModule(device_->GetVkDevice(),
-                                               &create_info, nullptr,
-                                               &shader) != VK_SUCCESS) {
-    return Result("Vulkan::Calling vkCreateShaderModule Fail");
-  }
+  Result r = GetShaderModule(data, &shader);
+  if (!r.IsSuccess())
+    return r;
 
   info.shader_info[type].shader = shader;
 
@@ -305,6 +297,32 @@ Result EngineVulkan::SetShader(amber::Pipeline* pipeline,
   return {};
 }
 
+Result EngineVulkan::GetShaderModule(const std::vector<uint32_t>& data,
+                                     VkShaderModule* module) {
+  uint64_t hash = XXH64(data.data(), data.size() * sizeof(uint32_t));
+  auto range = shader_modules_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second.code == data) {
+      *module = it->second.module;
+      return {};
+    }
+  }
+
+  VkShaderModuleCreateInfo create_info = VkShaderModuleCreateInfo();
+  create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+  create_info.codeSize = data.size() * sizeof(uint32_t);
+  create_info.pCode = data.data();
+
+  if (device_->GetPtrs()->vkCreateShaderModule(device_->GetVkDevice(),
+                                               &create_info, nullptr,
+                                               module) != VK_SUCCESS) {
+    return Result("Vulkan::Calling vkCreateShaderModule Fail");
+  }
+
+  shader_modules_.insert(std::make_pair(hash, ShaderModule{data, *module}));
+  return {};
+}
+
 Result EngineVulkan::GetVkShaderStageInfo(
     amber::Pipeline* pipeline,
     std::vector<VkPipelineShaderStageCreateInfo>* out) {
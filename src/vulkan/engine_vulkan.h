@@ -88,10 +88,24 @@ class EngineVulkan : public Engine {
                    ShaderType type,
                    const std::vector<uint32_t>& data);
 
+  /// Returns in |module| the shader module for the SPIR-V |data|, creating it
+  /// unless a module with identical SPIR-V already exists.
+  Result GetShaderModule(const std::vector<uint32_t>& data,
+                         VkShaderModule* module);
+
   std::unique_ptr<Device> device_;
   std::unique_ptr<CommandPool> pool_;
 
   std::map<amber::Pipeline*, PipelineInfo> pipeline_map_;
+
+  struct ShaderModule {
+    std::vector<uint32_t> code;
+    VkShaderModule module;
+  };
+  /// Shader modules keyed by the hash of their SPIR-V. Pipelines with
+  /// identical shaders, such as derived pipelines, share a module. The
+  /// modules are owned here and destroyed with the engine.
+  std::unordered_multimap<uint64_t, ShaderModule> shader_modules_;
 };
 
 }  // namespace vulkan
@@ -176,12 +176,11 @@ void FrameBuffer::CopyBuffersToImages() {
   for (size_t i = 0; i < color_images_.size(); ++i) {
     auto& img = color_images_[i];
     auto* info = color_attachments_[i];
-    auto* values = info->buffer->ValuePtr();
     // Nothing to do if our local buffer is empty
-    if (values->empty())
+    if (info->buffer->GetRawDataSize() == 0)
       continue;
 
-    std::memcpy(img->HostAccessibleMemoryPtr(), values->data(),
+    std::memcpy(img->HostAccessibleMemoryPtr(), info->buffer->GetRawData(),
                 info->buffer->GetSizeInBytes());
   }
 }
@@ -44,7 +44,7 @@ Result IndexBuffer::SendIndexData(CommandBuffer* command, Buffer* buffer) {
     return r;
 
   std::memcpy(transfer_buffer_->HostAccessibleMemoryPtr(),
-              buffer->ValuePtr()->data(), buffer->GetSizeInBytes());
+              buffer->GetRawData(), buffer->GetSizeInBytes());
 
   transfer_buffer_->CopyToDevice(command);
   return {};
@@ -71,11 +71,10 @@ void TransferBuffer::CopyToHost(CommandBuffer* command_buffer) {
   MemoryBarrier(command_buffer);
 }
 
-void TransferBuffer::UpdateMemoryWithRawData(
-    const std::vector<uint8_t>& raw_data) {
-  size_t effective_size =
-      raw_data.size() > GetSizeInBytes() ? GetSizeInBytes() : raw_data.size();
-  std::memcpy(HostAccessibleMemoryPtr(), raw_data.data(), effective_size);
+void TransferBuffer::UpdateMemoryWithRawData(const uint8_t* raw_data,
+                                             size_t size) {
+  size_t effective_size = size > GetSizeInBytes() ? GetSizeInBytes() : size;
+  std::memcpy(HostAccessibleMemoryPtr(), raw_data, effective_size);
 }
 
 }  // namespace vulkan
@@ -15,7 +15,8 @@
 #ifndef SRC_VULKAN_TRANSFER_BUFFER_H_
 #define SRC_VULKAN_TRANSFER_BUFFER_H_
 
-#include <vector>
+#include <cstddef>
+#include <cstdint>
 
 #include "amber/result.h"
 #include "amber/vulkan_header.h"
@@ -44,7 +45,7 @@ class TransferBuffer : public Resource {
   /// device to the host.
   void CopyToHost(CommandBuffer* command_buffer) override;
 
-  void UpdateMemoryWithRawData(const std::vector<uint8_t>& raw_data);
+  void UpdateMemoryWithRawData(const uint8_t* raw_data, size_t size);
 
  private:
   VkBuffer buffer_ = VK_NULL_HANDLE;